@@ -0,0 +1,6 @@
+CREATE TABLE IF NOT EXISTS MessagesArchive (
+  message         INTEGER     PRIMARY KEY,
+  contents        LONGBLOB    NOT NULL
+);
+-- !
+UPDATE Information SET inf_value = '11' WHERE inf_key = 'schema_version';
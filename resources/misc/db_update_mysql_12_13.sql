@@ -0,0 +1,23 @@
+CREATE TABLE IF NOT EXISTS UpdateTelemetry (
+  id              INTEGER     AUTO_INCREMENT PRIMARY KEY,
+  account_id      INTEGER     NOT NULL,
+  feed            INTEGER     NOT NULL,
+  feed_title      TEXT,
+  date_updated    BIGINT      NOT NULL CHECK (date_updated != 0),
+  is_error        INTEGER(1)  NOT NULL DEFAULT 0 CHECK (is_error >= 0 AND is_error <= 1),
+  ttfb_time       BIGINT      NOT NULL DEFAULT -1,
+  download_time   BIGINT      NOT NULL DEFAULT -1,
+  download_bytes  BIGINT      NOT NULL DEFAULT -1,
+  decode_time     BIGINT      NOT NULL DEFAULT -1,
+  parse_time      BIGINT      NOT NULL DEFAULT -1,
+  db_time         BIGINT      NOT NULL DEFAULT -1,
+  msgs_new        INTEGER     NOT NULL DEFAULT 0,
+  msgs_updated    INTEGER     NOT NULL DEFAULT 0,
+  msgs_unchanged  INTEGER     NOT NULL DEFAULT 0,
+  
+  FOREIGN KEY (account_id) REFERENCES Accounts (id)
+);
+-- !
+CREATE INDEX UpdateTelemetry_date ON UpdateTelemetry (date_updated);
+-- !
+UPDATE Information SET inf_value = '13' WHERE inf_key = 'schema_version';
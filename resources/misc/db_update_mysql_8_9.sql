@@ -0,0 +1,18 @@
+ALTER TABLE Messages
+ADD COLUMN feed_id INTEGER;
+-- !
+UPDATE Messages SET feed_id = CAST(feed AS SIGNED)
+WHERE feed_id IS NULL ORDER BY id LIMIT :chunk_size;
+-- !
+ALTER TABLE Messages
+DROP COLUMN feed;
+-- !
+ALTER TABLE Messages
+CHANGE feed_id feed INTEGER NOT NULL;
+-- !
+CREATE INDEX Messages_feed ON Messages (account_id, feed);
+-- !
+ALTER TABLE CategoriesFeeds
+MODIFY feed INTEGER NOT NULL;
+-- !
+UPDATE Information SET inf_value = '9' WHERE inf_key = 'schema_version';
@@ -0,0 +1,7 @@
+ALTER TABLE Messages ADD COLUMN is_partial INTEGER(1) NOT NULL CHECK (is_partial >= 0 AND is_partial <= 1) DEFAULT 0;
+-- !
+ALTER TABLE TtRssAccounts ADD COLUMN headlines_only INTEGER(1) NOT NULL CHECK (headlines_only >= 0 AND headlines_only <= 1) DEFAULT 0;
+-- !
+ALTER TABLE TtRssAccounts ADD COLUMN prefetch_contents INTEGER(1) NOT NULL CHECK (prefetch_contents >= 0 AND prefetch_contents <= 1) DEFAULT 0;
+-- !
+UPDATE Information SET inf_value = '12' WHERE inf_key = 'schema_version';
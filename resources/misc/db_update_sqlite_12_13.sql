@@ -0,0 +1,23 @@
+CREATE TABLE IF NOT EXISTS UpdateTelemetry (
+  id              INTEGER     PRIMARY KEY,
+  account_id      INTEGER     NOT NULL,
+  feed            INTEGER     NOT NULL,
+  feed_title      TEXT,
+  date_updated    INTEGER     NOT NULL CHECK (date_updated != 0),
+  is_error        INTEGER(1)  NOT NULL CHECK (is_error >= 0 AND is_error <= 1) DEFAULT 0,
+  ttfb_time       INTEGER     NOT NULL DEFAULT -1,
+  download_time   INTEGER     NOT NULL DEFAULT -1,
+  download_bytes  INTEGER     NOT NULL DEFAULT -1,
+  decode_time     INTEGER     NOT NULL DEFAULT -1,
+  parse_time      INTEGER     NOT NULL DEFAULT -1,
+  db_time         INTEGER     NOT NULL DEFAULT -1,
+  msgs_new        INTEGER     NOT NULL DEFAULT 0,
+  msgs_updated    INTEGER     NOT NULL DEFAULT 0,
+  msgs_unchanged  INTEGER     NOT NULL DEFAULT 0,
+  
+  FOREIGN KEY (account_id) REFERENCES Accounts (id)
+);
+-- !
+CREATE INDEX IF NOT EXISTS UpdateTelemetry_date ON UpdateTelemetry (date_updated);
+-- !
+UPDATE Information SET inf_value = '13' WHERE inf_key = 'schema_version';
@@ -0,0 +1,11 @@
+CREATE TABLE IF NOT EXISTS CategoriesFeeds (
+  category        INTEGER     NOT NULL,
+  feed            TEXT        NOT NULL,
+  account_id      INTEGER     NOT NULL,
+  
+  FOREIGN KEY (account_id) REFERENCES Accounts (id)
+);
+-- !
+CREATE INDEX IF NOT EXISTS CategoriesFeeds_category ON CategoriesFeeds (account_id, category);
+-- !
+UPDATE Information SET inf_value = '8' WHERE inf_key = 'schema_version';
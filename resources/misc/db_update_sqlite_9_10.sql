@@ -0,0 +1,12 @@
+CREATE TABLE IF NOT EXISTS RetentionPolicies (
+  account_id      INTEGER     NOT NULL,
+  feed            INTEGER     NOT NULL,
+  max_age         INTEGER     NOT NULL CHECK (max_age >= 0) DEFAULT 0,
+  max_count       INTEGER     NOT NULL CHECK (max_count >= 0) DEFAULT 0,
+  keep_starred    INTEGER(1)  NOT NULL CHECK (keep_starred >= 0 AND keep_starred <= 1) DEFAULT 1,
+  
+  PRIMARY KEY (account_id, feed),
+  FOREIGN KEY (account_id) REFERENCES Accounts (id)
+);
+-- !
+UPDATE Information SET inf_value = '10' WHERE inf_key = 'schema_version';
@@ -38,6 +38,10 @@
 #                   Otherwise simple text component is used and some features will be disabled.
 #                   Default value is "false". If QtWebEngine is installed during compilation, then
 #                   value of this variable is tweaked automatically.
+#   USE_SQLITE_BACKUP - if specified, then online backup API of SQLite library is used
+#                       for backing up of SQLite database. Qt must use the same (system)
+#                       SQLite library, otherwise "VACUUM INTO" is used at runtime.
+#                       Default value is "true" if SQLite library is found via pkg-config.
 #   PREFIX - specifies base folder to which files are copied during "make install"
 #            step, defaults to "$$OUT_PWD/usr" on Linux and to "$$OUT_PWD/app" on Windows.
 #   LRELEASE_EXECUTABLE - specifies the name/path of "lrelease" executable, defaults to "lrelease".
@@ -115,6 +119,19 @@ isEmpty(USE_WEBENGINE) {
   }
 }
 
+isEmpty(USE_SQLITE_BACKUP) {
+  CONFIG += link_pkgconfig
+
+  packagesExist(sqlite3) {
+    USE_SQLITE_BACKUP = true
+    message("rssguard: SQLite library IS installed, enabling online backups.")
+  }
+  else {
+    USE_SQLITE_BACKUP = false
+    message("rssguard: SQLite library is probably NOT installed, disabling online backups.")
+  }
+}
+
 message(rssguard: Shadow copy build directory \"$$OUT_PWD\".)
 
 isEmpty(LRELEASE_EXECUTABLE) {
@@ -194,6 +211,12 @@ else {
   message(rssguard: Application will be compiled without QtWebEngine module. Some features will be disabled.)
 }
 
+equals(USE_SQLITE_BACKUP, true) {
+  message(rssguard: Application will be compiled WITH online backups of SQLite database.)
+  LIBS += -lsqlite3
+  DEFINES += USE_SQLITE_BACKUP
+}
+
 # Make needed tweaks for RC file getting generated on Windows.
 win32 {
   RC_ICONS = resources/graphics/rssguard.ico
@@ -204,10 +227,13 @@ win32 {
 }
 
 HEADERS +=  src/core/feeddownloader.h \
+            src/core/feedstreamparser.h \
+            src/core/feedupdatetelemetry.h \
             src/core/feedsmodel.h \
             src/core/feedsproxymodel.h \
             src/core/message.h \
             src/core/messagesmodel.h \
+            src/core/messagespager.h \
             src/core/messagesproxymodel.h \
             src/core/parsingfactory.h \
             src/definitions/definitions.h \
@@ -224,6 +250,7 @@ HEADERS +=  src/core/feeddownloader.h \
             src/gui/dialogs/formabout.h \
             src/gui/dialogs/formaddaccount.h \
             src/gui/dialogs/formbackupdatabasesettings.h \
+            src/gui/dialogs/formupdatestatistics.h \
             src/gui/dialogs/formdatabasecleanup.h \
             src/gui/dialogs/formmain.h \
             src/gui/dialogs/formrestoredatabasesettings.h \
@@ -253,11 +280,16 @@ HEADERS +=  src/core/feeddownloader.h \
             src/miscellaneous/application.h \
             src/miscellaneous/autosaver.h \
             src/miscellaneous/databasecleaner.h \
+            src/miscellaneous/databasebackuper.h \
+            src/miscellaneous/retentionengine.h \
+            src/miscellaneous/tracer.h \
+            src/miscellaneous/benchmark.h \
             src/miscellaneous/databasefactory.h \
             src/miscellaneous/databasequeries.h \
             src/miscellaneous/debugging.h \
             src/miscellaneous/iconfactory.h \
             src/miscellaneous/iofactory.h \
+            src/miscellaneous/jsonstreamreader.h \
             src/miscellaneous/localization.h \
             src/miscellaneous/mutex.h \
             src/miscellaneous/settings.h \
@@ -269,6 +301,7 @@ HEADERS +=  src/core/feeddownloader.h \
             src/network-web/basenetworkaccessmanager.h \
             src/network-web/downloader.h \
             src/network-web/downloadmanager.h \
+            src/network-web/faviconresolver.h \
             src/network-web/networkfactory.h \
             src/network-web/silentnetworkaccessmanager.h \
             src/network-web/webfactory.h \
@@ -299,12 +332,15 @@ HEADERS +=  src/core/feeddownloader.h \
             src/services/standard/standardcategory.h \
             src/services/standard/standardfeed.h \
             src/services/standard/standardfeedsimportexportmodel.h \
+            src/services/standard/standardfeedsmetadatafetcher.h \
             src/services/standard/standardserviceentrypoint.h \
             src/services/standard/standardserviceroot.h \
             src/services/tt-rss/definitions.h \
             src/services/tt-rss/gui/formeditaccount.h \
             src/services/tt-rss/gui/formttrssfeeddetails.h \
             src/services/tt-rss/network/ttrssnetworkfactory.h \
+            src/services/tt-rss/network/ttrssicondownloader.h \
+            src/services/tt-rss/network/ttrsscontentsdownloader.h \
             src/services/tt-rss/ttrsscategory.h \
             src/services/tt-rss/ttrssfeed.h \
             src/services/tt-rss/ttrssrecyclebin.h \
@@ -322,10 +358,13 @@ HEADERS +=  src/core/feeddownloader.h \
             src/miscellaneous/feedreader.h
 
 SOURCES +=  src/core/feeddownloader.cpp \
+            src/core/feedstreamparser.cpp \
+            src/core/feedupdatetelemetry.cpp \
             src/core/feedsmodel.cpp \
             src/core/feedsproxymodel.cpp \
             src/core/message.cpp \
             src/core/messagesmodel.cpp \
+            src/core/messagespager.cpp \
             src/core/messagesproxymodel.cpp \
             src/core/parsingfactory.cpp \
             src/dynamic-shortcuts/dynamicshortcuts.cpp \
@@ -341,6 +380,7 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/gui/dialogs/formabout.cpp \
             src/gui/dialogs/formaddaccount.cpp \
             src/gui/dialogs/formbackupdatabasesettings.cpp \
+            src/gui/dialogs/formupdatestatistics.cpp \
             src/gui/dialogs/formdatabasecleanup.cpp \
             src/gui/dialogs/formmain.cpp \
             src/gui/dialogs/formrestoredatabasesettings.cpp \
@@ -371,11 +411,16 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/miscellaneous/application.cpp \
             src/miscellaneous/autosaver.cpp \
             src/miscellaneous/databasecleaner.cpp \
+            src/miscellaneous/databasebackuper.cpp \
+            src/miscellaneous/retentionengine.cpp \
+            src/miscellaneous/tracer.cpp \
+            src/miscellaneous/benchmark.cpp \
             src/miscellaneous/databasefactory.cpp \
             src/miscellaneous/databasequeries.cpp \
             src/miscellaneous/debugging.cpp \
             src/miscellaneous/iconfactory.cpp \
             src/miscellaneous/iofactory.cpp \
+            src/miscellaneous/jsonstreamreader.cpp \
             src/miscellaneous/localization.cpp \
             src/miscellaneous/mutex.cpp \
             src/miscellaneous/settings.cpp \
@@ -386,6 +431,7 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/network-web/basenetworkaccessmanager.cpp \
             src/network-web/downloader.cpp \
             src/network-web/downloadmanager.cpp \
+            src/network-web/faviconresolver.cpp \
             src/network-web/networkfactory.cpp \
             src/network-web/silentnetworkaccessmanager.cpp \
             src/network-web/webfactory.cpp \
@@ -415,11 +461,14 @@ SOURCES +=  src/core/feeddownloader.cpp \
             src/services/standard/standardcategory.cpp \
             src/services/standard/standardfeed.cpp \
             src/services/standard/standardfeedsimportexportmodel.cpp \
+            src/services/standard/standardfeedsmetadatafetcher.cpp \
             src/services/standard/standardserviceentrypoint.cpp \
             src/services/standard/standardserviceroot.cpp \
             src/services/tt-rss/gui/formeditaccount.cpp \
             src/services/tt-rss/gui/formttrssfeeddetails.cpp \
             src/services/tt-rss/network/ttrssnetworkfactory.cpp \
+            src/services/tt-rss/network/ttrssicondownloader.cpp \
+            src/services/tt-rss/network/ttrsscontentsdownloader.cpp \
             src/services/tt-rss/ttrsscategory.cpp \
             src/services/tt-rss/ttrssfeed.cpp \
             src/services/tt-rss/ttrssrecyclebin.cpp \
@@ -442,6 +491,7 @@ FORMS +=    src/gui/toolbareditor.ui \
             src/gui/dialogs/formabout.ui \
             src/gui/dialogs/formaddaccount.ui \
             src/gui/dialogs/formbackupdatabasesettings.ui \
+            src/gui/dialogs/formupdatestatistics.ui \
             src/gui/dialogs/formdatabasecleanup.ui \
             src/gui/dialogs/formmain.ui \
             src/gui/dialogs/formrestoredatabasesettings.ui \
@@ -19,6 +19,10 @@
 
 #include "services/abstract/feed.h"
 #include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/databasequeries.h"
+#include "miscellaneous/debugging.h"
+#include "miscellaneous/tracer.h"
 
 #include <QThread>
 #include <QDebug>
@@ -48,21 +52,28 @@ bool FeedDownloader::isUpdateRunning() const {
 }
 
 void FeedDownloader::updateAvailableFeeds() {
+  TraceSpan span("feeds", "FeedDownloader::updateAvailableFeeds");
+  int started_feeds = 0;
+
   while (!m_feeds.isEmpty()) {
     connect(m_feeds.first(), &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished,
             (Qt::ConnectionType) (Qt::UniqueConnection | Qt::AutoConnection));
     if (m_threadPool->tryStart(m_feeds.first())) {
       m_feeds.removeFirst();
       m_feedsUpdating++;
+      started_feeds++;
     }
     else {
       // We want to start update of some feeds but all working threads are occupied.
       break;
     }
   }
+
+  span.setArgument("started", started_feeds);
 }
 
 void FeedDownloader::updateFeeds(const QList<Feed*> &feeds) {
+  TraceSpan span("feeds", "FeedDownloader::updateFeeds");
   QMutexLocker locker(m_mutex);
 
   if (feeds.isEmpty()) {
@@ -70,7 +81,7 @@ void FeedDownloader::updateFeeds(const QList<Feed*> &feeds) {
     finalizeUpdate();
   }
   else {
-    qDebug().nospace() << "Starting feed updates from worker in thread: \'" << QThread::currentThreadId() << "\'.";
+    qCDebug(LOGNETWORK).nospace() << "Starting feed updates from worker in thread: \'" << QThread::currentThreadId() << "\'.";
 
     m_feeds = feeds;
     m_feedsOriginalCount = m_feeds.size();
@@ -89,6 +100,7 @@ void FeedDownloader::stopRunningUpdate() {
 }
 
 void FeedDownloader::oneFeedUpdateFinished(const QList<Message> &messages, bool error_during_obtaining) {
+  TraceSpan span("feeds", "FeedDownloader::oneFeedUpdateFinished");
   QMutexLocker locker(m_mutex);
 
   m_feedsUpdated++;
@@ -96,15 +108,17 @@ void FeedDownloader::oneFeedUpdateFinished(const QList<Message> &messages, bool
 
   Feed *feed = qobject_cast<Feed*>(sender());
 
+  span.setArgument("feed", feed->id());
+
   disconnect(feed, &Feed::messagesObtained, this, &FeedDownloader::oneFeedUpdateFinished);
 
   // Now, we check if there are any feeds we would like to update too.
   updateAvailableFeeds();
 
   // Now make sure, that messages are actually stored to SQL in a locked state.
-  qDebug().nospace() << "Saving messages of feed "
-                     << feed->id() << " in thread: \'"
-                     << QThread::currentThreadId() << "\'.";
+  qCDebug(LOGNETWORK).nospace() << "Saving messages of feed "
+                                << feed->id() << " in thread: \'"
+                                << QThread::currentThreadId() << "\'.";
 
   int updated_messages = feed->updateMessages(messages, error_during_obtaining);
 
@@ -118,7 +132,9 @@ void FeedDownloader::oneFeedUpdateFinished(const QList<Message> &messages, bool
     m_results.appendUpdatedFeed(QPair<QString,int>(feed->title(), updated_messages));
   }
 
-  qDebug("Made progress in feed updates, total feeds count %d/%d (id of feed is %d).", m_feedsUpdated, m_feedsOriginalCount, feed->id());
+  m_results.appendTelemetry(feed->lastUpdateTelemetry());
+
+  qCDebug(LOGNETWORK, "Made progress in feed updates, total feeds count %d/%d (id of feed is %d).", m_feedsUpdated, m_feedsOriginalCount, feed->id());
   emit updateProgress(feed, m_feedsUpdated, m_feedsOriginalCount);
 
   if (m_feeds.isEmpty() && m_feedsUpdating <= 0) {
@@ -127,10 +143,19 @@ void FeedDownloader::oneFeedUpdateFinished(const QList<Message> &messages, bool
 }
 
 void FeedDownloader::finalizeUpdate() {
-  qDebug().nospace() << "Finished feed updates in thread: \'" << QThread::currentThreadId() << "\'.";
+  TraceSpan span("feeds", "FeedDownloader::finalizeUpdate");
+
+  qCDebug(LOGNETWORK).nospace() << "Finished feed updates in thread: \'" << QThread::currentThreadId() << "\'.";
 
   m_results.sort();
 
+  if (!m_results.telemetry().isEmpty()) {
+    QSqlDatabase database = qApp->database()->connection(QSL("feed_upd"), DatabaseFactory::FromSettings);
+
+    DatabaseQueries::storeUpdateTelemetry(database, m_results.telemetry());
+    DatabaseQueries::purgeUpdateTelemetry(database, QDateTime::currentDateTimeUtc().addDays(-UPDATE_TELEMETRY_MAX_AGE));
+  }
+
   // Update of feeds has finished.
   // NOTE: This means that now "update lock" can be unlocked
   // and feeds can be added/edited/deleted and application
@@ -138,7 +163,8 @@ void FeedDownloader::finalizeUpdate() {
   emit updateFinished(m_results);
 }
 
-FeedDownloadResults::FeedDownloadResults() : m_updatedFeeds(QList<QPair<QString,int> >()) {
+FeedDownloadResults::FeedDownloadResults() : m_updatedFeeds(QList<QPair<QString,int> >()),
+  m_telemetry(QList<FeedUpdateTelemetry>()) {
 }
 
 QString FeedDownloadResults::overview(int how_many_feeds) const {
@@ -161,6 +187,10 @@ void FeedDownloadResults::appendUpdatedFeed(const QPair<QString,int> &feed) {
   m_updatedFeeds.append(feed);
 }
 
+void FeedDownloadResults::appendTelemetry(const FeedUpdateTelemetry &telemetry) {
+  m_telemetry.append(telemetry);
+}
+
 void FeedDownloadResults::sort() {
   qSort(m_updatedFeeds.begin(), m_updatedFeeds.end(), FeedDownloadResults::lessThan);
 }
@@ -171,8 +201,13 @@ bool FeedDownloadResults::lessThan(const QPair<QString, int> &lhs, const QPair<Q
 
 void FeedDownloadResults::clear() {
   m_updatedFeeds.clear();
+  m_telemetry.clear();
 }
 
 QList<QPair<QString,int> > FeedDownloadResults::updatedFeeds() const {
   return m_updatedFeeds;
 }
+
+QList<FeedUpdateTelemetry> FeedDownloadResults::telemetry() const {
+  return m_telemetry;
+}
@@ -23,6 +23,7 @@
 #include <QPair>
 
 #include "core/message.h"
+#include "core/feedupdatetelemetry.h"
 
 
 class Feed;
@@ -35,9 +36,11 @@ class FeedDownloadResults {
     explicit FeedDownloadResults();
 
     QList<QPair<QString,int> > updatedFeeds() const;
+    QList<FeedUpdateTelemetry> telemetry() const;
     QString overview(int how_many_feeds) const;
 
     void appendUpdatedFeed(const QPair<QString,int> &feed);
+    void appendTelemetry(const FeedUpdateTelemetry &telemetry);
     void sort();
     void clear();
 
@@ -46,6 +49,9 @@ class FeedDownloadResults {
   private:
     // QString represents title if the feed, int represents count of newly downloaded messages.
     QList<QPair<QString,int> > m_updatedFeeds;
+
+    // Measurements of all processed feeds, including those without new messages.
+    QList<FeedUpdateTelemetry> m_telemetry;
 };
 
 // This class offers means to "update" feeds and "special" categories.
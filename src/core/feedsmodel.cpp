@@ -26,19 +26,23 @@
 #include "services/standard/standardserviceroot.h"
 #include "miscellaneous/textfactory.h"
 #include "miscellaneous/databasefactory.h"
+#include "miscellaneous/databasequeries.h"
+#include "miscellaneous/debugging.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/feedreader.h"
+#include "miscellaneous/tracer.h"
 
 #include <QSqlError>
 #include <QSqlRecord>
 #include <QPair>
 #include <QStack>
 #include <QMimeData>
+#include <QTimer>
 
 #include <algorithm>
 
 
-FeedsModel::FeedsModel(QObject *parent) : QAbstractItemModel(parent) {
+FeedsModel::FeedsModel(QObject *parent) : QAbstractItemModel(parent), m_iconsPurgeScheduled(false) {
   setObjectName(QSL("FeedsModel"));
 
   // Create root item.
@@ -262,6 +266,7 @@ void FeedsModel::removeItem(const QModelIndex &index) {
 
     deleting_item->deleteLater();
     notifyWithCounts();
+    scheduleIconsPurge();
   }
 }
 
@@ -277,9 +282,22 @@ void FeedsModel::removeItem(RootItem *deleting_item) {
 
     deleting_item->deleteLater();
     notifyWithCounts();
+    scheduleIconsPurge();
   }
 }
 
+void FeedsModel::scheduleIconsPurge() {
+  if (!m_iconsPurgeScheduled) {
+    m_iconsPurgeScheduled = true;
+    QTimer::singleShot(0, this, SLOT(purgeUnusedIcons()));
+  }
+}
+
+void FeedsModel::purgeUnusedIcons() {
+  m_iconsPurgeScheduled = false;
+  DatabaseQueries::purgeUnusedIcons(qApp->database()->connection(objectName(), DatabaseFactory::FromSettings));
+}
+
 void FeedsModel::reassignNodeToNewParent(RootItem *original_node, RootItem *new_parent) {
   RootItem *original_parent = original_node->parent();
 
@@ -304,6 +322,18 @@ void FeedsModel::reassignNodeToNewParent(RootItem *original_node, RootItem *new_
   }
 }
 
+void FeedsModel::appendNodesToParents(const QList<QPair<RootItem*,RootItem*> > &nodes_with_parents) {
+  // NOTE: Nodes are only appended to the end of children lists,
+  // so existing indexes remain valid.
+  emit layoutAboutToBeChanged();
+
+  for (int i = 0; i < nodes_with_parents.size(); i++) {
+    nodes_with_parents.at(i).second->appendChild(nodes_with_parents.at(i).first);
+  }
+
+  emit layoutChanged();
+}
+
 QList<ServiceRoot*> FeedsModel::serviceRoots() const {
   QList<ServiceRoot*> roots;
 
@@ -377,10 +407,6 @@ QList<Feed*> FeedsModel::feedsForScheduledUpdate(bool auto_update_now) {
   return feeds_for_update;
 }
 
-QList<Message> FeedsModel::messagesForItem(RootItem *item) const {
-  return item->undeletedMessages();
-}
-
 int FeedsModel::columnCount(const QModelIndex &parent) const {
   Q_UNUSED(parent)
 
@@ -456,16 +482,20 @@ void FeedsModel::reloadChangedItem(RootItem *item) {
 }
 
 void FeedsModel::notifyWithCounts() {
+  TraceSpan span("model", "FeedsModel::notifyWithCounts");
   emit messageCountsChanged(countOfUnreadMessages(), hasAnyFeedNewMessages());
 }
 
 void FeedsModel::onItemDataChanged(const QList<RootItem *> &items) {
+  TraceSpan span("model", "FeedsModel::onItemDataChanged");
+  span.setArgument("items", items.size());
+
   if (items.size() > RELOAD_MODEL_BORDER_NUM) {
-    qDebug("There is request to reload feed model for more than %d items, reloading model fully.", RELOAD_MODEL_BORDER_NUM);
+    qCDebug(LOGMODEL, "There is request to reload feed model for more than %d items, reloading model fully.", RELOAD_MODEL_BORDER_NUM);
     reloadWholeLayout();
   }
   else {
-    qDebug("There is request to reload feed model, reloading the %d items individually.", items.size());
+    qCDebug(LOGMODEL, "There is request to reload feed model, reloading the %d items individually.", items.size());
 
     foreach (RootItem *item, items) {
       reloadChangedItem(item);
@@ -476,6 +506,7 @@ void FeedsModel::onItemDataChanged(const QList<RootItem *> &items) {
 }
 
 void FeedsModel::reloadWholeLayout() {
+  Tracer::recordInstant("model", "FeedsModel::reloadWholeLayout");
   emit layoutAboutToBeChanged();
   emit layoutChanged();
 }
@@ -490,8 +521,10 @@ bool FeedsModel::addServiceAccount(ServiceRoot *root, bool freshly_activated) {
   // Connect.
   connect(root, &ServiceRoot::itemRemovalRequested, this, static_cast<void (FeedsModel::*)(RootItem*)>(&FeedsModel::removeItem));
   connect(root, &ServiceRoot::itemReassignmentRequested, this, &FeedsModel::reassignNodeToNewParent);
+  connect(root, &ServiceRoot::itemsAppendRequested, this, &FeedsModel::appendNodesToParents);
   connect(root, &ServiceRoot::dataChanged, this, &FeedsModel::onItemDataChanged);
   connect(root, &ServiceRoot::reloadMessageListRequested, this, &FeedsModel::reloadMessageListRequested);
+  connect(root, &ServiceRoot::messagesChangesAvailable, this, &FeedsModel::messagesChangesAvailable);
   connect(root, &ServiceRoot::itemExpandRequested, this, &FeedsModel::itemExpandRequested);
   connect(root, &ServiceRoot::itemExpandStateSaveRequested, this, &FeedsModel::itemExpandStateSaveRequested);
 
@@ -528,6 +561,10 @@ bool FeedsModel::emptyAllBins() {
 }
 
 void FeedsModel::loadActivatedServiceAccounts() {
+  // Icons stored inline by older versions are moved to icon store just once,
+  // so that they are not decoded on every startup.
+  DatabaseQueries::migrateLegacyIcons(qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings));
+
   // Iterate all globally available feed "service plugins".
   foreach (const ServiceEntryPoint *entry_point, qApp->feedReader()->feedServices()) {
     // Load all stored root nodes from the entry point and add those to the model.
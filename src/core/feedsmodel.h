@@ -81,11 +81,6 @@ class FeedsModel : public QAbstractItemModel {
     // This method might change some properties of some feeds.
     QList<Feed*> feedsForScheduledUpdate(bool auto_update_now);
 
-    // Returns (undeleted) messages for given feeds.
-    // This is usually used for displaying whole feeds
-    // in "newspaper" mode.
-    QList<Message> messagesForItem(RootItem *item) const;
-
     // Returns ALL RECURSIVE CHILD feeds contained within single index.
     QList<Feed*> feedsForIndex(const QModelIndex &index) const;
 
@@ -116,6 +111,10 @@ class FeedsModel : public QAbstractItemModel {
     // If it is, then it reassigns original_node to new parent.
     void reassignNodeToNewParent(RootItem *original_node, RootItem *new_parent);
 
+    // Appends new nodes, which are not part of the model yet, to
+    // their new parents. Layout is changed only once for all nodes.
+    void appendNodesToParents(const QList<QPair<RootItem*,RootItem*> > &nodes_with_parents);
+
     // Adds given service root account.
     bool addServiceAccount(ServiceRoot *root, bool freshly_activated);
 
@@ -153,6 +152,9 @@ class FeedsModel : public QAbstractItemModel {
   private slots:
     void onItemDataChanged(const QList<RootItem*> &items);
 
+    // Removes icons of removed items from icon store.
+    void purgeUnusedIcons();
+
   signals:
     // Emitted if counts of messages are changed.
     void messageCountsChanged(int unread_messages, bool any_feed_has_unread_messages);
@@ -167,15 +169,24 @@ class FeedsModel : public QAbstractItemModel {
     // Emitted when there is a need of reloading of displayed messages.
     void reloadMessageListRequested(bool mark_selected_messages_read);
 
+    // Emitted when some messages are changed in DB and
+    // displayed messages can be updated without reloading.
+    void messagesChangesAvailable(MessagesChanges changes);
+
     // There was some drag/drop operation, notify view about this.
     // NOTE: View will probably expand dropped index.
     void requireItemValidationAfterDragDrop(const QModelIndex &source_index);
 
   private:
+    // Icons are purged once after items are removed, operation
+    // removing many items is finished and committed by then.
+    void scheduleIconsPurge();
+
     RootItem *m_rootItem;
     QList<QString> m_headerData;
     QList<QString> m_tooltipData;
     QIcon m_countsIcon;
+    bool m_iconsPurgeScheduled;
 };
 
 #endif // FEEDSMODEL_H
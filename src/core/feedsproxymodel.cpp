@@ -27,7 +27,8 @@
 
 FeedsProxyModel::FeedsProxyModel(FeedsModel *source_model, QObject *parent)
   : QSortFilterProxyModel(parent), m_sourceModel(source_model), m_selectedItem(nullptr),
-    m_showUnreadOnly(false), m_hiddenIndices(QList<QPair<int,QModelIndex> >()) {
+    m_showUnreadOnly(false), m_selectedPath(QSet<const RootItem*>()), m_selectedIndex(QPersistentModelIndex()),
+    m_pendingSelectionChanges(QList<QPersistentModelIndex>()), m_hiddenItems(QSet<const RootItem*>()) {
   setObjectName(QSL("FeedsProxyModel"));
   setSortRole(Qt::EditRole);
   setSortCaseSensitivity(Qt::CaseInsensitive);
@@ -36,6 +37,10 @@ FeedsProxyModel::FeedsProxyModel(FeedsModel *source_model, QObject *parent)
   setFilterRole(Qt::EditRole);
   setDynamicSortFilter(true);
   setSourceModel(m_sourceModel);
+
+  // Removed items must not stay in the list of hidden items.
+  connect(m_sourceModel, SIGNAL(modelReset()), this, SLOT(clearHiddenItems()));
+  connect(m_sourceModel, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)), this, SLOT(forgetRemovedItems(QModelIndex,int,int)));
 }
 
 FeedsProxyModel::~FeedsProxyModel() {
@@ -180,27 +185,6 @@ bool FeedsProxyModel::lessThan(const QModelIndex &left, const QModelIndex &right
 }
 
 bool FeedsProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const {
-  bool should_show = filterAcceptsRowInternal(source_row, source_parent);
-
-  if (should_show && m_hiddenIndices.contains(QPair<int,QModelIndex>(source_row, source_parent))) {
-    const_cast<FeedsProxyModel*>(this)->m_hiddenIndices.removeAll(QPair<int,QModelIndex>(source_row, source_parent));
-
-    // Load status.
-    emit expandAfterFilterIn(m_sourceModel->index(source_row, 0, source_parent));
-  }
-
-  if (!should_show) {
-    const_cast<FeedsProxyModel*>(this)->m_hiddenIndices.append(QPair<int,QModelIndex>(source_row, source_parent));
-  }
-
-  return should_show;
-}
-
-bool FeedsProxyModel::filterAcceptsRowInternal(int source_row, const QModelIndex &source_parent) const {
-  if (!m_showUnreadOnly) {
-    return QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
-  }
-
   const QModelIndex idx = m_sourceModel->index(source_row, 0, source_parent);
 
   if (!idx.isValid()) {
@@ -208,13 +192,30 @@ bool FeedsProxyModel::filterAcceptsRowInternal(int source_row, const QModelIndex
   }
 
   const RootItem *item = m_sourceModel->itemForIndex(idx);
+  const bool should_show = m_showUnreadOnly ?
+                             filterAcceptsRowInternal(item) :
+                             QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent);
+
+  if (should_show) {
+    if (m_hiddenItems.remove(item)) {
+      // Load status.
+      emit expandAfterFilterIn(idx);
+    }
+  }
+  else {
+    m_hiddenItems.insert(item);
+  }
 
+  return should_show;
+}
+
+bool FeedsProxyModel::filterAcceptsRowInternal(const RootItem *item) const {
   if (item->kind() == RootItemKind::Bin || item->kind() == RootItemKind::ServiceRoot) {
     // Recycle bin is always displayed.
     return true;
   }
-  else if (item->isParentOf(m_selectedItem)/* || item->isChildOf(m_selectedItem)*/ || m_selectedItem == item) {
-    // Currently selected item and all its parents and children must be displayed.
+  else if (m_selectedPath.contains(item)) {
+    // Currently selected item and all its parents must be displayed.
     return true;
   }
   else {
@@ -229,7 +230,61 @@ const RootItem *FeedsProxyModel::selectedItem() const {
 }
 
 void FeedsProxyModel::setSelectedItem(const RootItem *selected_item) {
+  if (m_selectedItem == selected_item) {
+    return;
+  }
+
   m_selectedItem = selected_item;
+  m_selectedPath.clear();
+
+  for (const RootItem *item = selected_item; item != nullptr; item = item->parent()) {
+    m_selectedPath.insert(item);
+  }
+
+  // NOTE: Previously selected item may be already deleted here, so
+  // persistent index is used to find rows which need to be re-evaluated.
+  m_pendingSelectionChanges.append(m_selectedIndex);
+  m_selectedIndex = QPersistentModelIndex(m_sourceModel->indexForItem(selected_item));
+  m_pendingSelectionChanges.append(m_selectedIndex);
+
+  if (m_showUnreadOnly) {
+    QTimer::singleShot(0, this, SLOT(refilterSelectionChanges()));
+  }
+  else {
+    // Selection does not affect filtering now.
+    m_pendingSelectionChanges.clear();
+  }
+}
+
+void FeedsProxyModel::refilterSelectionChanges() {
+  QModelIndexList changed_indexes;
+
+  while (!m_pendingSelectionChanges.isEmpty()) {
+    const QPersistentModelIndex idx = m_pendingSelectionChanges.takeFirst();
+
+    if (idx.isValid()) {
+      changed_indexes.append(idx);
+    }
+  }
+
+  // Rows of items and all their parents are re-evaluated by dynamic filter.
+  m_sourceModel->reloadChangedLayout(changed_indexes);
+}
+
+void FeedsProxyModel::clearHiddenItems() {
+  m_hiddenItems.clear();
+}
+
+void FeedsProxyModel::forgetRemovedItems(const QModelIndex &parent, int first, int last) {
+  if (m_hiddenItems.isEmpty()) {
+    return;
+  }
+
+  for (int row = first; row <= last; row++) {
+    foreach (const RootItem *item, m_sourceModel->itemForIndex(m_sourceModel->index(row, 0, parent))->getSubTree()) {
+      m_hiddenItems.remove(item);
+    }
+  }
 }
 
 bool FeedsProxyModel::showUnreadOnly() const {
@@ -20,6 +20,9 @@
 
 #include <QSortFilterProxyModel>
 
+#include <QSet>
+#include <QPersistentModelIndex>
+
 
 class FeedsModel;
 class RootItem;
@@ -51,6 +54,12 @@ class FeedsProxyModel : public QSortFilterProxyModel {
   private slots:
     void invalidateFilter();
 
+    // Re-evaluates filter only for rows of previously
+    // and currently selected items and their parents.
+    void refilterSelectionChanges();
+    void clearHiddenItems();
+    void forgetRemovedItems(const QModelIndex &parent, int first, int last);
+
   signals:
     void expandAfterFilterIn(QModelIndex idx) const;
 
@@ -58,13 +67,20 @@ class FeedsProxyModel : public QSortFilterProxyModel {
     // Compares two rows of data.
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
     bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const;
-    bool filterAcceptsRowInternal(int source_row, const QModelIndex &source_parent) const;
+    bool filterAcceptsRowInternal(const RootItem *item) const;
 
     // Source model pointer.
     FeedsModel *m_sourceModel;
     const RootItem *m_selectedItem;
     bool m_showUnreadOnly;
-    QList<QPair<int,QModelIndex> > m_hiddenIndices;
+
+    // Selected item and all its parents, these are always displayed.
+    QSet<const RootItem*> m_selectedPath;
+    QPersistentModelIndex m_selectedIndex;
+    QList<QPersistentModelIndex> m_pendingSelectionChanges;
+
+    // Items which are currently filtered out.
+    mutable QSet<const RootItem*> m_hiddenItems;
 };
 
 #endif // FEEDSPROXYMODEL_H
@@ -0,0 +1,392 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "core/feedstreamparser.h"
+
+#include "miscellaneous/textfactory.h"
+#include "miscellaneous/debugging.h"
+#include "network-web/webfactory.h"
+
+#include <QElapsedTimer>
+#include <QTextCodec>
+#include <QTextDecoder>
+
+
+FeedStreamParser::FeedStreamParser(Format format, const QString &encoding, int max_messages)
+  : m_format(format), m_itemElementName(format == ATOM10 ? QSL("entry") : QSL("item")), m_decoder(nullptr),
+    m_reader(), m_maxMessages(max_messages), m_currentTime(QDateTime::currentDateTime()), m_decodeTime(0), m_parseTime(0),
+    m_finished(false), m_depth(0), m_itemDepth(-1), m_inAuthorName(false) {
+  QTextCodec *codec = QTextCodec::codecForName(encoding.toLocal8Bit());
+
+  if (codec == nullptr) {
+    // No suitable codec for this encoding was found.
+    // Behave same way as non-incremental parsing does.
+    codec = QTextCodec::codecForName(DEFAULT_FEED_ENCODING);
+  }
+
+  m_decoder.reset(codec->makeDecoder());
+}
+
+FeedStreamParser::~FeedStreamParser() {
+}
+
+void FeedStreamParser::addData(const QByteArray &chunk) {
+  if (chunk.isEmpty() || isMessageLimitReached()) {
+    return;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // NOTE: Reader works with already decoded data, so encoding
+  // mentioned in XML declaration is ignored, exactly as with ParsingFactory.
+  m_reader.addData(m_decoder->toUnicode(chunk));
+  m_decodeTime += timer.nsecsElapsed();
+
+  timer.restart();
+  processTokens();
+  m_parseTime += timer.nsecsElapsed();
+}
+
+void FeedStreamParser::finish() {
+  QElapsedTimer timer;
+  timer.start();
+
+  processTokens();
+  m_parseTime += timer.nsecsElapsed();
+  m_finished = true;
+}
+
+bool FeedStreamParser::isMessageLimitReached() const {
+  return m_maxMessages > 0 && m_messages.size() >= m_maxMessages;
+}
+
+bool FeedStreamParser::hasError() const {
+  if (!m_reader.hasError() || isMessageLimitReached()) {
+    return false;
+  }
+
+  // Until all data are received, document can still continue in next chunk.
+  // Once parsing is finished, unfinished document means truncated data.
+  return m_finished || m_reader.error() != QXmlStreamReader::PrematureEndOfDocumentError;
+}
+
+QString FeedStreamParser::errorString() const {
+  return m_reader.errorString();
+}
+
+QList<Message> FeedStreamParser::messages() const {
+  return m_messages;
+}
+
+qint64 FeedStreamParser::decodeTime() const {
+  return m_decodeTime / 1000;
+}
+
+qint64 FeedStreamParser::parseTime() const {
+  return m_parseTime / 1000;
+}
+
+void FeedStreamParser::processTokens() {
+  while (!m_reader.atEnd() && !isMessageLimitReached()) {
+    switch (m_reader.readNext()) {
+      case QXmlStreamReader::StartElement:
+        processStartElement();
+        break;
+
+      case QXmlStreamReader::EndElement:
+        processEndElement();
+        break;
+
+      case QXmlStreamReader::Characters:
+        if (m_inAuthorName) {
+          m_authorName.append(m_reader.text());
+        }
+        else if (m_itemDepth >= 0 && !m_fieldName.isEmpty()) {
+          m_fieldText.append(m_reader.text());
+        }
+
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  // NOTE: If reader ends with "PrematureEndOfDocumentError", then
+  // it just waits for next chunk of data.
+}
+
+void FeedStreamParser::processStartElement() {
+  m_depth++;
+
+  if (m_itemDepth < 0) {
+    if (m_reader.name() == m_itemElementName) {
+      // New message starts here.
+      m_itemDepth = m_depth;
+      m_fields.clear();
+      m_fieldsAttributes.clear();
+      m_links.clear();
+      m_authorName.clear();
+    }
+  }
+  else if (m_depth == m_itemDepth + 1) {
+    // Direct child of message element, remember its data.
+    m_fieldName = m_reader.name().toString();
+    m_fieldQualifiedName = m_reader.qualifiedName().toString();
+    m_fieldText.clear();
+
+    if (!m_fieldsAttributes.contains(m_fieldName)) {
+      m_fieldsAttributes.insert(m_fieldName, m_reader.attributes());
+    }
+
+    if (m_fieldName == QL1S("link")) {
+      m_links.append(m_reader.attributes());
+    }
+  }
+  else if (m_depth == m_itemDepth + 2 && m_fieldName == QL1S("author") && m_reader.name() == QL1S("name")) {
+    m_inAuthorName = true;
+  }
+}
+
+void FeedStreamParser::processEndElement() {
+  if (m_itemDepth >= 0) {
+    if (m_depth == m_itemDepth) {
+      // Message element ends here.
+      appendMessage();
+      m_itemDepth = -1;
+    }
+    else if (m_depth == m_itemDepth + 1) {
+      // We prefer first non-empty value of each field. It is stored
+      // under local and qualified name, so that "dc:date" and "date" both work.
+      if (m_fields.value(m_fieldName).isEmpty()) {
+        m_fields.insert(m_fieldName, m_fieldText);
+      }
+
+      if (m_fieldQualifiedName != m_fieldName && m_fields.value(m_fieldQualifiedName).isEmpty()) {
+        m_fields.insert(m_fieldQualifiedName, m_fieldText);
+      }
+
+      m_fieldName.clear();
+      m_fieldQualifiedName.clear();
+      m_fieldText.clear();
+    }
+    else if (m_inAuthorName) {
+      m_inAuthorName = false;
+    }
+  }
+
+  m_depth--;
+}
+
+void FeedStreamParser::appendMessage() {
+  Message new_message;
+  bool message_valid;
+
+  switch (m_format) {
+    case ATOM10:
+      message_valid = fillAtomMessage(new_message);
+      break;
+
+    case RDF:
+      message_valid = fillRdfMessage(new_message);
+      break;
+
+    case RSS20:
+    default:
+      message_valid = fillRssMessage(new_message);
+      break;
+  }
+
+  if (!message_valid) {
+    // BOTH title and description are empty, skip this message.
+    return;
+  }
+
+  // WARNING: There is a difference between "" and QString() in terms of nullptr SQL values!
+  if (new_message.m_author.isNull()) {
+    new_message.m_author = "";
+  }
+
+  if (new_message.m_url.isNull()) {
+    new_message.m_url = "";
+  }
+
+  m_messages.append(new_message);
+}
+
+QString FeedStreamParser::field(const QString &name) const {
+  return m_fields.value(name);
+}
+
+QXmlStreamAttributes FeedStreamParser::fieldAttributes(const QString &name) const {
+  return m_fieldsAttributes.value(name);
+}
+
+bool FeedStreamParser::fillAtomMessage(Message &message) const {
+  // Deal with titles & descriptions.
+  const QString elem_title = field(QSL("title")).simplified();
+  QString elem_summary = field(QSL("summary"));
+
+  if (elem_summary.isEmpty()) {
+    elem_summary = field(QSL("content"));
+  }
+
+  if (elem_title.isEmpty()) {
+    if (elem_summary.isEmpty()) {
+      return false;
+    }
+
+    message.m_title = WebFactory::instance()->stripTags(elem_summary.simplified());
+    message.m_contents = elem_summary;
+  }
+  else {
+    message.m_title = WebFactory::instance()->stripTags(elem_title);
+    message.m_contents = elem_summary;
+  }
+
+  // Deal with link.
+  foreach (const QXmlStreamAttributes &link, m_links) {
+    if (link.value(QSL("rel")) == QL1S("enclosure")) {
+      message.m_enclosures.append(Enclosure(link.value(QSL("href")).toString(), link.value(QSL("type")).toString()));
+
+      qCDebug(LOGPARSER, "Adding enclosure '%s' for the message.", qPrintable(message.m_enclosures.last().m_url));
+    }
+    else {
+      message.m_url = link.value(QSL("href")).toString();
+    }
+  }
+
+  if (message.m_url.isEmpty() && !message.m_enclosures.isEmpty()) {
+    message.m_url = message.m_enclosures.first().m_url;
+  }
+
+  // Deal with authors.
+  message.m_author = WebFactory::instance()->escapeHtml(m_authorName);
+
+  // Deal with creation date.
+  message.m_created = TextFactory::parseDateTime(field(QSL("updated")));
+  message.m_createdFromFeed = !message.m_created.isNull();
+
+  if (!message.m_createdFromFeed) {
+    message.m_created = m_currentTime;
+  }
+
+  return true;
+}
+
+bool FeedStreamParser::fillRdfMessage(Message &message) const {
+  // Deal with title and description.
+  const QString elem_title = field(QSL("title")).simplified();
+  const QString elem_description = field(QSL("description"));
+
+  if (elem_title.isEmpty()) {
+    if (elem_description.isEmpty()) {
+      return false;
+    }
+
+    message.m_title = WebFactory::instance()->escapeHtml(WebFactory::instance()->stripTags(elem_description.simplified()));
+    message.m_contents = elem_description;
+  }
+  else {
+    message.m_title = WebFactory::instance()->escapeHtml(WebFactory::instance()->stripTags(elem_title));
+    message.m_contents = elem_description;
+  }
+
+  // Deal with link and author.
+  message.m_url = field(QSL("link"));
+  message.m_author = field(QSL("creator"));
+
+  // Deal with creation date.
+  QString elem_updated = field(QSL("date"));
+
+  if (elem_updated.isEmpty()) {
+    elem_updated = field(QSL("dc:date"));
+  }
+
+  message.m_created = TextFactory::parseDateTime(elem_updated);
+  message.m_createdFromFeed = !message.m_created.isNull();
+
+  if (!message.m_createdFromFeed) {
+    message.m_created = m_currentTime;
+  }
+
+  return true;
+}
+
+bool FeedStreamParser::fillRssMessage(Message &message) const {
+  // Deal with titles & descriptions.
+  const QString elem_title = field(QSL("title")).simplified();
+  QString elem_description = field(QSL("encoded"));
+  const QXmlStreamAttributes enclosure_attributes = fieldAttributes(QSL("enclosure"));
+  const QString elem_enclosure = enclosure_attributes.value(QSL("url")).toString();
+  const QString elem_enclosure_type = enclosure_attributes.value(QSL("type")).toString();
+
+  if (elem_description.isEmpty()) {
+    elem_description = field(QSL("description"));
+  }
+
+  if (elem_title.isEmpty()) {
+    if (elem_description.isEmpty()) {
+      return false;
+    }
+
+    message.m_title = WebFactory::instance()->stripTags(elem_description.simplified());
+    message.m_contents = elem_description;
+  }
+  else {
+    message.m_title = WebFactory::instance()->stripTags(elem_title);
+    message.m_contents = elem_description;
+  }
+
+  if (!elem_enclosure.isEmpty()) {
+    message.m_enclosures.append(Enclosure(elem_enclosure, elem_enclosure_type));
+
+    qCDebug(LOGPARSER, "Adding enclosure '%s' for the message.", qPrintable(elem_enclosure));
+  }
+
+  // Deal with link and author.
+  message.m_url = field(QSL("link"));
+
+  if (message.m_url.isEmpty() && !message.m_enclosures.isEmpty()) {
+    message.m_url = message.m_enclosures.first().m_url;
+  }
+
+  if (message.m_url.isEmpty()) {
+    // Try to get "href" attribute.
+    message.m_url = fieldAttributes(QSL("link")).value(QSL("href")).toString();
+  }
+
+  message.m_author = field(QSL("author"));
+
+  if (message.m_author.isEmpty()) {
+    message.m_author = field(QSL("creator"));
+  }
+
+  // Deal with creation date.
+  message.m_created = TextFactory::parseDateTime(field(QSL("pubDate")));
+
+  if (message.m_created.isNull()) {
+    message.m_created = TextFactory::parseDateTime(field(QSL("date")));
+  }
+
+  if (!(message.m_createdFromFeed = !message.m_created.isNull())) {
+    message.m_created = m_currentTime;
+  }
+
+  return true;
+}
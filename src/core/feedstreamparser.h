@@ -0,0 +1,120 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FEEDSTREAMPARSER_H
+#define FEEDSTREAMPARSER_H
+
+#include "core/message.h"
+
+#include <QXmlStreamReader>
+#include <QXmlStreamAttributes>
+#include <QScopedPointer>
+#include <QHash>
+#include <QList>
+
+
+class QTextDecoder;
+
+// Incremental counterpart of ParsingFactory.
+//
+// Raw feed data are pushed into the parser chunk by chunk
+// as they arrive from network. Each chunk is decoded
+// with feed encoding on-the-fly and all messages which are
+// complete so far are produced immediately.
+class FeedStreamParser {
+  public:
+    enum Format {
+      RSS20   = 0,
+      RDF     = 1,
+      ATOM10  = 2
+    };
+
+    // Constructors and destructors.
+    // NOTE: Parsing stops once "max_messages" messages are
+    // obtained, zero or negative value means "no limit".
+    explicit FeedStreamParser(Format format, const QString &encoding, int max_messages = 0);
+    virtual ~FeedStreamParser();
+
+    // Decodes and parses next chunk of raw feed data.
+    void addData(const QByteArray &chunk);
+
+    // Flushes decoder, no more data are expected.
+    void finish();
+
+    // Returns true if limit of messages was reached and
+    // rest of the feed data is not needed anymore.
+    bool isMessageLimitReached() const;
+
+    // Returns true if feed data are not well-formed or,
+    // after parsing is finished, if they are truncated.
+    bool hasError() const;
+    QString errorString() const;
+
+    QList<Message> messages() const;
+
+    // Total time spent by decoding and by parsing of data, in microseconds.
+    qint64 decodeTime() const;
+    qint64 parseTime() const;
+
+  private:
+    void processTokens();
+    void processStartElement();
+    void processEndElement();
+    void appendMessage();
+
+    QString field(const QString &name) const;
+    QXmlStreamAttributes fieldAttributes(const QString &name) const;
+
+    bool fillAtomMessage(Message &message) const;
+    bool fillRdfMessage(Message &message) const;
+    bool fillRssMessage(Message &message) const;
+
+  private:
+    Format m_format;
+    QString m_itemElementName;
+    QScopedPointer<QTextDecoder> m_decoder;
+    QXmlStreamReader m_reader;
+    int m_maxMessages;
+    QDateTime m_currentTime;
+
+    // Nanoseconds spent by decoding and parsing.
+    qint64 m_decodeTime;
+    qint64 m_parseTime;
+
+    // True once all data were received and parsed.
+    bool m_finished;
+
+    // Depth of currently opened element and depth of
+    // currently opened message element, -1 if we are not
+    // inside of any message.
+    int m_depth;
+    int m_itemDepth;
+
+    // Data of currently parsed message.
+    QString m_fieldName;
+    QString m_fieldQualifiedName;
+    QString m_fieldText;
+    bool m_inAuthorName;
+    QString m_authorName;
+    QHash<QString,QString> m_fields;
+    QHash<QString,QXmlStreamAttributes> m_fieldsAttributes;
+    QList<QXmlStreamAttributes> m_links;
+
+    QList<Message> m_messages;
+};
+
+#endif // FEEDSTREAMPARSER_H
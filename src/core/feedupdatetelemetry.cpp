@@ -0,0 +1,201 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "core/feedupdatetelemetry.h"
+
+#include <QMap>
+#include <QPair>
+#include <QStringList>
+#include <QtMath>
+
+
+qint64 FeedUpdateTelemetry::totalTime() const {
+  qint64 total = 0;
+
+  // NOTE: Time to first byte is part of download time.
+  foreach (qint64 stage_time, QList<qint64>() << m_downloadTime << m_decodeTime << m_parseTime << m_databaseTime) {
+    if (stage_time > 0) {
+      total += stage_time;
+    }
+  }
+
+  return total;
+}
+
+UpdateTelemetryStatistics::UpdateTelemetryStatistics(const QList<FeedUpdateTelemetry> &records)
+  : m_feeds(QList<TelemetryItemStatistics>()), m_accounts(QList<TelemetryItemStatistics>()),
+    m_stages(QList<TelemetryStageStatistics>()), m_updatesCount(records.size()) {
+  QList<qint64> ttfb_times, download_times, decode_times, parse_times, database_times, total_times;
+  QMap<QPair<int,int>,QList<FeedUpdateTelemetry> > feeds_records;
+  QMap<int,QList<FeedUpdateTelemetry> > accounts_records;
+
+  foreach (const FeedUpdateTelemetry &record, records) {
+    if (record.m_timeToFirstByte >= 0) {
+      ttfb_times.append(record.m_timeToFirstByte);
+    }
+
+    if (record.m_downloadTime >= 0) {
+      download_times.append(record.m_downloadTime);
+    }
+
+    if (record.m_decodeTime >= 0) {
+      decode_times.append(record.m_decodeTime);
+    }
+
+    if (record.m_parseTime >= 0) {
+      parse_times.append(record.m_parseTime);
+    }
+
+    if (record.m_databaseTime >= 0) {
+      database_times.append(record.m_databaseTime);
+    }
+
+    total_times.append(record.totalTime());
+    feeds_records[QPair<int,int>(record.m_accountId, record.m_feedId)].append(record);
+    accounts_records[record.m_accountId].append(record);
+  }
+
+  m_stages << aggregateStage(tr("Time to first byte"), ttfb_times)
+           << aggregateStage(tr("Download"), download_times)
+           << aggregateStage(tr("Decoding"), decode_times)
+           << aggregateStage(tr("Parsing"), parse_times)
+           << aggregateStage(tr("Database"), database_times)
+           << aggregateStage(tr("Whole update"), total_times);
+
+  foreach (const QList<FeedUpdateTelemetry> &feed_records, feeds_records) {
+    m_feeds.append(aggregate(feed_records));
+  }
+
+  foreach (const QList<FeedUpdateTelemetry> &account_records, accounts_records) {
+    TelemetryItemStatistics account = aggregate(account_records);
+
+    account.m_feedId = -1;
+    account.m_title = QString();
+    m_accounts.append(account);
+  }
+
+  qSort(m_accounts.begin(), m_accounts.end(), [](const TelemetryItemStatistics &lhs, const TelemetryItemStatistics &rhs) {
+    return lhs.m_totalTime > rhs.m_totalTime;
+  });
+}
+
+int UpdateTelemetryStatistics::updatesCount() const {
+  return m_updatesCount;
+}
+
+QList<TelemetryStageStatistics> UpdateTelemetryStatistics::stages() const {
+  return m_stages;
+}
+
+QList<TelemetryItemStatistics> UpdateTelemetryStatistics::slowestFeeds(int how_many) const {
+  QList<TelemetryItemStatistics> feeds = m_feeds;
+
+  qSort(feeds.begin(), feeds.end(), [](const TelemetryItemStatistics &lhs, const TelemetryItemStatistics &rhs) {
+    return lhs.m_percentile95Time > rhs.m_percentile95Time;
+  });
+
+  return feeds.mid(0, how_many);
+}
+
+QList<TelemetryItemStatistics> UpdateTelemetryStatistics::largestFeeds(int how_many) const {
+  QList<TelemetryItemStatistics> feeds = m_feeds;
+
+  qSort(feeds.begin(), feeds.end(), [](const TelemetryItemStatistics &lhs, const TelemetryItemStatistics &rhs) {
+    return lhs.m_averageBytes > rhs.m_averageBytes;
+  });
+
+  return feeds.mid(0, how_many);
+}
+
+QList<TelemetryItemStatistics> UpdateTelemetryStatistics::accounts() const {
+  return m_accounts;
+}
+
+qint64 UpdateTelemetryStatistics::percentile(QList<qint64> values, int percentile) {
+  if (values.isEmpty()) {
+    return 0;
+  }
+
+  qSort(values);
+
+  const int rank = qCeil(values.size() * percentile / 100.0);
+  return values.at(qBound(0, rank - 1, values.size() - 1));
+}
+
+TelemetryItemStatistics UpdateTelemetryStatistics::aggregate(const QList<FeedUpdateTelemetry> &records) const {
+  TelemetryItemStatistics item;
+  QList<qint64> total_times;
+  qint64 downloaded_bytes = 0;
+  int download_samples = 0;
+  qint64 stage_times[4] = { 0, 0, 0, 0 };
+
+  // Records are sorted by date, so the most recent title of the feed is used.
+  item.m_accountId = records.last().m_accountId;
+  item.m_feedId = records.last().m_feedId;
+  item.m_title = records.last().m_feedTitle;
+
+  foreach (const FeedUpdateTelemetry &record, records) {
+    item.m_updates++;
+    item.m_errors += record.m_error ? 1 : 0;
+    item.m_newMessages += record.m_newMessages;
+    item.m_totalTime += record.totalTime();
+    total_times.append(record.totalTime());
+
+    if (record.m_downloadedBytes >= 0) {
+      downloaded_bytes += record.m_downloadedBytes;
+      download_samples++;
+      item.m_maximumBytes = qMax(item.m_maximumBytes, record.m_downloadedBytes);
+    }
+
+    stage_times[0] += qMax(record.m_downloadTime, Q_INT64_C(0));
+    stage_times[1] += qMax(record.m_decodeTime, Q_INT64_C(0));
+    stage_times[2] += qMax(record.m_parseTime, Q_INT64_C(0));
+    stage_times[3] += qMax(record.m_databaseTime, Q_INT64_C(0));
+  }
+
+  item.m_medianTime = percentile(total_times, 50);
+  item.m_percentile95Time = percentile(total_times, 95);
+  item.m_averageBytes = download_samples > 0 ? downloaded_bytes / download_samples : 0;
+
+  const QStringList stage_names = QStringList() << tr("Download") << tr("Decoding") << tr("Parsing") << tr("Database");
+  int dominant_stage = 0;
+
+  for (int i = 1; i < 4; i++) {
+    if (stage_times[i] > stage_times[dominant_stage]) {
+      dominant_stage = i;
+    }
+  }
+
+  item.m_dominantStage = stage_names.at(dominant_stage);
+  return item;
+}
+
+TelemetryStageStatistics UpdateTelemetryStatistics::aggregateStage(const QString &stage, const QList<qint64> &values) const {
+  TelemetryStageStatistics statistics;
+
+  statistics.m_stage = stage;
+  statistics.m_samples = values.size();
+  statistics.m_median = percentile(values, 50);
+  statistics.m_percentile95 = percentile(values, 95);
+
+  foreach (qint64 value, values) {
+    statistics.m_maximum = qMax(statistics.m_maximum, value);
+    statistics.m_total += value;
+  }
+
+  return statistics;
+}
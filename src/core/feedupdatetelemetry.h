@@ -0,0 +1,129 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FEEDUPDATETELEMETRY_H
+#define FEEDUPDATETELEMETRY_H
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+
+
+// Measurements of single update of single feed.
+// NOTE: All durations are in microseconds, negative
+// values mean that particular stage was not measured.
+struct FeedUpdateTelemetry {
+  int m_accountId;
+  int m_feedId;
+  QString m_feedTitle;
+  QDateTime m_updated;
+  bool m_error;
+
+  // Time to first byte includes host lookup, connecting and TLS handshake,
+  // these are not exposed separately by QNetworkAccessManager.
+  qint64 m_timeToFirstByte;
+  qint64 m_downloadTime;
+  qint64 m_downloadedBytes;
+
+  qint64 m_decodeTime;
+  qint64 m_parseTime;
+  qint64 m_databaseTime;
+
+  int m_newMessages;
+  int m_updatedMessages;
+  int m_unchangedMessages;
+
+  FeedUpdateTelemetry() : m_accountId(0), m_feedId(0), m_feedTitle(QString()), m_updated(QDateTime()), m_error(false),
+    m_timeToFirstByte(-1), m_downloadTime(-1), m_downloadedBytes(-1), m_decodeTime(-1), m_parseTime(-1),
+    m_databaseTime(-1), m_newMessages(0), m_updatedMessages(0), m_unchangedMessages(0) {
+  }
+
+  // Sum of all measured stages.
+  qint64 totalTime() const;
+};
+
+struct TelemetryStageStatistics {
+  QString m_stage;
+  int m_samples;
+  qint64 m_median;
+  qint64 m_percentile95;
+  qint64 m_maximum;
+  qint64 m_total;
+
+  TelemetryStageStatistics() : m_stage(QString()), m_samples(0), m_median(0), m_percentile95(0), m_maximum(0), m_total(0) {
+  }
+};
+
+// Aggregated measurements of single feed or single account.
+struct TelemetryItemStatistics {
+  int m_accountId;
+  int m_feedId;
+  QString m_title;
+  int m_updates;
+  int m_errors;
+  qint64 m_medianTime;
+  qint64 m_percentile95Time;
+  qint64 m_totalTime;
+  qint64 m_averageBytes;
+  qint64 m_maximumBytes;
+  int m_newMessages;
+
+  // Name of stage which took most of the time.
+  QString m_dominantStage;
+
+  TelemetryItemStatistics() : m_accountId(0), m_feedId(0), m_title(QString()), m_updates(0), m_errors(0),
+    m_medianTime(0), m_percentile95Time(0), m_totalTime(0), m_averageBytes(0), m_maximumBytes(0),
+    m_newMessages(0), m_dominantStage(QString()) {
+  }
+};
+
+// Computes aggregates from stored telemetry records.
+class UpdateTelemetryStatistics {
+    Q_DECLARE_TR_FUNCTIONS(UpdateTelemetryStatistics)
+
+  public:
+    explicit UpdateTelemetryStatistics(const QList<FeedUpdateTelemetry> &records);
+
+    int updatesCount() const;
+
+    // Percentiles of durations of all stages and of whole updates.
+    QList<TelemetryStageStatistics> stages() const;
+
+    // Feeds sorted by 95th percentile of their update time.
+    QList<TelemetryItemStatistics> slowestFeeds(int how_many) const;
+
+    // Feeds sorted by average size of their downloaded data.
+    QList<TelemetryItemStatistics> largestFeeds(int how_many) const;
+
+    // Accounts sorted by total time spent on their updates.
+    QList<TelemetryItemStatistics> accounts() const;
+
+    // Returns nearest-rank percentile of given values, values do not have to be sorted.
+    static qint64 percentile(QList<qint64> values, int percentile);
+
+  private:
+    TelemetryItemStatistics aggregate(const QList<FeedUpdateTelemetry> &records) const;
+    TelemetryStageStatistics aggregateStage(const QString &stage, const QList<qint64> &values) const;
+
+    QList<TelemetryItemStatistics> m_feeds;
+    QList<TelemetryItemStatistics> m_accounts;
+    QList<TelemetryStageStatistics> m_stages;
+    int m_updatesCount;
+};
+
+#endif // FEEDUPDATETELEMETRY_H
@@ -68,11 +68,11 @@ Message::Message() {
   m_title = m_url = m_author = m_contents = m_feedId = m_customId = m_customHash = "";
   m_enclosures = QList<Enclosure>();
   m_accountId = m_id = 0;
-  m_isRead = m_isImportant = false;
+  m_isRead = m_isImportant = m_isPartial = m_isArchived = false;
 }
 
 Message Message::fromSqlRecord(const QSqlRecord &record, bool *result) {
-  if (record.count() != MSG_DB_CUSTOM_HASH_INDEX + 1) {
+  if (record.count() != MSG_DB_PARTIAL_INDEX + 1) {
     if (result != nullptr) {
       *result = false;
       return Message();
@@ -94,6 +94,11 @@ Message Message::fromSqlRecord(const QSqlRecord &record, bool *result) {
   message.m_accountId = record.value(MSG_DB_ACCOUNT_ID_INDEX).toInt();
   message.m_customId = record.value(MSG_DB_CUSTOM_ID_INDEX).toString();
   message.m_customHash = record.value(MSG_DB_CUSTOM_HASH_INDEX).toString();
+  message.m_isPartial = record.value(MSG_DB_PARTIAL_INDEX).toBool();
+
+  // Contents of old messages are stored compressed in archive, they
+  // are loaded only when message is displayed.
+  message.m_isArchived = record.value(MSG_DB_CONTENTS_INDEX).isNull() && message.m_id > 0;
 
   if (result != nullptr) {
     *result = true;
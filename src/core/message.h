@@ -23,6 +23,7 @@
 #include <QDateTime>
 #include <QStringList>
 #include <QSqlRecord>
+#include <QMetaType>
 
 
 // Represents single enclosure.
@@ -64,6 +65,14 @@ class Message {
     bool m_isRead;
     bool m_isImportant;
 
+    // Is true if only headline of message was synchronized
+    // and "contents" hold just an excerpt of full contents.
+    bool m_isPartial;
+
+    // Is true if contents of message are stored in archive
+    // and were not loaded yet, "contents" are empty then.
+    bool m_isArchived;
+
     QList<Enclosure> m_enclosures;
 
     // Is true if "created" date was obtained directly
@@ -71,4 +80,19 @@ class Message {
     bool m_createdFromFeed;
 };
 
+// Describes which messages were changed in DB
+// by single operation, for example by update of one feed.
+struct MessagesChanges {
+  public:
+    inline bool isEmpty() const {
+      return m_insertedIds.isEmpty() && m_updatedIds.isEmpty() && m_deletedIds.isEmpty();
+    }
+
+    QList<int> m_insertedIds;
+    QList<int> m_updatedIds;
+    QList<int> m_deletedIds;
+};
+
+Q_DECLARE_METATYPE(MessagesChanges)
+
 #endif // MESSAGE_H
@@ -23,12 +23,20 @@
 #include "miscellaneous/databasefactory.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/databasequeries.h"
+#include "miscellaneous/tracer.h"
 #include "services/abstract/serviceroot.h"
 
 
 MessagesModel::MessagesModel(QObject *parent)
   : QSqlTableModel(parent, qApp->database()->connection(QSL("MessagesModel"), DatabaseFactory::FromSettings)),
-    m_messageHighlighter(NoHighlighting), m_customDateFormat(QString()) {
+    m_messageHighlighter(NoHighlighting), m_sortColumn(-1), m_sortOrder(Qt::AscendingOrder), m_applyingChanges(false),
+    m_customDateFormat(QString()), m_highlightColor(QColor(Qt::blue)), m_displayDates(QVector<QString>()),
+    m_rowsForIds(QHash<int,int>()), m_readRows(QBitArray()), m_importantRows(QBitArray()),
+    m_archivedContents(ARCHIVE_CACHE_SIZE) {
+  connect(this, SIGNAL(modelReset()), this, SLOT(rebuildMessageIndex()));
+  connect(this, SIGNAL(rowsRemoved(QModelIndex,int,int)), this, SLOT(rebuildMessageIndex()));
+  connect(this, SIGNAL(rowsInserted(QModelIndex,int,int)), this, SLOT(indexMessages(QModelIndex,int,int)));
+
   setupFonts();
   setupIcons();
   setupHeaderData();
@@ -61,13 +69,18 @@ void MessagesModel::fetchAllData() {
 }
 
 void MessagesModel::setupFonts() {
-  m_normalFont = Application::font("MessagesView");
-  m_boldFont = m_normalFont;
-  m_boldFont.setBold(true);
+  const QFont normal_font = Application::font("MessagesView");
+  QFont bold_font = normal_font;
+
+  bold_font.setBold(true);
+  m_normalFont = normal_font;
+  m_boldFont = bold_font;
 }
 
 void MessagesModel::loadMessages(RootItem *item) {
+  TraceSpan span("model", "MessagesModel::loadMessages");
   m_selectedItem = item;
+  m_archivedContents.clear();
 
   if (item == nullptr) {
     setFilter("true != true");
@@ -85,24 +98,23 @@ void MessagesModel::loadMessages(RootItem *item) {
   }
 
   fetchAllData();
+  span.setArgument("messages", rowCount());
 }
 
 bool MessagesModel::setMessageImportantById(int id, RootItem::Importance important) {
-  for (int i = 0; i < rowCount(); i++) {
-    int found_id = data(i, MSG_DB_ID_INDEX, Qt::EditRole).toInt();
+  const int row = rowForMessageId(id);
 
-    if (found_id == id) {
-      bool set = setData(index(i, MSG_DB_IMPORTANT_INDEX), important);
+  if (row < 0) {
+    return false;
+  }
 
-      if (set) {
-        emit dataChanged(index(i, 0), index(i, MSG_DB_CUSTOM_HASH_INDEX));
-      }
+  const bool set = setData(index(row, MSG_DB_IMPORTANT_INDEX), important);
 
-      return set;
-    }
+  if (set) {
+    emit dataChanged(index(row, 0), index(row, MSG_DB_PARTIAL_INDEX));
   }
 
-  return false;
+  return set;
 }
 
 bool MessagesModel::submitAll() {
@@ -121,7 +133,211 @@ int MessagesModel::messageId(int row_index) const {
 }
 
 RootItem::Importance MessagesModel::messageImportance(int row_index) const {
-  return (RootItem::Importance) data(row_index, MSG_DB_IMPORTANT_INDEX, Qt::EditRole).toInt();
+  return isMessageImportant(row_index) ? RootItem::Important : RootItem::NotImportant;
+}
+
+int MessagesModel::rowForMessageId(int id) const {
+  return m_rowsForIds.value(id, -1);
+}
+
+bool MessagesModel::isMessageRead(int row_index) const {
+  return row_index >= 0 && row_index < m_readRows.size() && m_readRows.testBit(row_index);
+}
+
+bool MessagesModel::isMessageImportant(int row_index) const {
+  return row_index >= 0 && row_index < m_importantRows.size() && m_importantRows.testBit(row_index);
+}
+
+int MessagesModel::nextUnreadRow(int from_row, int to_row) const {
+  to_row = qMin(to_row, m_readRows.size() - 1);
+
+  for (int row = qMax(0, from_row); row <= to_row; row++) {
+    if (!m_readRows.testBit(row)) {
+      return row;
+    }
+  }
+
+  return -1;
+}
+
+bool MessagesModel::applyMessagesChanges(const MessagesChanges &changes) {
+  foreach (int deleted_id, changes.m_deletedIds) {
+    if (rowForMessageId(deleted_id) >= 0) {
+      // Loaded rows of SQL model cannot be removed without reloading.
+      return false;
+    }
+  }
+
+  if (m_selectedItem == nullptr || (changes.m_insertedIds.isEmpty() && changes.m_updatedIds.isEmpty())) {
+    return true;
+  }
+
+  if (!changes.m_insertedIds.isEmpty() && canFetchMore()) {
+    // Position of new rows cannot be determined when
+    // not all rows are loaded.
+    return false;
+  }
+
+  bool ok;
+  const QList<QSqlRecord> records = DatabaseQueries::getMessageRecords(database(), filter(),
+                                                                       changes.m_insertedIds + changes.m_updatedIds, &ok);
+
+  if (!ok) {
+    return false;
+  }
+
+  QList<QSqlRecord> new_records;
+  QSet<int> matching_ids;
+
+  foreach (const QSqlRecord &record, records) {
+    matching_ids.insert(record.value(MSG_DB_ID_INDEX).toInt());
+  }
+
+  foreach (int updated_id, changes.m_updatedIds) {
+    if (!matching_ids.contains(updated_id) && rowForMessageId(updated_id) >= 0) {
+      // Displayed message does not match the filter anymore.
+      return false;
+    }
+  }
+
+  // Update already displayed messages first, their rows are not shifted yet.
+  // Updated messages, which are not loaded yet, get their new data
+  // once more rows are fetched.
+  foreach (const QSqlRecord &record, records) {
+    const int row = rowForMessageId(record.value(MSG_DB_ID_INDEX).toInt());
+
+    if (row >= 0) {
+      setRecord(row, record);
+      indexMessage(row);
+      m_displayDates[row] = QString();
+    }
+    else if (!canFetchMore()) {
+      new_records.append(record);
+    }
+  }
+
+  if (!new_records.isEmpty()) {
+    // Rows are inserted empty and filled afterwards, so they
+    // are indexed here once their data are set.
+    m_applyingChanges = true;
+
+    foreach (const QSqlRecord &record, new_records) {
+      const int row = insertionRow(record);
+
+      if (insertRecord(row, record)) {
+        indexMessage(row);
+      }
+    }
+
+    m_applyingChanges = false;
+  }
+
+  return true;
+}
+
+void MessagesModel::setSort(int column, Qt::SortOrder order) {
+  m_sortColumn = column;
+  m_sortOrder = order;
+
+  QSqlTableModel::setSort(column, order);
+}
+
+int MessagesModel::insertionRow(const QSqlRecord &record) const {
+  if (m_sortColumn < 0) {
+    return rowCount();
+  }
+
+  const QVariant new_value = record.value(m_sortColumn);
+  const QByteArray new_text = new_value.toString().toUtf8();
+
+  // Text is compared the same way as DB does in ORDER BY clause, SQLite uses
+  // binary collation, MySQL case-insensitive one by default.
+  const bool case_insensitive = qApp->database()->activeDatabaseDriver() == DatabaseFactory::MYSQL;
+  int low = 0;
+  int high = rowCount();
+
+  // Rows are sorted by DB, find first row which should be displayed after new one.
+  while (low < high) {
+    const int middle = (low + high) / 2;
+    const QVariant middle_value = QSqlTableModel::data(index(middle, m_sortColumn));
+    bool middle_numeric, new_numeric;
+    const qlonglong middle_number = middle_value.toLongLong(&middle_numeric);
+    const qlonglong new_number = new_value.toLongLong(&new_numeric);
+    int comparison;
+
+    if (middle_numeric && new_numeric) {
+      comparison = middle_number < new_number ? -1 : (middle_number > new_number ? 1 : 0);
+    }
+    else if (case_insensitive) {
+      comparison = QString::compare(middle_value.toString(), new_value.toString(), Qt::CaseInsensitive);
+    }
+    else {
+      comparison = qstrcmp(middle_value.toString().toUtf8(), new_text);
+    }
+
+    if ((m_sortOrder == Qt::AscendingOrder && comparison <= 0) || (m_sortOrder == Qt::DescendingOrder && comparison >= 0)) {
+      low = middle + 1;
+    }
+    else {
+      high = middle;
+    }
+  }
+
+  return low;
+}
+
+void MessagesModel::rebuildMessageIndex() {
+  m_rowsForIds.clear();
+  m_readRows.clear();
+  m_importantRows.clear();
+  m_displayDates.clear();
+
+  if (rowCount() > 0) {
+    indexMessages(QModelIndex(), 0, rowCount() - 1);
+  }
+}
+
+void MessagesModel::indexMessages(const QModelIndex &parent, int first, int last) {
+  Q_UNUSED(parent)
+
+  const int indexed_rows = m_readRows.size();
+  const int count = last - first + 1;
+
+  if (first > indexed_rows) {
+    rebuildMessageIndex();
+    return;
+  }
+
+  m_readRows.resize(indexed_rows + count);
+  m_importantRows.resize(indexed_rows + count);
+  m_displayDates.insert(first, count, QString());
+  m_rowsForIds.reserve(indexed_rows + count);
+
+  if (first < indexed_rows) {
+    // Rows were inserted among indexed ones, move rows below them.
+    for (int row = indexed_rows - 1; row >= first; row--) {
+      m_readRows.setBit(row + count, m_readRows.testBit(row));
+      m_importantRows.setBit(row + count, m_importantRows.testBit(row));
+    }
+
+    for (QHash<int,int>::iterator i = m_rowsForIds.begin(); i != m_rowsForIds.end(); ++i) {
+      if (i.value() >= first) {
+        i.value() += count;
+      }
+    }
+  }
+
+  if (!m_applyingChanges) {
+    for (int row = first; row <= last; row++) {
+      indexMessage(row);
+    }
+  }
+}
+
+void MessagesModel::indexMessage(int row) {
+  m_rowsForIds.insert(QSqlTableModel::data(index(row, MSG_DB_ID_INDEX)).toInt(), row);
+  m_readRows.setBit(row, QSqlTableModel::data(index(row, MSG_DB_READ_INDEX)).toInt() == 1);
+  m_importantRows.setBit(row, QSqlTableModel::data(index(row, MSG_DB_IMPORTANT_INDEX)).toInt() == 1);
 }
 
 RootItem *MessagesModel::loadedItem() const {
@@ -135,13 +351,42 @@ void MessagesModel::updateDateFormat() {
   else {
     m_customDateFormat = QString();
   }
+
+  clearDisplayCache();
 }
 
 void MessagesModel::reloadWholeLayout() {
+  setupFonts();
+  clearDisplayCache();
+
   emit layoutAboutToBeChanged();
   emit layoutChanged();
 }
 
+void MessagesModel::clearDisplayCache() {
+  // Keep size of the cache, so that it stays parallel to rows.
+  m_displayDates.fill(QString());
+}
+
+QString MessagesModel::displayDate(const QModelIndex &idx) const {
+  const int row = idx.row();
+
+  if (row >= 0 && row < m_displayDates.size() && !m_displayDates.at(row).isNull()) {
+    return m_displayDates.at(row);
+  }
+
+  const QDateTime date = TextFactory::parseDateTime(QSqlTableModel::data(idx, Qt::EditRole).value<qint64>()).toLocalTime();
+  const QString formatted_date = m_customDateFormat.isEmpty() ?
+                                   date.toString(Qt::DefaultLocaleShortDate) :
+                                   date.toString(m_customDateFormat);
+
+  if (row >= 0 && row < m_displayDates.size()) {
+    m_displayDates[row] = formatted_date;
+  }
+
+  return formatted_date;
+}
+
 Message MessagesModel::messageAt(int row_index) const { 
   return Message::fromSqlRecord(record(row_index));
 }
@@ -161,7 +406,8 @@ void MessagesModel::setupHeaderData() {
                   /*: Tooltip for attachments of message.*/ tr("Attachments") <<
                   /*: Tooltip for account ID of message.*/ tr("Account ID") <<
                   /*: Tooltip for custom ID of message.*/ tr("Custom ID") <<
-                  /*: Tooltip for custom hash string of message.*/ tr("Custom hash");
+                  /*: Tooltip for custom hash string of message.*/ tr("Custom hash") <<
+                  /*: Tooltip for "partial" column in msg list.*/ tr("Partial");
 
   m_tooltipData << tr("Id of the message.") << tr("Is message read?") <<
                    tr("Is message deleted?") << tr("Is message important?") <<
@@ -170,7 +416,7 @@ void MessagesModel::setupHeaderData() {
                    tr("Author of the message.") << tr("Creation date of the message.") <<
                    tr("Contents of the message.") << tr("Is message permanently deleted from recycle bin?") <<
                    tr("List of attachments.") << tr("Account ID of the message.") << tr("Custom ID of the message") <<
-                   tr("Custom hash of the message.");
+                   tr("Custom hash of the message.") << tr("Are only headline and excerpt of the message downloaded?");
 }
 
 Qt::ItemFlags MessagesModel::flags(const QModelIndex &index) const {
@@ -179,6 +425,21 @@ Qt::ItemFlags MessagesModel::flags(const QModelIndex &index) const {
   return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable | Qt::ItemNeverHasChildren;
 }
 
+bool MessagesModel::setData(const QModelIndex &index, const QVariant &value, int role) {
+  if (!QSqlTableModel::setData(index, value, role)) {
+    return false;
+  }
+
+  if (index.column() == MSG_DB_READ_INDEX && index.row() < m_readRows.size()) {
+    m_readRows.setBit(index.row(), value.toInt() == 1);
+  }
+  else if (index.column() == MSG_DB_IMPORTANT_INDEX && index.row() < m_importantRows.size()) {
+    m_importantRows.setBit(index.row(), value.toInt() == 1);
+  }
+
+  return true;
+}
+
 QVariant MessagesModel::data(int row, int column, int role) const {
   return data(index(row, column), role);
 }
@@ -190,13 +451,7 @@ QVariant MessagesModel::data(const QModelIndex &idx, int role) const {
       int index_column = idx.column();
 
       if (index_column == MSG_DB_DCREATED_INDEX) {
-        if (m_customDateFormat.isEmpty()) {
-          return TextFactory::parseDateTime(QSqlTableModel::data(idx,
-                                                                 role).value<qint64>()).toLocalTime().toString(Qt::DefaultLocaleShortDate);
-        }
-        else {
-          return TextFactory::parseDateTime(QSqlTableModel::data(idx, role).value<qint64>()).toLocalTime().toString(m_customDateFormat);
-        }
+        return displayDate(idx);
       }
       else if (index_column == MSG_DB_AUTHOR_INDEX) {
         const QString author_name = QSqlTableModel::data(idx, role).toString();
@@ -215,15 +470,15 @@ QVariant MessagesModel::data(const QModelIndex &idx, int role) const {
       return QSqlTableModel::data(idx, role);
 
     case Qt::FontRole:
-      return QSqlTableModel::data(index(idx.row(), MSG_DB_READ_INDEX)).toInt() == 1 ? m_normalFont : m_boldFont;
+      return isMessageRead(idx.row()) ? m_normalFont : m_boldFont;
 
     case Qt::ForegroundRole:
       switch (m_messageHighlighter) {
         case HighlightImportant:
-          return QSqlTableModel::data(index(idx.row(), MSG_DB_IMPORTANT_INDEX)).toInt() == 1 ? QColor(Qt::blue) : QVariant();
+          return isMessageImportant(idx.row()) ? m_highlightColor : QVariant();
 
         case HighlightUnread:
-          return QSqlTableModel::data(index(idx.row(), MSG_DB_READ_INDEX)).toInt() == 0 ? QColor(Qt::blue) : QVariant();
+          return !isMessageRead(idx.row()) ? m_highlightColor : QVariant();
 
         case NoHighlighting:
         default:
@@ -234,10 +489,10 @@ QVariant MessagesModel::data(const QModelIndex &idx, int role) const {
       const int index_column = idx.column();
 
       if (index_column == MSG_DB_READ_INDEX) {
-        return QSqlTableModel::data(idx).toInt() == 1 ? m_readIcon : m_unreadIcon;
+        return isMessageRead(idx.row()) ? m_readIcon : m_unreadIcon;
       }
       else if (index_column == MSG_DB_IMPORTANT_INDEX) {
-        return QSqlTableModel::data(idx).toInt() == 1 ? m_favoriteIcon : QVariant();
+        return isMessageImportant(idx.row()) ? m_favoriteIcon : QVariant();
       }
       else {
         return QVariant();
@@ -250,7 +505,7 @@ QVariant MessagesModel::data(const QModelIndex &idx, int role) const {
 }
 
 bool MessagesModel::setMessageRead(int row_index, RootItem::ReadStatus read) {
-  if (data(row_index, MSG_DB_READ_INDEX, Qt::EditRole).toInt() == read) {
+  if (isMessageRead(row_index) == (read == RootItem::Read)) {
     // Read status is the same is the one currently set.
     // In that case, no extra work is needed.
     return true;
@@ -280,22 +535,94 @@ bool MessagesModel::setMessageRead(int row_index, RootItem::ReadStatus read) {
   }
 }
 
-bool MessagesModel::setMessageReadById(int id, RootItem::ReadStatus read) {
-  for (int i = 0; i < rowCount(); i++) {
-    int found_id = data(i, MSG_DB_ID_INDEX, Qt::EditRole).toInt();
+bool MessagesModel::loadMessageContents(int row_index, Message &message) {
+  loadArchivedContents(message);
+
+  if (!message.m_isPartial) {
+    return true;
+  }
 
-    if (found_id == id) {
-      bool set = setData(index(i, MSG_DB_READ_INDEX), read);
+  // Contents could be already prefetched in background.
+  bool is_partial;
+  const QString stored_contents = DatabaseQueries::getMessageContents(database(), message.m_id, &is_partial);
 
-      if (set) {
-        emit dataChanged(index(i, 0), index(i, MSG_DB_CUSTOM_HASH_INDEX));
-      }
+  if (is_partial) {
+    // Contents are downloaded in background, excerpt is shown meanwhile.
+    m_selectedItem->getParentServiceRoot()->requestMessageContents(message);
+    return false;
+  }
+
+  message.m_contents = stored_contents;
+  message.m_isPartial = false;
+
+  // Rewrite "visible" data in the model.
+  setData(index(row_index, MSG_DB_CONTENTS_INDEX), message.m_contents);
+  setData(index(row_index, MSG_DB_PARTIAL_INDEX), 0);
+  return true;
+}
+
+void MessagesModel::loadArchivedContents(Message &message) const {
+  if (!message.m_isArchived) {
+    return;
+  }
 
-      return set;
+  const int row = rowForMessageId(message.m_id);
+
+  if (row >= 0) {
+    message.m_contents = archivedContents(row);
+  }
+  else {
+    message.m_contents = DatabaseQueries::getArchivedContents(database(), message.m_id);
+  }
+
+  message.m_isArchived = false;
+}
+
+QString MessagesModel::archivedContents(int row_index) const {
+  const int id = messageId(row_index);
+
+  const QString *cached_contents = m_archivedContents.object(id);
+
+  if (cached_contents != nullptr) {
+    return *cached_contents;
+  }
+
+  const QString contents = DatabaseQueries::getArchivedContents(database(), id);
+
+  m_archivedContents.insert(id, new QString(contents), contents.size());
+  return contents;
+}
+
+bool MessagesModel::isMessageArchived(int row_index) const {
+  return QSqlTableModel::data(index(row_index, MSG_DB_CONTENTS_INDEX)).isNull();
+}
+
+QHash<int,QString> MessagesModel::archivedContentsOfLoadedMessages() const {
+  QList<int> ids;
+
+  for (int i = 0; i < rowCount(); i++) {
+    if (isMessageArchived(i)) {
+      ids.append(messageId(i));
     }
   }
 
-  return false;
+  return DatabaseQueries::getArchivedContents(database(), ids);
+}
+
+bool MessagesModel::setMessageReadById(int id, RootItem::ReadStatus read) {
+  const int row = rowForMessageId(id);
+
+  if (row < 0) {
+    return false;
+  }
+
+  const bool set = setData(index(row, MSG_DB_READ_INDEX), read);
+
+  if (set) {
+    emit dataChanged(index(row, 0), index(row, MSG_DB_PARTIAL_INDEX));
+  }
+
+  return set;
 }
 
 bool MessagesModel::switchMessageImportance(int row_index) {
@@ -26,6 +26,10 @@
 
 #include <QFont>
 #include <QIcon>
+#include <QHash>
+#include <QBitArray>
+#include <QCache>
+#include <QVector>
 
 
 class MessagesModel : public QSqlTableModel {
@@ -49,12 +53,22 @@ class MessagesModel : public QSqlTableModel {
     QVariant data(int row, int column, int role = Qt::DisplayRole) const;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const;
     Qt::ItemFlags flags(const QModelIndex &index) const;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole);
 
     // Returns message at given index.
     Message messageAt(int row_index) const;
     int messageId(int row_index) const;
     RootItem::Importance messageImportance(int row_index) const;
 
+    // Fast lookups which do not touch underlying SQL data.
+    // Returns row of message with given ID or -1 if message is not loaded.
+    int rowForMessageId(int id) const;
+    bool isMessageRead(int row_index) const;
+    bool isMessageImportant(int row_index) const;
+
+    // Returns first unread row in <from_row, to_row> or -1.
+    int nextUnreadRow(int from_row, int to_row) const;
+
     RootItem *loadedItem() const;
 
     void updateDateFormat();
@@ -67,6 +81,24 @@ class MessagesModel : public QSqlTableModel {
     bool switchMessageImportance(int row_index);
     bool setMessageRead(int row_index, RootItem::ReadStatus read);
 
+    // Makes sure that full contents of given message are available.
+    // If only headline of the message was synchronized, then contents are
+    // downloaded by service root of the message in background and false is returned.
+    // Row of the message is updated once the service root announces the change.
+    bool loadMessageContents(int row_index, Message &message);
+
+    // Loads contents of message from archive, if they are archived.
+    void loadArchivedContents(Message &message) const;
+
+    // Returns contents of archived message in given row, decompressed
+    // contents are cached, so that repeated reading is cheap.
+    QString archivedContents(int row_index) const;
+    bool isMessageArchived(int row_index) const;
+
+    // Returns archived contents of all loaded messages keyed by message IDs.
+    // NOTE: Contents are loaded by single query and they are not cached.
+    QHash<int,QString> archivedContentsOfLoadedMessages() const;
+
     // BATCH messages manipulators.
     // NOTE: These methods are used for changing of attributes of
     // many messages via DIRECT SQL calls.
@@ -86,6 +118,13 @@ class MessagesModel : public QSqlTableModel {
     // Loads messages of given feeds.
     void loadMessages(RootItem *item);
 
+    // Inserts/updates rows of given messages if they match current filter,
+    // model is NOT reset. Returns false if changes cannot be applied
+    // this way and model needs to be reloaded.
+    bool applyMessagesChanges(const MessagesChanges &changes);
+
+    void setSort(int column, Qt::SortOrder order);
+
   public slots:
     // NOTE: These methods DO NOT actually change data in the DB, just in the model.
     // These are particularly used by msg browser.
@@ -96,24 +135,58 @@ class MessagesModel : public QSqlTableModel {
     // To disable persistent changes submissions.
     bool submitAll();
 
+    // Keep lookup tables in sync with loaded rows.
+    void rebuildMessageIndex();
+    void indexMessages(const QModelIndex &parent, int first, int last);
+
   private:
     void setupHeaderData();
     void setupFonts();
     void setupIcons();
 
+    // Stores state of message in given row to lookup tables.
+    void indexMessage(int row);
+
+    // Returns row where message should be inserted to respect current sorting.
+    int insertionRow(const QSqlRecord &record) const;
+
+    // Returns formatted creation date of message in given row.
+    QString displayDate(const QModelIndex &idx) const;
+    void clearDisplayCache();
+
     MessageHighlighter m_messageHighlighter;
+    int m_sortColumn;
+    Qt::SortOrder m_sortOrder;
+    bool m_applyingChanges;
 
     QString m_customDateFormat;
     RootItem *m_selectedItem;
     QList<QString> m_headerData;
     QList<QString> m_tooltipData;
 
-    QFont m_normalFont;
-    QFont m_boldFont;
-
-    QIcon m_favoriteIcon;
-    QIcon m_readIcon;
-    QIcon m_unreadIcon;
+    // Role values are resolved once and shared by all rows,
+    // so that data() does not construct them on every paint.
+    QVariant m_normalFont;
+    QVariant m_boldFont;
+    QVariant m_highlightColor;
+
+    QVariant m_favoriteIcon;
+    QVariant m_readIcon;
+    QVariant m_unreadIcon;
+
+    // Formatted creation dates, parallel to loaded rows. Dates are
+    // formatted lazily when rows are displayed, null string means
+    // that date of the row is not formatted yet.
+    mutable QVector<QString> m_displayDates;
+
+    // Lookup tables for loaded rows, these are filled whenever
+    // rows are (re)loaded and updated when message states change.
+    QHash<int,int> m_rowsForIds;
+    QBitArray m_readRows;
+    QBitArray m_importantRows;
+
+    // Decompressed contents of archived messages, by their IDs.
+    mutable QCache<int,QString> m_archivedContents;
 };
 
 Q_DECLARE_METATYPE(MessagesModel::MessageHighlighter)
@@ -0,0 +1,76 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "core/messagespager.h"
+
+#include "miscellaneous/databasequeries.h"
+
+
+MessagesPager::MessagesPager(const QString &filter, int page_size)
+  : m_filter(filter), m_pageSize(page_size), m_keys(QVector<QPair<qint64,int> >()),
+    m_pageStart(-1), m_page(QList<Message>()) {
+}
+
+MessagesPager::~MessagesPager() {
+}
+
+bool MessagesPager::reload(QSqlDatabase db) {
+  bool ok;
+
+  m_keys = DatabaseQueries::getMessageKeys(db, m_filter, &ok);
+  m_pageStart = -1;
+  m_page.clear();
+
+  return ok;
+}
+
+int MessagesPager::count() const {
+  return m_keys.size();
+}
+
+Message MessagesPager::messageAt(QSqlDatabase db, int position) {
+  if (position < 0 || position >= m_keys.size()) {
+    return Message();
+  }
+
+  if (m_pageStart < 0 || position < m_pageStart || position >= m_pageStart + m_page.size()) {
+    // Message is not in current page. Load page, which contains the message
+    // and also some preceding messages, so that scrolling back does not
+    // cause another load.
+    loadPage(db, qMax(0, position - m_pageSize / 4));
+  }
+
+  return m_page.value(position - m_pageStart);
+}
+
+QList<Message> MessagesPager::messages(QSqlDatabase db, int position, int count) {
+  if (position < 0 || position >= m_keys.size() || count <= 0) {
+    return QList<Message>();
+  }
+
+  QList<Message> messages = DatabaseQueries::getMessagesPage(db, m_filter, m_keys.at(position).first,
+                                                            m_keys.at(position).second, count);
+
+  // Messages are displayed, so their archived contents are needed.
+  DatabaseQueries::loadArchivedContents(db, messages);
+  return messages;
+}
+
+void MessagesPager::loadPage(QSqlDatabase db, int first_position) {
+  m_page = messages(db, first_position, m_pageSize);
+  m_pageStart = first_position;
+}
@@ -0,0 +1,63 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MESSAGESPAGER_H
+#define MESSAGESPAGER_H
+
+#include "core/message.h"
+
+#include <QSqlDatabase>
+#include <QVector>
+#include <QPair>
+
+
+// Provides random access to (possibly huge) list of messages
+// without keeping them all in memory.
+//
+// Only ordering keys of messages are kept, actual messages
+// are streamed from database in pages via keyset pagination.
+class MessagesPager {
+  public:
+    // Constructors and destructors.
+    explicit MessagesPager(const QString &filter, int page_size = NEWSPAPER_PAGE_SIZE);
+    virtual ~MessagesPager();
+
+    // (Re)loads ordering keys of messages which match the filter.
+    bool reload(QSqlDatabase db);
+
+    int count() const;
+
+    // Returns message at given position, page
+    // with the message is loaded if needed.
+    Message messageAt(QSqlDatabase db, int position);
+
+    // Returns "count" messages starting at given position.
+    QList<Message> messages(QSqlDatabase db, int position, int count);
+
+  private:
+    void loadPage(QSqlDatabase db, int first_position);
+
+    QString m_filter;
+    int m_pageSize;
+    QVector<QPair<qint64,int> > m_keys;
+
+    // Currently loaded page.
+    int m_pageStart;
+    QList<Message> m_page;
+};
+
+#endif // MESSAGESPAGER_H
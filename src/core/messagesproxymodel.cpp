@@ -21,7 +21,8 @@
 
 
 MessagesProxyModel::MessagesProxyModel(MessagesModel *source_model, QObject *parent)
-  : QSortFilterProxyModel(parent), m_sourceModel(source_model) {
+  : QSortFilterProxyModel(parent), m_sourceModel(source_model), m_archivedContents(QHash<int,QString>()),
+    m_archivedContentsLoaded(false), m_archivedMatches(QSet<int>()) {
 
   setObjectName(QSL("MessagesProxyModel"));
   setSortRole(Qt::EditRole);
@@ -31,6 +32,9 @@ MessagesProxyModel::MessagesProxyModel(MessagesModel *source_model, QObject *par
   setFilterRole(Qt::EditRole);
   setDynamicSortFilter(false);
   setSourceModel(m_sourceModel);
+
+  connect(m_sourceModel, &MessagesModel::modelReset, this, &MessagesProxyModel::invalidateArchivedContents);
+  connect(m_sourceModel, &MessagesModel::rowsInserted, this, &MessagesProxyModel::invalidateArchivedContents);
 }
 
 MessagesProxyModel::~MessagesProxyModel() {
@@ -50,11 +54,18 @@ QModelIndex MessagesProxyModel::getNextPreviousUnreadItemIndex(int default_row)
 }
 
 QModelIndex MessagesProxyModel::getNextUnreadItemIndex(int default_row, int max_row) const {
+  if (filterRegExp().isEmpty()) {
+    // Rows are not filtered (nor sorted) by proxy, so source rows
+    // can be used directly.
+    const int unread_row = m_sourceModel->nextUnreadRow(default_row, max_row);
+
+    return unread_row < 0 ? QModelIndex() : index(unread_row, MSG_DB_READ_INDEX);
+  }
+
   while (default_row <= max_row) {
     // Get info if the message is read or not.
     const QModelIndex proxy_index = index(default_row, MSG_DB_READ_INDEX);
-    const bool is_read = m_sourceModel->data(mapToSource(proxy_index).row(),
-                                             MSG_DB_READ_INDEX, Qt::EditRole).toInt() == 1;
+    const bool is_read = m_sourceModel->isMessageRead(mapToSource(proxy_index).row());
 
     if (!is_read) {
       // We found unread message, mark it.
@@ -76,6 +87,43 @@ bool MessagesProxyModel::lessThan(const QModelIndex &left, const QModelIndex &ri
   return false;
 }
 
+bool MessagesProxyModel::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const {
+  if (QSortFilterProxyModel::filterAcceptsRow(source_row, source_parent)) {
+    return true;
+  }
+
+  return !m_archivedMatches.isEmpty() && m_archivedMatches.contains(m_sourceModel->messageId(source_row));
+}
+
+void MessagesProxyModel::setSearchPattern(const QString &pattern) {
+  m_archivedMatches.clear();
+
+  if (pattern.isEmpty()) {
+    invalidateArchivedContents();
+  }
+  else {
+    const QRegExp regexp(pattern, filterCaseSensitivity(), QRegExp::RegExp);
+
+    if (!m_archivedContentsLoaded) {
+      m_archivedContents = m_sourceModel->archivedContentsOfLoadedMessages();
+      m_archivedContentsLoaded = true;
+    }
+
+    foreach (int message_id, m_archivedContents.keys()) {
+      if (m_archivedContents.value(message_id).contains(regexp)) {
+        m_archivedMatches.insert(message_id);
+      }
+    }
+  }
+
+  setFilterRegExp(pattern);
+}
+
+void MessagesProxyModel::invalidateArchivedContents() {
+  m_archivedContents.clear();
+  m_archivedContentsLoaded = false;
+}
+
 QModelIndexList MessagesProxyModel::mapListFromSource(const QModelIndexList &indexes, bool deep) const {
   QModelIndexList mapped_indexes;
 
@@ -20,6 +20,9 @@
 
 #include <QSortFilterProxyModel>
 
+#include <QHash>
+#include <QSet>
+
 
 class MessagesModel;
 
@@ -43,14 +46,30 @@ class MessagesProxyModel : public QSortFilterProxyModel {
     // Performs sort of items.
     void sort(int column, Qt::SortOrder order = Qt::AscendingOrder);
 
+    // Filters messages by given pattern, archived contents of messages are searched too.
+    void setSearchPattern(const QString &pattern);
+
+  private slots:
+    // Archived contents are loaded again for next search.
+    void invalidateArchivedContents();
+
   private:
     QModelIndex getNextUnreadItemIndex(int default_row, int max_row) const;
 
     // Compares two rows of data.
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
 
+    // Archived contents are not in the source model, they are searched separately.
+    bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const;
+
     // Source model pointer.
     MessagesModel *m_sourceModel;
+
+    // Archived contents of loaded messages are loaded once per search,
+    // IDs of messages whose archived contents match the pattern are kept.
+    QHash<int,QString> m_archivedContents;
+    bool m_archivedContentsLoaded;
+    QSet<int> m_archivedMatches;
 };
 
 #endif // MESSAGESPROXYMODEL_H
@@ -18,6 +18,8 @@
 #include "core/parsingfactory.h"
 
 #include "miscellaneous/textfactory.h"
+#include "miscellaneous/debugging.h"
+#include "miscellaneous/tracer.h"
 #include "network-web/webfactory.h"
 
 #include <QDomDocument>
@@ -28,6 +30,7 @@ ParsingFactory::ParsingFactory() {
 }
 
 QList<Message> ParsingFactory::parseAsATOM10(const QString &data) {
+  TraceSpan span("parser", "ParsingFactory::parseAsATOM10");
   QList<Message> messages;
   QDomDocument xml_file;
   QDateTime current_time = QDateTime::currentDateTime();
@@ -76,7 +79,7 @@ QList<Message> ParsingFactory::parseAsATOM10(const QString &data) {
       if (link.attribute(QSL("rel")) == QSL("enclosure")) {
         new_message.m_enclosures.append(Enclosure(link.attribute(QSL("href")), link.attribute(QSL("type"))));
 
-        qDebug("Adding enclosure '%s' for the message.", qPrintable(new_message.m_enclosures.last().m_url));
+        qCDebug(LOGPARSER, "Adding enclosure '%s' for the message.", qPrintable(new_message.m_enclosures.last().m_url));
       }
       else {
         new_message.m_url = link.attribute(QSL("href"));
@@ -113,10 +116,12 @@ QList<Message> ParsingFactory::parseAsATOM10(const QString &data) {
     messages.append(new_message);
   }
 
+  span.setArgument("messages", messages.size());
   return messages;
 }
 
 QList<Message> ParsingFactory::parseAsRDF(const QString &data) {
+  TraceSpan span("parser", "ParsingFactory::parseAsRDF");
   QList<Message> messages;
   QDomDocument xml_file;
   QDateTime current_time = QDateTime::currentDateTime();
@@ -184,10 +189,12 @@ QList<Message> ParsingFactory::parseAsRDF(const QString &data) {
     messages.append(new_message);
   }
 
+  span.setArgument("messages", messages.size());
   return messages;
 }
 
 QList<Message> ParsingFactory::parseAsRSS20(const QString &data) {
+  TraceSpan span("parser", "ParsingFactory::parseAsRSS20");
   QList<Message> messages;
   QDomDocument xml_file;
   QDateTime current_time = QDateTime::currentDateTime();
@@ -232,7 +239,7 @@ QList<Message> ParsingFactory::parseAsRSS20(const QString &data) {
     if (!elem_enclosure.isEmpty()) {
       new_message.m_enclosures.append(Enclosure(elem_enclosure, elem_enclosure_type));
 
-      qDebug("Adding enclosure '%s' for the message.", qPrintable(elem_enclosure));
+      qCDebug(LOGPARSER, "Adding enclosure '%s' for the message.", qPrintable(elem_enclosure));
     }
 
     // Deal with link and author.
@@ -277,5 +284,6 @@ QList<Message> ParsingFactory::parseAsRSS20(const QString &data) {
     messages.append(new_message);
   }
 
+  span.setArgument("messages", messages.size());
   return messages;
 }
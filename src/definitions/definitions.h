@@ -50,14 +50,31 @@
 #define MESSAGES_VIEW_DEFAULT_COL             170
 #define FEEDS_VIEW_COLUMN_COUNT               2
 #define FEED_DOWNLOADER_MAX_THREADS           6
+#define METADATA_FETCHER_MAX_DOWNLOADS        16
+#define METADATA_FETCHER_MAX_HOST_DOWNLOADS   2
+#define IMPORT_INSERT_BATCH_SIZE              50
 #define DEFAULT_DAYS_TO_DELETE_MSG            14
 #define ELLIPSIS_LENGTH                       3
 #define MIN_CATEGORY_NAME_LENGTH              1
 #define DEFAULT_AUTO_UPDATE_INTERVAL          15
 #define AUTO_UPDATE_INTERVAL                  60000
 #define STARTUP_UPDATE_DELAY                  30000
+#define RETENTION_STARTUP_DELAY               120000
+#define RETENTION_BATCH_SIZE                  500
+#define RETENTION_BATCH_DELAY                 250
+#define RETENTION_BUSY_DELAY                  10000
+#define RETENTION_VACUUM_PAGES                256
+#define ARCHIVE_COMPRESSION_LEVEL             6
+#define ARCHIVE_CACHE_SIZE                    4194304
+#define UPDATE_TELEMETRY_MAX_AGE              30
+#define UPDATE_STATISTICS_TOP_FEEDS           25
+#define TRACE_BUFFER_SIZE                     100000
+#define BENCHMARK_ROUNDS                      5
+#define BENCHMARK_ACCOUNT_ID                  -1
+#define BENCHMARK_FEED_ID                     -1
 #define TIMEZONE_OFFSET_LIMIT                 6
 #define CHANGE_EVENT_DELAY                    250
+#define MESSAGE_PRERENDER_DELAY               400
 #define FLAG_ICON_SUBFOLDER                   "flags"
 #define SEACRH_MESSAGES_ACTION_NAME           "search"
 #define HIGHLIGHTER_ACTION_NAME               "highlighter"
@@ -74,6 +91,9 @@
 #define GOOGLE_SUGGEST_URL                    "http://suggestqueries.google.com/complete/search?output=toolbar&hl=en&q=%1"
 #define ENCRYPTION_FILE_NAME                  "key.private"
 #define RELOAD_MODEL_BORDER_NUM               10
+#define NEWSPAPER_PAGE_SIZE                   40
+#define NEWSPAPER_MAX_PAGES                   5
+#define NEWSPAPER_ROW_HEIGHT                  300
 
 #define MAX_ZOOM_FACTOR     5.0f
 #define MIN_ZOOM_FACTOR     0.25f
@@ -89,6 +109,13 @@
 
 #define FEED_REGEX_MATCHER                    "<link[^>]+type=\\\"application/(atom|rss)\\+xml\\\"[^>]*>"
 #define FEED_HREF_REGEX_MATCHER               "href\\=\\\"[^\\\"]+\\\""
+#define FAVICON_REGEX_MATCHER                 "<link[^>]+rel=[\\\"']([^\\\"']*\\s)?icon(\\s[^\\\"']*)?[\\\"'][^>]*>"
+#define FAVICON_HREF_REGEX_MATCHER            "href=[\\\"']([^\\\"']+)[\\\"']"
+#define FAVICON_MAX_PARALLEL_DOWNLOADS        6
+#define FAVICON_MAX_REDIRECTIONS              5
+#define FAVICON_CACHE_EXPIRATION_DAYS         30
+#define FAVICON_CACHE_FAILURE_EXPIRATION_DAYS 1
+#define FAVICON_CACHE_FILE                    "favicons.ini"
 
 #define PLACEHOLDER_UNREAD_COUNTS   "%unread"
 #define PLACEHOLDER_ALL_COUNTS      "%all"
@@ -97,6 +124,11 @@
 #define BACKUP_SUFFIX_SETTINGS  ".ini.backup"
 #define BACKUP_NAME_DATABASE    "database"
 #define BACKUP_SUFFIX_DATABASE  ".db.backup"
+#define BACKUP_SUFFIX_DUMP      ".sql.backup"
+#define BACKUP_SUFFIX_ICONS     ".icons.backup"
+#define BACKUP_PAGES_PER_STEP   100
+#define BACKUP_ROWS_PER_BATCH   500
+#define BACKUP_STEP_DELAY       25
 
 #define APP_DB_MYSQL_DRIVER           "QMYSQL"
 #define APP_DB_MYSQL_INIT             "db_init_mysql.sql"
@@ -109,9 +141,12 @@
 #define APP_DB_SQLITE_FILE            "database.db"
 
 // Keep this in sync with schema versions declared in SQL initialization code.
-#define APP_DB_SCHEMA_VERSION         "7"
+#define APP_DB_SCHEMA_VERSION         "13"
 #define APP_DB_UPDATE_FILE_PATTERN    "db_update_%1_%2_%3.sql"
 #define APP_DB_COMMENT_SPLIT          "-- !\n"
+#define APP_DB_UPDATE_CHUNK_PARAM     ":chunk_size"
+#define APP_DB_UPDATE_CHUNK_SIZE      5000
+#define APP_DB_UPDATE_PROGRESS_KEY    "schema_update_progress"
 #define APP_DB_NAME_PLACEHOLDER       "##"
 
 #define APP_CFG_PATH        "config"
@@ -120,6 +155,8 @@
 #define APP_QUIT_INSTANCE   "-q"
 #define APP_IS_RUNNING      "app_is_running"
 #define APP_SKIN_USER_FOLDER "skins"
+#define APP_ICON_STORE_FOLDER "icons"
+#define APP_ICON_STORE_PREFIX "icon-store:"
 #define APP_SKIN_DEFAULT    "vergilius"
 #define APP_SKIN_METADATA_FILE "metadata.xml"
 #define APP_STYLE_DEFAULT   "Fusion"
@@ -163,6 +200,7 @@
 #define MSG_DB_ACCOUNT_ID_INDEX         12
 #define MSG_DB_CUSTOM_ID_INDEX          13
 #define MSG_DB_CUSTOM_HASH_INDEX        14
+#define MSG_DB_PARTIAL_INDEX            15
 
 // Indexes of columns as they are DEFINED IN THE TABLE for CATEGORIES.
 #define CAT_DB_ID_INDEX           0
@@ -19,6 +19,8 @@
 
 #include "miscellaneous/application.h"
 #include "miscellaneous/iconfactory.h"
+#include "miscellaneous/feedreader.h"
+#include "miscellaneous/databasebackuper.h"
 #include "exceptions/applicationexception.h"
 
 #include <QDialogButtonBox>
@@ -41,15 +43,14 @@ FormBackupDatabaseSettings::FormBackupDatabaseSettings(QWidget *parent) : QDialo
   connect(m_ui->m_txtBackupName->lineEdit(), &BaseLineEdit::textChanged, this, &FormBackupDatabaseSettings::checkBackupNames);
   connect(m_ui->m_txtBackupName->lineEdit(), &BaseLineEdit::textChanged, this, &FormBackupDatabaseSettings::checkOkButton);
   connect(m_ui->m_btnSelectFolder, &QPushButton::clicked, this, &FormBackupDatabaseSettings::selectFolderInitial);
+  connect(qApp->feedReader()->databaseBackuper(), &DatabaseBackuper::backupProgress,
+          this, &FormBackupDatabaseSettings::onBackupProgress);
+  connect(qApp->feedReader()->databaseBackuper(), &DatabaseBackuper::backupFinished,
+          this, &FormBackupDatabaseSettings::onBackupFinished);
 
   selectFolder(qApp->getDocumentsFolderPath());
   m_ui->m_txtBackupName->lineEdit()->setText(QString(APP_LOW_NAME) + QL1S("_") + QDateTime::currentDateTime().toString(QSL("yyyyMMddHHmm")));
   m_ui->m_lblResult->setStatus(WidgetWithStatus::Warning, tr("No operation executed yet."), tr("No operation executed yet."));
-
-  if (qApp->database()->activeDatabaseDriver() != DatabaseFactory::SQLITE &&
-      qApp->database()->activeDatabaseDriver() != DatabaseFactory::SQLITE_MEMORY) {
-    m_ui->m_checkBackupDatabase->setDisabled(true);
-  }
 }
 
 FormBackupDatabaseSettings::~FormBackupDatabaseSettings() {
@@ -60,13 +61,40 @@ void FormBackupDatabaseSettings::performBackup() {
   try {
     qApp->backupDatabaseSettings(m_ui->m_checkBackupDatabase->isChecked(), m_ui->m_checkBackupSettings->isChecked(),
                                  m_ui->m_lblSelectFolder->label()->text(), m_ui->m_txtBackupName->lineEdit()->text());
+
+    if (m_ui->m_checkBackupDatabase->isChecked()) {
+      // Result is reported once database backup is finished.
+      m_ui->m_buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+      m_ui->m_lblResult->setStatus(WidgetWithStatus::Progress, tr("Backing up database..."), tr("Backing up database..."));
+    }
+    else {
+      m_ui->m_lblResult->setStatus(WidgetWithStatus::Ok,
+                                   tr("Backup was created successfully and stored in target directory."),
+                                   tr("Backup was created successfully."));
+    }
+  }
+  catch (const ApplicationException &ex) {
+    m_ui->m_lblResult->setStatus(WidgetWithStatus::Error, ex.message(), tr("Backup failed."));
+  }
+}
+
+void FormBackupDatabaseSettings::onBackupProgress(int progress, const QString &description) {
+  Q_UNUSED(progress)
+
+  m_ui->m_lblResult->setStatus(WidgetWithStatus::Progress, description, description);
+}
+
+void FormBackupDatabaseSettings::onBackupFinished(bool result, const QString &error_message) {
+  if (result) {
     m_ui->m_lblResult->setStatus(WidgetWithStatus::Ok,
                                  tr("Backup was created successfully and stored in target directory."),
                                  tr("Backup was created successfully."));
   }
-  catch (const ApplicationException &ex) {
-    m_ui->m_lblResult->setStatus(WidgetWithStatus::Error, ex.message(), tr("Backup failed."));
+  else {
+    m_ui->m_lblResult->setStatus(WidgetWithStatus::Error, error_message, tr("Backup failed."));
   }
+
+  checkOkButton();
 }
 
 void FormBackupDatabaseSettings::selectFolderInitial() {
@@ -34,6 +34,8 @@ class FormBackupDatabaseSettings : public QDialog {
 
   private slots:
     void performBackup();
+    void onBackupProgress(int progress, const QString &description);
+    void onBackupFinished(bool result, const QString &error_message);
     void selectFolderInitial();
     void selectFolder(QString path = QString());
     void checkBackupNames(const QString &name);
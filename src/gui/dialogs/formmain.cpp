@@ -25,6 +25,7 @@
 #include "miscellaneous/databasefactory.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/feedreader.h"
+#include "miscellaneous/tracer.h"
 #include "network-web/webfactory.h"
 #include "gui/feedsview.h"
 #include "gui/messagebox.h"
@@ -40,6 +41,7 @@
 #include "gui/dialogs/formsettings.h"
 #include "gui/dialogs/formupdate.h"
 #include "gui/dialogs/formdatabasecleanup.h"
+#include "gui/dialogs/formupdatestatistics.h"
 #include "gui/dialogs/formbackupdatabasesettings.h"
 #include "gui/dialogs/formrestoredatabasesettings.h"
 #include "gui/dialogs/formaddaccount.h"
@@ -72,6 +74,9 @@ FormMain::FormMain(QWidget *parent, Qt::WindowFlags f)
   // Prepare main window and tabs.
   prepareMenus();
 
+  // Trace can be saved only if tracing was enabled on startup.
+  m_ui->m_actionSaveTrace->setVisible(Tracer::isEnabled());
+
   // Prepare tabs.
   //m_ui->m_tabWidget->initializeTabs();
   tabWidget()->feedMessageViewer()->feedsToolBar()->loadChangeableActions();
@@ -124,6 +129,29 @@ void FormMain::showDbCleanupAssistant() {
   }
 }
 
+void FormMain::showUpdateStatistics() {
+  QScopedPointer<FormUpdateStatistics> form_pointer(new FormUpdateStatistics(this));
+  form_pointer.data()->exec();
+}
+
+void FormMain::saveTrace() {
+  const QString file_path = QFileDialog::getSaveFileName(this, tr("Save trace"), Tracer::defaultFilePath(),
+                                                         tr("Chrome trace (*.json)"));
+
+  if (file_path.isEmpty()) {
+    return;
+  }
+
+  if (Tracer::save(file_path)) {
+    qApp->showGuiMessage(tr("Trace saved"), tr("Trace was saved, open it in \"chrome://tracing\" or Perfetto."),
+                         QSystemTrayIcon::Information, this);
+  }
+  else {
+    qApp->showGuiMessage(tr("Trace not saved"), tr("Trace could not be written to selected file."),
+                         QSystemTrayIcon::Critical, this, true);
+  }
+}
+
 QList<QAction*> FormMain::allActions() const {
   QList<QAction*> actions;
 
@@ -165,6 +193,8 @@ QList<QAction*> FormMain::allActions() const {
   actions << m_ui->m_actionServiceEdit;
   actions << m_ui->m_actionServiceDelete;
   actions << m_ui->m_actionCleanupDatabase;
+  actions << m_ui->m_actionShowUpdateStatistics;
+  actions << m_ui->m_actionSaveTrace;
   actions << m_ui->m_actionAddFeedIntoSelectedAccount;
   actions << m_ui->m_actionAddCategoryIntoSelectedAccount;
   actions << m_ui->m_actionViewSelectedItemsNewspaperMode;
@@ -351,8 +381,18 @@ void FormMain::updateAccountsMenu() {
 void FormMain::onFeedUpdatesFinished(FeedDownloadResults results) {
   Q_UNUSED(results)
 
+  // NOTE: Message list is not reloaded here, changed
+  // messages were already applied to it during the update.
   statusBar()->clearProgressFeeds();
-  tabWidget()->feedMessageViewer()->messagesView()->reloadSelections(false);
+}
+
+void FormMain::onRetentionFinished(int removed_messages, qint64 reclaimed_bytes) {
+  // NOTE: Removed messages were already dropped from message list batch by batch.
+  if (removed_messages > 0 || reclaimed_bytes > 0) {
+    qApp->showGuiMessage(tr("Old messages removed"),
+                         tr("%n old message(s) removed, %1 MB of disk space reclaimed.", 0, removed_messages).arg(reclaimed_bytes / 1000000.0),
+                         QSystemTrayIcon::Information);
+  }
 }
 
 void FormMain::onFeedUpdatesStarted() {
@@ -451,6 +491,8 @@ void FormMain::setupIcons() {
   m_ui->m_actionAboutGuard->setIcon(icon_theme_factory->fromTheme(QSL("help-about")));
   m_ui->m_actionCheckForUpdates->setIcon(icon_theme_factory->fromTheme(QSL("system-upgrade")));
   m_ui->m_actionCleanupDatabase->setIcon(icon_theme_factory->fromTheme(QSL("edit-clear")));
+  m_ui->m_actionShowUpdateStatistics->setIcon(icon_theme_factory->fromTheme(QSL("monitor")));
+  m_ui->m_actionSaveTrace->setIcon(icon_theme_factory->fromTheme(QSL("document-export")));
   m_ui->m_actionReportBug->setIcon(icon_theme_factory->fromTheme(QSL("call-start")));
   m_ui->m_actionBackupDatabaseSettings->setIcon(icon_theme_factory->fromTheme(QSL("document-export")));
   m_ui->m_actionRestoreDatabaseSettings->setIcon(icon_theme_factory->fromTheme(QSL("document-import")));
@@ -606,6 +648,8 @@ void FormMain::createConnections() {
   connect(m_ui->m_actionDownloadManager, SIGNAL(triggered()), m_ui->m_tabWidget, SLOT(showDownloadManager()));
 
   connect(m_ui->m_actionCleanupDatabase, SIGNAL(triggered()), this, SLOT(showDbCleanupAssistant()));
+  connect(m_ui->m_actionShowUpdateStatistics, SIGNAL(triggered()), this, SLOT(showUpdateStatistics()));
+  connect(m_ui->m_actionSaveTrace, SIGNAL(triggered()), this, SLOT(saveTrace()));
 
   // Menu "Help" connections.
   connect(m_ui->m_actionAboutGuard, SIGNAL(triggered()), this, SLOT(showAbout()));
@@ -631,6 +675,7 @@ void FormMain::createConnections() {
   connect(qApp->feedReader(), &FeedReader::feedUpdatesStarted, this, &FormMain::onFeedUpdatesStarted);
   connect(qApp->feedReader(), &FeedReader::feedUpdatesProgress, this, &FormMain::onFeedUpdatesProgress);
   connect(qApp->feedReader(), &FeedReader::feedUpdatesFinished, this, &FormMain::onFeedUpdatesFinished);
+  connect(qApp->feedReader(), &FeedReader::retentionFinished, this, &FormMain::onRetentionFinished);
 
   // Toolbar forwardings.
   connect(m_ui->m_actionAddFeedIntoSelectedAccount, SIGNAL(triggered()),
@@ -76,6 +76,7 @@ class FormMain : public QMainWindow {
     void onFeedUpdatesStarted();
     void onFeedUpdatesProgress(const Feed *feed, int current, int total);
     void onFeedUpdatesFinished(FeedDownloadResults results);
+    void onRetentionFinished(int removed_messages, qint64 reclaimed_bytes);
 
     // Displays various dialogs.
     void backupDatabaseSettings();
@@ -86,6 +87,8 @@ class FormMain : public QMainWindow {
     void showWiki();
     void showAddAccountDialog();
     void showDbCleanupAssistant();
+    void showUpdateStatistics();
+    void saveTrace();
     void reportABug();
     void donate();
 
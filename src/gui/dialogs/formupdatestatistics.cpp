@@ -0,0 +1,154 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "gui/dialogs/formupdatestatistics.h"
+
+#include "definitions/definitions.h"
+#include "core/feedsmodel.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/databasequeries.h"
+#include "miscellaneous/feedreader.h"
+#include "miscellaneous/iconfactory.h"
+#include "network-web/downloadmanager.h"
+#include "services/abstract/serviceroot.h"
+
+#include <QPushButton>
+
+
+FormUpdateStatistics::FormUpdateStatistics(QWidget *parent) : QDialog(parent), m_ui(new Ui::FormUpdateStatistics) {
+  m_ui->setupUi(this);
+
+  setWindowIcon(qApp->icons()->fromTheme(QSL("monitor")));
+
+  m_ui->m_cmbPeriod->addItem(tr("Last 24 hours"), 1);
+  m_ui->m_cmbPeriod->addItem(tr("Last 7 days"), 7);
+  m_ui->m_cmbPeriod->addItem(tr("Last %n day(s)", 0, UPDATE_TELEMETRY_MAX_AGE), UPDATE_TELEMETRY_MAX_AGE);
+  m_ui->m_cmbPeriod->setCurrentIndex(1);
+
+  m_ui->m_treeStages->setHeaderLabels(QStringList() << tr("Stage") << tr("Samples") << tr("Median") <<
+                                      tr("95th percentile") << tr("Maximum") << tr("Total"));
+  const QStringList feed_columns = QStringList() << tr("Feed") << tr("Account") << tr("Updates") << tr("Errors") <<
+                                   tr("Median") << tr("95th percentile") << tr("Slowest stage") << tr("Average size");
+
+  m_ui->m_treeSlowestFeeds->setHeaderLabels(feed_columns);
+  m_ui->m_treeLargestFeeds->setHeaderLabels(feed_columns);
+  m_ui->m_treeAccounts->setHeaderLabels(QStringList() << tr("Account") << tr("Updates") << tr("Errors") << tr("Median") <<
+                                        tr("95th percentile") << tr("Total time") << tr("New messages"));
+
+  m_ui->m_buttonBox->button(QDialogButtonBox::Reset)->setText(tr("C&lear statistics"));
+
+  connect(m_ui->m_cmbPeriod, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+          this, &FormUpdateStatistics::loadStatistics);
+  connect(m_ui->m_buttonBox->button(QDialogButtonBox::Reset), &QPushButton::clicked,
+          this, &FormUpdateStatistics::clearStatistics);
+
+  loadStatistics();
+}
+
+FormUpdateStatistics::~FormUpdateStatistics() {
+  qDebug("Destroying FormUpdateStatistics instance.");
+}
+
+void FormUpdateStatistics::loadStatistics() {
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  const int days = m_ui->m_cmbPeriod->currentData().toInt();
+  const UpdateTelemetryStatistics statistics(DatabaseQueries::getUpdateTelemetry(database,
+                                                                                 QDateTime::currentDateTimeUtc().addDays(-days)));
+
+  m_ui->m_lblSummary->setText(tr("%n feed update(s) recorded.", 0, statistics.updatesCount()));
+
+  loadStages(statistics);
+  loadFeeds(m_ui->m_treeSlowestFeeds, statistics.slowestFeeds(UPDATE_STATISTICS_TOP_FEEDS));
+  loadFeeds(m_ui->m_treeLargestFeeds, statistics.largestFeeds(UPDATE_STATISTICS_TOP_FEEDS));
+  loadAccounts(statistics);
+}
+
+void FormUpdateStatistics::clearStatistics() {
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+
+  DatabaseQueries::purgeUpdateTelemetry(database);
+  loadStatistics();
+}
+
+void FormUpdateStatistics::loadStages(const UpdateTelemetryStatistics &statistics) {
+  m_ui->m_treeStages->clear();
+
+  foreach (const TelemetryStageStatistics &stage, statistics.stages()) {
+    QTreeWidgetItem *item = new QTreeWidgetItem(m_ui->m_treeStages);
+
+    item->setText(0, stage.m_stage);
+    item->setText(1, QString::number(stage.m_samples));
+    item->setText(2, formatTime(stage.m_median));
+    item->setText(3, formatTime(stage.m_percentile95));
+    item->setText(4, formatTime(stage.m_maximum));
+    item->setText(5, formatTime(stage.m_total));
+  }
+
+  m_ui->m_treeStages->resizeColumnToContents(0);
+}
+
+void FormUpdateStatistics::loadFeeds(QTreeWidget *tree, const QList<TelemetryItemStatistics> &feeds) {
+  tree->clear();
+
+  foreach (const TelemetryItemStatistics &feed, feeds) {
+    QTreeWidgetItem *item = new QTreeWidgetItem(tree);
+
+    item->setText(0, feed.m_title);
+    item->setText(1, accountTitle(feed.m_accountId));
+    item->setText(2, QString::number(feed.m_updates));
+    item->setText(3, QString::number(feed.m_errors));
+    item->setText(4, formatTime(feed.m_medianTime));
+    item->setText(5, formatTime(feed.m_percentile95Time));
+    item->setText(6, feed.m_dominantStage);
+    item->setText(7, DownloadManager::dataString(feed.m_averageBytes));
+    item->setToolTip(7, tr("Largest download: %1").arg(DownloadManager::dataString(feed.m_maximumBytes)));
+  }
+
+  tree->resizeColumnToContents(0);
+}
+
+void FormUpdateStatistics::loadAccounts(const UpdateTelemetryStatistics &statistics) {
+  m_ui->m_treeAccounts->clear();
+
+  foreach (const TelemetryItemStatistics &account, statistics.accounts()) {
+    QTreeWidgetItem *item = new QTreeWidgetItem(m_ui->m_treeAccounts);
+
+    item->setText(0, accountTitle(account.m_accountId));
+    item->setText(1, QString::number(account.m_updates));
+    item->setText(2, QString::number(account.m_errors));
+    item->setText(3, formatTime(account.m_medianTime));
+    item->setText(4, formatTime(account.m_percentile95Time));
+    item->setText(5, formatTime(account.m_totalTime));
+    item->setText(6, QString::number(account.m_newMessages));
+  }
+
+  m_ui->m_treeAccounts->resizeColumnToContents(0);
+}
+
+QString FormUpdateStatistics::accountTitle(int account_id) const {
+  foreach (const ServiceRoot *root, qApp->feedReader()->feedsModel()->serviceRoots()) {
+    if (root->accountId() == account_id) {
+      return root->title();
+    }
+  }
+
+  return tr("Removed account");
+}
+
+QString FormUpdateStatistics::formatTime(qint64 microseconds) const {
+  return tr("%1 ms").arg(microseconds / 1000.0, 0, 'f', 1);
+}
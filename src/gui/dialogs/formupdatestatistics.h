@@ -0,0 +1,52 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FORMUPDATESTATISTICS_H
+#define FORMUPDATESTATISTICS_H
+
+#include <QDialog>
+
+#include "ui_formupdatestatistics.h"
+
+#include "core/feedupdatetelemetry.h"
+
+
+class FormUpdateStatistics : public QDialog {
+    Q_OBJECT
+
+  public:
+    // Constructors.
+    explicit FormUpdateStatistics(QWidget *parent = 0);
+    virtual ~FormUpdateStatistics();
+
+  private slots:
+    void loadStatistics();
+    void clearStatistics();
+
+  private:
+    void loadStages(const UpdateTelemetryStatistics &statistics);
+    void loadFeeds(QTreeWidget *tree, const QList<TelemetryItemStatistics> &feeds);
+    void loadAccounts(const UpdateTelemetryStatistics &statistics);
+
+    QString accountTitle(int account_id) const;
+    QString formatTime(qint64 microseconds) const;
+
+  private:
+    QScopedPointer<Ui::FormUpdateStatistics> m_ui;
+};
+
+#endif // FORMUPDATESTATISTICS_H
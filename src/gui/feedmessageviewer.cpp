@@ -212,6 +212,9 @@ void FeedMessageViewer::createConnections() {
   // Message changers.
   connect(m_messagesView, SIGNAL(currentMessageRemoved()), m_messagesBrowser, SLOT(clear()));
   connect(m_messagesView, SIGNAL(currentMessageChanged(Message,RootItem*)), m_messagesBrowser, SLOT(loadMessage(Message,RootItem*)));
+#if defined(USE_WEBENGINE)
+  connect(m_messagesView, SIGNAL(nextMessageHinted(Message,RootItem*)), m_messagesBrowser, SLOT(prerenderMessage(Message,RootItem*)));
+#endif
 
   connect(m_messagesBrowser, SIGNAL(markMessageRead(int,RootItem::ReadStatus)),
           m_messagesView->sourceModel(), SLOT(setMessageReadById(int,RootItem::ReadStatus)));
@@ -225,6 +228,8 @@ void FeedMessageViewer::createConnections() {
   // to reload selections.
   connect(m_feedsView->sourceModel(), SIGNAL(reloadMessageListRequested(bool)),
           m_messagesView, SLOT(reloadSelections(bool)));
+  connect(m_feedsView->sourceModel(), SIGNAL(messagesChangesAvailable(MessagesChanges)),
+          m_messagesView, SLOT(applyMessagesChanges(MessagesChanges)));
 }
 
 void FeedMessageViewer::initialize() {
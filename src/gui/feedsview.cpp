@@ -320,10 +320,11 @@ void FeedsView::markAllItemsRead() {
 
 void FeedsView::openSelectedItemsInNewspaperMode() {
   RootItem *selected_item = selectedItem();
-  const QList<Message> messages = m_sourceModel->messagesForItem(selected_item);
+  ServiceRoot *service_root = selected_item != nullptr ? selected_item->getParentServiceRoot() : nullptr;
 
-  if (!messages.isEmpty()) {
-    emit openMessagesInNewspaperView(selected_item, messages);
+  if (service_root != nullptr) {
+    // Messages are not loaded here, newspaper view streams them from DB itself.
+    emit openFilterInNewspaperView(selected_item, service_root->messagesFilterForItem(selected_item));
   }
 }
 
@@ -469,7 +470,6 @@ void FeedsView::selectionChanged(const QItemSelection &selected, const QItemSele
   m_proxyModel->setSelectedItem(selected_item);
   QTreeView::selectionChanged(selected, deselected);
   emit itemSelected(selected_item);
-  m_proxyModel->invalidateReadFeedsFilter();
 }
 
 void FeedsView::keyPressEvent(QKeyEvent *event) {
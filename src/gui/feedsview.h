@@ -97,8 +97,8 @@ class FeedsView : public QTreeView {
     // Emitted if user selects new feeds.
     void itemSelected(RootItem *item);
 
-    // Requests opening of given messages in newspaper mode.
-    void openMessagesInNewspaperView(RootItem *root, const QList<Message> &messages);
+    // Requests opening of all messages which match given filter in newspaper mode.
+    void openFilterInNewspaperView(RootItem *root, const QString &filter);
 
   protected:
     // Handle selections.
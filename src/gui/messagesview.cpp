@@ -20,6 +20,7 @@
 #include "core/messagesproxymodel.h"
 #include "core/messagesmodel.h"
 #include "miscellaneous/settings.h"
+#include "miscellaneous/debugging.h"
 #include "miscellaneous/feedreader.h"
 #include "network-web/networkfactory.h"
 #include "network-web/webfactory.h"
@@ -38,9 +39,13 @@ MessagesView::MessagesView(QWidget *parent)
   : QTreeView(parent),
     m_contextMenu(nullptr),
     m_columnsAdjusted(false),
-    m_batchUnreadSwitch(false) {
+    m_batchUnreadSwitch(false),
+    m_pendingContentsId(-1),
+    m_nextMessageHintTimer(new QTimer(this)) {
   m_sourceModel = qApp->feedReader()->messagesModel();
   m_proxyModel = qApp->feedReader()->messagesProxyModel();
+  m_nextMessageHintTimer->setSingleShot(true);
+  m_nextMessageHintTimer->setInterval(MESSAGE_PRERENDER_DELAY);
 
   // Forward count changes to the view.
   createConnections();
@@ -58,6 +63,7 @@ void MessagesView::createConnections() {
   // Adjust columns when layout gets changed.
   connect(header(), SIGNAL(geometriesChanged()), this, SLOT(adjustColumns()));
   connect(header(), SIGNAL(sortIndicatorChanged(int,Qt::SortOrder)), this, SLOT(onSortIndicatorChanged(int,Qt::SortOrder)));
+  connect(m_nextMessageHintTimer, SIGNAL(timeout()), this, SLOT(hintNextMessage()));
 }
 
 void MessagesView::keyboardSearch(const QString &search) {
@@ -73,7 +79,7 @@ void MessagesView::reloadSelections(bool mark_current_index_read) {
 
   QModelIndex current_index = selectionModel()->currentIndex();
   const QModelIndex mapped_current_index = m_proxyModel->mapToSource(current_index);
-  const Message selected_message = m_sourceModel->messageAt(mapped_current_index.row());
+  const int selected_message_id = mapped_current_index.isValid() ? m_sourceModel->messageId(mapped_current_index.row()) : 0;
   const int col = qApp->settings()->value(GROUP(GUI), SETTING(GUI::DefaultSortColumnMessages)).toInt();
   const Qt::SortOrder ord = static_cast<Qt::SortOrder>(qApp->settings()->value(GROUP(GUI), SETTING(GUI::DefaultSortOrderMessages)).toInt());
 
@@ -81,25 +87,12 @@ void MessagesView::reloadSelections(bool mark_current_index_read) {
   m_sourceModel->sort(col, ord);
 
   // Now, we must find the same previously focused message.
-  if (selected_message.m_id > 0) {
-    if (m_proxyModel->rowCount() == 0) {
-      current_index = QModelIndex();
-    }
-    else {
-      for (int i = 0; i < m_proxyModel->rowCount(); i++) {
-        QModelIndex msg_idx = m_proxyModel->index(i, MSG_DB_TITLE_INDEX);
-        Message msg = m_sourceModel->messageAt(m_proxyModel->mapToSource(msg_idx).row());
-
-        if (msg.m_id == selected_message.m_id) {
-          current_index = msg_idx;
-          break;
-        }
+  if (selected_message_id > 0) {
+    const int source_row = m_sourceModel->rowForMessageId(selected_message_id);
 
-        if (i == m_proxyModel->rowCount() - 1) {
-          current_index = QModelIndex();
-        }
-      }
-    }
+    current_index = source_row < 0 ?
+                      QModelIndex() :
+                      m_proxyModel->mapFromSource(m_sourceModel->index(source_row, MSG_DB_TITLE_INDEX));
   }
 
   if (current_index.isValid()) {
@@ -123,7 +116,23 @@ void MessagesView::reloadSelections(bool mark_current_index_read) {
 
   const QDateTime dt2 = QDateTime::currentDateTime();
 
-  qDebug("Reloading of msg selections took %lld miliseconds.", dt1.msecsTo(dt2));
+  qCDebug(LOGGUI, "Reloading of msg selections took %lld miliseconds.", dt1.msecsTo(dt2));
+}
+
+void MessagesView::applyMessagesChanges(const MessagesChanges &changes) {
+  if (!m_sourceModel->applyMessagesChanges(changes)) {
+    reloadSelections(false);
+  }
+  else if (m_pendingContentsId >= 0 && changes.m_updatedIds.contains(m_pendingContentsId)) {
+    // Contents of displayed message were downloaded, show them.
+    const int row = m_sourceModel->rowForMessageId(m_pendingContentsId);
+
+    m_pendingContentsId = -1;
+
+    if (row >= 0 && m_proxyModel->mapToSource(currentIndex()).row() == row) {
+      emit currentMessageChanged(m_sourceModel->messageAt(row), m_sourceModel->loadedItem());
+    }
+  }
 }
 
 void MessagesView::setupAppearance() {
@@ -200,7 +209,10 @@ void MessagesView::mousePressEvent(QMouseEvent *event) {
 
         if (mapped_index.column() == MSG_DB_IMPORTANT_INDEX) {
           if (m_sourceModel->switchMessageImportance(mapped_index.row())) {
-            emit currentMessageChanged(m_sourceModel->messageAt(mapped_index.row()), m_sourceModel->loadedItem());
+            Message message = m_sourceModel->messageAt(mapped_index.row());
+
+            m_sourceModel->loadArchivedContents(message);
+            emit currentMessageChanged(message, m_sourceModel->loadedItem());
           }
         }
       }
@@ -236,9 +248,9 @@ void MessagesView::selectionChanged(const QItemSelection &selected, const QItemS
   const QModelIndex current_index = currentIndex();
   const QModelIndex mapped_current_index = m_proxyModel->mapToSource(current_index);
 
-  qDebug("Current row changed - row [%d,%d] source [%d, %d].",
-         current_index.row(), current_index.column(),
-         mapped_current_index.row(), mapped_current_index.column());
+  qCDebug(LOGGUI, "Current row changed - row [%d,%d] source [%d, %d].",
+          current_index.row(), current_index.column(),
+          mapped_current_index.row(), mapped_current_index.column());
 
   if (mapped_current_index.isValid() && selected_rows.count() > 0) {
     Message message = m_sourceModel->messageAt(m_proxyModel->mapToSource(current_index).row());
@@ -250,9 +262,24 @@ void MessagesView::selectionChanged(const QItemSelection &selected, const QItemS
       message.m_isRead = true;
     }
 
+    // Only headline of the message could be synchronized, so obtain its
+    // full contents, they are displayed once they are downloaded.
+    m_pendingContentsId = m_sourceModel->loadMessageContents(mapped_current_index.row(), message) ? -1 : message.m_id;
+
     emit currentMessageChanged(message, m_sourceModel->loadedItem());
+
+    // Following message is the most likely to be selected next, viewer
+    // prepares it once user stays on current message for a while.
+    if (selected_rows.count() == 1) {
+      m_nextMessageHintTimer->start();
+    }
+    else {
+      m_nextMessageHintTimer->stop();
+    }
   }
   else {
+    m_nextMessageHintTimer->stop();
+    m_pendingContentsId = -1;
     emit currentMessageRemoved();
   }
 
@@ -263,6 +290,27 @@ void MessagesView::selectionChanged(const QItemSelection &selected, const QItemS
   QTreeView::selectionChanged(selected, deselected);
 }
 
+void MessagesView::hintNextMessage() {
+  const QModelIndex current_index = currentIndex();
+  const QModelIndex next_index = m_proxyModel->mapToSource(current_index.sibling(current_index.row() + 1, current_index.column()));
+
+  if (!next_index.isValid() || selectionModel()->selectedRows().count() != 1) {
+    return;
+  }
+
+  Message next_message = m_sourceModel->messageAt(next_index.row());
+
+  // Archived contents are not decompressed just for the hint,
+  // such message is loaded normally once it is selected.
+  if (next_message.m_isArchived) {
+    return;
+  }
+
+  // It will be marked read once selected.
+  next_message.m_isRead = true;
+  emit nextMessageHinted(next_message, m_sourceModel->loadedItem());
+}
+
 void MessagesView::loadItem(RootItem *item) {
   const int col = qApp->settings()->value(GROUP(GUI), SETTING(GUI::DefaultSortColumnMessages)).toInt();
   const Qt::SortOrder ord = static_cast<Qt::SortOrder>(qApp->settings()->value(GROUP(GUI), SETTING(GUI::DefaultSortOrderMessages)).toInt());
@@ -506,7 +554,7 @@ void MessagesView::selectNextUnreadItem() {
 }
 
 void MessagesView::searchMessages(const QString &pattern) {
-  m_proxyModel->setFilterRegExp(pattern);
+  m_proxyModel->setSearchPattern(pattern);
 
   if (selectionModel()->selectedRows().size() == 0) {
     emit currentMessageRemoved();
@@ -549,6 +597,7 @@ void MessagesView::adjustColumns() {
     hideColumn(MSG_DB_ACCOUNT_ID_INDEX);
     hideColumn(MSG_DB_CUSTOM_ID_INDEX);
     hideColumn(MSG_DB_CUSTOM_HASH_INDEX);
+    hideColumn(MSG_DB_PARTIAL_INDEX);
 
     qDebug("Adjusting column resize modes for MessagesView.");
   }
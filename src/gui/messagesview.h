@@ -27,6 +27,7 @@
 
 
 class MessagesProxyModel;
+class QTimer;
 
 class MessagesView : public QTreeView {
     Q_OBJECT
@@ -54,6 +55,10 @@ class MessagesView : public QTreeView {
     // "current" index is not marked as read.
     void reloadSelections(bool mark_current_index_read);
 
+    // Applies changes of individual messages without reloading
+    // whole list, falls back to reloading if that is not possible.
+    void applyMessagesChanges(const MessagesChanges &changes);
+
     // Loads un-deleted messages from selected feeds.
     void loadItem(RootItem *item);
 
@@ -88,6 +93,9 @@ class MessagesView : public QTreeView {
     // Saves current sort state.
     void onSortIndicatorChanged(int column, Qt::SortOrder order);
 
+    // Hints message following current message to viewer.
+    void hintNextMessage();
+
   signals:
     // Link/message openers.
     void openLinkNewTab(const QString &link);
@@ -98,6 +106,9 @@ class MessagesView : public QTreeView {
     void currentMessageChanged(const Message &message, RootItem *root);
     void currentMessageRemoved();
 
+    // Message which will be likely displayed next.
+    void nextMessageHinted(const Message &message, RootItem *root);
+
   private:
     // Creates needed connections.
     void createConnections();
@@ -121,6 +132,12 @@ class MessagesView : public QTreeView {
 
     bool m_columnsAdjusted;
     bool m_batchUnreadSwitch;
+
+    // ID of displayed message, whose contents are being downloaded.
+    int m_pendingContentsId;
+
+    // Postpones hinting of next message until user stops moving through messages.
+    QTimer *m_nextMessageHintTimer;
 };
 
 #endif // MESSAGESVIEW_H
@@ -22,44 +22,114 @@
 #include "miscellaneous/application.h"
 
 #include <QScrollBar>
+#include <QWheelEvent>
 
 
-NewspaperPreviewer::NewspaperPreviewer(RootItem *root, QList<Message> messages, QWidget *parent)
-  : TabContent(parent), m_ui(new Ui::NewspaperPreviewer), m_root(root), m_messages(messages) {
-  m_ui->setupUi(this); 
-  connect(m_ui->m_btnShowMoreMessages, SIGNAL(clicked(bool)), this, SLOT(showMoreMessages()));
-  showMoreMessages();
+NewspaperPreviewer::NewspaperPreviewer(RootItem *root, const QString &filter, QWidget *parent)
+  : TabContent(parent), m_ui(new Ui::NewspaperPreviewer), m_root(root), m_pager(filter),
+    m_renderers(QList<MessagePreviewer*>()), m_renderedPositions(QList<int>()) {
+  m_ui->setupUi(this);
+  m_ui->m_viewport->installEventFilter(this);
+
+  connect(m_ui->m_scrollBar, SIGNAL(valueChanged(int)), this, SLOT(updateRenderers()));
+
+  if (!m_pager.reload(qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings))) {
+    qWarning("Messages for newspaper view were not loaded.");
+  }
+
+  updateScrollBar();
 }
 
 NewspaperPreviewer::~NewspaperPreviewer() {
 }
 
-void NewspaperPreviewer::showMoreMessages() {
-  if (!m_root.isNull()) {
-    int current_scroll = m_ui->scrollArea->verticalScrollBar()->value();
+bool NewspaperPreviewer::eventFilter(QObject *watched, QEvent *event) {
+  if (watched == m_ui->m_viewport) {
+    switch (event->type()) {
+      case QEvent::Resize:
+        updateScrollBar();
+        updateRenderers();
+        break;
 
-    for (int i = 0; i < 10 && !m_messages.isEmpty(); i++) {
-      Message msg = m_messages.takeFirst();
-      MessagePreviewer *prev = new MessagePreviewer(this);
-      QMargins margins = prev->layout()->contentsMargins();
+      case QEvent::Wheel:
+        // Viewport itself does not scroll, let the scrollbar handle it.
+        QCoreApplication::sendEvent(m_ui->m_scrollBar, event);
+        return true;
 
-      connect(prev, SIGNAL(requestMessageListReload(bool)), this, SIGNAL(requestMessageListReload(bool)));
-
-      margins.setRight(0);
-      prev->layout()->setContentsMargins(margins);
-      prev->setFixedHeight(300);
-      prev->loadMessage(msg, m_root);
-      m_ui->m_layout->insertWidget(m_ui->m_layout->count() - 2, prev);
+      default:
+        break;
     }
+  }
+
+  return TabContent::eventFilter(watched, event);
+}
+
+void NewspaperPreviewer::updateScrollBar() {
+  const int viewport_height = m_ui->m_viewport->height();
+
+  m_ui->m_scrollBar->setRange(0, qMax(0, m_pager.count() * NEWSPAPER_ROW_HEIGHT - viewport_height));
+  m_ui->m_scrollBar->setPageStep(viewport_height);
+  m_ui->m_scrollBar->setSingleStep(NEWSPAPER_ROW_HEIGHT / 10);
+}
+
+MessagePreviewer *NewspaperPreviewer::createRenderer() {
+  MessagePreviewer *prev = new MessagePreviewer(m_ui->m_viewport);
+  QMargins margins = prev->layout()->contentsMargins();
+
+  connect(prev, SIGNAL(requestMessageListReload(bool)), this, SIGNAL(requestMessageListReload(bool)));
+
+  margins.setRight(0);
+  prev->layout()->setContentsMargins(margins);
+
+  m_renderers.append(prev);
+  m_renderedPositions.append(-1);
 
-    m_ui->m_btnShowMoreMessages->setText(tr("Show more messages (%n remaining)", "", m_messages.size()));
-    m_ui->m_btnShowMoreMessages->setEnabled(!m_messages.isEmpty());
-    m_ui->scrollArea->verticalScrollBar()->setValue(current_scroll);
+  return prev;
+}
+
+void NewspaperPreviewer::updateRenderers() {
+  if (m_root.isNull()) {
+    // This is called on every scroll, so user is not notified here.
+    qWarning("Cannot show more messages because parent feed was removed.");
+    return;
   }
-  else {
-    qApp->showGuiMessage(tr("Cannot show more messages"),
-                         tr("Cannot show more messages because parent feed was removed."),
-                         QSystemTrayIcon::Warning,
-                         qApp->mainForm(), true);
+
+  const int scroll_value = m_ui->m_scrollBar->value();
+  const int first_position = scroll_value / NEWSPAPER_ROW_HEIGHT;
+  const int offset = scroll_value % NEWSPAPER_ROW_HEIGHT;
+  const int last_position = qMin(m_pager.count(),
+                                 first_position + (m_ui->m_viewport->height() + offset) / NEWSPAPER_ROW_HEIGHT + 1);
+
+  // Release renderers which display messages, which are not visible anymore.
+  for (int i = 0; i < m_renderers.size(); i++) {
+    if (m_renderedPositions.at(i) < first_position || m_renderedPositions.at(i) >= last_position) {
+      m_renderedPositions[i] = -1;
+      m_renderers.at(i)->hide();
+    }
+  }
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+
+  for (int position = first_position; position < last_position; position++) {
+    int renderer_index = m_renderedPositions.indexOf(position);
+
+    if (renderer_index < 0) {
+      // Message is not rendered yet, recycle some free renderer or create new one.
+      renderer_index = m_renderedPositions.indexOf(-1);
+
+      if (renderer_index < 0) {
+        createRenderer();
+        renderer_index = m_renderers.size() - 1;
+      }
+
+      m_renderedPositions[renderer_index] = position;
+      m_renderers.at(renderer_index)->loadMessage(m_pager.messageAt(database, position), m_root);
+    }
+
+    MessagePreviewer *prev = m_renderers.at(renderer_index);
+
+    prev->setGeometry(0, (position - first_position) * NEWSPAPER_ROW_HEIGHT - offset,
+                      m_ui->m_viewport->width(), NEWSPAPER_ROW_HEIGHT);
+    prev->show();
   }
 }
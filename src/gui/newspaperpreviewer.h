@@ -25,6 +25,7 @@
 #include "ui_newspaperpreviewer.h"
 
 #include "core/message.h"
+#include "core/messagespager.h"
 #include "services/abstract/rootitem.h"
 
 #include <QPointer>
@@ -35,24 +36,42 @@ namespace Ui {
 }
 
 class RootItem;
+class MessagePreviewer;
 
+// Displays messages which match given filter in "newspaper" layout.
+//
+// Only renderers of currently visible messages are instantiated,
+// they are recycled as user scrolls and messages themselves
+// are streamed from DB in pages. Thus memory usage does not depend on
+// number of displayed messages.
 class NewspaperPreviewer : public TabContent {
     Q_OBJECT
 
   public:
-    explicit NewspaperPreviewer(RootItem *root, QList<Message> messages, QWidget *parent = 0);
+    explicit NewspaperPreviewer(RootItem *root, const QString &filter, QWidget *parent = 0);
     virtual ~NewspaperPreviewer();
 
+  protected:
+    bool eventFilter(QObject *watched, QEvent *event);
+
   private slots:
-    void showMoreMessages();
+    void updateRenderers();
 
   signals:
     void requestMessageListReload(bool mark_current_as_read);
 
   private:
+    void updateScrollBar();
+    MessagePreviewer *createRenderer();
+
     QScopedPointer<Ui::NewspaperPreviewer> m_ui;
     QPointer<RootItem> m_root;
-    QList<Message> m_messages;
+    MessagesPager m_pager;
+
+    // Pool of renderers and positions of messages they
+    // currently display, -1 if renderer is not used.
+    QList<MessagePreviewer*> m_renderers;
+    QList<int> m_renderedPositions;
 };
 
 #endif // NEWSPAPERPREVIEWER_H
@@ -19,6 +19,7 @@
 
 #include "miscellaneous/systemfactory.h"
 #include "miscellaneous/application.h"
+#include "miscellaneous/debugging.h"
 
 
 SettingsGeneral::SettingsGeneral(Settings *settings, QWidget *parent)
@@ -29,6 +30,17 @@ SettingsGeneral::SettingsGeneral(Settings *settings, QWidget *parent)
   connect(m_ui->m_checkAutostart, &QCheckBox::stateChanged, this, &SettingsGeneral::dirtifySettings);
   connect(m_ui->m_checkForUpdatesOnStart, &QCheckBox::stateChanged, this, &SettingsGeneral::dirtifySettings);
   connect(m_ui->m_checkRemoveTrolltechJunk, &QCheckBox::stateChanged, this, &SettingsGeneral::dirtifySettings);
+
+  m_loggingCategories.insert(m_ui->m_checkLogNetwork, QL1S(LOGNETWORK().categoryName()));
+  m_loggingCategories.insert(m_ui->m_checkLogParser, QL1S(LOGPARSER().categoryName()));
+  m_loggingCategories.insert(m_ui->m_checkLogDb, QL1S(LOGDB().categoryName()));
+  m_loggingCategories.insert(m_ui->m_checkLogModel, QL1S(LOGMODEL().categoryName()));
+  m_loggingCategories.insert(m_ui->m_checkLogGui, QL1S(LOGGUI().categoryName()));
+
+  foreach (QCheckBox *check_category, m_loggingCategories.keys()) {
+    check_category->setToolTip(m_loggingCategories.value(check_category));
+    connect(check_category, &QCheckBox::stateChanged, this, &SettingsGeneral::dirtifySettings);
+  }
 }
 
 SettingsGeneral::~SettingsGeneral() {
@@ -65,6 +77,13 @@ void SettingsGeneral::loadSettings() {
   m_ui->m_checkRemoveTrolltechJunk->setVisible(false);
 #endif
 
+  const QString enabled_setting = settings()->value(GROUP(General), SETTING(General::LoggingCategories)).toString();
+  const QStringList enabled_categories = enabled_setting.split(QL1C(','), QString::SkipEmptyParts);
+
+  foreach (QCheckBox *check_category, m_loggingCategories.keys()) {
+    check_category->setChecked(enabled_categories.contains(m_loggingCategories.value(check_category)));
+  }
+
   onEndLoadSettings();
 }
 
@@ -82,5 +101,17 @@ void SettingsGeneral::saveSettings() {
   settings()->setValue(GROUP(General), General::UpdateOnStartup, m_ui->m_checkForUpdatesOnStart->isChecked());
   settings()->setValue(GROUP(General), General::RemoveTrolltechJunk, m_ui->m_checkRemoveTrolltechJunk->isChecked());
 
+  QStringList enabled_categories;
+
+  foreach (QCheckBox *check_category, m_loggingCategories.keys()) {
+    if (check_category->isChecked()) {
+      enabled_categories.append(m_loggingCategories.value(check_category));
+    }
+  }
+
+  // Debug output is switched immediately, no restart is needed.
+  settings()->setValue(GROUP(General), General::LoggingCategories, enabled_categories.join(QL1C(',')));
+  Debugging::applyLoggingCategories();
+
   onEndSaveSettings();
 }
@@ -22,6 +22,8 @@
 
 #include "ui_settingsgeneral.h"
 
+#include <QHash>
+
 
 class SettingsGeneral : public SettingsPanel {
     Q_OBJECT
@@ -39,6 +41,9 @@ class SettingsGeneral : public SettingsPanel {
 
   private:
     Ui::SettingsGeneral *m_ui;
+
+    // Names of logging categories toggled by individual check boxes.
+    QHash<QCheckBox*,QString> m_loggingCategories;
 };
 
 #endif // SETTINGSGENERAL_H
@@ -146,8 +146,8 @@ void TabWidget::createConnections() {
 
   connect(feedMessageViewer()->messagesView(), SIGNAL(openMessagesInNewspaperView(RootItem*,QList<Message>)),
           this, SLOT(addNewspaperView(RootItem*,QList<Message>)));
-  connect(feedMessageViewer()->feedsView(), SIGNAL(openMessagesInNewspaperView(RootItem*,QList<Message>)),
-          this, SLOT(addNewspaperView(RootItem*,QList<Message>)));
+  connect(feedMessageViewer()->feedsView(), SIGNAL(openFilterInNewspaperView(RootItem*,QString)),
+          this, SLOT(addNewspaperView(RootItem*,QString)));
 }
 
 void TabWidget::initializeTabs() {
@@ -207,10 +207,20 @@ void TabWidget::closeAllTabs() {
 }
 
 int TabWidget::addNewspaperView(RootItem *root, const QList<Message> &messages) {
+  if (messages.isEmpty()) {
+    return -1;
+  }
+
 #if defined(USE_WEBENGINE)
   WebBrowser *prev = new WebBrowser(this);
 #else
-  NewspaperPreviewer *prev = new NewspaperPreviewer(root, messages, this);
+  QStringList ids;
+
+  foreach (const Message &message, messages) {
+    ids.append(QString::number(message.m_id));
+  }
+
+  NewspaperPreviewer *prev = new NewspaperPreviewer(root, QString("id IN (%1)").arg(ids.join(QSL(", "))), this);
 #endif
 
   int index = addTab(prev, qApp->icons()->fromTheme(QSL("format-justify-fill")), tr("Newspaper view"), TabBar::Closable);
@@ -224,6 +234,26 @@ int TabWidget::addNewspaperView(RootItem *root, const QList<Message> &messages)
   return index;
 }
 
+int TabWidget::addNewspaperView(RootItem *root, const QString &filter) {
+#if defined(USE_WEBENGINE)
+  // Web-based viewer renders single document, further
+  // pages of messages are appended to it as user scrolls.
+  WebBrowser *prev = new WebBrowser(this);
+#else
+  NewspaperPreviewer *prev = new NewspaperPreviewer(root, filter, this);
+#endif
+
+  int index = addTab(prev, qApp->icons()->fromTheme(QSL("format-justify-fill")), tr("Newspaper view"), TabBar::Closable);
+
+  setCurrentIndex(index);
+
+#if defined(USE_WEBENGINE)
+  prev->loadFilteredMessages(filter, root);
+#endif
+
+  return index;
+}
+
 int TabWidget::addEmptyBrowser() {
   return addBrowser(false, true);
 }
@@ -112,6 +112,9 @@ class TabWidget : public QTabWidget {
 
     int addNewspaperView(RootItem *root, const QList<Message> &messages);
 
+    // Opens newspaper view with all messages matching given filter.
+    int addNewspaperView(RootItem *root, const QString &filter);
+
     // Adds new WebBrowser tab to global TabWidget.
     int addEmptyBrowser();
 
@@ -36,6 +36,7 @@
 
 void WebBrowser::createConnections() {
   connect(m_webView, &WebViewer::messageStatusChangeRequested, this, &WebBrowser::receiveMessageStatusChangeRequest);
+  connect(m_webView, &WebViewer::moreMessagesRequested, this, &WebBrowser::loadMoreMessages);
 
   connect(m_txtLocation, &LocationLineEdit::submitted,
           this, static_cast<void (WebBrowser::*)(const QString&)>(&WebBrowser::loadUrl));
@@ -76,7 +77,8 @@ WebBrowser::WebBrowser(QWidget *parent) : TabContent(parent),
   m_actionBack(m_webView->pageAction(QWebEnginePage::Back)),
   m_actionForward(m_webView->pageAction(QWebEnginePage::Forward)),
   m_actionReload(m_webView->pageAction(QWebEnginePage::Reload)),
-  m_actionStop(m_webView->pageAction(QWebEnginePage::Stop)) {
+  m_actionStop(m_webView->pageAction(QWebEnginePage::Stop)),
+  m_pageSizes(QList<int>()), m_loadedMessages(0) {
 
   // Initialize the components and layout.
   initializeLayout();
@@ -118,6 +120,9 @@ void WebBrowser::resetZoom() {
 void WebBrowser::clear() {
   m_webView->clear();
   m_messages.clear();
+  m_pager.reset();
+  m_pageSizes.clear();
+  m_loadedMessages = 0;
   hide();
 }
 
@@ -126,6 +131,10 @@ void WebBrowser::loadUrl(const QString &url) {
 }
 
 void WebBrowser::loadMessages(const QList<Message> &messages, RootItem *root) {
+  m_pager.reset();
+  m_pageSizes.clear();
+  m_loadedMessages = 0;
+
   if (m_messages.size() == messages.size()) {
     for (int i = 0; i < messages.size(); i++) {
       if (m_messages.at(i).m_id != messages.at(i).m_id) {
@@ -152,6 +161,53 @@ void WebBrowser::loadMessage(const Message &message, RootItem *root) {
   loadMessages(QList<Message>() << message, root);
 }
 
+void WebBrowser::loadFilteredMessages(const QString &filter, RootItem *root) {
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+
+  m_pager.reset(new MessagesPager(filter));
+  m_root = root;
+
+  if (!m_pager->reload(database)) {
+    qWarning("Messages for newspaper view were not loaded.");
+  }
+
+  m_messages = m_pager->messages(database, 0, NEWSPAPER_PAGE_SIZE);
+  m_pageSizes = QList<int>() << m_messages.size();
+  m_loadedMessages = m_messages.size();
+
+  if (!m_root.isNull()) {
+    m_webView->loadMessages(m_messages, m_loadedMessages < m_pager->count());
+    show();
+  }
+}
+
+void WebBrowser::loadMoreMessages() {
+  if (m_pager.isNull() || m_root.isNull() || m_loadedMessages >= m_pager->count()) {
+    return;
+  }
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  const QList<Message> messages = m_pager->messages(database, m_loadedMessages, NEWSPAPER_PAGE_SIZE);
+  const bool evict_first_page = m_pageSizes.size() >= NEWSPAPER_MAX_PAGES;
+
+  if (evict_first_page) {
+    // Messages scrolled far away are dropped, so that memory
+    // and DOM of the view do not grow without limit.
+    m_messages.erase(m_messages.begin(), m_messages.begin() + m_pageSizes.takeFirst());
+  }
+
+  m_messages.append(messages);
+  m_pageSizes.append(messages.size());
+  m_loadedMessages += messages.size();
+  m_webView->appendMessages(messages, !messages.isEmpty() && m_loadedMessages < m_pager->count(), evict_first_page);
+}
+
+void WebBrowser::prerenderMessage(const Message &message, RootItem *root) {
+  if (root != nullptr && root == m_root) {
+    m_webView->prerenderMessage(message);
+  }
+}
+
 void WebBrowser::receiveMessageStatusChangeRequest(int message_id, WebPage::MessageStatusChange change) {
   switch (change) {
     case WebPage::MarkRead:
@@ -21,10 +21,12 @@
 #include "gui/tabcontent.h"
 
 #include "core/message.h"
+#include "core/messagespager.h"
 #include "network-web/webpage.h"
 #include "services/abstract/rootitem.h"
 
 #include <QPointer>
+#include <QScopedPointer>
 #include <QToolBar>
 
 
@@ -67,6 +69,11 @@ class WebBrowser : public TabContent {
     void loadMessages(const QList<Message> &messages, RootItem *root);
     void loadMessage(const Message &message, RootItem *root);
 
+    // Displays messages which match given filter, messages
+    // are loaded from DB in pages as user scrolls down.
+    void loadFilteredMessages(const QString &filter, RootItem *root);
+    void prerenderMessage(const Message &message, RootItem *root);
+
     // Switches visibility of navigation bar.
     inline void setNavigationBarVisible(bool visible) {
       m_toolBar->setVisible(visible);
@@ -80,6 +87,7 @@ class WebBrowser : public TabContent {
     void onLoadingFinished(bool success);
 
     void receiveMessageStatusChangeRequest(int message_id, WebPage::MessageStatusChange change);
+    void loadMoreMessages();
 
     void onTitleChanged(const QString &new_title);
 
@@ -117,6 +125,13 @@ class WebBrowser : public TabContent {
 
     QList<Message> m_messages;
     QPointer<RootItem> m_root;
+
+    // Pager of filtered messages, null if fixed list of messages is displayed.
+    // Only last NEWSPAPER_MAX_PAGES pages are kept, sizes of kept pages
+    // are stored so that oldest page can be evicted.
+    QScopedPointer<MessagesPager> m_pager;
+    QList<int> m_pageSizes;
+    int m_loadedMessages;
 };
 
 #endif // WEBBROWSER_H
@@ -19,6 +19,7 @@
 
 #include "miscellaneous/skinfactory.h"
 #include "miscellaneous/application.h"
+#include "miscellaneous/tracer.h"
 #include "definitions/definitions.h"
 #include "network-web/webpage.h"
 #include "gui/dialogs/formmain.h"
@@ -26,12 +27,86 @@
 #include "gui/webbrowser.h"
 
 #include <QWheelEvent>
+#include <QJsonDocument>
 
 
-WebViewer::WebViewer(QWidget *parent) : QWebEngineView(parent) {
+// Each loaded page of messages is wrapped, so that whole pages can be removed.
+#define WEBVIEWER_PAGE_MARKUP "<div class=\"rssguard-page\">%1</div>"
+
+// Skin layout is loaded only once, messages are then swapped through this bridge.
+// Prerendered messages are laid out in hidden container, displaying them
+// means just swapping both containers. When more messages are available,
+// they are requested once user scrolls near the end of the page.
+#define WEBVIEWER_BRIDGE_MARKUP \
+  "<div id=\"rssguard-article\">%1</div>" \
+  "<div id=\"rssguard-prerender\" style=\"position: absolute; left: -10000px; top: 0; width: 100%; visibility: hidden;\"></div>" \
+  "<p id=\"rssguard-more\" style=\"text-align: center; display: none;\">" \
+  "<a href=\"#\" onclick=\"rssguard.requestMore(); return false;\">%2</a></p>" \
+  "<script>" \
+  "var rssguard = {" \
+  "  hasMore: false," \
+  "  loading: false," \
+  "  show: function(html, title, has_more) {" \
+  "    document.getElementById('rssguard-article').innerHTML = html;" \
+  "    document.title = title;" \
+  "    rssguard.setHasMore(!!has_more);" \
+  "    window.scrollTo(0, 0);" \
+  "  }," \
+  "  append: function(html, has_more, evict_first_page) {" \
+  "    var article = document.getElementById('rssguard-article');" \
+  "    article.insertAdjacentHTML('beforeend', html);" \
+  "    if (evict_first_page && article.firstElementChild) {" \
+  "      var height = article.firstElementChild.offsetHeight;" \
+  "      article.removeChild(article.firstElementChild);" \
+  "      window.scrollBy(0, -height);" \
+  "    }" \
+  "    rssguard.setHasMore(has_more);" \
+  "  }," \
+  "  setHasMore: function(has_more) {" \
+  "    rssguard.hasMore = has_more;" \
+  "    rssguard.loading = false;" \
+  "    document.getElementById('rssguard-more').style.display = has_more ? 'block' : 'none';" \
+  "  }," \
+  "  requestMore: function() {" \
+  "    if (rssguard.hasMore && !rssguard.loading) {" \
+  "      rssguard.loading = true;" \
+  "      alert('0-more');" \
+  "    }" \
+  "  }," \
+  "  prerender: function(html) {" \
+  "    document.getElementById('rssguard-prerender').innerHTML = html;" \
+  "  }," \
+  "  showPrerendered: function(title) {" \
+  "    var article = document.getElementById('rssguard-article');" \
+  "    var prerender = document.getElementById('rssguard-prerender');" \
+  "    prerender.id = 'rssguard-article';" \
+  "    prerender.removeAttribute('style');" \
+  "    article.id = 'rssguard-prerender';" \
+  "    article.setAttribute('style', 'position: absolute; left: -10000px; top: 0; width: 100%; visibility: hidden;');" \
+  "    article.innerHTML = '';" \
+  "    article.parentNode.appendChild(article);" \
+  "    document.title = title;" \
+  "    rssguard.setHasMore(false);" \
+  "    window.scrollTo(0, 0);" \
+  "  }" \
+  "};" \
+  "window.addEventListener('scroll', function() {" \
+  "  if (window.innerHeight + window.pageYOffset >= document.body.scrollHeight - window.innerHeight / 2) {" \
+  "    rssguard.requestMore();" \
+  "  }" \
+  "});" \
+  "rssguard.setHasMore(%3);" \
+  "</script>"
+
+
+WebViewer::WebViewer(QWidget *parent) : QWebEngineView(parent), m_messagesPages(QStringList()), m_messagesTitle(QString()),
+  m_hasMoreMessages(false), m_layoutLoaded(false), m_prerenderedHtml(QString()) {
   WebPage *page = new WebPage(this);
 
   connect(page, &WebPage::messageStatusChangeRequested, this, &WebViewer::messageStatusChangeRequested);
+  connect(page, &WebPage::moreMessagesRequested, this, &WebViewer::moreMessagesRequested);
+  connect(this, &WebViewer::loadStarted, this, &WebViewer::onLoadingStarted);
+  connect(this, &WebViewer::loadFinished, this, &WebViewer::onLoadingFinished);
   setPage(page);
 }
 
@@ -43,8 +118,19 @@ bool WebViewer::canDecreaseZoom() {
   return zoomFactor() >= MIN_ZOOM_FACTOR + ZOOM_FACTOR_STEP;
 }
 
+QString WebViewer::messageContents() const {
+  return qApp->skins()->currentSkin().m_layoutMarkupWrapper.arg(m_messagesTitle,
+                                                                QString(WEBVIEWER_BRIDGE_MARKUP).arg(m_messagesPages.join(QString()),
+                                                                                                     tr("Load more messages"),
+                                                                                                     m_hasMoreMessages ?
+                                                                                                       QSL("true") :
+                                                                                                       QSL("false")));
+}
+
 void WebViewer::displayMessage() {
-  setHtml(m_messageContents, QUrl::fromUserInput(INTERNAL_URL_MESSAGE));
+  m_layoutLoaded = false;
+  m_prerenderedHtml.clear();
+  setHtml(messageContents(), QUrl::fromUserInput(INTERNAL_URL_MESSAGE));
 }
 
 bool WebViewer::increaseWebPageZoom() {
@@ -79,7 +165,7 @@ bool WebViewer::resetWebPageZoom() {
   }
 }
 
-void WebViewer::loadMessages(const QList<Message> &messages) {
+QString WebViewer::messagesHtml(const QList<Message> &messages) const {
   Skin skin = qApp->skins()->currentSkin();
   QString messages_layout;
   QString single_message_layout = skin.m_layoutMarkup;
@@ -115,13 +201,96 @@ void WebViewer::loadMessages(const QList<Message> &messages) {
                            .arg(enclosure_images));
   }
 
-  m_messageContents = skin.m_layoutMarkupWrapper.arg(messages.size() == 1 ? messages.at(0).m_title : tr("Newspaper view"),
-                                                     messages_layout);
-  bool previously_enabled = isEnabled();
+  return messages_layout;
+}
 
-  setEnabled(false);
-  displayMessage();
-  setEnabled(previously_enabled);
+QString WebViewer::bridgeCall(const QString &function, const QJsonArray &arguments) const {
+  // Arguments are passed as JSON array, which is valid JavaScript literal,
+  // so we do not need to escape message contents ourselves.
+  return QString("rssguard.%1.apply(null, %2);").arg(function,
+                                                     QString::fromUtf8(QJsonDocument(arguments).toJson(QJsonDocument::Compact)));
+}
+
+bool WebViewer::containsScripts(const QString &html) const {
+  return html.contains(QL1S("<script"), Qt::CaseInsensitive);
+}
+
+void WebViewer::loadMessages(const QList<Message> &messages, bool has_more) {
+  TraceSpan span("gui", "WebViewer::loadMessages");
+  span.setArgument("messages", messages.size());
+
+  const QString html = messagesHtml(messages);
+
+  m_messagesPages = QStringList() << QString(WEBVIEWER_PAGE_MARKUP).arg(html);
+  m_messagesTitle = messages.size() == 1 ? messages.at(0).m_title : tr("Newspaper view");
+  m_hasMoreMessages = has_more;
+
+  if (m_layoutLoaded && !containsScripts(html)) {
+    // Layout is already there, just swap displayed messages.
+    if (!m_prerenderedHtml.isEmpty() && m_prerenderedHtml == html) {
+      page()->runJavaScript(bridgeCall(QSL("showPrerendered"), QJsonArray() << m_messagesTitle));
+    }
+    else {
+      page()->runJavaScript(bridgeCall(QSL("show"), QJsonArray() << m_messagesPages.first() << m_messagesTitle << has_more));
+    }
+
+    m_prerenderedHtml.clear();
+  }
+  else {
+    bool previously_enabled = isEnabled();
+
+    setEnabled(false);
+    displayMessage();
+    setEnabled(previously_enabled);
+  }
+}
+
+void WebViewer::appendMessages(const QList<Message> &messages, bool has_more, bool evict_first_page) {
+  TraceSpan span("gui", "WebViewer::appendMessages");
+  span.setArgument("messages", messages.size());
+
+  const QString html = QString(WEBVIEWER_PAGE_MARKUP).arg(messagesHtml(messages));
+
+  if (evict_first_page && !m_messagesPages.isEmpty()) {
+    m_messagesPages.removeFirst();
+  }
+
+  m_messagesPages.append(html);
+  m_hasMoreMessages = has_more;
+
+  if (m_layoutLoaded && !containsScripts(html)) {
+    page()->runJavaScript(bridgeCall(QSL("append"), QJsonArray() << html << has_more << evict_first_page));
+  }
+  else {
+    displayMessage();
+  }
+}
+
+void WebViewer::prerenderMessage(const Message &message) {
+  if (!m_layoutLoaded) {
+    // Nothing to prerender into, message will be loaded normally.
+    return;
+  }
+
+  const QString html = messagesHtml(QList<Message>() << message);
+
+  if (containsScripts(html)) {
+    return;
+  }
+  else if (html != m_prerenderedHtml) {
+    m_prerenderedHtml = html;
+    page()->runJavaScript(bridgeCall(QSL("prerender"), QJsonArray() << m_prerenderedHtml));
+  }
+}
+
+void WebViewer::onLoadingStarted() {
+  // Some other page (or new layout) is being loaded.
+  m_layoutLoaded = false;
+  m_prerenderedHtml.clear();
+}
+
+void WebViewer::onLoadingFinished(bool success) {
+  m_layoutLoaded = success && url().host() == INTERNAL_URL_MESSAGE_HOST;
 }
 
 void WebViewer::loadMessage(const Message &message) {
@@ -129,6 +298,16 @@ void WebViewer::loadMessage(const Message &message) {
 }
 
 void WebViewer::clear() {
+  m_messagesPages.clear();
+  m_messagesTitle.clear();
+  m_hasMoreMessages = false;
+
+  if (m_layoutLoaded) {
+    // Keep the layout loaded for next message.
+    page()->runJavaScript(bridgeCall(QSL("show"), QJsonArray() << QString() << QString()));
+    return;
+  }
+
   bool previously_enabled = isEnabled();
 
   setEnabled(false);
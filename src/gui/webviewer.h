@@ -19,6 +19,8 @@
 #define WEBVIEWER_H
 
 #include <QWebEngineView>
+#include <QJsonArray>
+#include <QStringList>
 
 #include "core/message.h"
 #include "network-web/webpage.h"
@@ -33,9 +35,8 @@ class WebViewer : public QWebEngineView {
     bool canIncreaseZoom();
     bool canDecreaseZoom();
 
-    inline QString messageContents() {
-      return m_messageContents;
-    }
+    // Returns complete HTML document with currently displayed messages.
+    QString messageContents() const;
 
   public slots:
     // Page zoom modifiers.
@@ -44,19 +45,49 @@ class WebViewer : public QWebEngineView {
     bool resetWebPageZoom();
 
     void displayMessage();
-    void loadMessages(const QList<Message> &messages);
+    void loadMessages(const QList<Message> &messages, bool has_more = false);
     void loadMessage(const Message &message);
     void clear();
 
+    // Appends messages after currently displayed messages as new page.
+    // NOTE: If "has_more" is true, then viewer emits moreMessagesRequested()
+    // once user scrolls to the end of displayed messages. First displayed
+    // page is removed if "evict_first_page" is true.
+    void appendMessages(const QList<Message> &messages, bool has_more, bool evict_first_page = false);
+
+    // Renders message off-screen, so that it can be
+    // displayed instantly if it is loaded next.
+    void prerenderMessage(const Message &message);
+
+  private slots:
+    void onLoadingStarted();
+    void onLoadingFinished(bool success);
+
   protected:
     QWebEngineView *createWindow(QWebEnginePage::WebWindowType type);
     void wheelEvent(QWheelEvent *event);
 
   signals:
     void messageStatusChangeRequested(int message_id, WebPage::MessageStatusChange change);
+    void moreMessagesRequested();
 
   private:
-    QString m_messageContents;
+    QString messagesHtml(const QList<Message> &messages) const;
+    QString bridgeCall(const QString &function, const QJsonArray &arguments) const;
+
+    // Scripts inserted via bridge are not executed, messages with
+    // scripts are thus always loaded together with the layout.
+    bool containsScripts(const QString &html) const;
+
+    // HTML of currently displayed pages of messages and their title.
+    QStringList m_messagesPages;
+    QString m_messagesTitle;
+    bool m_hasMoreMessages;
+
+    // True if skin layout with our JavaScript bridge is loaded,
+    // in that case messages are swapped in-place.
+    bool m_layoutLoaded;
+    QString m_prerenderedHtml;
 };
 
 #endif // WEBVIEWER_H
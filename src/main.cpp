@@ -17,10 +17,12 @@
 
 #include "definitions/definitions.h"
 #include "miscellaneous/application.h"
+#include "miscellaneous/benchmark.h"
 #include "miscellaneous/databasefactory.h"
 #include "miscellaneous/debugging.h"
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/feedreader.h"
+#include "miscellaneous/tracer.h"
 #include "dynamic-shortcuts/dynamicshortcuts.h"
 #include "gui/dialogs/formmain.h"
 #include "gui/feedmessageviewer.h"
@@ -41,16 +43,26 @@
 
 
 int main(int argc, char *argv[]) {
+  QString benchmark_feed_file;
+
   for (int i = 0; i < argc; i++) {
     const QString str = QString::fromLocal8Bit(argv[i]);
 
     if (str == "-h") {
       qDebug("Usage: rssguard [OPTIONS]\n\n"
              "Option\t\tMeaning\n"
-             "-h\t\tDisplays this help.");
+             "-h\t\tDisplays this help.\n"
+             "-t\t\tRecords trace of feed updates and GUI, trace is saved on exit.\n"
+             "-b FILE\t\tMeasures parsing and storing of messages of given feed file and quits.");
 
       return EXIT_SUCCESS;
     }
+    else if (str == "-t") {
+      Tracer::setEnabled(true);
+    }
+    else if (str == "-b" && i + 1 < argc) {
+      benchmark_feed_file = QString::fromLocal8Bit(argv[++i]);
+    }
   }
 
   //: Abbreviation of language, e.g. en.
@@ -70,12 +82,22 @@ int main(int argc, char *argv[]) {
   Application application(APP_LOW_NAME, argc, argv);
   qDebug("Instantiated Application class.");
 
+  if (!benchmark_feed_file.isEmpty()) {
+    return Benchmark::run(benchmark_feed_file);
+  }
+
   // Check if another instance is running.
   if (application.sendMessage((QStringList() << APP_IS_RUNNING << application.arguments().mid(1)).join(ARGUMENTS_LIST_SEPARATOR))) {
     qWarning("Another instance of the application is already running. Notifying it.");
     return EXIT_FAILURE;
   }
 
+  if (qApp->settings()->value(GROUP(General), SETTING(General::TraceHotPaths)).toBool()) {
+    Tracer::setEnabled(true);
+  }
+
+  Debugging::applyLoggingCategories();
+
   // Load localization and setup locale before any widget is constructed.
   qApp->localization()->loadActiveLanguage();
 
@@ -87,6 +109,7 @@ int main(int argc, char *argv[]) {
   // Register needed metatypes.
   qRegisterMetaType<QList<Message> >("QList<Message>");
   qRegisterMetaType<QList<RootItem*> >("QList<RootItem*>");
+  qRegisterMetaType<MessagesChanges>("MessagesChanges");
 
   // Just call this instance, so that is is created in main GUI thread.
   WebFactory::instance();
@@ -21,6 +21,9 @@
 #include "miscellaneous/iofactory.h"
 #include "miscellaneous/mutex.h"
 #include "miscellaneous/feedreader.h"
+#include "miscellaneous/databasebackuper.h"
+#include "miscellaneous/tracer.h"
+#include "network-web/faviconresolver.h"
 #include "gui/feedsview.h"
 #include "gui/feedmessageviewer.h"
 #include "gui/messagebox.h"
@@ -48,7 +51,8 @@ Application::Application(const QString &id, int &argc, char **argv)
     m_feedReader(nullptr),
     m_updateFeedsLock(nullptr), m_userActions(QList<QAction*>()), m_mainForm(nullptr),
     m_trayIcon(nullptr), m_settings(nullptr), m_system(nullptr), m_skins(nullptr),
-    m_localization(nullptr), m_icons(nullptr), m_database(nullptr), m_downloadManager(nullptr) {
+    m_localization(nullptr), m_icons(nullptr), m_database(nullptr), m_downloadManager(nullptr),
+    m_favicons(nullptr) {
   connect(this, SIGNAL(aboutToQuit()), this, SLOT(onAboutToQuit()));
   connect(this, SIGNAL(commitDataRequest(QSessionManager&)), this, SLOT(onCommitData(QSessionManager&)));
   connect(this, SIGNAL(saveStateRequest(QSessionManager&)), this, SLOT(onSaveState(QSessionManager&)));
@@ -156,6 +160,14 @@ DownloadManager *Application::downloadManager() {
   return m_downloadManager;
 }
 
+FaviconResolver *Application::favicons() {
+  if (m_favicons == nullptr) {
+    m_favicons = new FaviconResolver(this);
+  }
+
+  return m_favicons;
+}
+
 Settings *Application::settings() {
   if (m_settings == nullptr) {
     m_settings = Settings::setupSettings(this);
@@ -243,14 +255,22 @@ void Application::backupDatabaseSettings(bool backup_database, bool backup_setti
     }
   }
 
-  if (backup_database &&
-      (database()->activeDatabaseDriver() == DatabaseFactory::SQLITE ||
-       database()->activeDatabaseDriver() == DatabaseFactory::SQLITE_MEMORY)) {
-    // We need to save the database first.
-    database()->saveDatabase();
+  if (backup_database) {
+    const QString target_file_path = target_path + QDir::separator() + backup_name +
+                                     (database()->activeDatabaseDriver() == DatabaseFactory::MYSQL ?
+                                        BACKUP_SUFFIX_DUMP :
+                                        BACKUP_SUFFIX_DATABASE);
 
-    if (!IOFactory::copyFile(database()->sqliteDatabaseFilePath(), target_path + QDir::separator() + backup_name + BACKUP_SUFFIX_DATABASE)) {
-      throw ApplicationException(tr("Database file not copied to output directory successfully."));
+    if (database()->activeDatabaseDriver() == DatabaseFactory::SQLITE_MEMORY) {
+      // In-memory database is accessible only from main thread,
+      // we need to save it first, its file is backed up then.
+      database()->saveDatabase();
+    }
+
+    // Database is backed up in background, see DatabaseBackuper signals.
+    if (!feedReader()->databaseBackuper()->startBackup(target_file_path,
+                                                       target_path + QDir::separator() + backup_name + BACKUP_SUFFIX_ICONS)) {
+      throw ApplicationException(tr("Another database backup is running."));
     }
   }
 }
@@ -377,6 +397,10 @@ void Application::onAboutToQuit() {
   qApp->feedReader()->stop();
   database()->saveDatabase();
 
+  if (Tracer::isEnabled()) {
+    Tracer::save(Tracer::defaultFilePath());
+  }
+
   if (mainForm() != nullptr) {
     mainForm()->saveSize();
   }
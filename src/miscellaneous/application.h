@@ -43,6 +43,7 @@
 
 class FormMain;
 class IconFactory;
+class FaviconResolver;
 class QAction;
 class Mutex;
 class QWebEngineDownloadItem;
@@ -74,6 +75,7 @@ class Application : public QtSingleApplication {
     DatabaseFactory *database();
     IconFactory *icons();
     DownloadManager *downloadManager();
+    FaviconResolver *favicons();
     Settings *settings();
     Mutex *feedUpdateLock();
     FormMain *mainForm();
@@ -95,6 +97,8 @@ class Application : public QtSingleApplication {
 
     void setMainForm(FormMain *main_form);
 
+    // NOTE: Settings are backed up immediately, database
+    // is backed up in background by DatabaseBackuper.
     void backupDatabaseSettings(bool backup_database, bool backup_settings,
                                 const QString &target_path, const QString &backup_name);
     void restoreDatabaseSettings(bool restore_database, bool restore_settings,
@@ -163,6 +167,7 @@ class Application : public QtSingleApplication {
     IconFactory *m_icons;
     DatabaseFactory *m_database;
     DownloadManager *m_downloadManager;
+    FaviconResolver *m_favicons;
 };
 
 #endif // APPLICATION_H
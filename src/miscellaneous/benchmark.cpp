@@ -0,0 +1,175 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "miscellaneous/benchmark.h"
+
+#include "definitions/definitions.h"
+#include "core/parsingfactory.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/databasequeries.h"
+#include "miscellaneous/debugging.h"
+
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+
+#include <cstdio>
+#include <cstdlib>
+
+
+Benchmark::Benchmark() {
+}
+
+int Benchmark::run(const QString &feed_file_path) {
+  if (qApp->database()->activeDatabaseDriver() == DatabaseFactory::MYSQL) {
+    qCritical("Benchmark needs SQLite database, messages are not stored into MySQL server.");
+    return EXIT_FAILURE;
+  }
+
+  QFile feed_file(feed_file_path);
+
+  if (!feed_file.open(QIODevice::ReadOnly)) {
+    qCritical("Feed file '%s' cannot be opened.", qPrintable(feed_file_path));
+    return EXIT_FAILURE;
+  }
+
+  const QString feed_contents = QString::fromUtf8(feed_file.readAll());
+  QSqlDatabase database = qApp->database()->connection(QSL("Benchmark"), DatabaseFactory::StrictlyInMemory);
+  int result = EXIT_SUCCESS;
+
+  feed_file.close();
+  std::printf("Feed file '%s', %d rounds.\n", qPrintable(feed_file_path), BENCHMARK_ROUNDS);
+
+  foreach (bool logging_enabled, QList<bool>() << false << true) {
+    qint64 parsing_time;
+    qint64 storing_time;
+    int message_count;
+
+    setLoggingEnabled(logging_enabled);
+
+    if (!measure(database, feed_contents, &parsing_time, &storing_time, &message_count)) {
+      result = EXIT_FAILURE;
+      break;
+    }
+
+    const double processed_messages = double(message_count) * BENCHMARK_ROUNDS;
+
+    std::printf("Logging categories %s: %d messages, parsing %.2f us/message, storing %.2f us/message, %.0f messages/s in total.\n",
+                logging_enabled ? "enabled" : "disabled",
+                message_count,
+                parsing_time / processed_messages / 1000.0,
+                storing_time / processed_messages / 1000.0,
+                processed_messages * 1e9 / (parsing_time + storing_time));
+  }
+
+  removeMessages(database);
+  Debugging::applyLoggingCategories();
+  return result;
+}
+
+bool Benchmark::measure(QSqlDatabase database, const QString &feed_contents,
+                        qint64 *parsing_time, qint64 *storing_time, int *message_count) {
+  QElapsedTimer timer;
+
+  *parsing_time = 0;
+  *storing_time = 0;
+  *message_count = 0;
+
+  for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+    // Each round stores all messages as new ones.
+    if (!removeMessages(database)) {
+      return false;
+    }
+
+    timer.start();
+    const QList<Message> messages = parse(feed_contents);
+    *parsing_time += timer.nsecsElapsed();
+
+    if (messages.isEmpty()) {
+      qCritical("Feed file does not contain any messages or its format is not supported.");
+      return false;
+    }
+
+    bool any_message_changed;
+    bool ok;
+
+    timer.start();
+    DatabaseQueries::updateMessages(database, messages, BENCHMARK_FEED_ID, BENCHMARK_ACCOUNT_ID,
+                                    QString(), &any_message_changed, &ok);
+    *storing_time += timer.nsecsElapsed();
+
+    if (!ok) {
+      qCritical("Messages of the feed file could not be stored.");
+      return false;
+    }
+
+    *message_count = messages.size();
+  }
+
+  return true;
+}
+
+QList<Message> Benchmark::parse(const QString &feed_contents) {
+  // Format of the feed is decided by its root element, same way
+  // as when feed is being added.
+  QDomDocument xml_document;
+
+  xml_document.setContent(feed_contents);
+
+  const QString root_tag_name = xml_document.documentElement().tagName();
+
+  if (root_tag_name == QL1S("rdf:RDF")) {
+    return ParsingFactory::parseAsRDF(feed_contents);
+  }
+  else if (root_tag_name == QL1S("rss")) {
+    return ParsingFactory::parseAsRSS20(feed_contents);
+  }
+  else if (root_tag_name == QL1S("feed")) {
+    return ParsingFactory::parseAsATOM10(feed_contents);
+  }
+  else {
+    return QList<Message>();
+  }
+}
+
+bool Benchmark::removeMessages(QSqlDatabase database) {
+  QSqlQuery query(database);
+
+  query.prepare(QSL("DELETE FROM Messages WHERE account_id = :account_id;"));
+  query.bindValue(QSL(":account_id"), BENCHMARK_ACCOUNT_ID);
+
+  if (!query.exec()) {
+    qCritical("Benchmark messages could not be removed: '%s'.", qPrintable(query.lastError().text()));
+    return false;
+  }
+
+  return true;
+}
+
+void Benchmark::setLoggingEnabled(bool enabled) {
+  QStringList rules;
+
+  foreach (const QString &category, Debugging::loggingCategories()) {
+    rules.append(QString(QSL("%1.debug=%2")).arg(category, enabled ? QSL("true") : QSL("false")));
+  }
+
+  QLoggingCategory::setFilterRules(rules.join(QL1C('\n')));
+}
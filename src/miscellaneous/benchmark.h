@@ -0,0 +1,54 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "core/message.h"
+
+#include <QSqlDatabase>
+#include <QString>
+
+
+// Measures throughput of parsing of feed file by ParsingFactory and
+// of storing of its messages by DatabaseQueries::updateMessages(), once
+// with hot path logging categories disabled and once with them enabled.
+// Results are printed to standard output, so that debug output
+// can be discarded.
+//
+// NOTE: Messages are stored into in-memory SQLite database under account
+// which does not exist and they are removed afterwards.
+class Benchmark {
+  public:
+    // Runs the benchmark and returns exit code of the application.
+    static int run(const QString &feed_file_path);
+
+  private:
+    // Constructor.
+    explicit Benchmark();
+
+    // Parses and stores messages of the feed repeatedly, total elapsed
+    // nanoseconds of parsing and of storing are returned.
+    static bool measure(QSqlDatabase database, const QString &feed_contents,
+                        qint64 *parsing_time, qint64 *storing_time, int *message_count);
+
+    static QList<Message> parse(const QString &feed_contents);
+    static bool removeMessages(QSqlDatabase database);
+    static void setLoggingEnabled(bool enabled);
+};
+
+#endif // BENCHMARK_H
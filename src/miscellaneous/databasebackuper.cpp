@@ -0,0 +1,415 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "miscellaneous/databasebackuper.h"
+
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/iofactory.h"
+
+#include <QDebug>
+#include <QThread>
+#include <QFile>
+#include <QDir>
+#include <QTextStream>
+#include <QSqlDriver>
+#include <QSqlError>
+#include <QSqlField>
+#include <QSqlIndex>
+#include <QSqlQuery>
+#include <QSqlRecord>
+
+#if defined(USE_SQLITE_BACKUP)
+#include <sqlite3.h>
+#endif
+
+
+DatabaseBackuper::DatabaseBackuper(QObject *parent) : QObject(parent), m_running(0), m_stopRequested(0) {
+}
+
+DatabaseBackuper::~DatabaseBackuper() {
+  qDebug("Destroying DatabaseBackuper instance.");
+}
+
+bool DatabaseBackuper::isBackupRunning() const {
+  return m_running.load() != 0;
+}
+
+bool DatabaseBackuper::startBackup(const QString &target_file_path, const QString &target_icons_folder) {
+  // Flag is raised here, in caller thread, so that two
+  // backups cannot be started before first one begins.
+  if (!m_running.testAndSetOrdered(0, 1)) {
+    return false;
+  }
+
+  m_stopRequested.store(0);
+  QMetaObject::invokeMethod(this, "backupDatabase", Qt::QueuedConnection,
+                            Q_ARG(QString, target_file_path), Q_ARG(QString, target_icons_folder));
+  return true;
+}
+
+void DatabaseBackuper::stopRunningBackup() {
+  m_stopRequested.store(1);
+}
+
+void DatabaseBackuper::backupDatabase(const QString &target_file_path, const QString &target_icons_folder) {
+  qDebug().nospace() << "Performing database backup in thread: \'" << QThread::currentThreadId() << "\'.";
+
+  emit backupStarted();
+
+  QString error_message;
+  bool result;
+
+  if (qApp->database()->activeDatabaseDriver() == DatabaseFactory::MYSQL) {
+    result = mysqlBackup(target_file_path, &error_message);
+  }
+  else {
+    result = sqliteBackup(target_file_path, &error_message);
+  }
+
+  // Icons are referenced from database, so they are part of the backup.
+  result = result && backupIcons(target_icons_folder, &error_message);
+
+  if (result) {
+    qDebug("Database was backed up into '%s'.", qPrintable(target_file_path));
+  }
+  else {
+    qWarning("Database backup failed: '%s'.", qPrintable(error_message));
+  }
+
+  m_running.store(0);
+  emit backupFinished(result, error_message);
+}
+
+QSqlDatabase DatabaseBackuper::backupConnection() const {
+  // NOTE: In-memory database lives in main thread only, it is
+  // saved to its file before the backup is started.
+  return qApp->database()->connection(QSL("db_backup"), DatabaseFactory::StrictlyFileBased);
+}
+
+bool DatabaseBackuper::sqliteBackup(const QString &target_file_path, QString *error_message) {
+  QSqlDatabase database = backupConnection();
+  QSqlQuery query(database);
+
+  // Backup goes into temporary file, target file is replaced
+  // only when complete backup is done.
+  const QString temporary_file_path = target_file_path + QSL(".tmp");
+
+  QFile::remove(temporary_file_path);
+  emit backupProgress(0, tr("Backing up database..."));
+
+  if (sqliteOnlineBackupAvailable(database)) {
+    if (!sqliteOnlineBackup(database, temporary_file_path, error_message)) {
+      QFile::remove(temporary_file_path);
+      return false;
+    }
+
+    return replaceTargetFile(temporary_file_path, target_file_path, error_message);
+  }
+
+  // NOTE: "VACUUM INTO" reads database in single read transaction,
+  // so result is consistent even if feeds are updated meanwhile.
+  if (query.exec(QString(QSL("VACUUM INTO '%1';")).arg(QString(temporary_file_path).replace(QL1C('\''), QSL("''"))))) {
+    emit backupProgress(100, tr("Backing up database (%1 %)...").arg(100));
+    return replaceTargetFile(temporary_file_path, target_file_path, error_message);
+  }
+
+  // SQLite older than 3.27 does not know "VACUUM INTO".
+  qWarning("Database cannot be backed up via VACUUM INTO, copying its file instead: '%s'.", qPrintable(query.lastError().text()));
+  QFile::remove(temporary_file_path);
+
+  if (!sqliteCopyFile(database, temporary_file_path, error_message)) {
+    QFile::remove(temporary_file_path);
+    return false;
+  }
+
+  return replaceTargetFile(temporary_file_path, target_file_path, error_message);
+}
+
+bool DatabaseBackuper::sqliteOnlineBackupAvailable(QSqlDatabase database) const {
+#if defined(USE_SQLITE_BACKUP)
+  const QVariant handle = database.driver()->handle();
+  QSqlQuery query(database);
+
+  if (!handle.isValid() || qstrcmp(handle.typeName(), "sqlite3*") != 0) {
+    return false;
+  }
+
+  // Qt might use its bundled SQLite, its handle cannot be passed to another library.
+  if (!query.exec(QSL("SELECT sqlite_version();")) || !query.next() ||
+      query.value(0).toString() != QString::fromLatin1(sqlite3_libversion())) {
+    qWarning("Database driver does not use linked SQLite library, online backup cannot be used.");
+    return false;
+  }
+
+  return true;
+#else
+  Q_UNUSED(database)
+
+  return false;
+#endif
+}
+
+bool DatabaseBackuper::sqliteOnlineBackup(QSqlDatabase database, const QString &target_file_path, QString *error_message) {
+#if defined(USE_SQLITE_BACKUP)
+  sqlite3 *source = *static_cast<sqlite3* const*>(database.driver()->handle().data());
+  sqlite3 *target = nullptr;
+
+  if (sqlite3_open(QFile::encodeName(target_file_path).constData(), &target) != SQLITE_OK) {
+    *error_message = QString::fromUtf8(sqlite3_errmsg(target));
+    sqlite3_close(target);
+    return false;
+  }
+
+  sqlite3_backup *backup = sqlite3_backup_init(target, "main", source, "main");
+
+  if (backup == nullptr) {
+    *error_message = QString::fromUtf8(sqlite3_errmsg(target));
+    sqlite3_close(target);
+    return false;
+  }
+
+  int step_result;
+
+  do {
+    // NOTE: Source database is locked only during each step. If it is changed
+    // by other connection meanwhile, SQLite restarts the backup, so that result
+    // is always consistent.
+    step_result = sqlite3_backup_step(backup, BACKUP_PAGES_PER_STEP);
+
+    const int page_count = sqlite3_backup_pagecount(backup);
+
+    if (page_count > 0) {
+      const int progress = 100 * (page_count - sqlite3_backup_remaining(backup)) / page_count;
+      emit backupProgress(progress, tr("Backing up database (%1 %)...").arg(progress));
+    }
+
+    if (step_result == SQLITE_OK || step_result == SQLITE_BUSY || step_result == SQLITE_LOCKED) {
+      // Give other connections chance to work with database.
+      QThread::msleep(BACKUP_STEP_DELAY);
+    }
+  } while ((step_result == SQLITE_OK || step_result == SQLITE_BUSY || step_result == SQLITE_LOCKED) &&
+           m_stopRequested.load() == 0);
+
+  sqlite3_backup_finish(backup);
+
+  if (step_result != SQLITE_DONE) {
+    *error_message = m_stopRequested.load() != 0 ?
+                       tr("Backup was cancelled.") :
+                       QString::fromUtf8(sqlite3_errmsg(target));
+  }
+
+  sqlite3_close(target);
+  return step_result == SQLITE_DONE;
+#else
+  Q_UNUSED(database)
+  Q_UNUSED(target_file_path)
+
+  *error_message = tr("Online backup of SQLite database is not available.");
+  return false;
+#endif
+}
+
+bool DatabaseBackuper::sqliteCopyFile(QSqlDatabase database, const QString &target_file_path, QString *error_message) {
+  QSqlQuery query(database);
+
+  emit backupProgress(0, tr("Copying database file..."));
+
+  // Read transaction holds shared lock, so that nobody
+  // can write into database file while it is copied.
+  if (!database.transaction() || !query.exec(QSL("SELECT COUNT(*) FROM Information;"))) {
+    *error_message = database.lastError().isValid() ? database.lastError().text() : query.lastError().text();
+    database.rollback();
+    return false;
+  }
+
+  const bool copied = IOFactory::copyFile(database.databaseName(), target_file_path);
+
+  query.finish();
+  database.rollback();
+
+  if (!copied) {
+    *error_message = tr("Database file not copied to output directory successfully.");
+  }
+
+  return copied;
+}
+
+bool DatabaseBackuper::mysqlBackup(const QString &target_file_path, QString *error_message) {
+  QSqlDatabase database = backupConnection();
+  const QString temporary_file_path = target_file_path + QSL(".tmp");
+  QFile target_file(temporary_file_path);
+
+  if (!target_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+    *error_message = target_file.errorString();
+    return false;
+  }
+
+  QTextStream stream(&target_file);
+  QSqlQuery query(database);
+
+  stream.setCodec("UTF-8");
+  query.setForwardOnly(true);
+
+  // All batches are read from one snapshot, feeds can be updated meanwhile.
+  if (!query.exec(QSL("START TRANSACTION WITH CONSISTENT SNAPSHOT;"))) {
+    *error_message = query.lastError().text();
+    target_file.remove();
+    return false;
+  }
+
+  const QStringList tables = database.tables(QSql::Tables);
+
+  stream << QSL("SET FOREIGN_KEY_CHECKS = 0;\n\n");
+
+  for (int i = 0; i < tables.size() && m_stopRequested.load() == 0; i++) {
+    const QString &table = tables.at(i);
+
+    if (!query.exec(QString(QSL("SHOW CREATE TABLE %1;")).arg(table)) || !query.next()) {
+      *error_message = query.lastError().text();
+      database.rollback();
+      target_file.remove();
+      return false;
+    }
+
+    stream << QString(QSL("DROP TABLE IF EXISTS %1;\n%2;\n\n")).arg(table, query.value(1).toString());
+
+    // Rows are read in batches ordered by primary key, each batch continues
+    // after last key of previous one (keyset pagination), so that reading
+    // of each batch is cheap. Tables without primary key are read at once.
+    const QSqlIndex primary_index = database.primaryIndex(table);
+    QStringList key_columns;
+    QStringList key_placeholders;
+    QVariantList last_key;
+
+    for (int j = 0; j < primary_index.count(); j++) {
+      key_columns.append(primary_index.fieldName(j));
+      key_placeholders.append(QSL("?"));
+    }
+
+    forever {
+      if (m_stopRequested.load() != 0) {
+        break;
+      }
+
+      QString select = QString(QSL("SELECT * FROM %1")).arg(table);
+
+      if (!key_columns.isEmpty()) {
+        if (!last_key.isEmpty()) {
+          select += QString(QSL(" WHERE (%1) > (%2)")).arg(key_columns.join(QSL(", ")), key_placeholders.join(QSL(", ")));
+        }
+
+        select += QString(QSL(" ORDER BY %1 LIMIT %2")).arg(key_columns.join(QSL(", ")), QString::number(BACKUP_ROWS_PER_BATCH));
+      }
+
+      query.prepare(select);
+
+      foreach (const QVariant &key_value, last_key) {
+        query.addBindValue(key_value);
+      }
+
+      if (!query.exec()) {
+        *error_message = query.lastError().text();
+        database.rollback();
+        target_file.remove();
+        return false;
+      }
+
+      QStringList rows;
+
+      while (query.next()) {
+        const QSqlRecord record = query.record();
+        QStringList values;
+
+        for (int j = 0; j < record.count(); j++) {
+          values.append(database.driver()->formatValue(record.field(j)));
+        }
+
+        rows.append(QL1C('(') + values.join(QSL(", ")) + QL1C(')'));
+
+        if (!key_columns.isEmpty()) {
+          last_key.clear();
+
+          foreach (const QString &key_column, key_columns) {
+            last_key.append(record.value(key_column));
+          }
+        }
+      }
+
+      if (!rows.isEmpty()) {
+        stream << QString(QSL("INSERT INTO %1 VALUES\n%2;\n")).arg(table, rows.join(QSL(",\n")));
+      }
+
+      if (key_columns.isEmpty() || rows.size() < BACKUP_ROWS_PER_BATCH) {
+        break;
+      }
+    }
+
+    stream << QL1C('\n');
+
+    const int progress = 100 * (i + 1) / tables.size();
+    emit backupProgress(progress, tr("Backing up database (%1 %)...").arg(progress));
+  }
+
+  stream << QSL("SET FOREIGN_KEY_CHECKS = 1;\n");
+  database.rollback();
+  stream.flush();
+
+  if (m_stopRequested.load() != 0) {
+    *error_message = tr("Backup was cancelled.");
+    target_file.remove();
+    return false;
+  }
+  else if (stream.status() != QTextStream::Ok || target_file.error() != QFile::NoError) {
+    *error_message = target_file.errorString();
+    target_file.remove();
+    return false;
+  }
+
+  target_file.close();
+  return replaceTargetFile(temporary_file_path, target_file_path, error_message);
+}
+
+bool DatabaseBackuper::backupIcons(const QString &target_icons_folder, QString *error_message) {
+  const QString temporary_folder = target_icons_folder + QSL(".tmp");
+
+  emit backupProgress(100, tr("Backing up icons..."));
+  QDir(temporary_folder).removeRecursively();
+
+  // NOTE: Stored icons are never modified, they are only added
+  // or removed, so they can be copied while application runs.
+  if (!IOFactory::copyFolder(qApp->getUserDataPath() + QDir::separator() + APP_ICON_STORE_FOLDER, temporary_folder) ||
+      !QDir(target_icons_folder).removeRecursively() || !QDir().rename(temporary_folder, target_icons_folder)) {
+    *error_message = tr("Icons not copied to output directory successfully.");
+    QDir(temporary_folder).removeRecursively();
+    return false;
+  }
+
+  return true;
+}
+
+bool DatabaseBackuper::replaceTargetFile(const QString &temporary_file_path, const QString &target_file_path,
+                                         QString *error_message) {
+  if ((QFile::exists(target_file_path) && !QFile::remove(target_file_path)) ||
+      !QFile::rename(temporary_file_path, target_file_path)) {
+    *error_message = tr("Database file not copied to output directory successfully.");
+    QFile::remove(temporary_file_path);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,83 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef DATABASEBACKUPER_H
+#define DATABASEBACKUPER_H
+
+#include <QObject>
+
+#include <QAtomicInt>
+#include <QSqlDatabase>
+
+
+// Backs up active database while application keeps running.
+//
+// SQLite database is copied via online backup API of SQLite in small
+// steps, so that feeds can be updated meanwhile. If the API cannot be
+// used, it is written into new file via "VACUUM INTO", which reads
+// single consistent snapshot. MySQL database is dumped table by table in
+// batches from single consistent snapshot. Backups are written to
+// temporary file first, target file is replaced when backup is done.
+// Files of icon store are copied into folder next to the backup.
+class DatabaseBackuper : public QObject {
+    Q_OBJECT
+
+  public:
+    // Constructors.
+    explicit DatabaseBackuper(QObject *parent = 0);
+    virtual ~DatabaseBackuper();
+
+    bool isBackupRunning() const;
+
+    // Starts backup in thread of this object, returns false
+    // if another backup is running.
+    // NOTE: This is thread-safe and can be called from any thread.
+    bool startBackup(const QString &target_file_path, const QString &target_icons_folder);
+
+    // NOTE: This is thread-safe and can be called from any thread.
+    void stopRunningBackup();
+
+  signals:
+    void backupStarted();
+    void backupProgress(int progress, const QString &description);
+    void backupFinished(bool result, const QString &error_message);
+
+  private slots:
+    void backupDatabase(const QString &target_file_path, const QString &target_icons_folder);
+
+  private:
+    // Returns connection owned by thread of the backuper.
+    QSqlDatabase backupConnection() const;
+
+    bool sqliteBackup(const QString &target_file_path, QString *error_message);
+
+    // Online backup is used only if Qt's driver uses the same SQLite library
+    // as the one this application is linked to (USE_SQLITE_BACKUP).
+    bool sqliteOnlineBackupAvailable(QSqlDatabase database) const;
+    bool sqliteOnlineBackup(QSqlDatabase database, const QString &target_file_path, QString *error_message);
+    bool sqliteCopyFile(QSqlDatabase database, const QString &target_file_path, QString *error_message);
+    bool mysqlBackup(const QString &target_file_path, QString *error_message);
+    bool backupIcons(const QString &target_icons_folder, QString *error_message);
+
+    // Replaces target file with finished temporary file.
+    bool replaceTargetFile(const QString &temporary_file_path, const QString &target_file_path, QString *error_message);
+
+    QAtomicInt m_running;
+    QAtomicInt m_stopRequested;
+};
+
+#endif // DATABASEBACKUPER_H
@@ -156,10 +156,24 @@ QString DatabaseFactory::mysqlInterpretErrorCode(MySQLError error_code) const {
 bool DatabaseFactory::initiateRestoration(const QString &database_backup_file_path) {
   switch (m_activeDatabaseDriver) {
     case SQLITE:
-    case SQLITE_MEMORY:
+    case SQLITE_MEMORY: {
+      const QString target_icons_folder = m_sqliteDatabaseFilePath + QDir::separator() + BACKUP_NAME_DATABASE + BACKUP_SUFFIX_ICONS;
+      QString icons_backup_folder = database_backup_file_path;
+
+      // Icon store is backed up into folder next to database file,
+      // backups made by older versions do not have it.
+      icons_backup_folder.chop(int(qstrlen(BACKUP_SUFFIX_DATABASE)));
+      icons_backup_folder += BACKUP_SUFFIX_ICONS;
+      QDir(target_icons_folder).removeRecursively();
+
+      if (QDir(icons_backup_folder).exists() && !IOFactory::copyFolder(icons_backup_folder, target_icons_folder)) {
+        return false;
+      }
+
       return IOFactory::copyFile(database_backup_file_path,
                                  m_sqliteDatabaseFilePath + QDir::separator() +
                                  BACKUP_NAME_DATABASE + BACKUP_SUFFIX_DATABASE);
+    }
 
     default:
       return false;
@@ -184,6 +198,18 @@ void DatabaseFactory::finishRestoration() {
       qCritical("Database file was NOT restored due to error when copying the file.");
     }
   }
+
+  const QString backup_icons_folder = m_sqliteDatabaseFilePath + QDir::separator() + BACKUP_NAME_DATABASE + BACKUP_SUFFIX_ICONS;
+
+  if (QDir(backup_icons_folder).exists()) {
+    if (IOFactory::copyFolder(backup_icons_folder, qApp->getUserDataPath() + QDir::separator() + APP_ICON_STORE_FOLDER)) {
+      QDir(backup_icons_folder).removeRecursively();
+      qDebug("Icon store was restored successully.");
+    }
+    else {
+      qCritical("Icon store was NOT restored due to error when copying its files.");
+    }
+  }
 }
 
 void DatabaseFactory::sqliteAssemblyDatabaseFilePath()  {
@@ -210,29 +236,40 @@ QSqlDatabase DatabaseFactory::sqliteInitializeInMemoryDatabase() {
     query_db.exec(QSL("PRAGMA count_changes = OFF"));
     query_db.exec(QSL("PRAGMA temp_store = MEMORY"));
 
+    // Loading messages from file-based database.
+    QSqlDatabase file_database = sqliteConnection(objectName(), StrictlyFileBased);
+    QSqlQuery copy_contents(database);
+
+    // Attach database.
+    copy_contents.exec(QString("ATTACH DATABASE '%1' AS 'storage';").arg(file_database.databaseName()));
+
     // Sample query which checks for existence of tables.
     query_db.exec(QSL("SELECT inf_value FROM Information WHERE inf_key = 'schema_version'"));
 
     if (query_db.lastError().isValid()) {
       qWarning("Error occurred. In-memory SQLite database is not initialized. Initializing now.");
 
-      QFile file_init(APP_MISC_PATH + QDir::separator() + APP_DB_SQLITE_INIT);
+      // NOTE: Schema is taken from file-based database which is already
+      // updated, initialization script would give us outdated schema.
+      QStringList statements;
 
-      if (!file_init.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        // Database initialization file not opened. HUGE problem.
-        qFatal("In-memory SQLite database initialization file '%s' from directory '%s' was not found. In-memory database is uninitialized.",
-               APP_DB_SQLITE_INIT,
-               qPrintable(APP_MISC_PATH));
+      if (copy_contents.exec(QSL("SELECT sql FROM storage.sqlite_master "
+                                 "WHERE sql IS NOT NULL AND name NOT LIKE 'sqlite_%' ORDER BY type = 'index';"))) {
+        while (copy_contents.next()) {
+          statements.append(copy_contents.value(0).toString());
+        }
+      }
+      else {
+        qFatal("Cannot obtain schema of file-based SQLite database.");
       }
 
-      const QStringList statements = QString(file_init.readAll()).split(APP_DB_COMMENT_SPLIT, QString::SkipEmptyParts);
       database.transaction();
 
       foreach(const QString &statement, statements) {
         query_db.exec(statement);
 
         if (query_db.lastError().isValid()) {
-          qFatal("In-memory SQLite database initialization failed. Initialization script '%s' is not correct.", APP_DB_SQLITE_INIT);
+          qFatal("In-memory SQLite database initialization failed. Statement '%s' is not correct.", qPrintable(statement));
         }
       }
 
@@ -246,13 +283,6 @@ QSqlDatabase DatabaseFactory::sqliteInitializeInMemoryDatabase() {
       qDebug("In-memory SQLite database has version '%s'.", qPrintable(query_db.value(0).toString()));
     }
 
-    // Loading messages from file-based database.
-    QSqlDatabase file_database = sqliteConnection(objectName(), StrictlyFileBased);
-    QSqlQuery copy_contents(database);
-
-    // Attach database.
-    copy_contents.exec(QString("ATTACH DATABASE '%1' AS 'storage';").arg(file_database.databaseName()));
-
     // Copy all stuff.
     // WARNING: All tables belong here.
     QStringList tables;
@@ -359,7 +389,8 @@ QSqlDatabase DatabaseFactory::sqliteInitializeFileBasedDatabase(const QString &c
       const QString installed_db_schema = query_db.value(0).toString();
       query_db.finish();
 
-      if (installed_db_schema < APP_DB_SCHEMA_VERSION) {
+      // NOTE: Versions must be compared as numbers, "10" is lexically lower than "9".
+      if (installed_db_schema.toInt() < QString(APP_DB_SCHEMA_VERSION).toInt()) {
         if (sqliteUpdateDatabaseSchema(database, installed_db_schema)) {
           qDebug("Database schema was updated from '%s' to '%s' successully or it is already up to date.",
                  qPrintable(installed_db_schema),
@@ -393,8 +424,12 @@ bool DatabaseFactory::sqliteUpdateDatabaseSchema(QSqlDatabase database, const QS
   int working_version = QString(source_db_schema_version).remove('.').toInt();
   const int current_version = QString(APP_DB_SCHEMA_VERSION).remove('.').toInt();
 
-  // Now, it would be good to create backup of SQLite DB file.
-  if (IOFactory::copyFile(sqliteDatabaseFilePath(), sqliteDatabaseFilePath() + ".bak")) {
+  // Now, it would be good to create backup of SQLite DB file. Backup made
+  // before interrupted update is kept, database is already half-converted now.
+  if (sqliteUpdateProgress(database, working_version) > 0) {
+    qDebug("Continuing interrupted update of database schema '%d' -> '%d'.", working_version, working_version + 1);
+  }
+  else if (IOFactory::copyFile(sqliteDatabaseFilePath(), sqliteDatabaseFilePath() + ".bak")) {
     qDebug("Creating backup of SQLite DB file.");
   }
   else {
@@ -419,14 +454,35 @@ bool DatabaseFactory::sqliteUpdateDatabaseSchema(QSqlDatabase database, const QS
 
     const QStringList statements = QString(update_file_handle.readAll()).split(APP_DB_COMMENT_SPLIT, QString::SkipEmptyParts);
 
-    foreach (const QString &statement, statements) {
-      QSqlQuery query = database.exec(statement);
+    // Each update is done in transaction, so that crash
+    // in the middle of it does not leave database half-converted. Only statements
+    // which copy rows in chunks commit each chunk, index of such statement is
+    // stored, so that interrupted update continues with it.
+    if (!database.transaction()) {
+      qFatal("Transaction for updating database schema cannot be started: '%s'.", qPrintable(database.lastError().text()));
+    }
+
+    for (int i = sqliteUpdateProgress(database, working_version); i < statements.size(); i++) {
+      // Some statements convert whole tables, so report progress.
+      qDebug("Updating database schema '%d' -> '%d', executing statement %d of %d.",
+             working_version, working_version + 1, i + 1, statements.size());
 
-      if (query.lastError().isValid()) {
-        qFatal("Query for updating database schema failed: '%s'.", qPrintable(query.lastError().text()));
+      if (!statements.at(i).contains(QSL(APP_DB_UPDATE_CHUNK_PARAM))) {
+        if (!executeUpdateStatement(database, statements.at(i))) {
+          database.rollback();
+          qFatal("Updating of database schema '%d' -> '%d' failed.", working_version, working_version + 1);
+        }
+      }
+      else if (!sqliteSetUpdateProgress(database, working_version, i) || !database.commit() ||
+               !executeUpdateStatement(database, statements.at(i)) || !database.transaction()) {
+        qFatal("Updating of database schema '%d' -> '%d' failed.", working_version, working_version + 1);
       }
     }
 
+    if (!sqliteSetUpdateProgress(database, working_version, 0) || !database.commit()) {
+      qFatal("Transaction for updating database schema cannot be committed: '%s'.", qPrintable(database.lastError().text()));
+    }
+
     // Increment the version.
     qDebug("Updating database schema: '%d' -> '%d'.", working_version, working_version + 1);
     working_version++;
@@ -435,6 +491,97 @@ bool DatabaseFactory::sqliteUpdateDatabaseSchema(QSqlDatabase database, const QS
   return true;
 }
 
+int DatabaseFactory::sqliteUpdateProgress(QSqlDatabase database, int working_version) {
+  QSqlQuery query(database);
+
+  query.prepare(QSL("SELECT inf_value FROM Information WHERE inf_key = :key;"));
+  query.bindValue(QSL(":key"), APP_DB_UPDATE_PROGRESS_KEY);
+
+  if (query.exec() && query.next()) {
+    const QStringList progress = query.value(0).toString().split(QL1C(':'));
+
+    if (progress.size() == 2 && progress.at(0).toInt() == working_version) {
+      return progress.at(1).toInt();
+    }
+  }
+
+  return 0;
+}
+
+bool DatabaseFactory::sqliteSetUpdateProgress(QSqlDatabase database, int working_version, int statement_index) {
+  QSqlQuery query(database);
+
+  query.prepare(QSL("DELETE FROM Information WHERE inf_key = :key;"));
+  query.bindValue(QSL(":key"), APP_DB_UPDATE_PROGRESS_KEY);
+
+  if (!query.exec()) {
+    qCritical("Progress of database schema update cannot be stored: '%s'.", qPrintable(query.lastError().text()));
+    return false;
+  }
+  else if (statement_index == 0) {
+    return true;
+  }
+
+  query.prepare(QSL("INSERT INTO Information (inf_key, inf_value) VALUES (:key, :value);"));
+  query.bindValue(QSL(":key"), APP_DB_UPDATE_PROGRESS_KEY);
+  query.bindValue(QSL(":value"), QString(QSL("%1:%2")).arg(QString::number(working_version), QString::number(statement_index)));
+
+  if (!query.exec()) {
+    qCritical("Progress of database schema update cannot be stored: '%s'.", qPrintable(query.lastError().text()));
+    return false;
+  }
+
+  return true;
+}
+
+bool DatabaseFactory::executeUpdateStatement(QSqlDatabase database, const QString &statement) {
+  QSqlQuery query(database);
+
+  if (!statement.contains(QSL(APP_DB_UPDATE_CHUNK_PARAM))) {
+    if (query.exec(statement)) {
+      return true;
+    }
+    else {
+      qCritical("Query for updating database schema failed: '%s'.", qPrintable(query.lastError().text()));
+      return false;
+    }
+  }
+
+  // Statement copies rows in chunks, it is repeated
+  // until there are no more rows to copy.
+  int processed_rows = 0;
+
+  query.prepare(statement);
+
+  forever {
+    query.bindValue(QSL(APP_DB_UPDATE_CHUNK_PARAM), APP_DB_UPDATE_CHUNK_SIZE);
+
+    if (!database.transaction()) {
+      qCritical("Transaction for chunk of database schema update cannot be started: '%s'.", qPrintable(database.lastError().text()));
+      return false;
+    }
+    else if (!query.exec()) {
+      qCritical("Query for updating database schema failed: '%s'.", qPrintable(query.lastError().text()));
+      database.rollback();
+      return false;
+    }
+
+    const int chunk_rows = query.numRowsAffected();
+
+    if (!database.commit()) {
+      qCritical("Chunk of database schema update cannot be committed: '%s'.", qPrintable(database.lastError().text()));
+      return false;
+    }
+
+    processed_rows += chunk_rows;
+    qDebug("Updating database schema, %d rows processed so far.", processed_rows);
+
+    if (chunk_rows < APP_DB_UPDATE_CHUNK_SIZE) {
+      return true;
+    }
+  }
+}
+
 bool DatabaseFactory::mysqlUpdateDatabaseSchema(QSqlDatabase database, const QString &source_db_schema_version, const QString &db_name) {
   int working_version = QString(source_db_schema_version).remove('.').toInt();
   const int current_version = QString(APP_DB_SCHEMA_VERSION).remove('.').toInt();
@@ -457,11 +604,13 @@ bool DatabaseFactory::mysqlUpdateDatabaseSchema(QSqlDatabase database, const QSt
 
     QStringList statements = QString(update_file_handle.readAll()).split(APP_DB_COMMENT_SPLIT, QString::SkipEmptyParts);
 
-    foreach (QString statement, statements) {
-      QSqlQuery query = database.exec(statement.replace(APP_DB_NAME_PLACEHOLDER, db_name));
+    for (int i = 0; i < statements.size(); i++) {
+      // Some statements convert whole tables, so report progress.
+      qDebug("Updating database schema '%d' -> '%d', executing statement %d of %d.",
+             working_version, working_version + 1, i + 1, statements.size());
 
-      if (query.lastError().isValid()) {
-        qFatal("Query for updating database schema failed: '%s'.", qPrintable(query.lastError().text()));
+      if (!executeUpdateStatement(database, statements[i].replace(APP_DB_NAME_PLACEHOLDER, db_name))) {
+        qFatal("Updating of database schema '%d' -> '%d' failed.", working_version, working_version + 1);
       }
     }
 
@@ -692,7 +841,8 @@ QSqlDatabase DatabaseFactory::mysqlInitializeDatabase(const QString &connection_
 
       const QString installed_db_schema = query_db.value(0).toString();
 
-      if (installed_db_schema < APP_DB_SCHEMA_VERSION) {
+      // NOTE: Versions must be compared as numbers, "10" is lexically lower than "9".
+      if (installed_db_schema.toInt() < QString(APP_DB_SCHEMA_VERSION).toInt()) {
         if (mysqlUpdateDatabaseSchema(database, installed_db_schema, database_name)) {
           qDebug("Database schema was updated from '%s' to '%s' successully or it is already up to date.",
                  qPrintable(installed_db_schema),
@@ -807,7 +957,9 @@ bool DatabaseFactory::sqliteVacuumDatabase() {
 
   QSqlQuery query_vacuum(database);
 
-  return query_vacuum.exec(QSL("VACUUM"));
+  // Full vacuum is run anyway, so database file is switched to incremental
+  // mode here, then background retention reclaims free space in small steps.
+  return query_vacuum.exec(QSL("PRAGMA auto_vacuum = INCREMENTAL;")) && query_vacuum.exec(QSL("VACUUM"));
 }
 
 void DatabaseFactory::saveDatabase() {
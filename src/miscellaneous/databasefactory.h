@@ -123,6 +123,11 @@ class DatabaseFactory : public QObject {
     // application session.
     void determineDriver();
 
+    // Executes single statement of schema update, statements with chunk size
+    // parameter are repeated until they process less rows than is the chunk size,
+    // each chunk is committed in its own transaction.
+    bool executeUpdateStatement(QSqlDatabase database, const QString &statement);
+
     // Holds the type of currently activated database backend.
     UsedDriver m_activeDatabaseDriver;
 
@@ -165,6 +170,11 @@ class DatabaseFactory : public QObject {
     // Updates database schema.
     bool sqliteUpdateDatabaseSchema(QSqlDatabase database, const QString &source_db_schema_version);
 
+    // Returns index of statement of given schema update, which was being executed when
+    // the update got interrupted, or zero if the update was not started yet.
+    int sqliteUpdateProgress(QSqlDatabase database, int working_version);
+    bool sqliteSetUpdateProgress(QSqlDatabase database, int working_version, int statement_index);
+
     // Creates new connection, initializes database and
     // returns opened connections.
     QSqlDatabase sqliteInitializeInMemoryDatabase();
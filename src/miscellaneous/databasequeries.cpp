@@ -32,9 +32,13 @@
 #include "miscellaneous/textfactory.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/iconfactory.h"
+#include "network-web/faviconresolver.h"
+#include "miscellaneous/debugging.h"
+#include "miscellaneous/tracer.h"
 
 #include <QVariant>
 #include <QUrl>
+#include <QSet>
 #include <QSqlError>
 
 
@@ -74,6 +78,21 @@ bool DatabaseQueries::markFeedsReadUnread(QSqlDatabase db, const QStringList &id
   return q.exec();
 }
 
+bool DatabaseQueries::markCategoryReadUnread(QSqlDatabase db, int category_id, int account_id, RootItem::ReadStatus read) {
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+  q.prepare(QSL("UPDATE Messages SET is_read = :read "
+                "WHERE feed IN (SELECT feed FROM CategoriesFeeds WHERE category = :category AND account_id = :ancestry_account_id) "
+                "AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id;"));
+
+  q.bindValue(QSL(":read"), read == RootItem::Read ? 1 : 0);
+  q.bindValue(QSL(":category"), category_id);
+  q.bindValue(QSL(":ancestry_account_id"), account_id);
+  q.bindValue(QSL(":account_id"), account_id);
+
+  return q.exec();
+}
+
 bool DatabaseQueries::markBinReadUnread(QSqlDatabase db, int account_id, RootItem::ReadStatus read) {
   QSqlQuery q(db);
   q.setForwardOnly(true);
@@ -138,45 +157,618 @@ bool DatabaseQueries::purgeImportantMessages(QSqlDatabase db) {
 }
 
 bool DatabaseQueries::purgeReadMessages(QSqlDatabase db) {
-  QSqlQuery q(db);
-  q.setForwardOnly(true);
-  q.prepare(QSL("DELETE FROM Messages WHERE is_important = :is_important AND is_deleted = :is_deleted AND is_read = :is_read;"));
-  q.bindValue(QSL(":is_read"), 1);
+  QVariantMap values;
+  values.insert(QSL(":is_read"), 1);
 
   // Remove only messages which are NOT in recycle bin.
-  q.bindValue(QSL(":is_deleted"), 0);
+  values.insert(QSL(":is_deleted"), 0);
 
   // Remove only messages which are NOT starred.
-  q.bindValue(QSL(":is_important"), 0);
+  values.insert(QSL(":is_important"), 0);
 
-  return q.exec();
+  return removeMessagesInChunks(db, QSL("is_important = :is_important AND is_deleted = :is_deleted AND is_read = :is_read"), values);
 }
 
 bool DatabaseQueries::purgeOldMessages(QSqlDatabase db, int older_than_days) {
-  QSqlQuery q(db);
   const qint64 since_epoch = QDateTime::currentDateTimeUtc().addDays(-older_than_days).toMSecsSinceEpoch();
-
-  q.setForwardOnly(true);
-  q.prepare(QSL("DELETE FROM Messages WHERE is_important = :is_important AND date_created < :date_created;"));
-  q.bindValue(QSL(":date_created"), since_epoch);
+  QVariantMap values;
+  values.insert(QSL(":date_created"), since_epoch);
 
   // Remove only messages which are NOT starred.
-  q.bindValue(QSL(":is_important"), 0);
+  values.insert(QSL(":is_important"), 0);
 
-  return q.exec();
+  return removeMessagesInChunks(db, QSL("is_important = :is_important AND date_created < :date_created"), values);
 }
 
 bool DatabaseQueries::purgeRecycleBin(QSqlDatabase db) {
+  QVariantMap values;
+  values.insert(QSL(":is_deleted"), 1);
+
+  // Remove only messages which are NOT starred.
+  values.insert(QSL(":is_important"), 0);
+
+  return removeMessagesInChunks(db, QSL("is_important = :is_important AND is_deleted = :is_deleted"), values);
+}
+
+QHash<QPair<int,int>,RetentionPolicy> DatabaseQueries::getRetentionPolicies(QSqlDatabase db, bool *ok) {
+  QHash<QPair<int,int>,RetentionPolicy> policies;
   QSqlQuery q(db);
 
   q.setForwardOnly(true);
-  q.prepare(QSL("DELETE FROM Messages WHERE is_important = :is_important AND is_deleted = :is_deleted;"));
-  q.bindValue(QSL(":is_deleted"), 1);
 
-  // Remove only messages which are NOT starred.
-  q.bindValue(QSL(":is_important"), 0);
+  if (q.exec(QSL("SELECT account_id, feed, max_age, max_count, keep_starred FROM RetentionPolicies;"))) {
+    while (q.next()) {
+      RetentionPolicy policy;
+      policy.m_maxAge = q.value(2).toInt();
+      policy.m_maxCount = q.value(3).toInt();
+      policy.m_keepStarred = q.value(4).toBool();
 
-  return q.exec();
+      policies.insert(QPair<int,int>(q.value(0).toInt(), q.value(1).toInt()), policy);
+    }
+
+    if (ok != NULL) {
+      *ok = true;
+    }
+  }
+  else if (ok != NULL) {
+    *ok = false;
+  }
+
+  return policies;
+}
+
+QList<QPair<int,int> > DatabaseQueries::getFeedsWithMessages(QSqlDatabase db, bool *ok) {
+  QList<QPair<int,int> > feeds;
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+
+  // NOTE: This is answered from "Messages_feed" index.
+  if (q.exec(QSL("SELECT DISTINCT account_id, feed FROM Messages;"))) {
+    while (q.next()) {
+      feeds.append(QPair<int,int>(q.value(0).toInt(), q.value(1).toInt()));
+    }
+
+    if (ok != NULL) {
+      *ok = true;
+    }
+  }
+  else if (ok != NULL) {
+    *ok = false;
+  }
+
+  return feeds;
+}
+
+QStringList DatabaseQueries::getExpiredMessages(QSqlDatabase db, int account_id, int feed_id,
+                                                const RetentionPolicy &policy, int limit, bool *ok) {
+  QStringList ids;
+  QSqlQuery q(db);
+  const QString starred_condition = policy.m_keepStarred ? QSL(" AND is_important = 0") : QString();
+
+  q.setForwardOnly(true);
+
+  if (policy.m_maxAge > 0) {
+    q.prepare(QString(QSL("SELECT id FROM Messages "
+                          "WHERE account_id = :account_id AND feed = :feed AND is_deleted = 0 AND is_pdeleted = 0 AND date_created < :date_created%1 "
+                          "LIMIT %2;")).arg(starred_condition, QString::number(limit)));
+    q.bindValue(QSL(":account_id"), account_id);
+    q.bindValue(QSL(":feed"), feed_id);
+    q.bindValue(QSL(":date_created"), QDateTime::currentDateTimeUtc().addDays(-policy.m_maxAge).toMSecsSinceEpoch());
+
+    if (!q.exec()) {
+      if (ok != NULL) {
+        *ok = false;
+      }
+
+      return ids;
+    }
+
+    while (q.next()) {
+      ids.append(q.value(0).toString());
+    }
+  }
+
+  if (ids.isEmpty() && policy.m_maxCount > 0) {
+    // Starred messages, if kept, do not count towards the limit. Messages in recycle bin
+    // and purged ones are left alone, purged ones prevent re-downloading.
+    q.prepare(QString(QSL("SELECT id FROM Messages "
+                          "WHERE account_id = :account_id AND feed = :feed AND is_deleted = 0 AND is_pdeleted = 0%1 "
+                          "ORDER BY date_created DESC LIMIT %2 OFFSET %3;")).arg(starred_condition,
+                                                                                 QString::number(limit),
+                                                                                 QString::number(policy.m_maxCount)));
+    q.bindValue(QSL(":account_id"), account_id);
+    q.bindValue(QSL(":feed"), feed_id);
+
+    if (!q.exec()) {
+      if (ok != NULL) {
+        *ok = false;
+      }
+
+      return ids;
+    }
+
+    while (q.next()) {
+      ids.append(q.value(0).toString());
+    }
+  }
+
+  if (ok != NULL) {
+    *ok = true;
+  }
+
+  return ids;
+}
+
+bool DatabaseQueries::removeMessages(QSqlDatabase db, const QStringList &ids) {
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+
+  return q.exec(QString(QSL("DELETE FROM Messages WHERE id IN (%1);")).arg(ids.join(QSL(", "))));
+}
+
+bool DatabaseQueries::purgeMessages(QSqlDatabase db, const QStringList &ids) {
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+
+  return q.exec(QString(QSL("UPDATE Messages SET is_deleted = 1, is_pdeleted = 1, contents = '', enclosures = '' "
+                            "WHERE id IN (%1);")).arg(ids.join(QSL(", "))));
+}
+
+QString DatabaseQueries::getArchivedContents(QSqlDatabase db, int message_id, bool *ok) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("SELECT contents FROM MessagesArchive WHERE message = :message;"));
+  q.bindValue(QSL(":message"), message_id);
+
+  if (q.exec()) {
+    if (ok != NULL) {
+      *ok = true;
+    }
+
+    if (q.next()) {
+      return QString::fromUtf8(qUncompress(q.value(0).toByteArray()));
+    }
+  }
+  else if (ok != NULL) {
+    *ok = false;
+  }
+
+  return QString();
+}
+
+QHash<int,QString> DatabaseQueries::getArchivedContents(QSqlDatabase db, const QList<int> &message_ids, bool *ok) {
+  QHash<int,QString> contents;
+  QStringList ids;
+
+  if (ok != NULL) {
+    *ok = true;
+  }
+
+  foreach (int message_id, message_ids) {
+    ids.append(QString::number(message_id));
+  }
+
+  if (ids.isEmpty()) {
+    return contents;
+  }
+
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+
+  if (!q.exec(QString(QSL("SELECT message, contents FROM MessagesArchive WHERE message IN (%1);")).arg(ids.join(QSL(", "))))) {
+    qWarning("Loading of archived contents failed: '%s'.", qPrintable(q.lastError().text()));
+
+    if (ok != NULL) {
+      *ok = false;
+    }
+
+    return contents;
+  }
+
+  while (q.next()) {
+    contents.insert(q.value(0).toInt(), QString::fromUtf8(qUncompress(q.value(1).toByteArray())));
+  }
+
+  return contents;
+}
+
+bool DatabaseQueries::loadArchivedContents(QSqlDatabase db, QList<Message> &messages) {
+  QHash<int,int> indexes_for_ids;
+  QStringList ids;
+
+  for (int i = 0; i < messages.size(); i++) {
+    if (messages.at(i).m_isArchived) {
+      indexes_for_ids.insert(messages.at(i).m_id, i);
+      ids.append(QString::number(messages.at(i).m_id));
+    }
+  }
+
+  if (ids.isEmpty()) {
+    return true;
+  }
+
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+
+  if (!q.exec(QString(QSL("SELECT message, contents FROM MessagesArchive WHERE message IN (%1);")).arg(ids.join(QSL(", "))))) {
+    qWarning("Loading of archived contents failed: '%s'.", qPrintable(q.lastError().text()));
+    return false;
+  }
+
+  while (q.next()) {
+    Message &message = messages[indexes_for_ids.value(q.value(0).toInt())];
+
+    message.m_contents = QString::fromUtf8(qUncompress(q.value(1).toByteArray()));
+    message.m_isArchived = false;
+  }
+
+  return true;
+}
+
+int DatabaseQueries::archiveMessages(QSqlDatabase db, qint64 older_than, int limit, bool *ok) {
+  QSqlQuery q(db);
+  QStringList ids;
+  QList<QByteArray> compressed_contents;
+
+  if (ok != NULL) {
+    *ok = false;
+  }
+
+  q.setForwardOnly(true);
+  q.prepare(QString(QSL("SELECT id, contents FROM Messages "
+                        "WHERE is_read = 1 AND is_partial = 0 AND date_created < :date_created AND contents IS NOT NULL AND contents != '' "
+                        "LIMIT %1;")).arg(limit));
+  q.bindValue(QSL(":date_created"), older_than);
+
+  if (!q.exec()) {
+    return 0;
+  }
+
+  while (q.next()) {
+    ids.append(q.value(0).toString());
+    compressed_contents.append(qCompress(q.value(1).toString().toUtf8(), ARCHIVE_COMPRESSION_LEVEL));
+  }
+
+  if (ids.isEmpty()) {
+    if (ok != NULL) {
+      *ok = true;
+    }
+
+    return 0;
+  }
+
+  if (!db.transaction()) {
+    qWarning("Transaction for archiving of messages failed: '%s'.", qPrintable(db.lastError().text()));
+    return 0;
+  }
+
+  // Compressed contents go to archive, hot table keeps NULL which
+  // marks message as archived, see Message::m_isArchived.
+  q.prepare(QSL("REPLACE INTO MessagesArchive (message, contents) VALUES (:message, :contents);"));
+
+  for (int i = 0; i < ids.size(); i++) {
+    q.bindValue(QSL(":message"), ids.at(i).toInt());
+    q.bindValue(QSL(":contents"), compressed_contents.at(i));
+
+    if (!q.exec()) {
+      qWarning("Archiving of message contents failed: '%s'.", qPrintable(q.lastError().text()));
+      db.rollback();
+      return 0;
+    }
+  }
+
+  if (!q.exec(QString(QSL("UPDATE Messages SET contents = NULL WHERE id IN (%1);")).arg(ids.join(QSL(", ")))) ||
+      !db.commit()) {
+    qWarning("Archiving of messages failed: '%s'.", qPrintable(db.lastError().text()));
+    db.rollback();
+    return 0;
+  }
+
+  if (ok != NULL) {
+    *ok = true;
+  }
+
+  return ids.size();
+}
+
+QString DatabaseQueries::getMessageContents(QSqlDatabase db, int message_id, bool *is_partial, bool *ok) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("SELECT contents, is_partial FROM Messages WHERE id = :id;"));
+  q.bindValue(QSL(":id"), message_id);
+
+  if (q.exec() && q.next()) {
+    if (ok != NULL) {
+      *ok = true;
+    }
+
+    *is_partial = q.value(1).toBool();
+
+    if (q.value(0).isNull()) {
+      return getArchivedContents(db, message_id, ok);
+    }
+    else {
+      return q.value(0).toString();
+    }
+  }
+  else {
+    if (ok != NULL) {
+      *ok = false;
+    }
+
+    *is_partial = true;
+    return QString();
+  }
+}
+
+bool DatabaseQueries::storeMessagesContents(QSqlDatabase db, const QList<Message> &messages, int account_id) {
+  QSqlQuery q(db);
+
+  if (!db.transaction()) {
+    qWarning("Transaction for storing of message contents failed: '%s'.", qPrintable(db.lastError().text()));
+    return false;
+  }
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("UPDATE Messages SET contents = :contents, is_partial = 0 "
+                "WHERE custom_id = :custom_id AND account_id = :account_id;"));
+
+  foreach (const Message &message, messages) {
+    q.bindValue(QSL(":contents"), message.m_contents);
+    q.bindValue(QSL(":custom_id"), message.m_customId);
+    q.bindValue(QSL(":account_id"), account_id);
+
+    if (!q.exec()) {
+      qWarning("Storing of message contents failed: '%s'.", qPrintable(q.lastError().text()));
+      db.rollback();
+      return false;
+    }
+  }
+
+  if (!db.commit()) {
+    qWarning("Storing of message contents failed: '%s'.", qPrintable(db.lastError().text()));
+    db.rollback();
+    return false;
+  }
+
+  return true;
+}
+
+bool DatabaseQueries::clearPartialMessages(QSqlDatabase db, const QStringList &custom_ids, int account_id) {
+  QSqlQuery q(db);
+
+  if (!db.transaction()) {
+    qWarning("Transaction for clearing of partial messages failed: '%s'.", qPrintable(db.lastError().text()));
+    return false;
+  }
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("UPDATE Messages SET is_partial = 0 WHERE custom_id = :custom_id AND account_id = :account_id;"));
+
+  foreach (const QString &custom_id, custom_ids) {
+    q.bindValue(QSL(":custom_id"), custom_id);
+    q.bindValue(QSL(":account_id"), account_id);
+
+    if (!q.exec()) {
+      qWarning("Clearing of partial messages failed: '%s'.", qPrintable(q.lastError().text()));
+      db.rollback();
+      return false;
+    }
+  }
+
+  if (!db.commit()) {
+    qWarning("Clearing of partial messages failed: '%s'.", qPrintable(db.lastError().text()));
+    db.rollback();
+    return false;
+  }
+
+  return true;
+}
+
+QHash<QString,int> DatabaseQueries::getPartialMessagesIds(QSqlDatabase db, int account_id, int limit, bool *ok) {
+  QSqlQuery q(db);
+  QHash<QString,int> ids;
+
+  // Newest unread messages are the most likely to be read soon.
+  q.setForwardOnly(true);
+  q.prepare(QString(QSL("SELECT custom_id, id FROM Messages "
+                        "WHERE is_partial = 1 AND is_read = 0 AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id "
+                        "ORDER BY date_created DESC LIMIT %1;")).arg(limit));
+  q.bindValue(QSL(":account_id"), account_id);
+
+  if (q.exec()) {
+    while (q.next()) {
+      ids.insert(q.value(0).toString(), q.value(1).toInt());
+    }
+
+    if (ok != NULL) {
+      *ok = true;
+    }
+  }
+  else if (ok != NULL) {
+    *ok = false;
+  }
+
+  return ids;
+}
+
+bool DatabaseQueries::storeUpdateTelemetry(QSqlDatabase db, const QList<FeedUpdateTelemetry> &telemetry) {
+  QSqlQuery q(db);
+
+  if (!db.transaction()) {
+    qWarning("Transaction for storing of update telemetry failed: '%s'.", qPrintable(db.lastError().text()));
+    return false;
+  }
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("INSERT INTO UpdateTelemetry "
+                "(account_id, feed, feed_title, date_updated, is_error, ttfb_time, download_time, download_bytes, "
+                "decode_time, parse_time, db_time, msgs_new, msgs_updated, msgs_unchanged) "
+                "VALUES (:account_id, :feed, :feed_title, :date_updated, :is_error, :ttfb_time, :download_time, :download_bytes, "
+                ":decode_time, :parse_time, :db_time, :msgs_new, :msgs_updated, :msgs_unchanged);"));
+
+  foreach (const FeedUpdateTelemetry &record, telemetry) {
+    q.bindValue(QSL(":account_id"), record.m_accountId);
+    q.bindValue(QSL(":feed"), record.m_feedId);
+    q.bindValue(QSL(":feed_title"), record.m_feedTitle);
+    q.bindValue(QSL(":date_updated"), record.m_updated.toMSecsSinceEpoch());
+    q.bindValue(QSL(":is_error"), (int) record.m_error);
+    q.bindValue(QSL(":ttfb_time"), record.m_timeToFirstByte);
+    q.bindValue(QSL(":download_time"), record.m_downloadTime);
+    q.bindValue(QSL(":download_bytes"), record.m_downloadedBytes);
+    q.bindValue(QSL(":decode_time"), record.m_decodeTime);
+    q.bindValue(QSL(":parse_time"), record.m_parseTime);
+    q.bindValue(QSL(":db_time"), record.m_databaseTime);
+    q.bindValue(QSL(":msgs_new"), record.m_newMessages);
+    q.bindValue(QSL(":msgs_updated"), record.m_updatedMessages);
+    q.bindValue(QSL(":msgs_unchanged"), record.m_unchangedMessages);
+
+    if (!q.exec()) {
+      qWarning("Storing of update telemetry failed: '%s'.", qPrintable(q.lastError().text()));
+      db.rollback();
+      return false;
+    }
+  }
+
+  if (!db.commit()) {
+    qWarning("Storing of update telemetry failed: '%s'.", qPrintable(db.lastError().text()));
+    db.rollback();
+    return false;
+  }
+
+  return true;
+}
+
+QList<FeedUpdateTelemetry> DatabaseQueries::getUpdateTelemetry(QSqlDatabase db, const QDateTime &since, bool *ok) {
+  QSqlQuery q(db);
+  QList<FeedUpdateTelemetry> telemetry;
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("SELECT account_id, feed, feed_title, date_updated, is_error, ttfb_time, download_time, download_bytes, "
+                "decode_time, parse_time, db_time, msgs_new, msgs_updated, msgs_unchanged "
+                "FROM UpdateTelemetry WHERE date_updated >= :since ORDER BY date_updated ASC;"));
+  q.bindValue(QSL(":since"), since.toMSecsSinceEpoch());
+
+  if (q.exec()) {
+    while (q.next()) {
+      FeedUpdateTelemetry record;
+
+      record.m_accountId = q.value(0).toInt();
+      record.m_feedId = q.value(1).toInt();
+      record.m_feedTitle = q.value(2).toString();
+      record.m_updated = QDateTime::fromMSecsSinceEpoch(q.value(3).value<qint64>());
+      record.m_error = q.value(4).toBool();
+      record.m_timeToFirstByte = q.value(5).value<qint64>();
+      record.m_downloadTime = q.value(6).value<qint64>();
+      record.m_downloadedBytes = q.value(7).value<qint64>();
+      record.m_decodeTime = q.value(8).value<qint64>();
+      record.m_parseTime = q.value(9).value<qint64>();
+      record.m_databaseTime = q.value(10).value<qint64>();
+      record.m_newMessages = q.value(11).toInt();
+      record.m_updatedMessages = q.value(12).toInt();
+      record.m_unchangedMessages = q.value(13).toInt();
+
+      telemetry.append(record);
+    }
+
+    if (ok != NULL) {
+      *ok = true;
+    }
+  }
+  else {
+    qWarning("Loading of update telemetry failed: '%s'.", qPrintable(q.lastError().text()));
+
+    if (ok != NULL) {
+      *ok = false;
+    }
+  }
+
+  return telemetry;
+}
+
+bool DatabaseQueries::purgeUpdateTelemetry(QSqlDatabase db, const QDateTime &older_than) {
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+
+  if (older_than.isValid()) {
+    q.prepare(QSL("DELETE FROM UpdateTelemetry WHERE date_updated < :date_updated;"));
+    q.bindValue(QSL(":date_updated"), older_than.toMSecsSinceEpoch());
+  }
+  else {
+    q.prepare(QSL("DELETE FROM UpdateTelemetry;"));
+  }
+
+  if (!q.exec()) {
+    qWarning("Purging of update telemetry failed: '%s'.", qPrintable(q.lastError().text()));
+    return false;
+  }
+
+  return true;
+}
+
+bool DatabaseQueries::removeOrphanedArchivedContents(QSqlDatabase db) {
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+
+  // Archived contents of removed or purged messages are removed in chunks too.
+  forever {
+    if (!q.exec(QString(QSL("SELECT message FROM MessagesArchive "
+                            "WHERE message NOT IN (SELECT id FROM Messages WHERE is_pdeleted = 0) LIMIT %1;")).arg(RETENTION_BATCH_SIZE))) {
+      return false;
+    }
+
+    QStringList ids;
+
+    while (q.next()) {
+      ids.append(q.value(0).toString());
+    }
+
+    if (!ids.isEmpty() &&
+        !q.exec(QString(QSL("DELETE FROM MessagesArchive WHERE message IN (%1);")).arg(ids.join(QSL(", "))))) {
+      return false;
+    }
+
+    if (ids.size() < RETENTION_BATCH_SIZE) {
+      return true;
+    }
+  }
+}
+
+bool DatabaseQueries::removeMessagesInChunks(QSqlDatabase db, const QString &condition, const QVariantMap &values) {
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+
+  forever {
+    q.prepare(QString(QSL("SELECT id FROM Messages WHERE %1 LIMIT %2;")).arg(condition,
+                                                                           QString::number(RETENTION_BATCH_SIZE)));
+
+    foreach (const QString &placeholder, values.keys()) {
+      q.bindValue(placeholder, values.value(placeholder));
+    }
+
+    if (!q.exec()) {
+      return false;
+    }
+
+    QStringList ids;
+
+    while (q.next()) {
+      ids.append(q.value(0).toString());
+    }
+
+    // Each chunk is deleted in its own statement, database lock
+    // is therefore released between chunks.
+    if (!ids.isEmpty() && !removeMessages(db, ids)) {
+      return false;
+    }
+
+    if (ids.size() < RETENTION_BATCH_SIZE) {
+      return true;
+    }
+  }
 }
 
 QMap<int,QPair<int,int> > DatabaseQueries::getMessageCountsForCategory(QSqlDatabase db, int custom_id, int account_id,
@@ -338,25 +930,15 @@ int DatabaseQueries::getMessageCountsForBin(QSqlDatabase db, int account_id, boo
   }
 }
 
-QList<Message> DatabaseQueries::getUndeletedMessagesForFeed(QSqlDatabase db, int feed_custom_id, int account_id, bool *ok) {
-  QList<Message> messages;
+QVector<QPair<qint64,int> > DatabaseQueries::getMessageKeys(QSqlDatabase db, const QString &filter, bool *ok) {
+  QVector<QPair<qint64,int> > keys;
   QSqlQuery q(db);
   q.setForwardOnly(true);
-  q.prepare("SELECT * "
-            "FROM Messages "
-            "WHERE is_deleted = 0 AND is_pdeleted = 0 AND feed = :feed AND account_id = :account_id;");
-
-  q.bindValue(QSL(":feed"), feed_custom_id);
-  q.bindValue(QSL(":account_id"), account_id);
 
-  if (q.exec()) {
+  if (q.exec(QString("SELECT date_created, id FROM Messages WHERE %1 "
+                     "ORDER BY date_created DESC, id DESC;").arg(filter))) {
     while (q.next()) {
-      bool decoded;
-      Message message = Message::fromSqlRecord(q.record(), &decoded);
-
-      if (decoded) {
-        messages.append(message);
-      }
+      keys.append(QPair<qint64,int>(q.value(0).value<qint64>(), q.value(1).toInt()));
     }
 
     if (ok != nullptr) {
@@ -369,27 +951,23 @@ QList<Message> DatabaseQueries::getUndeletedMessagesForFeed(QSqlDatabase db, int
     }
   }
 
-  return messages;
+  return keys;
 }
 
-QList<Message> DatabaseQueries::getUndeletedMessagesForBin(QSqlDatabase db, int account_id, bool *ok) {
-  QList<Message> messages;
+QList<QSqlRecord> DatabaseQueries::getMessageRecords(QSqlDatabase db, const QString &filter, const QList<int> &ids, bool *ok) {
+  QList<QSqlRecord> records;
+  QStringList textual_ids;
   QSqlQuery q(db);
-  q.setForwardOnly(true);
-  q.prepare("SELECT * "
-            "FROM Messages "
-            "WHERE is_deleted = 1 AND is_pdeleted = 0 AND account_id = :account_id;");
 
-  q.bindValue(QSL(":account_id"), account_id);
+  foreach (int id, ids) {
+    textual_ids.append(QString::number(id));
+  }
 
-  if (q.exec()) {
-    while (q.next()) {
-      bool decoded;
-      Message message = Message::fromSqlRecord(q.record(), &decoded);
+  q.setForwardOnly(true);
 
-      if (decoded) {
-        messages.append(message);
-      }
+  if (q.exec(QString("SELECT * FROM Messages WHERE (%1) AND id IN (%2);").arg(filter, textual_ids.join(QSL(", "))))) {
+    while (q.next()) {
+      records.append(q.record());
     }
 
     if (ok != nullptr) {
@@ -402,17 +980,23 @@ QList<Message> DatabaseQueries::getUndeletedMessagesForBin(QSqlDatabase db, int
     }
   }
 
-  return messages;
+  return records;
 }
 
-QList<Message> DatabaseQueries::getUndeletedMessagesForAccount(QSqlDatabase db, int account_id, bool *ok) {
+QList<Message> DatabaseQueries::getMessagesPage(QSqlDatabase db, const QString &filter, qint64 from_date, int from_id,
+                                                int limit, bool *ok) {
   QList<Message> messages;
   QSqlQuery q(db);
   q.setForwardOnly(true);
-  q.prepare("SELECT * "
-            "FROM Messages "
-            "WHERE is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id;");
-  q.bindValue(QSL(":account_id"), account_id);
+  q.prepare(QString("SELECT * "
+                    "FROM Messages "
+                    "WHERE (%1) AND (date_created < :date_before OR (date_created = :date_same AND id <= :id)) "
+                    "ORDER BY date_created DESC, id DESC LIMIT :limit;").arg(filter));
+
+  q.bindValue(QSL(":date_before"), from_date);
+  q.bindValue(QSL(":date_same"), from_date);
+  q.bindValue(QSL(":id"), from_id);
+  q.bindValue(QSL(":limit"), limit);
 
   if (q.exec()) {
     while (q.next()) {
@@ -443,7 +1027,11 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
                                     int account_id,
                                     const QString &url,
                                     bool *any_message_changed,
-                                    bool *ok) {
+                                    bool *ok,
+                                    MessagesChanges *changes) {
+  TraceSpan span("db", "DatabaseQueries::updateMessages");
+  span.setArgument("messages", messages.size());
+
   if (messages.isEmpty()) {
     *any_message_changed = false;
     *ok = true;
@@ -460,7 +1048,9 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
   QSqlQuery query_select_with_url(db);
   QSqlQuery query_select_with_id(db);
   QSqlQuery query_update(db);
+  QSqlQuery query_update_partial(db);
   QSqlQuery query_insert(db);
+  QSqlQuery query_remove_archived(db);
   QSqlQuery query_begin_transaction(db);
 
   // Here we have query which will check for existence of the "same" message in given feed.
@@ -481,15 +1071,27 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
   // Used to insert new messages.
   query_insert.setForwardOnly(true);
   query_insert.prepare("INSERT INTO Messages "
-                       "(feed, title, is_read, is_important, url, author, date_created, contents, enclosures, custom_id, custom_hash, account_id) "
-                       "VALUES (:feed, :title, :is_read, :is_important, :url, :author, :date_created, :contents, :enclosures, :custom_id, :custom_hash, :account_id);");
+                       "(feed, title, is_read, is_important, url, author, date_created, contents, enclosures, custom_id, custom_hash, account_id, is_partial) "
+                       "VALUES (:feed, :title, :is_read, :is_important, :url, :author, :date_created, :contents, :enclosures, :custom_id, :custom_hash, :account_id, :is_partial);");
 
   // Used to update existing messages.
   query_update.setForwardOnly(true);
   query_update.prepare("UPDATE Messages "
-                       "SET title = :title, is_read = :is_read, is_important = :is_important, url = :url, author = :author, date_created = :date_created, contents = :contents, enclosures = :enclosures "
+                       "SET title = :title, is_read = :is_read, is_important = :is_important, url = :url, author = :author, date_created = :date_created, contents = :contents, enclosures = :enclosures, is_partial = 0 "
                        "WHERE id = :id;");
 
+  // Full update replaces contents, so archived ones are not needed anymore.
+  query_remove_archived.setForwardOnly(true);
+  query_remove_archived.prepare("DELETE FROM MessagesArchive WHERE message = :message;");
+
+  // Used to update existing messages with only headline obtained,
+  // full contents, which could be downloaded meanwhile, must be kept.
+  query_update_partial.setForwardOnly(true);
+  query_update_partial.prepare("UPDATE Messages "
+                               "SET title = :title, is_read = :is_read, is_important = :is_important, url = :url, author = :author, date_created = :date_created, "
+                               "contents = CASE WHEN is_partial = 1 THEN :contents ELSE contents END, enclosures = :enclosures "
+                               "WHERE id = :id;");
+
   if (use_transactions && !query_begin_transaction.exec(qApp->database()->obtainBeginTransactionSql())) {
     qCritical("Transaction start for message downloader failed: '%s'.", qPrintable(query_begin_transaction.lastError().text()));
     return updated_messages;
@@ -550,7 +1152,7 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
         is_important_existing_message = query_select_with_id.value(3).toBool();
       }
       else if (query_select_with_id.lastError().isValid()) {
-        qDebug("Failed to check for existing message in DB via ID: '%s'.", qPrintable(query_select_with_id.lastError().text()));
+        qCDebug(LOGDB, "Failed to check for existing message in DB via ID: '%s'.", qPrintable(query_select_with_id.lastError().text()));
       }
 
       query_select_with_id.finish();
@@ -566,27 +1168,45 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
       if (/* 1 */ (!message.m_customId.isEmpty() && (message.m_created.toMSecsSinceEpoch() != date_existing_message || message.m_isRead != is_read_existing_message || message.m_isImportant != is_important_existing_message)) ||
           /* 2 */ (message.m_createdFromFeed && message.m_created.toMSecsSinceEpoch() != date_existing_message)) {
         // Message exists, it is changed, update it.
-        query_update.bindValue(QSL(":title"), message.m_title);
-        query_update.bindValue(QSL(":is_read"), (int) message.m_isRead);
-        query_update.bindValue(QSL(":is_important"), (int) message.m_isImportant);
-        query_update.bindValue(QSL(":url"), message.m_url);
-        query_update.bindValue(QSL(":author"), message.m_author);
-        query_update.bindValue(QSL(":date_created"), message.m_created.toMSecsSinceEpoch());
-        query_update.bindValue(QSL(":contents"), message.m_contents);
-        query_update.bindValue(QSL(":enclosures"), Enclosures::encodeEnclosuresToString(message.m_enclosures));
-        query_update.bindValue(QSL(":id"), id_existing_message);
+        QSqlQuery &query = message.m_isPartial ? query_update_partial : query_update;
+
+        query.bindValue(QSL(":title"), message.m_title);
+        query.bindValue(QSL(":is_read"), (int) message.m_isRead);
+        query.bindValue(QSL(":is_important"), (int) message.m_isImportant);
+        query.bindValue(QSL(":url"), message.m_url);
+        query.bindValue(QSL(":author"), message.m_author);
+        query.bindValue(QSL(":date_created"), message.m_created.toMSecsSinceEpoch());
+        query.bindValue(QSL(":contents"), message.m_contents);
+        query.bindValue(QSL(":enclosures"), Enclosures::encodeEnclosuresToString(message.m_enclosures));
+        query.bindValue(QSL(":id"), id_existing_message);
 
         *any_message_changed = true;
 
-        if (query_update.exec() && !message.m_isRead) {
+        const bool message_updated = query.exec();
+
+        if (message_updated && changes != nullptr) {
+          changes->m_updatedIds.append(id_existing_message);
+        }
+
+        if (message_updated && !message.m_isPartial) {
+          query_remove_archived.bindValue(QSL(":message"), id_existing_message);
+
+          if (!query_remove_archived.exec()) {
+            qWarning("Failed to remove archived contents of updated message: '%s'.", qPrintable(query_remove_archived.lastError().text()));
+          }
+
+          query_remove_archived.finish();
+        }
+
+        if (message_updated && !message.m_isRead) {
           updated_messages++;
         }
-        else if (query_update.lastError().isValid()) {
-          qWarning("Failed to update message in DB: '%s'.", qPrintable(query_update.lastError().text()));
+        else if (query.lastError().isValid()) {
+          qWarning("Failed to update message in DB: '%s'.", qPrintable(query.lastError().text()));
         }
 
-        query_update.finish();
-        qDebug("Updating message '%s' in DB.", qPrintable(message.m_title));
+        query.finish();
+        qCDebug(LOGDB, "Updating message '%s' in DB.", qPrintable(message.m_title));
       }
     }
     else {
@@ -603,10 +1223,15 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
       query_insert.bindValue(QSL(":custom_id"), message.m_customId);
       query_insert.bindValue(QSL(":custom_hash"), message.m_customHash);
       query_insert.bindValue(QSL(":account_id"), account_id);
+      query_insert.bindValue(QSL(":is_partial"), (int) message.m_isPartial);
 
       if (query_insert.exec() && query_insert.numRowsAffected() == 1) {
+        if (changes != nullptr) {
+          changes->m_insertedIds.append(query_insert.lastInsertId().toInt());
+        }
+
         updated_messages++;
-        qDebug("Added new message '%s' to DB.", qPrintable(message.m_title));
+        qCDebug(LOGDB, "Added new message '%s' to DB.", qPrintable(message.m_title));
       }
       else if (query_insert.lastError().isValid()) {
         qWarning("Failed to insert message to DB: '%s' - message title is '%s'.",
@@ -634,6 +1259,10 @@ int DatabaseQueries::updateMessages(QSqlDatabase db,
       *ok = false;
       updated_messages = 0;
     }
+
+    if (changes != nullptr) {
+      *changes = MessagesChanges();
+    }
   }
   else {
     if (ok != nullptr) {
@@ -666,6 +1295,9 @@ bool DatabaseQueries::deleteAccount(QSqlDatabase db, int account_id) {
 
   QStringList queries;
   queries << QSL("DELETE FROM Messages WHERE account_id = :account_id;") <<
+             QSL("DELETE FROM CategoriesFeeds WHERE account_id = :account_id;") <<
+             QSL("DELETE FROM RetentionPolicies WHERE account_id = :account_id;") <<
+             QSL("DELETE FROM UpdateTelemetry WHERE account_id = :account_id;") <<
              QSL("DELETE FROM Feeds WHERE account_id = :account_id;") <<
              QSL("DELETE FROM Categories WHERE account_id = :account_id;") <<
              QSL("DELETE FROM Accounts WHERE id = :account_id;");
@@ -708,6 +1340,11 @@ bool DatabaseQueries::deleteAccountData(QSqlDatabase db, int account_id, bool de
 
   result &= q.exec();
 
+  q.prepare(QSL("DELETE FROM CategoriesFeeds WHERE account_id = :account_id;"));
+  q.bindValue(QSL(":account_id"), account_id);
+
+  result &= q.exec();
+
   return result;
 }
 
@@ -738,6 +1375,107 @@ bool DatabaseQueries::cleanFeeds(QSqlDatabase db, const QStringList &ids, bool c
   }
 }
 
+bool DatabaseQueries::cleanCategory(QSqlDatabase db, int category_id, bool clean_read_only, int account_id) {
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+
+  if (clean_read_only) {
+    q.prepare(QSL("UPDATE Messages SET is_deleted = :deleted "
+                  "WHERE feed IN (SELECT feed FROM CategoriesFeeds WHERE category = :category AND account_id = :ancestry_account_id) "
+                  "AND is_deleted = 0 AND is_pdeleted = 0 AND is_read = 1 AND account_id = :account_id;"));
+  }
+  else {
+    q.prepare(QSL("UPDATE Messages SET is_deleted = :deleted "
+                  "WHERE feed IN (SELECT feed FROM CategoriesFeeds WHERE category = :category AND account_id = :ancestry_account_id) "
+                  "AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = :account_id;"));
+  }
+
+  q.bindValue(QSL(":deleted"), 1);
+  q.bindValue(QSL(":category"), category_id);
+  q.bindValue(QSL(":ancestry_account_id"), account_id);
+  q.bindValue(QSL(":account_id"), account_id);
+
+  if (!q.exec()) {
+    qDebug("Cleaning of category failed: '%s'.", qPrintable(q.lastError().text()));
+    return false;
+  }
+  else {
+    return true;
+  }
+}
+
+bool DatabaseQueries::updateFeedAncestry(QSqlDatabase db, int account_id, const QList<QPair<int,int> > &ancestry) {
+  QSqlQuery q(db);
+  q.setForwardOnly(true);
+  q.prepare(QSL("SELECT category, feed FROM CategoriesFeeds WHERE account_id = :account_id;"));
+  q.bindValue(QSL(":account_id"), account_id);
+
+  if (!q.exec()) {
+    qWarning("Loading of feed ancestry failed: '%s'.", qPrintable(q.lastError().text()));
+    return false;
+  }
+
+  QSet<QPair<int,int> > stored_pairs;
+  const QSet<QPair<int,int> > new_pairs = ancestry.toSet();
+
+  while (q.next()) {
+    stored_pairs.insert(QPair<int,int>(q.value(0).toInt(), q.value(1).toInt()));
+  }
+
+  const QSet<QPair<int,int> > removed_pairs = QSet<QPair<int,int> >(stored_pairs).subtract(new_pairs);
+  const QSet<QPair<int,int> > added_pairs = QSet<QPair<int,int> >(new_pairs).subtract(stored_pairs);
+
+  if (removed_pairs.isEmpty() && added_pairs.isEmpty()) {
+    // Stored ancestry is up-to-date.
+    return true;
+  }
+
+  if (!db.transaction()) {
+    qWarning("Transaction for feed ancestry update failed: '%s'.", qPrintable(db.lastError().text()));
+    return false;
+  }
+
+  QSqlQuery query_remove(db);
+  QSqlQuery query_add(db);
+
+  query_remove.setForwardOnly(true);
+  query_remove.prepare(QSL("DELETE FROM CategoriesFeeds WHERE category = :category AND feed = :feed AND account_id = :account_id;"));
+  query_add.setForwardOnly(true);
+  query_add.prepare(QSL("INSERT INTO CategoriesFeeds (category, feed, account_id) VALUES (:category, :feed, :account_id);"));
+
+  foreach (const QPair<int,int> &pair, removed_pairs) {
+    query_remove.bindValue(QSL(":category"), pair.first);
+    query_remove.bindValue(QSL(":feed"), pair.second);
+    query_remove.bindValue(QSL(":account_id"), account_id);
+
+    if (!query_remove.exec()) {
+      qWarning("Removing of feed ancestry failed: '%s'.", qPrintable(query_remove.lastError().text()));
+      db.rollback();
+      return false;
+    }
+  }
+
+  foreach (const QPair<int,int> &pair, added_pairs) {
+    query_add.bindValue(QSL(":category"), pair.first);
+    query_add.bindValue(QSL(":feed"), pair.second);
+    query_add.bindValue(QSL(":account_id"), account_id);
+
+    if (!query_add.exec()) {
+      qWarning("Storing of feed ancestry failed: '%s'.", qPrintable(query_add.lastError().text()));
+      db.rollback();
+      return false;
+    }
+  }
+
+  if (!db.commit()) {
+    qWarning("Committing of feed ancestry failed: '%s'.", qPrintable(db.lastError().text()));
+    db.rollback();
+    return false;
+  }
+
+  return true;
+}
+
 bool DatabaseQueries::purgeLeftoverMessages(QSqlDatabase db, int account_id) {
   QSqlQuery q(db);
 
@@ -755,6 +1493,10 @@ bool DatabaseQueries::purgeLeftoverMessages(QSqlDatabase db, int account_id) {
 }
 
 bool DatabaseQueries::storeAccountTree(QSqlDatabase db, RootItem *tree_root, int account_id) {
+  return storeAccountItems(db, tree_root->getSubTree(), account_id);
+}
+
+bool DatabaseQueries::storeAccountItems(QSqlDatabase db, const QList<RootItem*> &items, int account_id) {
   QSqlQuery query_category(db);
   QSqlQuery query_feed(db);
   query_category.setForwardOnly(true);
@@ -765,7 +1507,7 @@ bool DatabaseQueries::storeAccountTree(QSqlDatabase db, RootItem *tree_root, int
                      "VALUES (:title, :icon, :category, :protected, :update_type, :update_interval, :account_id, :custom_id);");
 
   // Iterate all children.
-  foreach (RootItem *child, tree_root->getSubTree()) {
+  foreach (RootItem *child, items) {
     if (child->kind() == RootItemKind::Category) {
       query_category.bindValue(QSL(":parent_id"), child->parent()->id());
       query_category.bindValue(QSL(":title"), child->title());
@@ -783,7 +1525,7 @@ bool DatabaseQueries::storeAccountTree(QSqlDatabase db, RootItem *tree_root, int
       Feed *feed = child->toFeed();
 
       query_feed.bindValue(QSL(":title"), feed->title());
-      query_feed.bindValue(QSL(":icon"), qApp->icons()->toByteArray(feed->icon()));
+      query_feed.bindValue(QSL(":icon"), qApp->icons()->toStoreReference(feed->icon()));
       query_feed.bindValue(QSL(":category"), feed->parent()->customId());
       query_feed.bindValue(QSL(":protected"), 0);
       query_feed.bindValue(QSL(":update_type"), (int) feed->autoUpdateType());
@@ -803,6 +1545,40 @@ bool DatabaseQueries::storeAccountTree(QSqlDatabase db, RootItem *tree_root, int
   return true;
 }
 
+bool DatabaseQueries::editCategoryPlacement(QSqlDatabase db, int category_id, int parent_id, const QString &title) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("UPDATE Categories SET parent_id = :parent_id, title = :title WHERE id = :id;"));
+  q.bindValue(QSL(":parent_id"), parent_id);
+  q.bindValue(QSL(":title"), title);
+  q.bindValue(QSL(":id"), category_id);
+
+  if (!q.exec()) {
+    qWarning("Changing placement of category failed: '%s'.", qPrintable(q.lastError().text()));
+    return false;
+  }
+
+  return true;
+}
+
+bool DatabaseQueries::editFeedPlacement(QSqlDatabase db, int feed_id, int parent_custom_id, const QString &title) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+  q.prepare(QSL("UPDATE Feeds SET category = :category, title = :title WHERE id = :id;"));
+  q.bindValue(QSL(":category"), parent_custom_id);
+  q.bindValue(QSL(":title"), title);
+  q.bindValue(QSL(":id"), feed_id);
+
+  if (!q.exec()) {
+    qWarning("Changing placement of feed failed: '%s'.", qPrintable(q.lastError().text()));
+    return false;
+  }
+
+  return true;
+}
+
 QStringList DatabaseQueries::customIdsOfMessagesFromAccount(QSqlDatabase db, int account_id, bool *ok) {
   QSqlQuery q(db);
   QStringList ids;
@@ -916,6 +1692,8 @@ QList<ServiceRoot*> DatabaseQueries::getTtRssAccounts(QSqlDatabase db, bool *ok)
       root->network()->setAuthPassword(TextFactory::decrypt(query.value(5).toString()));
       root->network()->setUrl(query.value(6).toString());
       root->network()->setForceServerSideUpdate(query.value(7).toBool());
+      root->network()->setHeadlinesOnly(query.value(8).toBool());
+      root->network()->setPrefetchContents(query.value(9).toBool());
 
       root->updateTitle();
       roots.append(root);
@@ -1108,7 +1886,11 @@ bool DatabaseQueries::deleteFeed(QSqlDatabase db, int feed_custom_id, int accoun
   q.bindValue(QSL(":feed"), feed_custom_id);
   q.bindValue(QSL(":account_id"), account_id);
 
-  return q.exec();
+  if (!q.exec()) {
+    return false;
+  }
+
+  return true;
 }
 
 bool DatabaseQueries::deleteCategory(QSqlDatabase db, int id) {
@@ -1119,7 +1901,11 @@ bool DatabaseQueries::deleteCategory(QSqlDatabase db, int id) {
   q.prepare(QSL("DELETE FROM Categories WHERE id = :category;"));
   q.bindValue(QSL(":category"), id);
 
-  return q.exec();
+  if (!q.exec()) {
+    return false;
+  }
+
+  return true;
 }
 
 int DatabaseQueries::addCategory(QSqlDatabase db, int parent_id, int account_id, const QString &title,
@@ -1135,7 +1921,7 @@ int DatabaseQueries::addCategory(QSqlDatabase db, int parent_id, int account_id,
   q.bindValue(QSL(":title"), title);
   q.bindValue(QSL(":description"), description);
   q.bindValue(QSL(":date_created"), creation_date.toMSecsSinceEpoch());
-  q.bindValue(QSL(":icon"), qApp->icons()->toByteArray(icon));
+  q.bindValue(QSL(":icon"), qApp->icons()->toStoreReference(icon));
   q.bindValue(QSL(":account_id"), account_id);
 
   if (!q.exec()) {
@@ -1175,7 +1961,7 @@ bool DatabaseQueries::editCategory(QSqlDatabase db, int parent_id, int category_
             "WHERE id = :id;");
   q.bindValue(QSL(":title"), title);
   q.bindValue(QSL(":description"), description);
-  q.bindValue(QSL(":icon"), qApp->icons()->toByteArray(icon));
+  q.bindValue(QSL(":icon"), qApp->icons()->toStoreReference(icon));
   q.bindValue(QSL(":parent_id"), parent_id);
   q.bindValue(QSL(":id"), category_id);
 
@@ -1197,7 +1983,7 @@ int DatabaseQueries::addFeed(QSqlDatabase db, int parent_id, int account_id, con
   q.bindValue(QSL(":title"), title);
   q.bindValue(QSL(":description"), description);
   q.bindValue(QSL(":date_created"), creation_date.toMSecsSinceEpoch());
-  q.bindValue(QSL(":icon"), qApp->icons()->toByteArray(icon));
+  q.bindValue(QSL(":icon"), qApp->icons()->toStoreReference(icon));
   q.bindValue(QSL(":category"), parent_id);
   q.bindValue(QSL(":encoding"), encoding);
   q.bindValue(QSL(":url"), url);
@@ -1255,7 +2041,7 @@ bool DatabaseQueries::editFeed(QSqlDatabase db, int parent_id, int feed_id, cons
             "WHERE id = :id;");
   q.bindValue(QSL(":title"), title);
   q.bindValue(QSL(":description"), description);
-  q.bindValue(QSL(":icon"), qApp->icons()->toByteArray(icon));
+  q.bindValue(QSL(":icon"), qApp->icons()->toStoreReference(icon));
   q.bindValue(QSL(":category"), parent_id);
   q.bindValue(QSL(":encoding"), encoding);
   q.bindValue(QSL(":url"), url);
@@ -1293,6 +2079,247 @@ bool DatabaseQueries::editBaseFeed(QSqlDatabase db, int feed_id, Feed::AutoUpdat
   return q.exec();
 }
 
+bool DatabaseQueries::editFeedIcon(QSqlDatabase db, int feed_id, const QIcon &icon) {
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+  q.prepare("UPDATE Feeds SET icon = :icon WHERE id = :id;");
+  q.bindValue(QSL(":icon"), qApp->icons()->toStoreReference(icon));
+  q.bindValue(QSL(":id"), feed_id);
+
+  return q.exec();
+}
+
+bool DatabaseQueries::migrateLegacyIcons(QSqlDatabase db) {
+  QSqlQuery q(db);
+  bool result = true;
+
+  q.setForwardOnly(true);
+
+  foreach (const QString &table, QStringList() << QSL("Categories") << QSL("Feeds")) {
+    QList<QPair<int,QByteArray> > legacy_icons;
+
+    if (!q.exec(QString("SELECT id, icon FROM %1;").arg(table))) {
+      qWarning("Icons of %s could not be loaded: '%s'.", qPrintable(table), qPrintable(q.lastError().text()));
+      result = false;
+      continue;
+    }
+
+    while (q.next()) {
+      const QByteArray icon = q.value(1).toByteArray();
+
+      if (!icon.isEmpty() && !icon.startsWith(APP_ICON_STORE_PREFIX)) {
+        legacy_icons.append(QPair<int,QByteArray>(q.value(0).toInt(), icon));
+      }
+    }
+
+    q.finish();
+
+    if (legacy_icons.isEmpty()) {
+      continue;
+    }
+
+    qDebug("Moving %d icons of %s to icon store.", legacy_icons.size(), qPrintable(table));
+
+    if (!db.transaction()) {
+      qWarning("Transaction for migration of icons failed: '%s'.", qPrintable(db.lastError().text()));
+      return false;
+    }
+
+    q.prepare(QString("UPDATE %1 SET icon = :icon WHERE id = :id;").arg(table));
+
+    for (int i = 0; i < legacy_icons.size(); i++) {
+      q.bindValue(QSL(":icon"), qApp->icons()->toStoreReference(qApp->icons()->fromStoreReference(legacy_icons.at(i).second)));
+      q.bindValue(QSL(":id"), legacy_icons.at(i).first);
+
+      if (!q.exec()) {
+        qWarning("Icon could not be moved to icon store: '%s'.", qPrintable(q.lastError().text()));
+        db.rollback();
+        return false;
+      }
+    }
+
+    if (!db.commit()) {
+      qWarning("Migration of icons could not be committed: '%s'.", qPrintable(db.lastError().text()));
+      db.rollback();
+      return false;
+    }
+  }
+
+  return result;
+}
+
+bool DatabaseQueries::purgeUnusedIcons(QSqlDatabase db) {
+  QSqlQuery q(db);
+  QSet<QByteArray> used_references;
+
+  q.setForwardOnly(true);
+
+  if (!q.exec(QSL("SELECT icon FROM Categories UNION ALL SELECT icon FROM Feeds;"))) {
+    qWarning("Used icons could not be loaded: '%s'.", qPrintable(q.lastError().text()));
+    return false;
+  }
+
+  while (q.next()) {
+    used_references.insert(q.value(0).toByteArray());
+  }
+
+  // Icons of websites cached by favicon resolver are in use too.
+  used_references.unite(qApp->favicons()->cachedReferences());
+  qApp->icons()->removeUnusedStoredIcons(used_references);
+  return true;
+}
+
+bool DatabaseQueries::addItemsInBulk(QSqlDatabase db, int account_id, const QList<StandardCategory*> &categories,
+                                     const QList<StandardFeed*> &feeds) {
+  if (!db.transaction()) {
+    qWarning("Transaction for bulk insertion of items failed: '%s'.", qPrintable(db.lastError().text()));
+    return false;
+  }
+
+  const QStringList category_columns = QStringList() << QSL("parent_id") << QSL("title") << QSL("description")
+                                                     << QSL("date_created") << QSL("icon");
+  const QStringList feed_columns = QStringList() << QSL("title") << QSL("description") << QSL("date_created")
+                                                 << QSL("icon") << QSL("category") << QSL("encoding") << QSL("url")
+                                                 << QSL("protected") << QSL("username") << QSL("password")
+                                                 << QSL("update_type") << QSL("update_interval") << QSL("type");
+  QList<QVariantList> rows;
+  QList<RootItem*> items;
+
+  for (int i = 0; i <= categories.size(); i++) {
+    StandardCategory *category = i < categories.size() ? categories.at(i) : nullptr;
+
+    // Category can be inserted only after its parent has its ID, so batch
+    // is stored once it is full or once parent of next category is in it.
+    if (!items.isEmpty() &&
+        (category == nullptr || items.size() >= IMPORT_INSERT_BATCH_SIZE || items.contains(category->parent()))) {
+      if (!insertItemsBatch(db, QSL("Categories"), category_columns, rows, items, account_id)) {
+        db.rollback();
+        return false;
+      }
+
+      rows.clear();
+      items.clear();
+    }
+
+    if (category != nullptr) {
+      rows.append(QVariantList() << category->parent()->id() << category->title() << category->description()
+                                 << category->creationDate().toMSecsSinceEpoch()
+                                 << qApp->icons()->toStoreReference(category->icon()));
+      items.append(category);
+    }
+  }
+
+  for (int i = 0; i < feeds.size(); i++) {
+    StandardFeed *feed = feeds.at(i);
+
+    rows.append(QVariantList() << feed->title() << feed->description() << feed->creationDate().toMSecsSinceEpoch()
+                               << qApp->icons()->toStoreReference(feed->icon()) << feed->parent()->id()
+                               << feed->encoding() << feed->url() << (feed->passwordProtected() ? 1 : 0)
+                               << feed->username()
+                               << (feed->password().isEmpty() ? feed->password() : TextFactory::encrypt(feed->password()))
+                               << (int) feed->autoUpdateType() << feed->autoUpdateInitialInterval() << (int) feed->type());
+    items.append(feed);
+
+    if (items.size() >= IMPORT_INSERT_BATCH_SIZE || i == feeds.size() - 1) {
+      if (!insertItemsBatch(db, QSL("Feeds"), feed_columns, rows, items, account_id)) {
+        db.rollback();
+        return false;
+      }
+
+      rows.clear();
+      items.clear();
+    }
+  }
+
+  if (!db.commit()) {
+    qWarning("Committing of bulk insertion of items failed: '%s'.", qPrintable(db.lastError().text()));
+    db.rollback();
+    return false;
+  }
+
+  return true;
+}
+
+bool DatabaseQueries::insertItemsBatch(QSqlDatabase db, const QString &table, const QStringList &columns,
+                                       const QList<QVariantList> &rows, const QList<RootItem*> &items, int account_id) {
+  // Each row gets temporary custom ID, so that primary IDs of
+  // all rows can be obtained with single query afterwards.
+  static const QString temporary_id_prefix = QSL("bulk-");
+  QStringList row_placeholders;
+  QSqlQuery q(db);
+
+  q.setForwardOnly(true);
+
+  for (int i = 0; i < rows.size(); i++) {
+    QStringList placeholders;
+
+    foreach (const QString &column, columns) {
+      placeholders.append(QString(QSL(":%1_%2")).arg(column, QString::number(i)));
+    }
+
+    placeholders << QString(QSL(":account_id_%1")).arg(i) << QString(QSL(":custom_id_%1")).arg(i);
+    row_placeholders.append(QString(QSL("(%1)")).arg(placeholders.join(QSL(", "))));
+  }
+
+  q.prepare(QString(QSL("INSERT INTO %1 (%2, account_id, custom_id) VALUES %3;")).arg(table,
+                                                                                      columns.join(QSL(", ")),
+                                                                                      row_placeholders.join(QSL(", "))));
+
+  for (int i = 0; i < rows.size(); i++) {
+    for (int j = 0; j < columns.size(); j++) {
+      q.bindValue(QString(QSL(":%1_%2")).arg(columns.at(j), QString::number(i)), rows.at(i).at(j));
+    }
+
+    q.bindValue(QString(QSL(":account_id_%1")).arg(i), account_id);
+    q.bindValue(QString(QSL(":custom_id_%1")).arg(i), temporary_id_prefix + QString::number(i));
+  }
+
+  if (!q.exec()) {
+    qWarning("Bulk insertion into table '%s' failed: '%s'.", qPrintable(table), qPrintable(q.lastError().text()));
+    return false;
+  }
+
+  q.prepare(QString(QSL("SELECT id, custom_id FROM %1 WHERE account_id = :account_id AND custom_id LIKE :prefix;")).arg(table));
+  q.bindValue(QSL(":account_id"), account_id);
+  q.bindValue(QSL(":prefix"), temporary_id_prefix + QL1C('%'));
+
+  if (!q.exec()) {
+    qWarning("Obtaining IDs of inserted items failed: '%s'.", qPrintable(q.lastError().text()));
+    return false;
+  }
+
+  int assigned_ids = 0;
+
+  while (q.next()) {
+    const int index = q.value(1).toString().mid(temporary_id_prefix.size()).toInt();
+    const int new_id = q.value(0).toInt();
+
+    if (index >= 0 && index < items.size()) {
+      items.at(index)->setId(new_id);
+      items.at(index)->setCustomId(new_id);
+      assigned_ids++;
+    }
+  }
+
+  if (assigned_ids != items.size()) {
+    qWarning("Only %d of %d inserted items obtained their IDs.", assigned_ids, items.size());
+    return false;
+  }
+
+  // Now set real custom IDs in the DB.
+  q.prepare(QString(QSL("UPDATE %1 SET custom_id = id WHERE account_id = :account_id AND custom_id LIKE :prefix;")).arg(table));
+  q.bindValue(QSL(":account_id"), account_id);
+  q.bindValue(QSL(":prefix"), temporary_id_prefix + QL1C('%'));
+
+  if (!q.exec()) {
+    qWarning("Setting of custom IDs of inserted items failed: '%s'.", qPrintable(q.lastError().text()));
+    return false;
+  }
+
+  return true;
+}
+
 QList<ServiceRoot*> DatabaseQueries::getAccounts(QSqlDatabase db, bool *ok) {
   QSqlQuery q(db);
   QList<ServiceRoot*> roots;
@@ -1416,12 +2443,14 @@ bool DatabaseQueries::deleteTtRssAccount(QSqlDatabase db, int account_id) {
 
 bool DatabaseQueries::overwriteTtRssAccount(QSqlDatabase db, const QString &username, const QString &password,
                                             bool auth_protected, const QString &auth_username, const QString &auth_password,
-                                            const QString &url, bool force_server_side_feed_update, int account_id) {
+                                            const QString &url, bool force_server_side_feed_update, bool headlines_only,
+                                            bool prefetch_contents, int account_id) {
   QSqlQuery q(db);
 
   q.prepare("UPDATE TtRssAccounts "
             "SET username = :username, password = :password, url = :url, auth_protected = :auth_protected, "
-            "auth_username = :auth_username, auth_password = :auth_password, force_update = :force_update "
+            "auth_username = :auth_username, auth_password = :auth_password, force_update = :force_update, "
+            "headlines_only = :headlines_only, prefetch_contents = :prefetch_contents "
             "WHERE id = :id;");
   q.bindValue(QSL(":username"), username);
   q.bindValue(QSL(":password"), TextFactory::encrypt(password));
@@ -1430,6 +2459,8 @@ bool DatabaseQueries::overwriteTtRssAccount(QSqlDatabase db, const QString &user
   q.bindValue(QSL(":auth_username"), auth_username);
   q.bindValue(QSL(":auth_password"), TextFactory::encrypt(auth_password));
   q.bindValue(QSL(":force_update"), force_server_side_feed_update ? 1 : 0);
+  q.bindValue(QSL(":headlines_only"), headlines_only ? 1 : 0);
+  q.bindValue(QSL(":prefetch_contents"), prefetch_contents ? 1 : 0);
   q.bindValue(QSL(":id"), account_id);
 
   if (q.exec()) {
@@ -1444,11 +2475,13 @@ bool DatabaseQueries::overwriteTtRssAccount(QSqlDatabase db, const QString &user
 bool DatabaseQueries::createTtRssAccount(QSqlDatabase db, int id_to_assign, const QString &username,
                                          const QString &password, bool auth_protected, const QString &auth_username,
                                          const QString &auth_password, const QString &url,
-                                         bool force_server_side_feed_update) {
+                                         bool force_server_side_feed_update, bool headlines_only, bool prefetch_contents) {
   QSqlQuery q(db);
 
-  q.prepare("INSERT INTO TtRssAccounts (id, username, password, auth_protected, auth_username, auth_password, url, force_update) "
-            "VALUES (:id, :username, :password, :auth_protected, :auth_username, :auth_password, :url, :force_update);");
+  q.prepare("INSERT INTO TtRssAccounts (id, username, password, auth_protected, auth_username, auth_password, url, force_update, "
+            "headlines_only, prefetch_contents) "
+            "VALUES (:id, :username, :password, :auth_protected, :auth_username, :auth_password, :url, :force_update, "
+            ":headlines_only, :prefetch_contents);");
   q.bindValue(QSL(":id"), id_to_assign);
   q.bindValue(QSL(":username"), username);
   q.bindValue(QSL(":password"), TextFactory::encrypt(password));
@@ -1457,6 +2490,8 @@ bool DatabaseQueries::createTtRssAccount(QSqlDatabase db, int id_to_assign, cons
   q.bindValue(QSL(":auth_password"), TextFactory::encrypt(auth_password));
   q.bindValue(QSL(":url"), url);
   q.bindValue(QSL(":force_update"), force_server_side_feed_update ? 1 : 0);
+  q.bindValue(QSL(":headlines_only"), headlines_only ? 1 : 0);
+  q.bindValue(QSL(":prefetch_contents"), prefetch_contents ? 1 : 0);
 
   if (q.exec()) {
     return true;
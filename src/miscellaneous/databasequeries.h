@@ -22,16 +22,22 @@
 
 #include "services/abstract/serviceroot.h"
 #include "services/standard/standardfeed.h"
+#include "miscellaneous/retentionengine.h"
+#include "core/feedupdatetelemetry.h"
 
 #include <QSqlQuery>
+#include <QVector>
 
 
+class StandardCategory;
+
 class DatabaseQueries {
   public:
     // Mark read/unread/starred/delete messages.
     static bool markMessagesReadUnread(QSqlDatabase db, const QStringList &ids, RootItem::ReadStatus read);
     static bool markMessageImportant(QSqlDatabase db, int id, RootItem::Importance importance);
     static bool markFeedsReadUnread(QSqlDatabase db, const QStringList &ids, int account_id, RootItem::ReadStatus read);
+    static bool markCategoryReadUnread(QSqlDatabase db, int category_id, int account_id, RootItem::ReadStatus read);
     static bool markBinReadUnread(QSqlDatabase db, int account_id, RootItem::ReadStatus read);
     static bool markAccountReadUnread(QSqlDatabase db, int account_id, RootItem::ReadStatus read);
     static bool switchMessagesImportance(QSqlDatabase db, const QStringList &ids);
@@ -44,6 +50,44 @@ class DatabaseQueries {
     static bool purgeReadMessages(QSqlDatabase db);
     static bool purgeOldMessages(QSqlDatabase db, int older_than_days);
     static bool purgeRecycleBin(QSqlDatabase db);
+
+    // Retention.
+    static QHash<QPair<int,int>,RetentionPolicy> getRetentionPolicies(QSqlDatabase db, bool *ok = NULL);
+    static QList<QPair<int,int> > getFeedsWithMessages(QSqlDatabase db, bool *ok = NULL);
+    static QStringList getExpiredMessages(QSqlDatabase db, int account_id, int feed_id,
+                                          const RetentionPolicy &policy, int limit, bool *ok = NULL);
+    static bool removeMessages(QSqlDatabase db, const QStringList &ids);
+
+    // Marks messages as purged and drops their contents, rows are kept
+    // so that messages still present in feeds are not downloaded again.
+    static bool purgeMessages(QSqlDatabase db, const QStringList &ids);
+
+    // Compressed archive of contents of old messages.
+    static QString getArchivedContents(QSqlDatabase db, int message_id, bool *ok = NULL);
+    static QHash<int,QString> getArchivedContents(QSqlDatabase db, const QList<int> &message_ids, bool *ok = NULL);
+
+    // Fills contents of archived messages from given list, using single query.
+    static bool loadArchivedContents(QSqlDatabase db, QList<Message> &messages);
+    static int archiveMessages(QSqlDatabase db, qint64 older_than, int limit, bool *ok = NULL);
+    static bool removeOrphanedArchivedContents(QSqlDatabase db);
+
+    // Contents of messages synchronized without contents (only headline and excerpt).
+    // NOTE: "is_partial" is set to false if full contents of the message are already stored.
+    static QString getMessageContents(QSqlDatabase db, int message_id, bool *is_partial, bool *ok = NULL);
+    static bool storeMessagesContents(QSqlDatabase db, const QList<Message> &messages, int account_id);
+
+    // Marks messages as complete, their stored excerpts are kept as contents.
+    static bool clearPartialMessages(QSqlDatabase db, const QStringList &custom_ids, int account_id);
+
+    // Returns primary IDs of partial messages keyed by their custom IDs.
+    static QHash<QString,int> getPartialMessagesIds(QSqlDatabase db, int account_id, int limit, bool *ok = NULL);
+
+    // Telemetry of feed updates, records are sorted by date.
+    // NOTE: All records are purged if "older_than" is invalid.
+    static bool storeUpdateTelemetry(QSqlDatabase db, const QList<FeedUpdateTelemetry> &telemetry);
+    static QList<FeedUpdateTelemetry> getUpdateTelemetry(QSqlDatabase db, const QDateTime &since, bool *ok = NULL);
+    static bool purgeUpdateTelemetry(QSqlDatabase db, const QDateTime &older_than = QDateTime());
+
     static bool purgeMessagesFromBin(QSqlDatabase db, bool clear_only_read, int account_id);
     static bool purgeLeftoverMessages(QSqlDatabase db, int account_id);
 
@@ -56,10 +100,16 @@ class DatabaseQueries {
                                        bool including_total_counts, bool *ok = NULL);
     static int getMessageCountsForBin(QSqlDatabase db, int account_id, bool including_total_counts, bool *ok = NULL);
 
-    // Get messages (for newspaper view for example).
-    static QList<Message> getUndeletedMessagesForFeed(QSqlDatabase db, int feed_custom_id, int account_id, bool *ok = NULL);
-    static QList<Message> getUndeletedMessagesForBin(QSqlDatabase db, int account_id, bool *ok = NULL);
-    static QList<Message> getUndeletedMessagesForAccount(QSqlDatabase db, int account_id, bool *ok = NULL);
+    // Get ordering keys (creation date and id) of all messages which match
+    // given filter. Newest messages come first.
+    static QVector<QPair<qint64,int> > getMessageKeys(QSqlDatabase db, const QString &filter, bool *ok = NULL);
+
+    // Get at most "limit" messages which match given filter, starting with message
+    // with given ordering key (keyset pagination). Ordering is same as for getMessageKeys().
+    // Returns records of messages with given IDs, which match the filter.
+    static QList<QSqlRecord> getMessageRecords(QSqlDatabase db, const QString &filter, const QList<int> &ids, bool *ok = NULL);
+    static QList<Message> getMessagesPage(QSqlDatabase db, const QString &filter, qint64 from_date, int from_id,
+                                          int limit, bool *ok = NULL);
 
     // Custom ID accumulators.
     static QStringList customIdsOfMessagesFromAccount(QSqlDatabase db, int account_id, bool *ok = NULL);
@@ -67,15 +117,41 @@ class DatabaseQueries {
     static QStringList customIdsOfMessagesFromFeed(QSqlDatabase db, int feed_custom_id, int account_id, bool *ok = NULL);
 
     // Common accounts methods.
+    // NOTE: If "changes" is given, IDs of inserted/updated messages are reported in it.
     static int updateMessages(QSqlDatabase db, const QList<Message> &messages, int feed_custom_id,
-                              int account_id, const QString &url, bool *any_message_changed, bool *ok = NULL);
+                              int account_id, const QString &url, bool *any_message_changed, bool *ok = NULL,
+                              MessagesChanges *changes = NULL);
     static bool deleteAccount(QSqlDatabase db, int account_id);
     static bool deleteAccountData(QSqlDatabase db, int account_id, bool delete_messages_too);
     static bool cleanFeeds(QSqlDatabase db, const QStringList &ids, bool clean_read_only, int account_id);
+    static bool cleanCategory(QSqlDatabase db, int category_id, bool clean_read_only, int account_id);
+
+    // Synchronizes stored (category, feed) ancestry pairs of given account, so that
+    // they equal to given pairs. Feeds are identified by custom IDs, NO_PARENT_CATEGORY
+    // stands for account root.
+    static bool updateFeedAncestry(QSqlDatabase db, int account_id, const QList<QPair<int,int> > &ancestry);
 
     static bool storeAccountTree(QSqlDatabase db, RootItem *tree_root, int account_id);
+
+    // Stores given categories and feeds of remote account, parents
+    // must be assigned to all items and must precede their children.
+    static bool storeAccountItems(QSqlDatabase db, const QList<RootItem*> &items, int account_id);
+
+    // Renames and/or moves category/feed of remote account.
+    static bool editCategoryPlacement(QSqlDatabase db, int category_id, int parent_id, const QString &title);
+    static bool editFeedPlacement(QSqlDatabase db, int feed_id, int parent_custom_id, const QString &title);
     static bool editBaseFeed(QSqlDatabase db, int feed_id, Feed::AutoUpdateType auto_update_type,
                              int auto_update_interval);
+    static bool editFeedIcon(QSqlDatabase db, int feed_id, const QIcon &icon);
+
+    // Moves icons which are still stored inline as Base64 data to icon store,
+    // does nothing if all icons are already stored there.
+    static bool migrateLegacyIcons(QSqlDatabase db);
+
+    // Removes icons, which are not used by any category or feed nor
+    // by favicon cache, from icon store.
+    // NOTE: Icon files are removed immediately, call this outside of transactions.
+    static bool purgeUnusedIcons(QSqlDatabase db);
 
     // ownCloud account.
     static QList<ServiceRoot*> getOwnCloudAccounts(QSqlDatabase db, bool *ok = NULL);
@@ -106,6 +182,12 @@ class DatabaseQueries {
                          const QString &encoding, const QString &url, bool is_protected,
                          const QString &username, const QString &password, Feed::AutoUpdateType auto_update_type,
                          int auto_update_interval, StandardFeed::Type feed_format);
+
+    // Stores many new categories and feeds in single transaction using multi-row
+    // statements. Parent of each item must be already stored or precede
+    // the item in the list. Primary IDs are assigned to all items.
+    static bool addItemsInBulk(QSqlDatabase db, int account_id, const QList<StandardCategory*> &categories,
+                               const QList<StandardFeed*> &feeds);
     static QList<ServiceRoot*> getAccounts(QSqlDatabase db, bool *ok = NULL);
     static Assignment getCategories(QSqlDatabase db, int account_id, bool *ok = NULL);
     static Assignment getFeeds(QSqlDatabase db, int account_id, bool *ok = NULL);
@@ -115,15 +197,25 @@ class DatabaseQueries {
     static bool deleteTtRssAccount(QSqlDatabase db, int account_id);
     static bool overwriteTtRssAccount(QSqlDatabase db, const QString &username, const QString &password,
                                       bool auth_protected, const QString &auth_username, const QString &auth_password,
-                                      const QString &url, bool force_server_side_feed_update, int account_id);
+                                      const QString &url, bool force_server_side_feed_update, bool headlines_only,
+                                      bool prefetch_contents, int account_id);
     static bool createTtRssAccount(QSqlDatabase db, int id_to_assign, const QString &username,
                                    const QString &password, bool auth_protected, const QString &auth_username,
                                    const QString &auth_password, const QString &url,
-                                   bool force_server_side_feed_update);
+                                   bool force_server_side_feed_update, bool headlines_only, bool prefetch_contents);
     static Assignment getTtRssCategories(QSqlDatabase db, int account_id, bool *ok = NULL);
     static Assignment getTtRssFeeds(QSqlDatabase db, int account_id, bool *ok = NULL);
 
   private:
+    // Deletes messages matching given condition in small chunks,
+    // so that database is not locked for the whole time.
+    static bool removeMessagesInChunks(QSqlDatabase db, const QString &condition, const QVariantMap &values);
+
+    // Inserts rows into given table with single statement and assigns
+    // primary IDs to corresponding items.
+    static bool insertItemsBatch(QSqlDatabase db, const QString &table, const QStringList &columns,
+                                 const QList<QVariantList> &rows, const QList<RootItem*> &items, int account_id);
+
     explicit DatabaseQueries();
 };
 
@@ -18,13 +18,21 @@
 #include "miscellaneous/debugging.h"
 
 #include "miscellaneous/application.h"
+#include "miscellaneous/settings.h"
 
 #include <QDir>
+#include <QStringList>
 
 #include <cstdio>
 #include <cstdlib>
 
 
+Q_LOGGING_CATEGORY(LOGNETWORK, "rssguard.network", QtInfoMsg)
+Q_LOGGING_CATEGORY(LOGPARSER, "rssguard.parser", QtInfoMsg)
+Q_LOGGING_CATEGORY(LOGDB, "rssguard.db", QtInfoMsg)
+Q_LOGGING_CATEGORY(LOGMODEL, "rssguard.model", QtInfoMsg)
+Q_LOGGING_CATEGORY(LOGGUI, "rssguard.gui", QtInfoMsg)
+
 Debugging::Debugging() {
 }
 
@@ -62,6 +70,25 @@ const char *Debugging::typeToString(QtMsgType type) {
   }
 }
 
+QStringList Debugging::loggingCategories() {
+  return QStringList() << QL1S(LOGNETWORK().categoryName()) << QL1S(LOGPARSER().categoryName()) <<
+                          QL1S(LOGDB().categoryName()) << QL1S(LOGMODEL().categoryName()) <<
+                          QL1S(LOGGUI().categoryName());
+}
+
+void Debugging::applyLoggingCategories() {
+  const QString enabled_setting = qApp->settings()->value(GROUP(General), SETTING(General::LoggingCategories)).toString();
+  const QStringList enabled_categories = enabled_setting.split(QL1C(','), QString::SkipEmptyParts);
+  QStringList rules;
+
+  foreach (const QString &category, loggingCategories()) {
+    rules.append(QString(QSL("%1.debug=%2")).arg(category, enabled_categories.contains(category) ? QSL("true") : QSL("false")));
+  }
+
+  // NOTE: Rules from QT_LOGGING_RULES environment variable still take precedence.
+  QLoggingCategory::setFilterRules(rules.join(QL1C('\n')));
+}
+
 void Debugging::debugHandler(QtMsgType type, const QMessageLogContext &placement, const QString &message) {
 #ifndef QT_NO_DEBUG_OUTPUT
   performLog(qPrintable(message), type, placement.file, placement.function, placement.line);
@@ -19,6 +19,19 @@
 #define DEBUGGING_H
 
 #include <QtGlobal>
+#include <QLoggingCategory>
+
+
+class QStringList;
+
+// Categories of debug output produced in hot paths. Their debug
+// messages are disabled by default, so that disabled qCDebug calls
+// do not even evaluate their arguments.
+Q_DECLARE_LOGGING_CATEGORY(LOGNETWORK)
+Q_DECLARE_LOGGING_CATEGORY(LOGPARSER)
+Q_DECLARE_LOGGING_CATEGORY(LOGDB)
+Q_DECLARE_LOGGING_CATEGORY(LOGMODEL)
+Q_DECLARE_LOGGING_CATEGORY(LOGGUI)
 
 
 class Debugging {
@@ -29,6 +42,13 @@ class Debugging {
     static void performLog(const char *message, QtMsgType type, const char *file = 0, const char *function = 0, int line = -1);
     static const char *typeToString(QtMsgType type);
 
+    // Returns names of all hot path logging categories.
+    static QStringList loggingCategories();
+
+    // Enables debug output of logging categories which
+    // are enabled in settings and disables the rest.
+    static void applyLoggingCategories();
+
   private:
     // Constructor.
     explicit Debugging();
@@ -27,8 +27,11 @@
 #include "core/messagesproxymodel.h"
 #include "core/feeddownloader.h"
 #include "miscellaneous/databasecleaner.h"
+#include "miscellaneous/databasebackuper.h"
+#include "miscellaneous/retentionengine.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/mutex.h"
+#include "miscellaneous/tracer.h"
 
 #include <QThread>
 #include <QTimer>
@@ -37,7 +40,8 @@
 FeedReader::FeedReader(QObject *parent)
   : QObject(parent), m_feedServices(QList<ServiceEntryPoint*>()), m_autoUpdateTimer(new QTimer(this)),
     m_feedDownloaderThread(nullptr), m_feedDownloader(nullptr),
-    m_dbCleanerThread(nullptr), m_dbCleaner(nullptr) {
+    m_dbCleanerThread(nullptr), m_dbCleaner(nullptr), m_dbBackuperThread(nullptr), m_dbBackuper(nullptr),
+    m_retentionTimer(new QTimer(this)), m_retentionThread(nullptr), m_retentionEngine(nullptr) {
   m_feedsModel = new FeedsModel(this);
   m_feedsProxyModel = new FeedsProxyModel(m_feedsModel, this);
   m_messagesModel = new MessagesModel(this);
@@ -50,6 +54,13 @@ FeedReader::FeedReader(QObject *parent)
     qDebug("Requesting update for all feeds on application startup.");
     QTimer::singleShot(STARTUP_UPDATE_DELAY, this, SLOT(updateAllFeeds()));
   }
+
+  connect(m_retentionTimer, &QTimer::timeout, this, &FeedReader::executeRetention);
+  updateRetentionStatus();
+
+  if (isRetentionEnabled()) {
+    QTimer::singleShot(RETENTION_STARTUP_DELAY, this, SLOT(executeRetention()));
+  }
 }
 
 FeedReader::~FeedReader() {
@@ -69,6 +80,9 @@ QList<ServiceEntryPoint*> FeedReader::feedServices() {
 }
 
 void FeedReader::updateFeeds(const QList<Feed*> &feeds) {
+  TraceSpan span("feeds", "FeedReader::updateFeeds");
+  span.setArgument("feeds", feeds.size());
+
   if (!qApp->feedUpdateLock()->tryLock()) {
     qApp->showGuiMessage(tr("Cannot update all items"),
                          tr("You cannot update all items because another critical operation is ongoing."),
@@ -79,6 +93,7 @@ void FeedReader::updateFeeds(const QList<Feed*> &feeds) {
   if (m_feedDownloader == nullptr) {
     m_feedDownloader = new FeedDownloader();
     m_feedDownloaderThread = new QThread();
+    m_feedDownloaderThread->setObjectName(QSL("FeedDownloader"));
 
     // Downloader setup.
     qRegisterMetaType<QList<Feed*> >("QList<Feed*>");
@@ -128,6 +143,51 @@ void FeedReader::stopRunningFeedUpdate() {
   }
 }
 
+void FeedReader::updateRetentionStatus() {
+  const int interval_hours = qBound(1, qApp->settings()->value(GROUP(Database), SETTING(Database::RetentionInterval)).toInt(),
+                                    24 * 7);
+
+  if (isRetentionEnabled()) {
+    m_retentionTimer->start(interval_hours * 3600000);
+    qDebug("Retention timer started with interval %d hours.", interval_hours);
+  }
+  else {
+    m_retentionTimer->stop();
+  }
+}
+
+bool FeedReader::isRetentionEnabled() const {
+  return qApp->settings()->value(GROUP(Database), SETTING(Database::RetentionEnabled)).toBool() ||
+         qApp->settings()->value(GROUP(Database), SETTING(Database::ArchiveEnabled)).toBool();
+}
+
+void FeedReader::executeRetention() {
+  if (!isRetentionEnabled()) {
+    return;
+  }
+
+  RetentionOrders orders;
+
+  orders.m_removeExpiredMessages = qApp->settings()->value(GROUP(Database), SETTING(Database::RetentionEnabled)).toBool();
+  orders.m_defaultPolicy.m_maxAge = qApp->settings()->value(GROUP(Database), SETTING(Database::RetentionMaxAge)).toInt();
+  orders.m_defaultPolicy.m_maxCount = qApp->settings()->value(GROUP(Database), SETTING(Database::RetentionMaxCount)).toInt();
+  orders.m_defaultPolicy.m_keepStarred = qApp->settings()->value(GROUP(Database), SETTING(Database::RetentionKeepStarred)).toBool();
+
+  if (qApp->settings()->value(GROUP(Database), SETTING(Database::ArchiveEnabled)).toBool()) {
+    orders.m_archiveAfterDays = qApp->settings()->value(GROUP(Database), SETTING(Database::ArchiveAfter)).toInt();
+  }
+
+  QMetaObject::invokeMethod(retentionEngine(), "startRetention", Q_ARG(RetentionOrders, orders));
+}
+
+void FeedReader::onRetentionFinished(int removed_messages, qint64 reclaimed_bytes) {
+  if (removed_messages > 0) {
+    m_feedsModel->reloadCountsOfWholeModel();
+  }
+
+  emit retentionFinished(removed_messages, reclaimed_bytes);
+}
+
 bool FeedReader::isFeedUpdateRunning() const {
   return m_feedDownloader != nullptr && m_feedDownloader->isUpdateRunning();
 }
@@ -149,6 +209,46 @@ DatabaseCleaner *FeedReader::databaseCleaner() {
   return m_dbCleaner;
 }
 
+DatabaseBackuper *FeedReader::databaseBackuper() {
+  if (m_dbBackuper == nullptr) {
+    m_dbBackuper = new DatabaseBackuper();
+    m_dbBackuperThread = new QThread();
+
+    m_dbBackuper->moveToThread(m_dbBackuperThread);
+    connect(m_dbBackuperThread, &QThread::finished, m_dbBackuperThread, &QThread::deleteLater);
+
+    m_dbBackuperThread->start();
+  }
+
+  return m_dbBackuper;
+}
+
+RetentionEngine *FeedReader::retentionEngine() {
+  if (m_retentionEngine == nullptr) {
+    m_retentionEngine = new RetentionEngine();
+    m_retentionThread = new QThread();
+
+    // Engine setup.
+    qRegisterMetaType<RetentionOrders>("RetentionOrders");
+    m_retentionEngine->moveToThread(m_retentionThread);
+    connect(m_retentionThread, &QThread::finished, m_retentionThread, &QThread::deleteLater);
+    connect(m_retentionEngine, &RetentionEngine::retentionFinished, this, &FeedReader::onRetentionFinished);
+    connect(m_retentionEngine, &RetentionEngine::messagesRemoved, m_feedsModel, &FeedsModel::messagesChangesAvailable);
+
+    // Retention yields to running feed updates.
+    connect(this, &FeedReader::feedUpdatesStarted, m_retentionEngine, &RetentionEngine::pause);
+    connect(this, &FeedReader::feedUpdatesFinished, m_retentionEngine, &RetentionEngine::resume);
+
+    m_retentionThread->start();
+
+    if (isFeedUpdateRunning()) {
+      QMetaObject::invokeMethod(m_retentionEngine, "pause");
+    }
+  }
+
+  return m_retentionEngine;
+}
+
 FeedDownloader *FeedReader::feedDownloader() const {
   return m_feedDownloader;
 }
@@ -202,6 +302,8 @@ void FeedReader::stop() {
     m_autoUpdateTimer->stop();
   }
 
+  m_retentionTimer->stop();
+
   // Close worker threads.
   if (m_feedDownloaderThread != nullptr && m_feedDownloaderThread->isRunning()) {
     m_feedDownloader->stopRunningUpdate();
@@ -231,6 +333,28 @@ void FeedReader::stop() {
     }
   }
 
+  if (m_dbBackuperThread != nullptr && m_dbBackuperThread->isRunning()) {
+    qDebug("Quitting database backuper thread.");
+    m_dbBackuper->stopRunningBackup();
+    m_dbBackuperThread->quit();
+
+    if (!m_dbBackuperThread->wait(CLOSE_LOCK_TIMEOUT)) {
+      qCritical("Database backuper thread is running despite it was told to quit. Terminating it.");
+      m_dbBackuperThread->terminate();
+    }
+  }
+
+  if (m_retentionThread != nullptr && m_retentionThread->isRunning()) {
+    qDebug("Quitting retention thread.");
+    QMetaObject::invokeMethod(m_retentionEngine, "stopRetention", Qt::BlockingQueuedConnection);
+    m_retentionThread->quit();
+
+    if (!m_retentionThread->wait(CLOSE_LOCK_TIMEOUT)) {
+      qCritical("Retention thread is running despite it was told to quit. Terminating it.");
+      m_retentionThread->terminate();
+    }
+  }
+
   // Close workers.
   if (m_feedDownloader != nullptr) {
     qDebug("Feed downloader exists. Deleting it from memory.");
@@ -242,6 +366,16 @@ void FeedReader::stop() {
     m_dbCleaner->deleteLater();
   }
 
+  if (m_dbBackuper != nullptr) {
+    qDebug("Database backuper exists. Deleting it from memory.");
+    m_dbBackuper->deleteLater();
+  }
+
+  if (m_retentionEngine != nullptr) {
+    qDebug("Retention engine exists. Deleting it from memory.");
+    m_retentionEngine->deleteLater();
+  }
+
   if (qApp->settings()->value(GROUP(Messages), SETTING(Messages::ClearReadOnExit)).toBool()) {
     m_feedsModel->markItemCleared(m_feedsModel->rootItem(), true);
   }
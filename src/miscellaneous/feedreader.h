@@ -30,6 +30,8 @@ class MessagesProxyModel;
 class FeedsProxyModel;
 class ServiceEntryPoint;
 class DatabaseCleaner;
+class DatabaseBackuper;
+class RetentionEngine;
 class QTimer;
 
 class FeedReader : public QObject {
@@ -46,6 +48,12 @@ class FeedReader : public QObject {
     // Access to DB cleaner.
     DatabaseCleaner *databaseCleaner();
 
+    // Access to DB backuper.
+    DatabaseBackuper *databaseBackuper();
+
+    // Access to retention engine.
+    RetentionEngine *retentionEngine();
+
     FeedDownloader *feedDownloader() const;
     FeedsModel *feedsModel() const;
     MessagesModel *messagesModel() const;
@@ -61,6 +69,13 @@ class FeedReader : public QObject {
     // and starts/stop the timer as needed.
     void updateAutoUpdateStatus();
 
+    // Resets retention interval according to settings.
+    void updateRetentionStatus();
+
+    // Returns true if removing of expired messages
+    // or archiving of old contents is enabled.
+    bool isRetentionEnabled() const;
+
   public slots:   
     // Schedules all feeds from all accounts for update.
     void updateAllFeeds();
@@ -71,11 +86,18 @@ class FeedReader : public QObject {
     // Is executed when next auto-update round could be done.
     void executeNextAutoUpdate();
 
+    // Starts retention round in background if it is enabled.
+    void executeRetention();
+    void onRetentionFinished(int removed_messages, qint64 reclaimed_bytes);
+
   signals:
     void feedUpdatesStarted();
     void feedUpdatesFinished(FeedDownloadResults updated_feeds);
     void feedUpdatesProgress(const Feed *feed, int current, int total);
 
+    // Emitted when background retention round finishes, counts of items are already reloaded.
+    void retentionFinished(int removed_messages, qint64 reclaimed_bytes);
+
   private:
     QList<ServiceEntryPoint*> m_feedServices;
 
@@ -95,6 +117,13 @@ class FeedReader : public QObject {
 
     QThread *m_dbCleanerThread;
     DatabaseCleaner *m_dbCleaner;
+
+    QThread *m_dbBackuperThread;
+    DatabaseBackuper *m_dbBackuper;
+
+    QTimer *m_retentionTimer;
+    QThread *m_retentionThread;
+    RetentionEngine *m_retentionEngine;
 };
 
 #endif // FEEDREADER_H
@@ -20,9 +20,13 @@
 #include "miscellaneous/settings.h"
 
 #include <QBuffer>
+#include <QCryptographicHash>
+#include <QFile>
+#include <QFileInfo>
 
 
-IconFactory::IconFactory(QObject *parent) : QObject(parent) {
+IconFactory::IconFactory(QObject *parent) : QObject(parent), m_storedIcons(QHash<QByteArray,QIcon>()),
+  m_storedReferences(QHash<qint64,QByteArray>()) {
 }
 
 IconFactory::~IconFactory() {
@@ -57,6 +61,122 @@ QByteArray IconFactory::toByteArray(const QIcon &icon) {
   return array.toBase64();
 }
 
+QByteArray IconFactory::toStoreReference(const QIcon &icon) {
+  if (icon.isNull()) {
+    return QByteArray();
+  }
+  else if (m_storedReferences.contains(icon.cacheKey())) {
+    // This very icon is already in the store, no need to encode it again.
+    return m_storedReferences.value(icon.cacheKey());
+  }
+
+  // Store the largest available version of the icon.
+  QSize size(64, 64);
+
+  foreach (const QSize &available_size, icon.availableSizes()) {
+    if (available_size.width() * available_size.height() > size.width() * size.height()) {
+      size = available_size;
+    }
+  }
+
+  QByteArray png_data;
+  QBuffer buffer(&png_data);
+
+  buffer.open(QIODevice::WriteOnly);
+  icon.pixmap(size).save(&buffer, "PNG");
+  buffer.close();
+
+  const QByteArray hash = QCryptographicHash::hash(png_data, QCryptographicHash::Sha1).toHex();
+  const QString file_path = iconStoreFolder() + QDir::separator() + QString::fromLatin1(hash) + QL1S(".png");
+
+  if (!QFile::exists(file_path)) {
+    QDir().mkpath(iconStoreFolder());
+
+    QFile file(file_path);
+
+    if (!file.open(QIODevice::WriteOnly) || file.write(png_data) != png_data.size()) {
+      qWarning("Icon could not be saved to icon store, using inline data instead.");
+      return toByteArray(icon);
+    }
+
+    file.close();
+  }
+
+  const QByteArray reference = QByteArray(APP_ICON_STORE_PREFIX) + hash;
+
+  m_storedReferences.insert(icon.cacheKey(), reference);
+  return reference;
+}
+
+QIcon IconFactory::fromStoreReference(const QByteArray &reference) {
+  if (reference.isEmpty()) {
+    return QIcon();
+  }
+
+  // Legacy data are keyed by their hash, so that duplicates are decoded only once.
+  const bool is_reference = reference.startsWith(APP_ICON_STORE_PREFIX);
+  const QByteArray key = is_reference ? reference : QCryptographicHash::hash(reference, QCryptographicHash::Sha1);
+
+  if (m_storedIcons.contains(key)) {
+    return m_storedIcons.value(key);
+  }
+
+  QIcon icon;
+
+  if (is_reference) {
+    // Icon created from file is not decoded until it is painted.
+    const QString hash = QString::fromLatin1(reference.mid(int(qstrlen(APP_ICON_STORE_PREFIX))));
+    const QString file_path = iconStoreFolder() + QDir::separator() + hash + QL1S(".png");
+
+    if (!QFile::exists(file_path)) {
+      // Missing icon is not remembered, it might be stored again later.
+      qWarning("Icon '%s' is missing in icon store.", qPrintable(hash));
+      return QIcon();
+    }
+
+    icon = QIcon(file_path);
+    m_storedReferences.insert(icon.cacheKey(), reference);
+  }
+  else {
+    icon = fromByteArray(reference);
+  }
+
+  m_storedIcons.insert(key, icon);
+  return icon;
+}
+
+void IconFactory::removeUnusedStoredIcons(const QSet<QByteArray> &used_references) {
+  QDir store(iconStoreFolder());
+
+  foreach (const QString &file_name, store.entryList(QStringList() << QSL("*.png"), QDir::Files)) {
+    const QByteArray reference = QByteArray(APP_ICON_STORE_PREFIX) + QFileInfo(file_name).completeBaseName().toLatin1();
+
+    if (used_references.contains(reference)) {
+      continue;
+    }
+
+    if (!store.remove(file_name)) {
+      qWarning("Unused icon '%s' could not be removed from icon store.", qPrintable(file_name));
+      continue;
+    }
+
+    // Forget the icon, so that it is written again if it is ever stored again.
+    m_storedIcons.remove(reference);
+
+    QMutableHashIterator<qint64,QByteArray> i(m_storedReferences);
+
+    while (i.hasNext()) {
+      if (i.next().value() == reference) {
+        i.remove();
+      }
+    }
+  }
+}
+
+QString IconFactory::iconStoreFolder() const {
+  return qApp->getUserDataPath() + QDir::separator() + APP_ICON_STORE_FOLDER;
+}
+
 QPixmap IconFactory::pixmap(const QString &name) {
   if (QIcon::themeName() == APP_NO_THEME) {
     return QPixmap();
@@ -26,6 +26,7 @@
 #include <QString>
 #include <QIcon>
 #include <QHash>
+#include <QSet>
 #include <QDir>
 
 
@@ -44,6 +45,20 @@ class IconFactory : public QObject {
     static QIcon fromByteArray(QByteArray array);
     static QByteArray toByteArray(const QIcon &icon);
 
+    // Used to store/retrieve QIcons to/from content-addressed icon store.
+    // Icons are saved as PNG files named by hash of their contents, so that
+    // identical icons of many feeds are stored only once. Returned reference
+    // is what gets stored in database.
+    //
+    // NOTE: Retrieved icons are shared and decoded lazily once they
+    // are painted for the first time. Legacy Base64-encoded byte arrays
+    // are still accepted by "fromStoreReference".
+    QByteArray toStoreReference(const QIcon &icon);
+    QIcon fromStoreReference(const QByteArray &reference);
+
+    // Removes icons which are not among given references from the store.
+    void removeUnusedStoredIcons(const QSet<QByteArray> &used_references);
+
     QPixmap pixmap(const QString &name);
 
     // Returns icon from active theme or invalid icon if
@@ -71,6 +86,14 @@ class IconFactory : public QObject {
 
     // Sets icon theme with given name as the active one and loads it.
     void setCurrentIconTheme(const QString &theme_name);
+
+  private:
+    QString iconStoreFolder() const;
+
+    // Icons obtained from the store (or from legacy byte arrays) and
+    // references of icons already saved into the store, keyed by icon cache keys.
+    QHash<QByteArray,QIcon> m_storedIcons;
+    QHash<qint64,QByteArray> m_storedReferences;
 };
 
 #endif // ICONFACTORY_H
@@ -127,3 +127,21 @@ bool IOFactory::copyFile(const QString &source, const QString &destination) {
 
   return QFile::copy(source, destination);
 }
+
+bool IOFactory::copyFolder(const QString &source, const QString &destination) {
+  const QDir source_folder(source);
+
+  if (!QDir().mkpath(destination)) {
+    return false;
+  }
+
+  foreach (const QString &file_name, source_folder.entryList(QDir::Files)) {
+    const QString source_file = source_folder.filePath(file_name);
+
+    if (!copyFile(source_file, destination + QDir::separator() + file_name) && QFile::exists(source_file)) {
+      return false;
+    }
+  }
+
+  return true;
+}
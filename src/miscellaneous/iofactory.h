@@ -52,6 +52,10 @@ class IOFactory {
 
     // Copies file, overwrites destination.
     static bool copyFile(const QString &source, const QString &destination);
+
+    // Copies files of folder into destination folder, overwrites existing files.
+    // Files which are removed from source folder meanwhile are skipped.
+    static bool copyFolder(const QString &source, const QString &destination);
 };
 
 #endif // IOFACTORY_H
@@ -0,0 +1,343 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "miscellaneous/jsonstreamreader.h"
+
+#include "definitions/definitions.h"
+
+#include <QJsonDocument>
+
+#include <cctype>
+#include <cstring>
+
+
+JsonStreamReader::JsonStreamReader(const QByteArray &data, int offset)
+  : m_data(data), m_position(qMax(0, offset)), m_tokenOffset(m_position), m_tokenType(Invalid),
+    m_text(QString()), m_number(0.0), m_boolean(false), m_hasError(false) {
+}
+
+JsonStreamReader::~JsonStreamReader() {
+}
+
+bool JsonStreamReader::readNext() {
+  if (m_hasError) {
+    return false;
+  }
+
+  const char *data = m_data.constData();
+  const int size = m_data.size();
+
+  // Commas and colons are just separators here, structure
+  // of the document is given by the tokens themselves.
+  while (m_position < size && (isspace((unsigned char) data[m_position]) ||
+                               data[m_position] == ',' || data[m_position] == ':')) {
+    m_position++;
+  }
+
+  m_tokenOffset = m_position;
+  m_text.clear();
+
+  if (m_position >= size) {
+    m_tokenType = Invalid;
+    return false;
+  }
+
+  switch (data[m_position]) {
+    case '{':
+      m_tokenType = StartObject;
+      m_position++;
+      return true;
+
+    case '}':
+      m_tokenType = EndObject;
+      m_position++;
+      return true;
+
+    case '[':
+      m_tokenType = StartArray;
+      m_position++;
+      return true;
+
+    case ']':
+      m_tokenType = EndArray;
+      m_position++;
+      return true;
+
+    case '"':
+      return readString();
+
+    case 't':
+      m_boolean = true;
+      m_tokenType = Bool;
+      return readLiteral("true", 4);
+
+    case 'f':
+      m_boolean = false;
+      m_tokenType = Bool;
+      return readLiteral("false", 5);
+
+    case 'n':
+      m_tokenType = Null;
+      return readLiteral("null", 4);
+
+    default:
+      return readNumber();
+  }
+}
+
+bool JsonStreamReader::skipValue() {
+  if (m_tokenType != StartObject && m_tokenType != StartArray) {
+    return !m_hasError;
+  }
+
+  const char *data = m_data.constData();
+  const int size = m_data.size();
+  int depth = 1;
+
+  // Scan raw bytes, nothing inside of skipped value is decoded.
+  while (m_position < size) {
+    switch (data[m_position++]) {
+      case '"':
+        while (m_position < size && data[m_position] != '"') {
+          m_position += data[m_position] == '\\' ? 2 : 1;
+        }
+
+        m_position++;
+        break;
+
+      case '{':
+      case '[':
+        depth++;
+        break;
+
+      case '}':
+      case ']':
+        if (--depth == 0) {
+          m_tokenOffset = m_position - 1;
+          m_tokenType = data[m_tokenOffset] == '}' ? EndObject : EndArray;
+          return true;
+        }
+
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  return setError();
+}
+
+JsonStreamReader::TokenType JsonStreamReader::tokenType() const {
+  return m_tokenType;
+}
+
+bool JsonStreamReader::isScalar() const {
+  return m_tokenType == String || m_tokenType == Number || m_tokenType == Bool || m_tokenType == Null;
+}
+
+int JsonStreamReader::tokenOffset() const {
+  return m_tokenOffset;
+}
+
+int JsonStreamReader::offset() const {
+  return m_position;
+}
+
+QString JsonStreamReader::text() const {
+  return m_text;
+}
+
+double JsonStreamReader::number() const {
+  return m_number;
+}
+
+bool JsonStreamReader::boolean(bool default_value) const {
+  return m_tokenType == Bool ? m_boolean : default_value;
+}
+
+bool JsonStreamReader::hasError() const {
+  return m_hasError;
+}
+
+QJsonObject JsonStreamReader::readObject(const QByteArray &data, const QString &streamed_member, int *streamed_offset) {
+  JsonStreamReader reader(data);
+  QByteArray filtered_data;
+
+  *streamed_offset = -1;
+
+  if (!reader.readNext() || reader.tokenType() != StartObject) {
+    return QJsonObject();
+  }
+
+  filtered_data.reserve(256);
+  filtered_data.append('{');
+
+  // Copy all members except the streamed one, so that only
+  // small part of the document is converted to JSON tree.
+  while (reader.readNext() && reader.tokenType() == Name) {
+    const int member_offset = reader.tokenOffset();
+    const bool is_streamed = reader.text() == streamed_member;
+
+    if (!reader.readNext()) {
+      return QJsonObject();
+    }
+
+    const int value_offset = reader.tokenOffset();
+    const bool is_array = reader.tokenType() == StartArray;
+
+    if (!reader.skipValue()) {
+      return QJsonObject();
+    }
+
+    if (is_streamed && is_array) {
+      *streamed_offset = value_offset;
+    }
+    else {
+      if (filtered_data.size() > 1) {
+        filtered_data.append(',');
+      }
+
+      filtered_data.append(data.constData() + member_offset, reader.offset() - member_offset);
+    }
+  }
+
+  filtered_data.append('}');
+  return QJsonDocument::fromJson(filtered_data).object();
+}
+
+bool JsonStreamReader::readString() {
+  const char *data = m_data.constData();
+  const int size = m_data.size();
+  int chunk_start = ++m_position;
+
+  while (m_position < size && data[m_position] != '"') {
+    if (data[m_position] != '\\') {
+      m_position++;
+      continue;
+    }
+
+    // Flush raw UTF-8 chunk and decode escape sequence.
+    m_text.append(QString::fromUtf8(data + chunk_start, m_position - chunk_start));
+
+    if (++m_position >= size) {
+      return setError();
+    }
+
+    switch (data[m_position++]) {
+      case '"':
+        m_text.append(QL1C('"'));
+        break;
+
+      case '\\':
+        m_text.append(QL1C('\\'));
+        break;
+
+      case '/':
+        m_text.append(QL1C('/'));
+        break;
+
+      case 'b':
+        m_text.append(QL1C('\b'));
+        break;
+
+      case 'f':
+        m_text.append(QL1C('\f'));
+        break;
+
+      case 'n':
+        m_text.append(QL1C('\n'));
+        break;
+
+      case 'r':
+        m_text.append(QL1C('\r'));
+        break;
+
+      case 't':
+        m_text.append(QL1C('\t'));
+        break;
+
+      case 'u': {
+        bool ok;
+        const ushort unicode = QByteArray::fromRawData(data + m_position, qMin(4, size - m_position)).toUShort(&ok, 16);
+
+        if (!ok || size - m_position < 4) {
+          return setError();
+        }
+
+        // NOTE: Surrogate pairs are encoded as two escapes, each of them
+        // produces one UTF-16 code unit, so pair is restored correctly.
+        m_text.append(QChar(unicode));
+        m_position += 4;
+        break;
+      }
+
+      default:
+        return setError();
+    }
+
+    chunk_start = m_position;
+  }
+
+  if (m_position >= size) {
+    return setError();
+  }
+
+  m_text.append(QString::fromUtf8(data + chunk_start, m_position - chunk_start));
+  m_position++;
+
+  // String followed by colon is name of object member.
+  int next = m_position;
+
+  while (next < size && isspace((unsigned char) data[next])) {
+    next++;
+  }
+
+  m_tokenType = next < size && data[next] == ':' ? Name : String;
+  return true;
+}
+
+bool JsonStreamReader::readLiteral(const char *literal, int length) {
+  if (m_data.size() - m_position < length || strncmp(m_data.constData() + m_position, literal, length) != 0) {
+    return setError();
+  }
+
+  m_position += length;
+  return true;
+}
+
+bool JsonStreamReader::readNumber() {
+  const char *data = m_data.constData();
+  const int size = m_data.size();
+
+  while (m_position < size && data[m_position] != '\0' && strchr("+-.0123456789eE", data[m_position]) != NULL) {
+    m_position++;
+  }
+
+  bool ok;
+
+  m_number = QByteArray::fromRawData(data + m_tokenOffset, m_position - m_tokenOffset).toDouble(&ok);
+  m_tokenType = Number;
+
+  return ok ? true : setError();
+}
+
+bool JsonStreamReader::setError() {
+  m_hasError = true;
+  m_tokenType = Invalid;
+  return false;
+}
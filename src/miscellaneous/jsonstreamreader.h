@@ -0,0 +1,104 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef JSONSTREAMREADER_H
+#define JSONSTREAMREADER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QJsonObject>
+
+
+// Pull-based tokenizer of JSON documents.
+//
+// Reader works directly on raw UTF-8 bytes of the document
+// and does not build any JSON tree, so large arrays (for example
+// pages of messages) can be processed item by item.
+// Only string values are decoded, rest of the tokens is just scanned.
+class JsonStreamReader {
+  public:
+    enum TokenType {
+      Invalid,
+      StartObject,
+      EndObject,
+      StartArray,
+      EndArray,
+      Name,
+      String,
+      Number,
+      Bool,
+      Null
+    };
+
+    // Constructors and destructors.
+    // NOTE: Reading starts at given byte offset of the document.
+    explicit JsonStreamReader(const QByteArray &data, int offset = 0);
+    virtual ~JsonStreamReader();
+
+    // Reads next token. Returns false if end of document
+    // is reached or if document is not well-formed.
+    bool readNext();
+
+    // If current token starts object or array, then reader skips
+    // everything up to the matching end token, which becomes current token.
+    // Scalar tokens are left untouched.
+    bool skipValue();
+
+    TokenType tokenType() const;
+
+    // Returns true if current token is a string, number, boolean or null.
+    bool isScalar() const;
+
+    // Byte offset of the start of current token and byte offset
+    // right after the end of current token.
+    int tokenOffset() const;
+    int offset() const;
+
+    // Values of current token.
+    // NOTE: "text()" is valid for names and strings only,
+    // "boolean()" returns given default value for tokens other than booleans.
+    QString text() const;
+    double number() const;
+    bool boolean(bool default_value = false) const;
+
+    bool hasError() const;
+
+    // Parses top-level object of the document.
+    // If the object contains array member "streamed_member", then the
+    // member is not materialised, its byte offset is stored in "streamed_offset"
+    // instead and it can be read later with JsonStreamReader.
+    // NOTE: Offset is set to -1 if there is no such array member.
+    static QJsonObject readObject(const QByteArray &data, const QString &streamed_member, int *streamed_offset);
+
+  private:
+    bool readString();
+    bool readLiteral(const char *literal, int length);
+    bool readNumber();
+    bool setError();
+
+  private:
+    QByteArray m_data;
+    int m_position;
+    int m_tokenOffset;
+    TokenType m_tokenType;
+    QString m_text;
+    double m_number;
+    bool m_boolean;
+    bool m_hasError;
+};
+
+#endif // JSONSTREAMREADER_H
@@ -0,0 +1,300 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "miscellaneous/retentionengine.h"
+
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/databasequeries.h"
+
+#include <QDebug>
+#include <QDateTime>
+#include <QThread>
+#include <QTimer>
+#include <QSqlQuery>
+
+
+// Value of "auto_vacuum" pragma for incremental mode.
+#define SQLITE_INCREMENTAL_VACUUM 2
+
+RetentionEngine::RetentionEngine(QObject *parent)
+  : QObject(parent), m_batchTimer(new QTimer(this)), m_running(false), m_paused(false), m_phase(Removing),
+    m_removedMessages(0), m_archivedMessages(0), m_reclaimedBytes(0) {
+  m_batchTimer->setSingleShot(true);
+  connect(m_batchTimer, &QTimer::timeout, this, &RetentionEngine::processNextBatch);
+}
+
+RetentionEngine::~RetentionEngine() {
+  qDebug("Destroying RetentionEngine instance.");
+}
+
+bool RetentionEngine::isRunning() const {
+  return m_running;
+}
+
+void RetentionEngine::startRetention(const RetentionOrders &orders) {
+  if (m_running) {
+    qDebug("Retention is already running, new request is ignored.");
+    return;
+  }
+
+  qDebug().nospace() << "Starting retention in thread: \'" << QThread::currentThreadId() << "\'.";
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  bool ok_policies = true, ok_feeds = true;
+
+  m_orders = orders;
+  m_policies.clear();
+  m_pendingFeeds.clear();
+
+  if (m_orders.m_removeExpiredMessages) {
+    m_policies = DatabaseQueries::getRetentionPolicies(database, &ok_policies);
+    m_pendingFeeds = DatabaseQueries::getFeedsWithMessages(database, &ok_feeds);
+  }
+
+  if (!ok_policies || !ok_feeds) {
+    qWarning("Retention policies or list of feeds were not loaded, retention is skipped.");
+    return;
+  }
+
+  m_running = true;
+  m_phase = Removing;
+  m_removedMessages = 0;
+  m_archivedMessages = 0;
+  m_reclaimedBytes = 0;
+
+  emit retentionStarted();
+  m_batchTimer->start(0);
+}
+
+void RetentionEngine::stopRetention() {
+  if (m_running) {
+    qDebug("Stopping retention, %d messages were removed so far.", m_removedMessages);
+    m_batchTimer->stop();
+    finishRetention();
+  }
+}
+
+void RetentionEngine::pause() {
+  m_paused = true;
+}
+
+void RetentionEngine::resume() {
+  m_paused = false;
+}
+
+void RetentionEngine::processNextBatch() {
+  if (!m_running) {
+    return;
+  }
+
+  if (m_paused) {
+    // Feeds are being updated, do not compete with them for database.
+    m_batchTimer->start(RETENTION_BUSY_DELAY);
+  }
+  else {
+    switch (m_phase) {
+      case Removing:
+        removeNextChunk();
+        break;
+
+      case Archiving:
+        archiveNextChunk();
+        break;
+
+      case Vacuuming:
+      default:
+        vacuumNextSlice();
+        break;
+    }
+  }
+}
+
+RetentionPolicy RetentionEngine::policyForFeed(int account_id, int feed_id) const {
+  const QPair<int,int> feed_key(account_id, feed_id);
+  const QPair<int,int> account_key(account_id, NO_PARENT_CATEGORY);
+
+  if (m_policies.contains(feed_key)) {
+    return m_policies.value(feed_key);
+  }
+  else if (m_policies.contains(account_key)) {
+    return m_policies.value(account_key);
+  }
+  else {
+    return m_orders.m_defaultPolicy;
+  }
+}
+
+void RetentionEngine::removeNextChunk() {
+  if (m_pendingFeeds.isEmpty()) {
+    startArchiving();
+    return;
+  }
+
+  const QPair<int,int> feed = m_pendingFeeds.first();
+  const RetentionPolicy policy = policyForFeed(feed.first, feed.second);
+
+  if (policy.isEmpty()) {
+    m_pendingFeeds.removeFirst();
+    m_batchTimer->start(0);
+    return;
+  }
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  bool ok;
+  const QStringList ids = DatabaseQueries::getExpiredMessages(database, feed.first, feed.second,
+                                                              policy, RETENTION_BATCH_SIZE, &ok);
+
+  if (!ok || ids.isEmpty()) {
+    // Feed is done, continue with next one.
+    m_pendingFeeds.removeFirst();
+    m_batchTimer->start(0);
+  }
+  else if (DatabaseQueries::purgeMessages(database, ids)) {
+    MessagesChanges changes;
+
+    foreach (const QString &id, ids) {
+      changes.m_deletedIds.append(id.toInt());
+    }
+
+    m_removedMessages += ids.size();
+    emit messagesRemoved(changes);
+    m_batchTimer->start(RETENTION_BATCH_DELAY);
+  }
+  else {
+    qWarning("Removing of %d expired messages of feed '%d' failed.", ids.size(), feed.second);
+    m_pendingFeeds.removeFirst();
+    m_batchTimer->start(RETENTION_BATCH_DELAY);
+  }
+}
+
+void RetentionEngine::startArchiving() {
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+
+  // Archived contents of messages removed since last round are not needed anymore.
+  if (!DatabaseQueries::removeOrphanedArchivedContents(database)) {
+    qWarning("Removing of orphaned archived contents failed.");
+  }
+
+  if (m_orders.m_archiveAfterDays > 0) {
+    m_phase = Archiving;
+    m_batchTimer->start(0);
+  }
+  else {
+    startVacuum();
+  }
+}
+
+void RetentionEngine::archiveNextChunk() {
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  const qint64 older_than = QDateTime::currentDateTimeUtc().addDays(-m_orders.m_archiveAfterDays).toMSecsSinceEpoch();
+  bool ok;
+  const int archived = DatabaseQueries::archiveMessages(database, older_than, RETENTION_BATCH_SIZE, &ok);
+
+  m_archivedMessages += archived;
+
+  if (ok && archived == RETENTION_BATCH_SIZE) {
+    m_batchTimer->start(RETENTION_BATCH_DELAY);
+  }
+  else {
+    if (!ok) {
+      qWarning("Archiving of message contents failed, it will be retried in next round.");
+    }
+
+    startVacuum();
+  }
+}
+
+void RetentionEngine::startVacuum() {
+  if (qApp->database()->activeDatabaseDriver() != DatabaseFactory::SQLITE) {
+    // Only file-based SQLite database can be vacuumed incrementally.
+    finishRetention();
+    return;
+  }
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  QSqlQuery query(database);
+
+  query.setForwardOnly(true);
+
+  if (!query.exec(QSL("PRAGMA auto_vacuum;")) || !query.next()) {
+    qWarning("Auto-vacuum mode of database file cannot be determined, free space was not reclaimed.");
+    finishRetention();
+    return;
+  }
+
+  if (query.value(0).toInt() != SQLITE_INCREMENTAL_VACUUM) {
+    // Switching to incremental mode requires full vacuum, which locks the database
+    // for long time, so it is left to the user, see database cleanup.
+    qDebug("Database file is not in incremental auto-vacuum mode, free space was not reclaimed.");
+    finishRetention();
+    return;
+  }
+
+  m_phase = Vacuuming;
+  m_batchTimer->start(0);
+}
+
+void RetentionEngine::vacuumNextSlice() {
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  QSqlQuery query(database);
+  int page_size = 0, free_pages_before = 0, free_pages_after = 0;
+
+  query.setForwardOnly(true);
+
+  if (query.exec(QSL("PRAGMA page_size;")) && query.next()) {
+    page_size = query.value(0).toInt();
+  }
+
+  if (query.exec(QSL("PRAGMA freelist_count;")) && query.next()) {
+    free_pages_before = query.value(0).toInt();
+  }
+
+  if (free_pages_before > 0) {
+    if (query.exec(QString(QSL("PRAGMA incremental_vacuum(%1);")).arg(RETENTION_VACUUM_PAGES))) {
+      // NOTE: Some versions of SQLite free one page per each step
+      // of the pragma, so step through it completely.
+      while (query.next()) {
+      }
+    }
+
+    if (query.exec(QSL("PRAGMA freelist_count;")) && query.next()) {
+      free_pages_after = query.value(0).toInt();
+    }
+  }
+
+  m_reclaimedBytes += qint64(free_pages_before - free_pages_after) * page_size;
+
+  if (free_pages_after > 0 && free_pages_after < free_pages_before) {
+    m_batchTimer->start(RETENTION_BATCH_DELAY);
+  }
+  else {
+    finishRetention();
+  }
+}
+
+void RetentionEngine::finishRetention() {
+  m_running = false;
+  m_phase = Removing;
+  m_pendingFeeds.clear();
+  m_policies.clear();
+
+  qDebug("Retention finished, %d messages were removed, %d were archived and %lld bytes were reclaimed.",
+         m_removedMessages, m_archivedMessages, m_reclaimedBytes);
+
+  emit retentionFinished(m_removedMessages, m_reclaimedBytes);
+}
@@ -0,0 +1,131 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef RETENTIONENGINE_H
+#define RETENTIONENGINE_H
+
+#include <QObject>
+
+#include "core/message.h"
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+
+
+class QTimer;
+
+struct RetentionPolicy {
+  // Maximal age of messages in days, zero means "no limit".
+  int m_maxAge;
+
+  // Maximal count of messages per feed, zero means "no limit".
+  int m_maxCount;
+
+  bool m_keepStarred;
+
+  RetentionPolicy() : m_maxAge(0), m_maxCount(0), m_keepStarred(true) {
+  }
+
+  bool isEmpty() const {
+    return m_maxAge <= 0 && m_maxCount <= 0;
+  }
+};
+
+struct RetentionOrders {
+  // Policies are applied only if this is true.
+  bool m_removeExpiredMessages;
+
+  // Used for feeds which have no policy of their own nor of their account.
+  RetentionPolicy m_defaultPolicy;
+
+  // Contents of read messages older than this are archived, zero means "never".
+  int m_archiveAfterDays;
+
+  RetentionOrders() : m_removeExpiredMessages(false), m_defaultPolicy(RetentionPolicy()), m_archiveAfterDays(0) {
+  }
+};
+
+// Keeps size of database bounded in background.
+//
+// Messages which violate retention policies are purged
+// in small batches with pauses between them, so that
+// database is never locked for long time. Then contents of
+// old read messages are moved to compressed archive and
+// free pages of SQLite database file are reclaimed incrementally,
+// if the file was switched to incremental mode by database cleanup.
+class RetentionEngine : public QObject {
+    Q_OBJECT
+
+  public:
+    // Constructors.
+    explicit RetentionEngine(QObject *parent = 0);
+    virtual ~RetentionEngine();
+
+    bool isRunning() const;
+
+  signals:
+    void retentionStarted();
+
+    // Emitted after each removed batch, so that displayed messages can be dropped.
+    void messagesRemoved(const MessagesChanges &changes);
+    void retentionFinished(int removed_messages, qint64 reclaimed_bytes);
+
+  public slots:
+    // Starts retention round.
+    void startRetention(const RetentionOrders &orders);
+    void stopRetention();
+
+    // Batches are postponed while feeds are being updated.
+    void pause();
+    void resume();
+
+  private slots:
+    void processNextBatch();
+
+  private:
+    RetentionPolicy policyForFeed(int account_id, int feed_id) const;
+    void removeNextChunk();
+    void startArchiving();
+    void archiveNextChunk();
+    void startVacuum();
+    void vacuumNextSlice();
+    void finishRetention();
+
+    enum Phase {
+      Removing,
+      Archiving,
+      Vacuuming
+    };
+
+    QTimer *m_batchTimer;
+    bool m_running;
+    bool m_paused;
+    Phase m_phase;
+
+    RetentionOrders m_orders;
+    QHash<QPair<int,int>,RetentionPolicy> m_policies;
+    QList<QPair<int,int> > m_pendingFeeds;
+
+    int m_removedMessages;
+    int m_archivedMessages;
+    qint64 m_reclaimedBytes;
+};
+
+Q_DECLARE_METATYPE(RetentionOrders)
+
+#endif // RETENTIONENGINE_H
@@ -46,6 +46,12 @@ DVALUE(bool) Feeds::FeedsUpdateOnStartupDef = false;
 DKEY Feeds::ShowOnlyUnreadFeeds               = "show_only_unread_feeds";
 DVALUE(bool) Feeds::ShowOnlyUnreadFeedsDef    = false;
 
+DKEY Feeds::IncrementalParsing                = "incremental_parsing";
+DVALUE(bool) Feeds::IncrementalParsingDef     = false;
+
+DKEY Feeds::MaxMessagesPerUpdate              = "max_messages_per_update";
+DVALUE(int) Feeds::MaxMessagesPerUpdateDef    = 0;
+
 // Messages.
 DKEY Messages::ID                            = "messages";
 
@@ -173,6 +179,12 @@ DVALUE(bool) General::FirstRunDef             = true;
 DKEY General::Language               = "language";
 DVALUE(QString) General::LanguageDef = QLocale::system().name();
 
+DKEY General::TraceHotPaths                   = "trace_hot_paths";
+DVALUE(bool) General::TraceHotPathsDef        = false;
+
+DKEY General::LoggingCategories               = "logging_categories";
+DVALUE(char*) General::LoggingCategoriesDef   = "";
+
 // Downloads.
 DKEY Downloads::ID                                    = "download_manager";
 
@@ -240,6 +252,31 @@ DVALUE(int) Database::MySQLPortDef        = APP_DB_MYSQL_PORT;
 DKEY Database::ActiveDriver               = "database_driver";
 DVALUE(char*) Database::ActiveDriverDef   = APP_DB_SQLITE_DRIVER;
 
+DKEY Database::RetentionEnabled               = "retention_enabled";
+DVALUE(bool) Database::RetentionEnabledDef    = false;
+
+// In hours.
+DKEY Database::RetentionInterval              = "retention_interval";
+DVALUE(int) Database::RetentionIntervalDef    = 24;
+
+// In days, zero means that age of messages is not limited.
+DKEY Database::RetentionMaxAge                = "retention_max_age";
+DVALUE(int) Database::RetentionMaxAgeDef      = 0;
+
+// Per feed, zero means that count of messages is not limited.
+DKEY Database::RetentionMaxCount              = "retention_max_count";
+DVALUE(int) Database::RetentionMaxCountDef    = 0;
+
+DKEY Database::RetentionKeepStarred             = "retention_keep_starred";
+DVALUE(bool) Database::RetentionKeepStarredDef  = true;
+
+DKEY Database::ArchiveEnabled               = "archive_enabled";
+DVALUE(bool) Database::ArchiveEnabledDef    = false;
+
+// In days, contents of read messages older than this are compressed.
+DKEY Database::ArchiveAfter                 = "archive_after";
+DVALUE(int) Database::ArchiveAfterDef       = 7;
+
 // Keyboard.
 DKEY Keyboard::ID = "keyboard";
 
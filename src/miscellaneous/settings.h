@@ -60,6 +60,12 @@ namespace Feeds {
 
   KEY ShowOnlyUnreadFeeds;
   VALUE(bool) ShowOnlyUnreadFeedsDef;
+
+  KEY IncrementalParsing;
+  VALUE(bool) IncrementalParsingDef;
+
+  KEY MaxMessagesPerUpdate;
+  VALUE(int) MaxMessagesPerUpdateDef;
 }
 
 // Messages.
@@ -192,6 +198,12 @@ namespace General {
 
   KEY Language;
   VALUE(QString) LanguageDef;
+
+  KEY TraceHotPaths;
+  VALUE(bool) TraceHotPathsDef;
+
+  KEY LoggingCategories;
+  VALUE(char*) LoggingCategoriesDef;
 }
 
 // Downloads.
@@ -265,6 +277,27 @@ namespace Database {
 
   KEY ActiveDriver;
   VALUE(char*) ActiveDriverDef;
+
+  KEY RetentionEnabled;
+  VALUE(bool) RetentionEnabledDef;
+
+  KEY RetentionInterval;
+  VALUE(int) RetentionIntervalDef;
+
+  KEY RetentionMaxAge;
+  VALUE(int) RetentionMaxAgeDef;
+
+  KEY RetentionMaxCount;
+  VALUE(int) RetentionMaxCountDef;
+
+  KEY RetentionKeepStarred;
+  VALUE(bool) RetentionKeepStarredDef;
+
+  KEY ArchiveEnabled;
+  VALUE(bool) ArchiveEnabledDef;
+
+  KEY ArchiveAfter;
+  VALUE(int) ArchiveAfterDef;
 }
 
 // Keyboard.
@@ -0,0 +1,182 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "miscellaneous/tracer.h"
+
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThread>
+
+
+QAtomicInt Tracer::s_enabled(0);
+QMutex Tracer::s_mutex;
+QElapsedTimer Tracer::s_clock;
+QVector<Tracer::TraceEvent> Tracer::s_events;
+QHash<quintptr,QString> Tracer::s_threadNames;
+int Tracer::s_nextEvent = 0;
+bool Tracer::s_wrapped = false;
+
+Tracer::Tracer() {
+}
+
+void Tracer::setEnabled(bool enabled) {
+  QMutexLocker locker(&s_mutex);
+
+  if (enabled && s_events.isEmpty()) {
+    s_events.resize(TRACE_BUFFER_SIZE);
+    s_nextEvent = 0;
+    s_wrapped = false;
+    s_clock.start();
+  }
+
+  s_enabled.store(enabled ? 1 : 0);
+  qDebug("Tracing of hot paths is %s.", enabled ? "enabled" : "disabled");
+}
+
+qint64 Tracer::timestamp() {
+  return s_clock.nsecsElapsed() / 1000;
+}
+
+void Tracer::recordInstant(const char *category, const char *name) {
+  if (!isEnabled()) {
+    return;
+  }
+
+  const TraceEvent event = { category, name, nullptr, 0, timestamp(), -1, (quintptr) QThread::currentThreadId() };
+  appendEvent(event);
+}
+
+void Tracer::recordSpan(const char *category, const char *name, qint64 start, qint64 duration,
+                        const char *argument_name, qint64 argument_value) {
+  if (!isEnabled()) {
+    return;
+  }
+
+  const TraceEvent event = { category, name, argument_name, argument_value, start, duration,
+                             (quintptr) QThread::currentThreadId() };
+  appendEvent(event);
+}
+
+void Tracer::appendEvent(const TraceEvent &event) {
+  QMutexLocker locker(&s_mutex);
+
+  if (s_events.isEmpty()) {
+    return;
+  }
+
+  if (!s_threadNames.contains(event.m_threadId)) {
+    QThread *thread = QThread::currentThread();
+    QString thread_name = thread->objectName();
+
+    if (thread == qApp->thread()) {
+      thread_name = QSL("GUI");
+    }
+    else if (thread_name.isEmpty()) {
+      thread_name = QString(QSL("Thread %1")).arg(event.m_threadId);
+    }
+
+    s_threadNames.insert(event.m_threadId, thread_name);
+  }
+
+  // Oldest events are overwritten once the buffer is full.
+  s_events[s_nextEvent] = event;
+  s_nextEvent = (s_nextEvent + 1) % s_events.size();
+  s_wrapped = s_wrapped || s_nextEvent == 0;
+}
+
+bool Tracer::save(const QString &file_path) {
+  QJsonArray trace_events;
+  const qint64 process_id = QCoreApplication::applicationPid();
+
+  {
+    QMutexLocker locker(&s_mutex);
+
+    const int count = s_wrapped ? s_events.size() : s_nextEvent;
+    const int first = s_wrapped ? s_nextEvent : 0;
+
+    for (int i = 0; i < count; i++) {
+      const TraceEvent &event = s_events.at((first + i) % s_events.size());
+      QJsonObject json_event;
+
+      json_event[QSL("cat")] = QString::fromLatin1(event.m_category);
+      json_event[QSL("name")] = QString::fromLatin1(event.m_name);
+      json_event[QSL("ts")] = event.m_timestamp;
+      json_event[QSL("pid")] = process_id;
+      json_event[QSL("tid")] = (qint64) event.m_threadId;
+
+      if (event.m_duration < 0) {
+        json_event[QSL("ph")] = QSL("i");
+        json_event[QSL("s")] = QSL("t");
+      }
+      else {
+        json_event[QSL("ph")] = QSL("X");
+        json_event[QSL("dur")] = event.m_duration;
+      }
+
+      if (event.m_argumentName != nullptr) {
+        QJsonObject arguments;
+
+        arguments[QString::fromLatin1(event.m_argumentName)] = event.m_argumentValue;
+        json_event[QSL("args")] = arguments;
+      }
+
+      trace_events.append(json_event);
+    }
+
+    // Metadata events give threads readable names in the timeline.
+    foreach (quintptr thread_id, s_threadNames.keys()) {
+      QJsonObject json_event;
+      QJsonObject arguments;
+
+      arguments[QSL("name")] = s_threadNames.value(thread_id);
+      json_event[QSL("name")] = QSL("thread_name");
+      json_event[QSL("ph")] = QSL("M");
+      json_event[QSL("pid")] = process_id;
+      json_event[QSL("tid")] = (qint64) thread_id;
+      json_event[QSL("args")] = arguments;
+      trace_events.append(json_event);
+    }
+  }
+
+  QJsonObject trace;
+  QFile file(file_path);
+
+  trace[QSL("traceEvents")] = trace_events;
+  trace[QSL("displayTimeUnit")] = QSL("ms");
+
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qWarning("Cannot open file '%s' for writing of trace.", qPrintable(file_path));
+    return false;
+  }
+
+  file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact));
+  file.close();
+
+  qDebug("Trace of %d events was saved to '%s'.", trace_events.size(), qPrintable(file_path));
+  return true;
+}
+
+QString Tracer::defaultFilePath() {
+  return qApp->getUserDataPath() + QDir::separator() + QSL(APP_LOW_NAME) + QSL("-trace.json");
+}
@@ -0,0 +1,110 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+
+// Records spans and instant events of hot paths into
+// in-memory ring buffer. Buffer can be saved in Chrome trace
+// event format and opened in "chrome://tracing" or Perfetto.
+//
+// NOTE: Recording can be called from any thread. When tracing
+// is disabled, recording costs single check of atomic flag.
+class Tracer {
+  public:
+    inline static bool isEnabled() {
+      return s_enabled.load() != 0;
+    }
+
+    // Enables tracing and allocates the buffer.
+    static void setEnabled(bool enabled);
+
+    // Returns microseconds elapsed since tracing was enabled.
+    static qint64 timestamp();
+
+    static void recordInstant(const char *category, const char *name);
+    static void recordSpan(const char *category, const char *name, qint64 start, qint64 duration,
+                           const char *argument_name = nullptr, qint64 argument_value = 0);
+
+    // Writes recorded events as Chrome trace JSON.
+    static bool save(const QString &file_path);
+    static QString defaultFilePath();
+
+  private:
+    struct TraceEvent {
+      const char *m_category;
+      const char *m_name;
+      const char *m_argumentName;
+      qint64 m_argumentValue;
+      qint64 m_timestamp;
+
+      // Negative duration marks instant event.
+      qint64 m_duration;
+      quintptr m_threadId;
+    };
+
+    // Constructor.
+    explicit Tracer();
+
+    static void appendEvent(const TraceEvent &event);
+
+    static QAtomicInt s_enabled;
+    static QMutex s_mutex;
+    static QElapsedTimer s_clock;
+    static QVector<TraceEvent> s_events;
+    static QHash<quintptr,QString> s_threadNames;
+    static int s_nextEvent;
+    static bool s_wrapped;
+};
+
+// Records span which lasts from construction to destruction of the object.
+class TraceSpan {
+  public:
+    inline explicit TraceSpan(const char *category, const char *name)
+      : m_category(category), m_name(name), m_argumentName(nullptr), m_argumentValue(0),
+        m_start(Tracer::isEnabled() ? Tracer::timestamp() : -1) {
+    }
+
+    inline ~TraceSpan() {
+      if (m_start >= 0) {
+        Tracer::recordSpan(m_category, m_name, m_start, Tracer::timestamp() - m_start, m_argumentName, m_argumentValue);
+      }
+    }
+
+    // Attaches single numeric argument, like count of processed items, to the span.
+    inline void setArgument(const char *name, qint64 value) {
+      m_argumentName = name;
+      m_argumentValue = value;
+    }
+
+  private:
+    const char *m_category;
+    const char *m_name;
+    const char *m_argumentName;
+    qint64 m_argumentValue;
+    qint64 m_start;
+};
+
+#endif // TRACER_H
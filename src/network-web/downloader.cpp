@@ -17,6 +17,7 @@
 
 #include "network-web/downloader.h"
 
+#include "miscellaneous/debugging.h"
 #include "network-web/silentnetworkaccessmanager.h"
 
 #include <QTimer>
@@ -25,8 +26,9 @@
 Downloader::Downloader(QObject *parent)
   : QObject(parent), m_activeReply(nullptr), m_downloadManager(new SilentNetworkAccessManager(this)),
     m_timer(new QTimer(this)), m_customHeaders(QHash<QByteArray, QByteArray>()), m_inputData(QByteArray()),
-    m_targetProtected(false), m_targetUsername(QString()), m_targetPassword(QString()),
-    m_lastOutputData(QByteArray()), m_lastOutputError(QNetworkReply::NoError), m_lastContentType(QVariant()) {
+    m_incrementalMode(false), m_targetProtected(false), m_targetUsername(QString()), m_targetPassword(QString()),
+    m_lastOutputData(QByteArray()), m_lastOutputError(QNetworkReply::NoError), m_lastContentType(QVariant()),
+    m_elapsedTimer(QElapsedTimer()), m_lastTimeToFirstByte(-1), m_lastDuration(0), m_lastBytesReceived(0) {
 
   m_timer->setInterval(DOWNLOAD_TIMEOUT);
   m_timer->setSingleShot(true);
@@ -58,12 +60,16 @@ void Downloader::manipulateData(const QString &url, QNetworkAccessManager::Opera
   }
 
   m_inputData = data;
+  m_lastTimeToFirstByte = -1;
+  m_lastDuration = 0;
+  m_lastBytesReceived = 0;
+  m_elapsedTimer.start();
 
   // Set url for this request and fire it up.
   m_timer->setInterval(timeout);
 
   if (non_const_url.startsWith(URI_SCHEME_FEED)) {
-    qDebug("Replacing URI schemes for '%s'.", qPrintable(non_const_url));
+    qCDebug(LOGNETWORK, "Replacing URI schemes for '%s'.", qPrintable(non_const_url));
     request.setUrl(non_const_url.replace(QRegExp(QString('^') + URI_SCHEME_FEED), QString(URI_SCHEME_HTTP)));
   }
   else {
@@ -128,9 +134,18 @@ void Downloader::finished() {
   else {
     // No redirection is indicated. Final file is obtained in our "reply" object.
     // Read the data into output buffer.
-    m_lastOutputData = reply->readAll();
+    if (m_incrementalMode) {
+      // Most of data were already emitted, just flush the rest.
+      m_lastOutputData.clear();
+      readyReadInternal();
+    }
+    else {
+      m_lastOutputData = reply->readAll();
+    }
+
     m_lastContentType = reply->header(QNetworkRequest::ContentTypeHeader);
     m_lastOutputError = reply->error();
+    m_lastDuration = m_elapsedTimer.nsecsElapsed() / 1000;
 
     m_activeReply->deleteLater();
     m_activeReply = nullptr;
@@ -144,9 +159,35 @@ void Downloader::progressInternal(qint64 bytes_received, qint64 bytes_total) {
     m_timer->start();
   }
 
+  m_lastBytesReceived = bytes_received;
   emit progress(bytes_received, bytes_total);
 }
 
+void Downloader::readyReadInternal() {
+  if (!m_incrementalMode || m_activeReply == nullptr) {
+    return;
+  }
+
+  // Bodies of redirections and error pages are not interesting for us.
+  const bool is_redirection = m_activeReply->attribute(QNetworkRequest::RedirectionTargetAttribute).isValid();
+  const int http_status = m_activeReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+  if (is_redirection || http_status >= 400) {
+    return;
+  }
+
+  const QByteArray chunk = m_activeReply->readAll();
+
+  if (!chunk.isEmpty()) {
+    emit dataReceived(chunk);
+  }
+}
+
+void Downloader::metaDataChangedInternal() {
+  // Headers of redirections arrive too, so the final reply overwrites them.
+  m_lastTimeToFirstByte = m_elapsedTimer.nsecsElapsed() / 1000;
+}
+
 void Downloader::timeout() {
   cancel();
 }
@@ -160,6 +201,7 @@ void Downloader::runDeleteRequest(const QNetworkRequest &request) {
   m_activeReply->setProperty("password", m_targetPassword);
 
   connect(m_activeReply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(progressInternal(qint64,qint64)));
+  connect(m_activeReply, SIGNAL(metaDataChanged()), this, SLOT(metaDataChangedInternal()));
   connect(m_activeReply, SIGNAL(finished()), this, SLOT(finished()));
 }
 
@@ -172,6 +214,7 @@ void Downloader::runPutRequest(const QNetworkRequest &request, const QByteArray
   m_activeReply->setProperty("password", m_targetPassword);
 
   connect(m_activeReply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(progressInternal(qint64,qint64)));
+  connect(m_activeReply, SIGNAL(metaDataChanged()), this, SLOT(metaDataChangedInternal()));
   connect(m_activeReply, SIGNAL(finished()), this, SLOT(finished()));
 }
 
@@ -184,6 +227,7 @@ void Downloader::runPostRequest(const QNetworkRequest &request, const QByteArray
   m_activeReply->setProperty("password", m_targetPassword);
 
   connect(m_activeReply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(progressInternal(qint64,qint64)));
+  connect(m_activeReply, SIGNAL(metaDataChanged()), this, SLOT(metaDataChangedInternal()));
   connect(m_activeReply, SIGNAL(finished()), this, SLOT(finished()));
 }
 
@@ -196,13 +240,35 @@ void Downloader::runGetRequest(const QNetworkRequest &request) {
   m_activeReply->setProperty("password", m_targetPassword);
 
   connect(m_activeReply, SIGNAL(downloadProgress(qint64,qint64)), this, SLOT(progressInternal(qint64,qint64)));
+  connect(m_activeReply, SIGNAL(metaDataChanged()), this, SLOT(metaDataChangedInternal()));
+  connect(m_activeReply, SIGNAL(readyRead()), this, SLOT(readyReadInternal()));
   connect(m_activeReply, SIGNAL(finished()), this, SLOT(finished()));
 }
 
+bool Downloader::incrementalMode() const {
+  return m_incrementalMode;
+}
+
+void Downloader::setIncrementalMode(bool incremental) {
+  m_incrementalMode = incremental;
+}
+
 QVariant Downloader::lastContentType() const {
   return m_lastContentType;
 }
 
+qint64 Downloader::lastTimeToFirstByte() const {
+  return m_lastTimeToFirstByte;
+}
+
+qint64 Downloader::lastDuration() const {
+  return m_lastDuration;
+}
+
+qint64 Downloader::lastBytesReceived() const {
+  return m_lastBytesReceived;
+}
+
 void Downloader::cancel() {
   if (m_activeReply != nullptr) {
     // Download action timed-out, too slow connection or target is not reachable.
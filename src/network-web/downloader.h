@@ -24,6 +24,7 @@
 
 #include <QNetworkReply>
 #include <QSslError>
+#include <QElapsedTimer>
 
 
 class SilentNetworkAccessManager;
@@ -42,6 +43,19 @@ class Downloader : public QObject {
     QNetworkReply::NetworkError lastOutputError() const;
     QVariant lastContentType() const;
 
+    // Timings of last finished request in microseconds since
+    // the request was started, redirections are included.
+    // Time to first byte is -1 if no response arrived at all.
+    qint64 lastTimeToFirstByte() const;
+    qint64 lastDuration() const;
+    qint64 lastBytesReceived() const;
+
+    // If incremental mode is enabled, then downloaded data are not
+    // collected in output buffer but they are emitted in chunks
+    // via dataReceived() signal as soon as they arrive.
+    bool incrementalMode() const;
+    void setIncrementalMode(bool incremental);
+
   public slots:
     void cancel();
 
@@ -68,6 +82,9 @@ class Downloader : public QObject {
     void progress(qint64 bytes_received, qint64 bytes_total);
     void completed(QNetworkReply::NetworkError status, QByteArray contents = QByteArray());
 
+    // Emitted for each chunk of data in incremental mode.
+    void dataReceived(const QByteArray &chunk);
+
   private slots:
     // Called when current reply is processed.
     void finished();
@@ -75,6 +92,12 @@ class Downloader : public QObject {
     // Called when progress of downloaded file changes.
     void progressInternal(qint64 bytes_received, qint64 bytes_total);
 
+    // Called when new data of current reply are available.
+    void readyReadInternal();
+
+    // Called when headers of current reply arrive.
+    void metaDataChangedInternal();
+
     // Called when current operation times out.
     void timeout();
 
@@ -90,6 +113,7 @@ class Downloader : public QObject {
     QTimer *m_timer;
     QHash<QByteArray, QByteArray> m_customHeaders;
     QByteArray m_inputData;
+    bool m_incrementalMode;
 
     bool m_targetProtected;
     QString m_targetUsername;
@@ -99,6 +123,10 @@ class Downloader : public QObject {
     QByteArray m_lastOutputData;
     QNetworkReply::NetworkError m_lastOutputError;
     QVariant m_lastContentType;
+    QElapsedTimer m_elapsedTimer;
+    qint64 m_lastTimeToFirstByte;
+    qint64 m_lastDuration;
+    qint64 m_lastBytesReceived;
 };
 
 #endif // DOWNLOADER_H
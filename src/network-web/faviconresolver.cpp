@@ -0,0 +1,253 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "network-web/faviconresolver.h"
+
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "miscellaneous/iconfactory.h"
+#include "network-web/silentnetworkaccessmanager.h"
+
+#include <QSettings>
+#include <QDateTime>
+#include <QRegExp>
+#include <QTimer>
+#include <QPixmap>
+#include <QDir>
+
+
+FaviconResolver::FaviconResolver(QObject *parent)
+  : QObject(parent), m_network(new SilentNetworkAccessManager(this)),
+    m_cache(new QSettings(qApp->getUserDataPath() + QDir::separator() + APP_ICON_STORE_FOLDER +
+                          QDir::separator() + FAVICON_CACHE_FILE, QSettings::IniFormat, this)),
+    m_queue(QList<QUrl>()), m_pendingSites(QSet<QString>()), m_activeJobs(QHash<QNetworkReply*,FaviconJob>()) {
+  QDir().mkpath(qApp->getUserDataPath() + QDir::separator() + APP_ICON_STORE_FOLDER);
+}
+
+FaviconResolver::~FaviconResolver() {
+  qDebug("Destroying FaviconResolver instance.");
+}
+
+QString FaviconResolver::siteKey(const QUrl &url) {
+  if (url.host().isEmpty()) {
+    return QString();
+  }
+
+  // Key is used as group name in the cache, so it must not contain slashes.
+  const QUrl site = url.adjusted(QUrl::RemoveScheme | QUrl::RemoveUserInfo | QUrl::RemoveFilename |
+                                 QUrl::RemoveQuery | QUrl::RemoveFragment);
+
+  return QString::fromLatin1(QUrl::toPercentEncoding(site.toString()));
+}
+
+QIcon FaviconResolver::cachedIcon(const QUrl &url, bool *found) const {
+  const QString site = siteKey(url);
+  const QDateTime checked = m_cache->value(site + QL1S("/checked")).toDateTime();
+  const QByteArray reference = m_cache->value(site + QL1S("/icon")).toByteArray();
+  const int expiration_days = reference.isEmpty() ? FAVICON_CACHE_FAILURE_EXPIRATION_DAYS : FAVICON_CACHE_EXPIRATION_DAYS;
+  const bool valid = !site.isEmpty() && checked.isValid() && checked.addDays(expiration_days) > QDateTime::currentDateTime();
+  const QIcon icon = valid ? qApp->icons()->fromStoreReference(reference) : QIcon();
+
+  if (found != nullptr) {
+    // Record whose icon is gone from icon store is not valid anymore,
+    // icon is resolved again then.
+    *found = valid && (reference.isEmpty() || !icon.isNull());
+  }
+
+  return icon;
+}
+
+void FaviconResolver::requestIcon(const QUrl &url) {
+  const QString site = siteKey(url);
+  bool found;
+
+  if (site.isEmpty()) {
+    return;
+  }
+
+  const QIcon icon = cachedIcon(url, &found);
+
+  if (found) {
+    emit iconResolved(site, icon);
+  }
+  else if (!m_pendingSites.contains(site)) {
+    m_pendingSites.insert(site);
+    m_queue.append(url);
+    processQueue();
+  }
+}
+
+void FaviconResolver::requestIcons(const QStringList &urls) {
+  foreach (const QString &url, urls) {
+    requestIcon(QUrl(url));
+  }
+}
+
+QIcon FaviconResolver::preferredIcon(const QStringList &urls, bool *resolved) const {
+  foreach (const QString &url, urls) {
+    bool found;
+    const QIcon icon = cachedIcon(QUrl(url), &found);
+
+    if (QUrl(url).host().isEmpty()) {
+      continue;
+    }
+    else if (!found) {
+      // Site with higher priority is still being resolved.
+      *resolved = false;
+      return QIcon();
+    }
+    else if (!icon.isNull()) {
+      *resolved = true;
+      return icon;
+    }
+  }
+
+  // None of the sites has icon.
+  *resolved = true;
+  return QIcon();
+}
+
+QSet<QByteArray> FaviconResolver::cachedReferences() const {
+  QSet<QByteArray> references;
+
+  foreach (const QString &site, m_cache->childGroups()) {
+    references.insert(m_cache->value(site + QL1S("/icon")).toByteArray());
+  }
+
+  return references;
+}
+
+void FaviconResolver::processQueue() {
+  while (m_activeJobs.size() < FAVICON_MAX_PARALLEL_DOWNLOADS && !m_queue.isEmpty()) {
+    const QUrl url = m_queue.takeFirst();
+    FaviconJob job;
+
+    QUrl site_url = url;
+
+    if (site_url.scheme().isEmpty()) {
+      site_url.setScheme(QSL("http"));
+    }
+
+    job.m_site = siteKey(url);
+    job.m_redirections = 0;
+
+    // Page of the site folder and home page of the site are checked for icon links first.
+    job.m_pages << site_url.resolved(QUrl(QSL("."))).toString() << site_url.resolved(QUrl(QSL("/"))).toString();
+    job.m_pages.removeDuplicates();
+
+    download(QUrl(job.m_pages.first()), job);
+  }
+}
+
+void FaviconResolver::download(const QUrl &url, const FaviconJob &job) {
+  QNetworkReply *reply = m_network->get(QNetworkRequest(url));
+
+  m_activeJobs.insert(reply, job);
+  connect(reply, SIGNAL(finished()), this, SLOT(onReplyFinished()));
+
+  // Reply gets "finished" with error when aborted.
+  QTimer::singleShot(DOWNLOAD_TIMEOUT, reply, SLOT(abort()));
+}
+
+void FaviconResolver::onReplyFinished() {
+  QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+
+  if (reply == nullptr || !m_activeJobs.contains(reply)) {
+    return;
+  }
+
+  FaviconJob job = m_activeJobs.take(reply);
+  const QUrl redirection = reply->attribute(QNetworkRequest::RedirectionTargetAttribute).toUrl();
+
+  reply->deleteLater();
+
+  if (reply->error() == QNetworkReply::NoError && redirection.isValid() &&
+      ++job.m_redirections <= FAVICON_MAX_REDIRECTIONS) {
+    download(reply->url().resolved(redirection), job);
+    return;
+  }
+
+  job.m_redirections = 0;
+
+  if (!job.m_pages.isEmpty()) {
+    // We have page of the site, extract icon links from it.
+    job.m_pages.removeFirst();
+
+    if (reply->error() == QNetworkReply::NoError) {
+      job.m_candidates.append(iconLinksFromHtmlPage(reply->url(), QString::fromUtf8(reply->readAll())));
+    }
+
+    if (!job.m_pages.isEmpty()) {
+      download(QUrl(job.m_pages.first()), job);
+      return;
+    }
+
+    // Default location is the last resort.
+    job.m_candidates.append(reply->url().resolved(QUrl(QSL("/favicon.ico"))).toString());
+    job.m_candidates.removeDuplicates();
+  }
+  else if (reply->error() == QNetworkReply::NoError) {
+    QPixmap icon_pixmap;
+
+    if (icon_pixmap.loadFromData(reply->readAll())) {
+      finishJob(job, QIcon(icon_pixmap));
+      return;
+    }
+  }
+
+  tryNextCandidate(job);
+}
+
+void FaviconResolver::tryNextCandidate(FaviconJob job) {
+  if (job.m_candidates.isEmpty()) {
+    // Site has no usable icon.
+    finishJob(job, QIcon());
+  }
+  else {
+    const QUrl candidate = QUrl(job.m_candidates.takeFirst());
+
+    download(candidate, job);
+  }
+}
+
+void FaviconResolver::finishJob(const FaviconJob &job, const QIcon &icon) {
+  qDebug("Favicon for site '%s' %s.", qPrintable(QUrl::fromPercentEncoding(job.m_site.toLatin1())),
+         icon.isNull() ? "was not found" : "was resolved");
+
+  m_cache->setValue(job.m_site + QL1S("/icon"), qApp->icons()->toStoreReference(icon));
+  m_cache->setValue(job.m_site + QL1S("/checked"), QDateTime::currentDateTime());
+  m_pendingSites.remove(job.m_site);
+
+  emit iconResolved(job.m_site, icon);
+  processQueue();
+}
+
+QStringList FaviconResolver::iconLinksFromHtmlPage(const QUrl &url, const QString &html) const {
+  QStringList icons;
+  const QRegExp rx(FAVICON_REGEX_MATCHER, Qt::CaseInsensitive);
+  const QRegExp rx_href(FAVICON_HREF_REGEX_MATCHER, Qt::CaseInsensitive);
+
+  for (int pos = 0; (pos = rx.indexIn(html, pos)) != -1; pos += rx.matchedLength()) {
+    const QString link_element = html.mid(pos, rx.matchedLength());
+
+    if (rx_href.indexIn(link_element) != -1) {
+      icons.append(url.resolved(QUrl(rx_href.cap(1))).toString());
+    }
+  }
+
+  return icons;
+}
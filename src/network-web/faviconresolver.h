@@ -0,0 +1,107 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FAVICONRESOLVER_H
+#define FAVICONRESOLVER_H
+
+#include <QObject>
+
+#include <QIcon>
+#include <QUrl>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QNetworkReply>
+
+
+class QSettings;
+class SilentNetworkAccessManager;
+
+// Obtains favicons of websites directly from them.
+//
+// Site's HTML is searched for "<link rel=icon>" first, then
+// "/favicon.ico" is tried. Results (including failures) are kept in
+// persistent per-site cache with expiration. Icons are fetched
+// asynchronously with limited number of parallel downloads.
+class FaviconResolver : public QObject {
+    Q_OBJECT
+
+  public:
+    // Constructors and destructors.
+    explicit FaviconResolver(QObject *parent = 0);
+    virtual ~FaviconResolver();
+
+    // Returns key of site of given URL, sites are distinguished by host,
+    // port and folder of the URL. Empty key is returned for URLs without host.
+    static QString siteKey(const QUrl &url);
+
+    // Returns cached icon for site of given URL. "found" is set to true if
+    // there is valid cache record for the site, record might say that
+    // the site has no icon, then null icon is returned.
+    QIcon cachedIcon(const QUrl &url, bool *found = nullptr) const;
+
+    // Schedules (asynchronous) resolving of icon for site of given URL.
+    // "iconResolved" is emitted once icon is resolved, it is emitted
+    // immediately if cache already contains the icon.
+    void requestIcon(const QUrl &url);
+    void requestIcons(const QStringList &urls);
+
+    // Returns cached icon of first of given sites (in their order of
+    // priority) which has an icon. "resolved" is set to false if some site
+    // preceding that site is not resolved yet, so the result is not final
+    // and null icon is returned. Results thus do not depend on order
+    // in which sites respond.
+    QIcon preferredIcon(const QStringList &urls, bool *resolved) const;
+
+    // Returns icon store references of all cached icons.
+    QSet<QByteArray> cachedReferences() const;
+
+  signals:
+    // Emitted when icon for site with given key is resolved, "icon" is null
+    // if site does not have any icon.
+    void iconResolved(const QString &site, const QIcon &icon);
+
+  private slots:
+    void onReplyFinished();
+
+  private:
+    struct FaviconJob {
+      QString m_site;
+
+      // Pages which are searched for icon links, first one is being downloaded.
+      QStringList m_pages;
+      QStringList m_candidates;
+      int m_redirections;
+    };
+
+    void processQueue();
+    void download(const QUrl &url, const FaviconJob &job);
+    void tryNextCandidate(FaviconJob job);
+    void finishJob(const FaviconJob &job, const QIcon &icon);
+
+    QStringList iconLinksFromHtmlPage(const QUrl &url, const QString &html) const;
+
+    SilentNetworkAccessManager *m_network;
+    QSettings *m_cache;
+
+    // Sites waiting for processing (by site keys) and running downloads.
+    QList<QUrl> m_queue;
+    QSet<QString> m_pendingSites;
+    QHash<QNetworkReply*,FaviconJob> m_activeJobs;
+};
+
+#endif // FAVICONRESOLVER_H
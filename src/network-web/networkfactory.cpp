@@ -18,6 +18,8 @@
 #include "network-web/networkfactory.h"
 
 #include "definitions/definitions.h"
+#include "core/feedstreamparser.h"
+#include "core/feedupdatetelemetry.h"
 #include "miscellaneous/settings.h"
 #include "network-web/silentnetworkaccessmanager.h"
 #include "network-web/downloader.h"
@@ -128,26 +130,6 @@ QString NetworkFactory::networkErrorText(QNetworkReply::NetworkError error_code)
   }
 }
 
-QNetworkReply::NetworkError NetworkFactory::downloadIcon(const QList<QString> &urls, int timeout, QIcon &output) {
-  QNetworkReply::NetworkError network_result = QNetworkReply::UnknownNetworkError;
-
-  foreach (const QString &url, urls) {
-    const QString google_s2_with_url = QString("http://www.google.com/s2/favicons?domain=%1").arg(QUrl(url).host());
-    QByteArray icon_data;
-    network_result =  performNetworkOperation(google_s2_with_url, timeout, QByteArray(), QString(), icon_data,
-                                              QNetworkAccessManager::GetOperation).first;
-
-    if (network_result == QNetworkReply::NoError) {
-      QPixmap icon_pixmap;
-      icon_pixmap.loadFromData(icon_data);
-      output = QIcon(icon_pixmap);
-      break;
-    }
-  }
-
-  return network_result;
-}
-
 NetworkResult NetworkFactory::performNetworkOperation(const QString &url, int timeout, const QByteArray &input_data,
                                                       const QString &input_content_type, QByteArray &output,
                                                       QNetworkAccessManager::Operation operation, bool protected_contents,
@@ -179,7 +161,8 @@ NetworkResult NetworkFactory::performNetworkOperation(const QString &url, int ti
 
 NetworkResult NetworkFactory::downloadFeedFile(const QString &url, int timeout,
                                                QByteArray &output, bool protected_contents,
-                                               const QString &username, const QString &password) {
+                                               const QString &username, const QString &password,
+                                               FeedUpdateTelemetry *telemetry) {
   // Here, we want to achieve "synchronous" approach because we want synchronout download API for
   // some use-cases too.
   Downloader downloader;
@@ -197,5 +180,58 @@ NetworkResult NetworkFactory::downloadFeedFile(const QString &url, int timeout,
   result.first = downloader.lastOutputError();
   result.second = downloader.lastContentType();
 
+  if (telemetry != nullptr) {
+    telemetry->m_timeToFirstByte = downloader.lastTimeToFirstByte();
+    telemetry->m_downloadTime = downloader.lastDuration();
+    telemetry->m_downloadedBytes = downloader.lastBytesReceived();
+  }
+
+  return result;
+}
+
+NetworkResult NetworkFactory::downloadFeedFile(const QString &url, int timeout, FeedStreamParser &parser,
+                                               bool protected_contents, const QString &username,
+                                               const QString &password, FeedUpdateTelemetry *telemetry) {
+  Downloader downloader;
+  QEventLoop loop;
+  NetworkResult result;
+
+  downloader.appendRawHeader("Accept", ACCEPT_HEADER_FOR_FEED_DOWNLOADER);
+  downloader.setIncrementalMode(true);
+
+  QObject::connect(&downloader, &Downloader::dataReceived, [&](const QByteArray &chunk) {
+    parser.addData(chunk);
+
+    if (parser.isMessageLimitReached()) {
+      // We have all messages we want, rest of the feed is not needed.
+      downloader.cancel();
+    }
+  });
+
+  // We need to quit event loop when the download finishes.
+  QObject::connect(&downloader, SIGNAL(completed(QNetworkReply::NetworkError)), &loop, SLOT(quit()));
+
+  downloader.downloadFile(url, timeout, protected_contents, username, password);
+  loop.exec();
+
+  if (parser.isMessageLimitReached()) {
+    // Download was aborted intentionally.
+    result.first = QNetworkReply::NoError;
+  }
+  else {
+    result.first = downloader.lastOutputError();
+    parser.finish();
+  }
+
+  result.second = downloader.lastContentType();
+
+  if (telemetry != nullptr) {
+    // NOTE: Data are parsed while they are downloaded, so
+    // download time includes decoding and parsing here.
+    telemetry->m_timeToFirstByte = downloader.lastTimeToFirstByte();
+    telemetry->m_downloadTime = downloader.lastDuration();
+    telemetry->m_downloadedBytes = downloader.lastBytesReceived();
+  }
+
   return result;
 }
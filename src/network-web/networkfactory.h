@@ -26,6 +26,9 @@
 
 typedef QPair<QNetworkReply::NetworkError, QVariant> NetworkResult;
 
+class FeedStreamParser;
+struct FeedUpdateTelemetry;
+
 class NetworkFactory {
     Q_DECLARE_TR_FUNCTIONS(NetworkFactory)
 
@@ -39,19 +42,24 @@ class NetworkFactory {
     // Returns human readable text for given network error.
     static QString networkErrorText(QNetworkReply::NetworkError error_code);
 
-    // Performs SYNCHRONOUS download if favicon for the site,
-    // given URL belongs to.
-    static QNetworkReply::NetworkError downloadIcon(const QList<QString> &urls, int timeout, QIcon &output);
-
     static NetworkResult performNetworkOperation(const QString &url, int timeout, const QByteArray &input_data,
                                                  const QString &input_content_type, QByteArray &output,
                                                  QNetworkAccessManager::Operation operation,
                                                  bool protected_contents = false, const QString &username = QString(),
                                                  const QString &password = QString(), bool set_basic_header = false);
 
+    // NOTE: Network stages of the download are stored
+    // into "telemetry" if it is provided.
     static NetworkResult downloadFeedFile(const QString &url, int timeout, QByteArray &output,
                                           bool protected_contents = false, const QString &username = QString(),
-                                          const QString &password = QString());
+                                          const QString &password = QString(), FeedUpdateTelemetry *telemetry = nullptr);
+
+    // Downloads feed file and pushes its data into the parser
+    // while download is still running. Download is aborted
+    // as soon as parser has enough messages.
+    static NetworkResult downloadFeedFile(const QString &url, int timeout, FeedStreamParser &parser,
+                                          bool protected_contents = false, const QString &username = QString(),
+                                          const QString &password = QString(), FeedUpdateTelemetry *telemetry = nullptr);
 };
 
 #endif // NETWORKFACTORY_H
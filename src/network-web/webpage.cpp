@@ -51,6 +51,9 @@ void WebPage::javaScriptAlert(const QUrl &securityOrigin, const QString &msg) {
     else if (action == QSL("unstarred")) {
       emit messageStatusChangeRequested(message_id, MarkUnstarred);
     }
+    else if (action == QSL("more")) {
+      emit moreMessagesRequested();
+    }
     else {
       QWebEnginePage::javaScriptAlert(securityOrigin, msg);
     }
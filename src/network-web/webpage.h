@@ -44,6 +44,10 @@ class WebPage : public QWebEnginePage {
 
   signals:
     void messageStatusChangeRequested(int message_id, WebPage::MessageStatusChange change);
+
+    // Emitted when user scrolls to the end of displayed messages
+    // or clicks "load more" link.
+    void moreMessagesRequested();
 };
 
 #endif // WEBPAGE_H
@@ -21,16 +21,19 @@
 #include "miscellaneous/application.h"
 #include "miscellaneous/mutex.h"
 #include "miscellaneous/databasequeries.h"
+#include "miscellaneous/debugging.h"
+#include "miscellaneous/tracer.h"
 #include "services/abstract/recyclebin.h"
 #include "services/abstract/serviceroot.h"
 
 #include <QThread>
+#include <QElapsedTimer>
 
 
 Feed::Feed(RootItem *parent)
   : RootItem(parent), m_url(QString()), m_status(Normal), m_autoUpdateType(DefaultAutoUpdate),
     m_autoUpdateInitialInterval(DEFAULT_AUTO_UPDATE_INTERVAL), m_autoUpdateRemainingInterval(DEFAULT_AUTO_UPDATE_INTERVAL),
-    m_totalCount(0), m_unreadCount(0) {
+    m_totalCount(0), m_unreadCount(0), m_telemetry(FeedUpdateTelemetry()) {
   setKind(RootItemKind::Feed);
   setAutoDelete(false);
 }
@@ -38,11 +41,6 @@ Feed::Feed(RootItem *parent)
 Feed::~Feed() {
 }
 
-QList<Message> Feed::undeletedMessages() const {
-  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
-  return DatabaseQueries::getUndeletedMessagesForFeed(database, customId(), getParentServiceRoot()->accountId());
-}
-
 QVariant Feed::data(int column, int role) const {
   switch (role) {
     case Qt::ForegroundRole:
@@ -142,16 +140,33 @@ void Feed::updateCounts(bool including_total_count) {
 }
 
 void Feed::run() {
-  qDebug().nospace() << "Downloading new messages for feed "
-                     << customId() << " in thread: \'"
-                     << QThread::currentThreadId() << "\'.";
+  TraceSpan span("network", "Feed::run");
+  span.setArgument("feed", id());
+
+  qCDebug(LOGNETWORK).nospace() << "Downloading new messages for feed "
+                                << customId() << " in thread: \'"
+                                << QThread::currentThreadId() << "\'.";
   
   bool error_during_obtaining;
+  QElapsedTimer timer;
+
+  m_telemetry = FeedUpdateTelemetry();
+  m_telemetry.m_updated = QDateTime::currentDateTimeUtc();
+  timer.start();
+
   QList<Message> msgs = obtainNewMessages(&error_during_obtaining);
 
-  qDebug().nospace() << "Downloaded " << msgs.size() << " messages for feed "
-                     << customId() << " in thread: \'"
-                     << QThread::currentThreadId() << "\'.";
+  if (m_telemetry.m_downloadTime < 0) {
+    // Stages were not measured separately, whole
+    // obtaining of messages is accounted as download.
+    m_telemetry.m_downloadTime = timer.nsecsElapsed() / 1000;
+  }
+
+  qCDebug(LOGNETWORK).nospace() << "Downloaded " << msgs.size() << " messages for feed "
+                                << customId() << " in thread: \'"
+                                << QThread::currentThreadId() << "\'.";
+
+  timer.restart();
 
   // Now, do some general operations on messages (tweak encoding etc.).
   for (int i = 0; i < msgs.size(); i++) {
@@ -161,6 +176,8 @@ void Feed::run() {
     msgs[i].m_title = QUrl::fromPercentEncoding(msgs[i].m_title.toUtf8());
   }
 
+  m_telemetry.m_decodeTime = qMax(m_telemetry.m_decodeTime, Q_INT64_C(0)) + timer.nsecsElapsed() / 1000;
+
   emit messagesObtained(msgs, error_during_obtaining);
 }
 
@@ -168,12 +185,13 @@ int Feed::updateMessages(const QList<Message> &messages, bool error_during_obtai
   QList<RootItem*> items_to_update;
   int updated_messages = 0;
   bool is_main_thread = QThread::currentThread() == qApp->thread();
+  bool ok = true;
 
-  qDebug("Updating messages in DB. Main thread: '%s'.", qPrintable(is_main_thread ? "true" : "false"));
+  qCDebug(LOGDB, "Updating messages in DB. Main thread: '%s'.", qPrintable(is_main_thread ? "true" : "false"));
   
   if (!error_during_obtaining) {
     bool anything_updated = false;
-    bool ok = true;
+    MessagesChanges changes;
 
     if (!messages.isEmpty()) {
       int custom_id = customId();
@@ -181,10 +199,24 @@ int Feed::updateMessages(const QList<Message> &messages, bool error_during_obtai
       QSqlDatabase database = is_main_thread ?
                                 qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings) :
                                 qApp->database()->connection(QSL("feed_upd"), DatabaseFactory::FromSettings);
-      updated_messages = DatabaseQueries::updateMessages(database, messages, custom_id, account_id, url(), &anything_updated, &ok);
+      QElapsedTimer timer;
+
+      timer.start();
+      updated_messages = DatabaseQueries::updateMessages(database, messages, custom_id, account_id, url(),
+                                                         &anything_updated, &ok, &changes);
+      m_telemetry.m_databaseTime = timer.nsecsElapsed() / 1000;
     }
 
+    m_telemetry.m_newMessages = changes.m_insertedIds.size();
+    m_telemetry.m_updatedMessages = changes.m_updatedIds.size();
+    m_telemetry.m_unchangedMessages = messages.size() - m_telemetry.m_newMessages - m_telemetry.m_updatedMessages;
+
     if (ok) {
+      if (!changes.isEmpty()) {
+        // Let displayed message list pick up just changed messages.
+        getParentServiceRoot()->messagesChanged(changes);
+      }
+
       setStatus(updated_messages > 0 ? NewMessages : Normal);
       updateCounts(true);
 
@@ -195,8 +227,21 @@ int Feed::updateMessages(const QList<Message> &messages, bool error_during_obtai
     }
   }
 
+  m_telemetry.m_accountId = getParentServiceRoot()->accountId();
+  m_telemetry.m_feedId = customId();
+  m_telemetry.m_feedTitle = title();
+  m_telemetry.m_error = error_during_obtaining || !ok;
+
   items_to_update.append(this);
   getParentServiceRoot()->itemChanged(items_to_update);
   
   return updated_messages;
 }
+
+FeedUpdateTelemetry Feed::lastUpdateTelemetry() const {
+  return m_telemetry;
+}
+
+FeedUpdateTelemetry &Feed::telemetry() {
+  return m_telemetry;
+}
@@ -21,6 +21,7 @@
 #include "services/abstract/rootitem.h"
 
 #include "core/message.h"
+#include "core/feedupdatetelemetry.h"
 
 #include <QVariant>
 #include <QRunnable>
@@ -53,8 +54,6 @@ class Feed : public RootItem, public QRunnable {
     explicit Feed(RootItem *parent = NULL);
     virtual ~Feed();
 
-    QList<Message> undeletedMessages() const;
-
     int countOfAllMessages() const;
     int countOfUnreadMessages() const;
 
@@ -81,6 +80,9 @@ class Feed : public RootItem, public QRunnable {
     // Runs update in thread (thread pooled).
     void run();
 
+    // Measurements of last update of this feed.
+    FeedUpdateTelemetry lastUpdateTelemetry() const;
+
   public slots:
     void updateCounts(bool including_total_count);
     int updateMessages(const QList<Message> &messages, bool error_during_obtaining);
@@ -88,6 +90,11 @@ class Feed : public RootItem, public QRunnable {
   signals:
     void messagesObtained(QList<Message> messages, bool error_during_obtaining);
 
+  protected:
+    // Measurements of running update, obtainNewMessages() fills
+    // in stages which it is able to measure.
+    FeedUpdateTelemetry &telemetry();
+
   private:
     // Performs synchronous obtaining of new messages for this feed.
     virtual QList<Message> obtainNewMessages(bool *error_during_obtaining) = 0;
@@ -100,6 +107,7 @@ class Feed : public RootItem, public QRunnable {
     int m_autoUpdateRemainingInterval;
     int m_totalCount;
     int m_unreadCount;
+    FeedUpdateTelemetry m_telemetry;
 };
 
 Q_DECLARE_METATYPE(Feed::AutoUpdateType)
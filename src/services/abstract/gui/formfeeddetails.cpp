@@ -26,6 +26,7 @@
 #include "miscellaneous/textfactory.h"
 #include "miscellaneous/iconfactory.h"
 #include "network-web/networkfactory.h"
+#include "network-web/faviconresolver.h"
 #include "gui/baselineedit.h"
 #include "gui/messagebox.h"
 #include "gui/systemtrayicon.h"
@@ -217,6 +218,8 @@ void FormFeedDetails::guessFeed() {
                                                                                       m_ui->m_txtUsername->lineEdit()->text(),
                                                                                       m_ui->m_txtPassword->lineEdit()->text());
 
+  m_iconLocations.clear();
+
   if (result.first != nullptr) {
     // Icon or whole feed was guessed.
     m_ui->m_btnIcon->setIcon(result.first->icon());
@@ -234,16 +237,19 @@ void FormFeedDetails::guessFeed() {
                                                                          Qt::MatchFixedString));
     }
 
-    if (result.second == QNetworkReply::NoError) {
-      m_ui->m_lblFetchMetadata->setStatus(WidgetWithStatus::Ok,
-                                          tr("All metadata fetched successfully."),
-                                          tr("Feed and icon metadata fetched."));
-    }
-    else {
+    if (result.second != QNetworkReply::NoError) {
       m_ui->m_lblFetchMetadata->setStatus(WidgetWithStatus::Warning,
                                           tr("Result: %1.").arg(NetworkFactory::networkErrorText(result.second)),
                                           tr("Feed or icon metadata not fetched."));
     }
+    else if (result.first->icon().isNull()) {
+      waitForIcon(result.first->iconLocations());
+    }
+    else {
+      m_ui->m_lblFetchMetadata->setStatus(WidgetWithStatus::Ok,
+                                          tr("All metadata fetched successfully."),
+                                          tr("Feed and icon metadata fetched."));
+    }
 
     // Remove temporary feed object.
     delete result.first;
@@ -261,11 +267,16 @@ void FormFeedDetails::guessIconOnly() {
                                                                                      m_ui->m_txtUsername->lineEdit()->text(),
                                                                                      m_ui->m_txtPassword->lineEdit()->text());
 
+  m_iconLocations.clear();
+
   if (result.first != nullptr) {
     // Icon or whole feed was guessed.
     m_ui->m_btnIcon->setIcon(result.first->icon());
 
-    if (result.second == QNetworkReply::NoError) {
+    if (result.second == QNetworkReply::NoError && result.first->icon().isNull()) {
+      waitForIcon(result.first->iconLocations());
+    }
+    else if (result.second == QNetworkReply::NoError) {
       m_ui->m_lblFetchMetadata->setStatus(WidgetWithStatus::Ok,
                                           tr("Icon fetched successfully."),
                                           tr("Icon metadata fetched."));
@@ -287,6 +298,48 @@ void FormFeedDetails::guessIconOnly() {
   }
 }
 
+void FormFeedDetails::waitForIcon(const QStringList &icon_locations) {
+  m_iconLocations = icon_locations;
+  m_ui->m_lblFetchMetadata->setStatus(WidgetWithStatus::Progress,
+                                      tr("Fetching icon..."),
+                                      tr("Feed metadata fetched, icon is being fetched."));
+
+  connect(qApp->favicons(), &FaviconResolver::iconResolved, this, &FormFeedDetails::onIconResolved, Qt::UniqueConnection);
+
+  // Icon might be resolved already, check it right away.
+  onIconResolved(QString(), QIcon());
+}
+
+void FormFeedDetails::onIconResolved(const QString &site, const QIcon &icon) {
+  Q_UNUSED(site)
+  Q_UNUSED(icon)
+
+  if (m_iconLocations.isEmpty()) {
+    return;
+  }
+
+  bool resolved;
+  const QIcon preferred_icon = qApp->favicons()->preferredIcon(m_iconLocations, &resolved);
+
+  if (!resolved) {
+    return;
+  }
+
+  m_iconLocations.clear();
+
+  if (preferred_icon.isNull()) {
+    m_ui->m_lblFetchMetadata->setStatus(WidgetWithStatus::Warning,
+                                        tr("Result: %1.").arg(NetworkFactory::networkErrorText(QNetworkReply::ContentNotFoundError)),
+                                        tr("Icon metadata not fetched."));
+  }
+  else {
+    m_ui->m_btnIcon->setIcon(preferred_icon);
+    m_ui->m_lblFetchMetadata->setStatus(WidgetWithStatus::Ok,
+                                        tr("All metadata fetched successfully."),
+                                        tr("Feed and icon metadata fetched."));
+  }
+}
+
 void FormFeedDetails::createConnections() {
   // General connections.
   connect(m_ui->m_buttonBox, SIGNAL(accepted()), this, SLOT(apply()));
@@ -67,6 +67,9 @@ class FormFeedDetails : public QDialog {
     void onLoadIconFromFile();
     void onUseDefaultIcon();
 
+    // Displays icon of guessed feed once it is resolved in background.
+    void onIconResolved(const QString &site, const QIcon &icon);
+
   protected:
     // Sets the feed which will be edited.
     // NOTE: This must be reimplemented in subclasses. Also this
@@ -82,6 +85,9 @@ class FormFeedDetails : public QDialog {
     // Loads categories into the dialog from the model.
     void loadCategories(const QList<Category*> categories, RootItem *root_item);
 
+    // Waits (without blocking) for icon from given locations.
+    void waitForIcon(const QStringList &icon_locations);
+
   protected:
     QScopedPointer<Ui::FormFeedDetails> m_ui;
     Feed *m_editableFeed;
@@ -92,6 +98,9 @@ class FormFeedDetails : public QDialog {
     QAction *m_actionUseDefaultIcon;
     QAction *m_actionFetchIcon;
     QAction *m_actionNoIcon;
+
+    // Locations of possible icons of guessed feed, which is still being resolved.
+    QStringList m_iconLocations;
 };
 
 #endif // FORMFEEDDETAILS_H
@@ -89,13 +89,6 @@ QList<QAction*> RecycleBin::contextMenu() {
   return m_contextMenu;
 }
 
-QList<Message> RecycleBin::undeletedMessages() const {
-  const int account_id = getParentServiceRoot()->accountId();
-  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
-
-  return DatabaseQueries::getUndeletedMessagesForBin(database, account_id);
-}
-
 bool RecycleBin::markAsReadUnread(RootItem::ReadStatus status) {
   QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
   ServiceRoot *parent_root = getParentServiceRoot();
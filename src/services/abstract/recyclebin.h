@@ -31,7 +31,6 @@ class RecycleBin : public RootItem {
     QVariant data(int column, int role) const;
 
     QList<QAction*> contextMenu();
-    QList<Message> undeletedMessages() const;
 
     bool markAsReadUnread(ReadStatus status);
     bool cleanMessages(bool clear_only_read);
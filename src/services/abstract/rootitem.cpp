@@ -36,11 +36,13 @@ RootItem::RootItem(RootItem *parent_item)
     m_icon(QIcon()),
     m_creationDate(QDateTime()),
     m_childItems(QList<RootItem*>()),
-    m_parentItem(parent_item) {
+    m_parentItem(parent_item),
+    m_subTreeIndex(nullptr) {
   setupFonts();
 }
 
 RootItem::~RootItem() {
+  delete m_subTreeIndex;
   qDeleteAll(m_childItems);
 }
 
@@ -84,16 +86,6 @@ bool RootItem::markAsReadUnread(ReadStatus status) {
   return result;
 }
 
-QList<Message> RootItem::undeletedMessages() const {
-  QList<Message> messages;
-
-  foreach (RootItem *child, m_childItems) {
-    messages.append(child->undeletedMessages());
-  }
-
-  return messages;
-}
-
 bool RootItem::cleanMessages(bool clear_only_read) {
   bool result = true;
 
@@ -244,123 +236,165 @@ bool RootItem::isParentOf(const RootItem *child) const {
   }
 }
 
-QList<RootItem*> RootItem::getSubTree() const {
-  QList<RootItem*> children;
-  QList<RootItem*> traversable_items;
+const RootItem::SubTreeIndex *RootItem::subTreeIndex() const {
+  const RootItem *owner = this;
 
-  traversable_items.append(const_cast<RootItem* const>(this));
+  // Find nearest item which keeps the index.
+  while (owner != nullptr && owner->kind() != RootItemKind::Root && owner->kind() != RootItemKind::ServiceRoot) {
+    owner = owner->parent();
+  }
 
-  // Iterate all nested items.
-  while (!traversable_items.isEmpty()) {
-    RootItem *active_item = traversable_items.takeFirst();
+  if (owner != nullptr) {
+    if (owner->m_subTreeIndex == nullptr) {
+      owner->m_subTreeIndex = new SubTreeIndex();
+      owner->fillSubTreeIndex(owner->m_subTreeIndex);
+    }
 
-    children.append(active_item);
-    traversable_items.append(active_item->childItems());
+    if (owner->m_subTreeIndex->m_ranges.contains(this)) {
+      return owner->m_subTreeIndex;
+    }
   }
 
-  return children;
+  // Item is not (yet) placed in any tree or its parent does
+  // not list it as a child, so it keeps index of its own subtree.
+  if (m_subTreeIndex == nullptr) {
+    m_subTreeIndex = new SubTreeIndex();
+    fillSubTreeIndex(m_subTreeIndex);
+  }
+
+  return m_subTreeIndex;
 }
 
-QList<RootItem*> RootItem::getSubTree(RootItemKind::Kind kind_of_item) const {
-  QList<RootItem*> children;
-  QList<RootItem*> traversable_items;
+void RootItem::fillSubTreeIndex(SubTreeIndex *index) const {
+  RootItem *this_item = const_cast<RootItem* const>(this);
+  SubTreeIndex::Range range;
 
-  traversable_items.append(const_cast<RootItem* const>(this));
+  range.m_firstItem = index->m_items.size();
+  range.m_firstCategory = index->m_categories.size();
+  range.m_firstFeed = index->m_feeds.size();
 
-  // Iterate all nested items.
-  while (!traversable_items.isEmpty()) {
-    RootItem *active_item = traversable_items.takeFirst();
+  index->m_items.append(this_item);
 
-    if ((active_item->kind() & kind_of_item) > 0) {
-      children.append(active_item);
-    }
+  if (kind() == RootItemKind::Category) {
+    index->m_categories.append(toCategory());
 
-    traversable_items.append(active_item->childItems());
+    if (!index->m_categoriesForCustomIds.contains(customId())) {
+      index->m_categoriesForCustomIds.insert(customId(), toCategory());
+    }
   }
+  else if (kind() == RootItemKind::Feed) {
+    index->m_feeds.append(toFeed());
 
-  return children;
-}
+    if (!index->m_feedsForCustomIds.contains(customId())) {
+      index->m_feedsForCustomIds.insert(customId(), toFeed());
+    }
+  }
 
-QList<Category*> RootItem::getSubTreeCategories() const {
-  QList<Category*> children;
-  QList<RootItem*> traversable_items;
+  foreach (const RootItem *child, m_childItems) {
+    child->fillSubTreeIndex(index);
+  }
 
-  traversable_items.append(const_cast<RootItem* const>(this));
+  range.m_lastItem = index->m_items.size();
+  range.m_lastCategory = index->m_categories.size();
+  range.m_lastFeed = index->m_feeds.size();
 
-  // Iterate all nested items.
-  while (!traversable_items.isEmpty()) {
-    RootItem *active_item = traversable_items.takeFirst();
+  index->m_ranges.insert(this, range);
+}
 
-    if (active_item->kind() == RootItemKind::Category) {
-      children.append(active_item->toCategory());
+void RootItem::invalidateSubTreeIndex() {
+  for (RootItem *item = this; item != nullptr; item = item->parent()) {
+    if (item->m_subTreeIndex != nullptr) {
+      delete item->m_subTreeIndex;
+      item->m_subTreeIndex = nullptr;
     }
 
-    traversable_items.append(active_item->childItems());
+    if (item->kind() == RootItemKind::ServiceRoot) {
+      item->toServiceRoot()->setFeedAncestryOutdated();
+    }
   }
-
-  return children;
 }
 
-QHash<int,Category*> RootItem::getHashedSubTreeCategories() const {
-  QHash<int,Category*> children;
-  QList<RootItem*> traversable_items;
+QList<RootItem*> RootItem::getSubTree() const {
+  const SubTreeIndex *index = subTreeIndex();
+  const SubTreeIndex::Range range = index->m_ranges.value(this);
+
+  return index->m_items.mid(range.m_firstItem, range.m_lastItem - range.m_firstItem).toList();
+}
 
-  traversable_items.append(const_cast<RootItem* const>(this));
+QList<RootItem*> RootItem::getSubTree(RootItemKind::Kind kind_of_item) const {
+  const SubTreeIndex *index = subTreeIndex();
+  const SubTreeIndex::Range range = index->m_ranges.value(this);
+  QList<RootItem*> children;
 
-  // Iterate all nested items.
-  while (!traversable_items.isEmpty()) {
-    RootItem *active_item = traversable_items.takeFirst();
+  for (int i = range.m_firstItem; i < range.m_lastItem; i++) {
+    RootItem *item = index->m_items.at(i);
 
-    if (active_item->kind() == RootItemKind::Category && !children.contains(active_item->customId())) {
-      children.insert(active_item->customId(), active_item->toCategory());
+    if ((item->kind() & kind_of_item) > 0) {
+      children.append(item);
     }
-
-    traversable_items.append(active_item->childItems());
   }
 
   return children;
 }
 
-QHash<int,Feed*> RootItem::getHashedSubTreeFeeds() const {
-  QHash<int,Feed*> children;
-  QList<RootItem*> traversable_items;
+QList<Category*> RootItem::getSubTreeCategories() const {
+  const SubTreeIndex *index = subTreeIndex();
+  const SubTreeIndex::Range range = index->m_ranges.value(this);
 
-  traversable_items.append(const_cast<RootItem* const>(this));
+  return index->m_categories.mid(range.m_firstCategory, range.m_lastCategory - range.m_firstCategory).toList();
+}
 
-  // Iterate all nested items.
-  while (!traversable_items.isEmpty()) {
-    RootItem *active_item = traversable_items.takeFirst();
+QHash<int,Category*> RootItem::getHashedSubTreeCategories() const {
+  const SubTreeIndex *index = subTreeIndex();
 
-    if (active_item->kind() == RootItemKind::Feed && !children.contains(active_item->customId())) {
-      children.insert(active_item->customId(), active_item->toFeed());
-    }
+  if (index->m_items.first() == this) {
+    // Whole index belongs to this item, return shared copy.
+    return index->m_categoriesForCustomIds;
+  }
 
-    traversable_items.append(active_item->childItems());
+  const SubTreeIndex::Range range = index->m_ranges.value(this);
+  QHash<int,Category*> children;
+
+  for (int i = range.m_firstCategory; i < range.m_lastCategory; i++) {
+    Category *category = index->m_categories.at(i);
+
+    if (!children.contains(category->customId())) {
+      children.insert(category->customId(), category);
+    }
   }
 
   return children;
 }
 
-QList<Feed*> RootItem::getSubTreeFeeds() const {
-  QList<Feed*> children;
-  QList<RootItem*> traversable_items;
+QHash<int,Feed*> RootItem::getHashedSubTreeFeeds() const {
+  const SubTreeIndex *index = subTreeIndex();
+
+  if (index->m_items.first() == this) {
+    // Whole index belongs to this item, return shared copy.
+    return index->m_feedsForCustomIds;
+  }
 
-  traversable_items.append(const_cast<RootItem* const>(this));
+  const SubTreeIndex::Range range = index->m_ranges.value(this);
+  QHash<int,Feed*> children;
 
-  // Iterate all nested items.
-  while (!traversable_items.isEmpty()) {
-    RootItem *active_item = traversable_items.takeFirst();
+  for (int i = range.m_firstFeed; i < range.m_lastFeed; i++) {
+    Feed *feed = index->m_feeds.at(i);
 
-    if (active_item->kind() == RootItemKind::Feed) {
-      children.append(active_item->toFeed());
+    if (!children.contains(feed->customId())) {
+      children.insert(feed->customId(), feed);
     }
-
-    traversable_items.append(active_item->childItems());
   }
 
   return children;
 }
 
+QList<Feed*> RootItem::getSubTreeFeeds() const {
+  const SubTreeIndex *index = subTreeIndex();
+  const SubTreeIndex::Range range = index->m_ranges.value(this);
+
+  return index->m_feeds.mid(range.m_firstFeed, range.m_lastFeed - range.m_firstFeed).toList();
+}
+
 ServiceRoot *RootItem::getParentServiceRoot() const {
   const RootItem *working_parent = this;
 
@@ -398,6 +432,9 @@ int RootItem::id() const {
 
 void RootItem::setId(int id) {
   m_id = id;
+
+  // IDs of categories are part of stored feed ancestry.
+  invalidateSubTreeIndex();
 }
 
 QString RootItem::title() const {
@@ -441,6 +478,7 @@ void RootItem::setBoldFont(const QFont &bold_font) {
 }
 
 bool RootItem::removeChild(RootItem *child) {
+  invalidateSubTreeIndex();
   return m_childItems.removeOne(child);
 }
 
@@ -450,6 +488,7 @@ int RootItem::customId() const {
 
 void RootItem::setCustomId(int custom_id) {
   m_customId = custom_id;
+  invalidateSubTreeIndex();
 }
 
 Category *RootItem::toCategory() const {
@@ -477,6 +516,7 @@ int RootItem::countOfUnreadMessages() const {
 bool RootItem::removeChild(int index) {
   if (index >= 0 && index < m_childItems.size()) {
     m_childItems.removeAt(index);
+    invalidateSubTreeIndex();
     return true;
   }
   else {
@@ -23,6 +23,8 @@
 #include <QIcon>
 #include <QDateTime>
 #include <QFont>
+#include <QVector>
+#include <QHash>
 
 
 class Category;
@@ -96,10 +98,6 @@ class RootItem : public QObject {
     // to mark this item as read/unread.
     virtual bool markAsReadUnread(ReadStatus status);
 
-    // Get ALL undeleted messages from this item in one single list.
-    // This is currently used for displaying items in "newspaper mode".
-    virtual QList<Message> undeletedMessages() const;
-
     // This method should "clean" all messages it contains.
     // What "clean" means? It means delete messages -> move them to recycle bin
     // or eventually remove them completely if there is no recycle bin functionality.
@@ -139,6 +137,7 @@ class RootItem : public QObject {
     inline void appendChild(RootItem *child) {
       m_childItems.append(child);
       child->setParent(this);
+      invalidateSubTreeIndex();
     }
 
     // Access to children.
@@ -150,10 +149,12 @@ class RootItem : public QObject {
     // NOTE: Children are NOT freed from the memory.
     inline void clearChildren() {
       m_childItems.clear();
+      invalidateSubTreeIndex();
     }
 
     inline void setChildItems(QList<RootItem*> child_items) {
       m_childItems = child_items;
+      invalidateSubTreeIndex();
     }
 
     // Removes particular child at given index.
@@ -177,6 +178,10 @@ class RootItem : public QObject {
     QHash<int,Feed*> getHashedSubTreeFeeds() const;
     QList<Feed*> getSubTreeFeeds() const;
 
+    // Drops cached flat index of subtrees of this item and all its parents.
+    // NOTE: This must be called whenever structure of the tree changes.
+    void invalidateSubTreeIndex();
+
     // Returns the service root node which is direct or indirect parent of current item.
     ServiceRoot *getParentServiceRoot() const;
 
@@ -218,8 +223,31 @@ class RootItem : public QObject {
     ServiceRoot *toServiceRoot() const;
 
   private:
+    // Flat pre-order index of all items of the subtree, kept by
+    // model root and service roots. Subtree of each contained item
+    // occupies contiguous range of these vectors.
+    struct SubTreeIndex {
+      struct Range {
+        int m_firstItem, m_lastItem;
+        int m_firstCategory, m_lastCategory;
+        int m_firstFeed, m_lastFeed;
+      };
+
+      QVector<RootItem*> m_items;
+      QVector<Category*> m_categories;
+      QVector<Feed*> m_feeds;
+      QHash<const RootItem*,Range> m_ranges;
+      QHash<int,Category*> m_categoriesForCustomIds;
+      QHash<int,Feed*> m_feedsForCustomIds;
+    };
+
     void setupFonts();
 
+    // Returns index which contains subtree of this item, index is built if needed.
+    // NOTE: Index is built lazily and it is not thread-safe, use it from main thread only.
+    const SubTreeIndex *subTreeIndex() const;
+    void fillSubTreeIndex(SubTreeIndex *index) const;
+
     RootItemKind::Kind m_kind;
     int m_id;
     int m_customId;
@@ -233,6 +261,7 @@ class RootItem : public QObject {
 
     QList<RootItem*> m_childItems;
     RootItem *m_parentItem;
+    mutable SubTreeIndex *m_subTreeIndex;
 };
 
 #endif // ROOTITEM_H
@@ -22,14 +22,17 @@
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/textfactory.h"
 #include "miscellaneous/databasequeries.h"
+#include "miscellaneous/debugging.h"
 #include "services/abstract/category.h"
 #include "services/abstract/feed.h"
 #include "services/abstract/recyclebin.h"
 
 #include <QSqlTableModel>
+#include <QSqlError>
+#include <QSet>
 
 
-ServiceRoot::ServiceRoot(RootItem *parent) : RootItem(parent), m_accountId(NO_PARENT_CATEGORY) {
+ServiceRoot::ServiceRoot(RootItem *parent) : RootItem(parent), m_accountId(NO_PARENT_CATEGORY), m_feedAncestryOutdated(true) {
   setKind(RootItemKind::ServiceRoot);
   setCreationDate(QDateTime::currentDateTime());
 }
@@ -138,14 +141,18 @@ void ServiceRoot::cleanAllItems() {
   }
 }
 
-bool ServiceRoot::cleanFeeds(QList<Feed*> items, bool clean_read_only) {
+bool ServiceRoot::cleanCategory(Category *category, bool clean_read_only) {
   QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
 
-  if (DatabaseQueries::cleanFeeds(database, textualFeedIds(items), clean_read_only, accountId())) {
-    // Messages are cleared, now inform model about need to reload data.
+  if (category->id() <= 0 || !updateFeedAncestry()) {
+    // Fallback to listing all feeds of category.
+    return cleanFeeds(category->getSubTreeFeeds(), clean_read_only);
+  }
+
+  if (DatabaseQueries::cleanCategory(database, category->id(), clean_read_only, accountId())) {
     QList<RootItem*> itemss;
 
-    foreach (Feed *feed, items) {
+    foreach (Feed *feed, category->getSubTreeFeeds()) {
       feed->updateCounts(true);
       itemss.append(feed);
     }
@@ -166,30 +173,200 @@ bool ServiceRoot::cleanFeeds(QList<Feed*> items, bool clean_read_only) {
   }
 }
 
-void ServiceRoot::storeNewFeedTree(RootItem *root) {
+bool ServiceRoot::cleanFeeds(QList<Feed*> items, bool clean_read_only) {
   QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
 
-  if (DatabaseQueries::storeAccountTree(database, root, accountId())) {
+  if (DatabaseQueries::cleanFeeds(database, textualFeedIds(items), clean_read_only, accountId())) {
+    // Messages are cleared, now inform model about need to reload data.
+    QList<RootItem*> itemss;
+
+    foreach (Feed *feed, items) {
+      feed->updateCounts(true);
+      itemss.append(feed);
+    }
+
     RecycleBin *bin = recycleBin();
 
-    if (bin != nullptr && !childItems().contains(bin)) {
-      // As the last item, add recycle bin, which is needed.
-      appendChild(bin);
+    if (bin != nullptr) {
       bin->updateCounts(true);
+      itemss.append(bin);
     }
+
+    itemChanged(itemss);
+    requestReloadMessageList(true);
+    return true;
+  }
+  else {
+    return false;
   }
 }
 
-void ServiceRoot::removeLeftOverMessages() {
+QList<RootItem*> ServiceRoot::mergeNewFeedTree(RootItem *new_tree) {
   QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  const QList<Category*> old_categories_ordered = getSubTreeCategories();
+  QHash<int,Category*> old_categories = getHashedSubTreeCategories();
+  QHash<int,Feed*> old_feeds = getHashedSubTreeFeeds();
 
-  DatabaseQueries::purgeLeftoverMessages(database, accountId());
+  // Maps items of new tree to their counterparts in the model.
+  QHash<RootItem*,RootItem*> model_items;
+  QList<RootItem*> added_items, changed_items, unused_items, removed_items;
+
+  // Model is changed only after all changes are committed to DB.
+  QList<QPair<RootItem*,RootItem*> > reassignments;
+  QList<QPair<RootItem*,RootItem*> > renames;
+
+  if (!database.transaction()) {
+    qWarning("Transaction for sync-in failed: '%s'.", qPrintable(database.lastError().text()));
+    return added_items;
+  }
+
+  model_items.insert(new_tree, this);
+
+  // Items of new tree are visited so that each parent precedes its children.
+  // All of them are detached first, so that each can be either adopted
+  // by the model or thrown away independently of others.
+  const QList<RootItem*> new_items = new_tree->getSubTree();
+
+  foreach (RootItem *new_item, new_items) {
+    new_item->clearChildren();
+  }
+
+  foreach (RootItem *new_item, new_items) {
+    if (new_item == new_tree) {
+      continue;
+    }
+
+    RootItem *new_parent = model_items.value(new_item->parent());
+    RootItem *existing_item = nullptr;
+
+    if (new_parent == nullptr) {
+      // Parent of this item could not be merged.
+      unused_items.append(new_item);
+      continue;
+    }
+    else if (new_item->kind() == RootItemKind::Category) {
+      existing_item = old_categories.take(new_item->customId());
+    }
+    else if (new_item->kind() == RootItemKind::Feed) {
+      existing_item = old_feeds.take(new_item->customId());
+    }
+    else {
+      unused_items.append(new_item);
+      continue;
+    }
+
+    // Top-level items are stored with IDs of root of new tree, which
+    // are the same as those used for top-level items loaded from DB.
+    RootItem *stored_parent = new_parent == this ? new_tree : new_parent;
+
+    if (existing_item == nullptr) {
+      // This item is new, store it and add it to the model.
+      new_item->setParent(stored_parent);
+
+      if (DatabaseQueries::storeAccountItems(database, QList<RootItem*>() << new_item, accountId())) {
+        new_item->setParent(nullptr);
+        reassignments.append(QPair<RootItem*,RootItem*>(new_item, new_parent));
+
+        model_items.insert(new_item, new_item);
+        added_items.append(new_item);
+      }
+      else {
+        qWarning("Storing of new item '%s' failed.", qPrintable(new_item->title()));
+        unused_items.append(new_item);
+      }
+    }
+    else {
+      // Item exists, it might be renamed or moved.
+      if (existing_item->title() != new_item->title() || existing_item->parent() != new_parent) {
+        const bool placement_changed = existing_item->kind() == RootItemKind::Category ?
+                                         DatabaseQueries::editCategoryPlacement(database, existing_item->id(),
+                                                                                stored_parent->id(), new_item->title()) :
+                                         DatabaseQueries::editFeedPlacement(database, existing_item->id(),
+                                                                            stored_parent->customId(), new_item->title());
+
+        if (placement_changed) {
+          renames.append(QPair<RootItem*,RootItem*>(existing_item, new_item));
+          reassignments.append(QPair<RootItem*,RootItem*>(existing_item, new_parent));
+          changed_items.append(existing_item);
+        }
+      }
+
+      model_items.insert(new_item, existing_item);
+      unused_items.append(new_item);
+    }
+  }
+
+  // Items which are not in new tree do not exist anymore. Feeds go first,
+  // categories are removed from the deepest ones.
+  foreach (Feed *feed, old_feeds) {
+    if (DatabaseQueries::deleteFeed(database, feed->customId(), accountId())) {
+      removed_items.append(feed);
+    }
+  }
+
+  const QSet<Category*> removed_categories = old_categories.values().toSet();
+
+  for (int i = old_categories_ordered.size() - 1; i >= 0; i--) {
+    Category *category = old_categories_ordered.at(i);
+
+    if (removed_categories.contains(category) && DatabaseQueries::deleteCategory(database, category->id())) {
+      removed_items.append(category);
+    }
+  }
+
+  if (!database.commit()) {
+    qWarning("Committing of sync-in failed: '%s'.", qPrintable(database.lastError().text()));
+    database.rollback();
+
+    // Nothing was changed, none of new items is needed.
+    qDeleteAll(added_items);
+    qDeleteAll(unused_items);
+    new_tree->clearChildren();
+    return QList<RootItem*>();
+  }
+
+  typedef QPair<RootItem*,RootItem*> ItemPair;
+
+  foreach (const ItemPair &rename, renames) {
+    rename.first->setTitle(rename.second->title());
+  }
+
+  foreach (const ItemPair &reassignment, reassignments) {
+    requestItemReassignment(reassignment.first, reassignment.second);
+  }
+
+  foreach (RootItem *removed_item, removed_items) {
+    requestItemRemoval(removed_item);
+  }
+
+  qDeleteAll(unused_items);
+  new_tree->clearChildren();
+
+  RecycleBin *bin = recycleBin();
+
+  if (bin != nullptr && !childItems().contains(bin)) {
+    // As the last item, add recycle bin, which is needed.
+    requestItemReassignment(bin, this);
+    bin->updateCounts(true);
+  }
+
+  qDebug("Sync-in added %d, changed %d items of account %d.", added_items.size(), changed_items.size(), accountId());
+
+  if (!changed_items.isEmpty()) {
+    itemChanged(changed_items);
+  }
+
+  if (!removed_items.isEmpty()) {
+    requestReloadMessageList(false);
+  }
+
+  return added_items;
 }
 
-QList<Message> ServiceRoot::undeletedMessages() const {
+void ServiceRoot::removeLeftOverMessages() {
   QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
 
-  return DatabaseQueries::getUndeletedMessagesForAccount(database, accountId());
+  DatabaseQueries::purgeLeftoverMessages(database, accountId());
 }
 
 void ServiceRoot::itemChanged(const QList<RootItem*> &items) {
@@ -200,6 +377,10 @@ void ServiceRoot::requestReloadMessageList(bool mark_selected_messages_read) {
   emit reloadMessageListRequested(mark_selected_messages_read);
 }
 
+void ServiceRoot::messagesChanged(const MessagesChanges &changes) {
+  emit messagesChangesAvailable(changes);
+}
+
 void ServiceRoot::requestItemExpand(const QList<RootItem*> &items, bool expand) {
   emit itemExpandRequested(items, expand);
 }
@@ -212,6 +393,12 @@ void ServiceRoot::requestItemReassignment(RootItem *item, RootItem *new_parent)
   emit itemReassignmentRequested(item, new_parent);
 }
 
+void ServiceRoot::requestItemsAppend(const QList<QPair<RootItem*,RootItem*> > &items_with_parents) {
+  if (!items_with_parents.isEmpty()) {
+    emit itemsAppendRequested(items_with_parents);
+  }
+}
+
 void ServiceRoot::requestItemRemoval(RootItem *item) {
   emit itemRemovalRequested(item);
 }
@@ -225,52 +412,25 @@ void ServiceRoot::syncIn() {
   RootItem *new_tree = obtainNewTreeForSyncIn();
 
   if (new_tree != nullptr) {
-    // Purge old data from SQL and clean all model items.
-    requestItemExpandStateSave(this);
+    // Only differences between current and new tree are applied, so
+    // existing items keep their expand states, counts and selection.
+    const QList<RootItem*> added_items = mergeNewFeedTree(new_tree);
 
-    QMap<int,QVariant> feed_custom_data = storeCustomFeedsData();
-
-    removeOldFeedTree(false);
-    cleanAllItems();
-    restoreCustomFeedsData(feed_custom_data, new_tree->getHashedSubTreeFeeds());
-
-    // Model is clean, now store new tree into DB and
-    // set primary IDs of the items.
-    storeNewFeedTree(new_tree);
-
-    // We have new feed, some feeds were maybe removed,
-    // so remove left over messages.
-    removeLeftOverMessages();
-
-    foreach (RootItem *top_level_item, new_tree->childItems()) {
-      top_level_item->setParent(nullptr);
-      requestItemReassignment(top_level_item, this);
-    }
-
-    updateCounts(true);
-
-    new_tree->clearChildren();
     new_tree->deleteLater();
 
-    QList<RootItem*> all_items = getSubTree();
-
-    itemChanged(all_items);
-    requestReloadMessageList(true);
-
-    // Now we must refresh expand states.
+    // Now we must refresh expand states of newly added categories.
     QList<RootItem*> items_to_expand;
 
-    foreach (RootItem *item, all_items) {
-      if (qApp->settings()->value(GROUP(CategoriesExpandStates), item->hashCode(), item->childCount() > 0).toBool()) {
+    foreach (RootItem *item, added_items) {
+      if (item->kind() == RootItemKind::Category &&
+          qApp->settings()->value(GROUP(CategoriesExpandStates), item->hashCode(), item->childCount() > 0).toBool()) {
         items_to_expand.append(item);
       }
     }
 
-    if (!items_to_expand.contains(this)) {
-      items_to_expand.prepend(this);
+    if (!items_to_expand.isEmpty()) {
+      requestItemExpand(items_to_expand, true);
     }
-
-    requestItemExpand(items_to_expand, true);
   }
 
   setIcon(original_icon);
@@ -344,12 +504,73 @@ bool ServiceRoot::markFeedsReadUnread(QList<Feed*> items, RootItem::ReadStatus r
   }
 }
 
+bool ServiceRoot::markCategoryReadUnread(Category *category, RootItem::ReadStatus read) {
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+
+  if (category->id() <= 0 || !updateFeedAncestry()) {
+    // Fallback to listing all feeds of category.
+    return markFeedsReadUnread(category->getSubTreeFeeds(), read);
+  }
+
+  if (DatabaseQueries::markCategoryReadUnread(database, category->id(), accountId(), read)) {
+    QList<RootItem*> itemss;
+
+    foreach (Feed *feed, category->getSubTreeFeeds()) {
+      feed->updateCounts(false);
+      itemss.append(feed);
+    }
+
+    itemChanged(itemss);
+    requestReloadMessageList(read == RootItem::Read);
+    return true;
+  }
+  else {
+    return false;
+  }
+}
+
+void ServiceRoot::setFeedAncestryOutdated() {
+  m_feedAncestryOutdated = true;
+}
+
+bool ServiceRoot::updateFeedAncestry() const {
+  if (!m_feedAncestryOutdated) {
+    return true;
+  }
+
+  QList<QPair<int,int> > ancestry;
+
+  foreach (const Feed *feed, getSubTreeFeeds()) {
+    const int feed_id = feed->customId();
+
+    for (const RootItem *ancestor = feed->parent(); ancestor != nullptr; ancestor = ancestor->parent()) {
+      if (ancestor == this) {
+        ancestry.append(QPair<int,int>(NO_PARENT_CATEGORY, feed_id));
+        break;
+      }
+      else if (ancestor->kind() == RootItemKind::Category && ancestor->id() > 0) {
+        ancestry.append(QPair<int,int>(ancestor->id(), feed_id));
+      }
+    }
+  }
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+
+  if (DatabaseQueries::updateFeedAncestry(database, accountId(), ancestry)) {
+    m_feedAncestryOutdated = false;
+    return true;
+  }
+  else {
+    return false;
+  }
+}
+
 QStringList ServiceRoot::textualFeedIds(const QList<Feed*> &feeds) const {
   QStringList stringy_ids;
   stringy_ids.reserve(feeds.size());
 
   foreach (const Feed *feed, feeds) {
-    stringy_ids.append(QString("'%1'").arg(QString::number(feed->customId())));
+    stringy_ids.append(QString::number(feed->customId()));
   }
 
   return stringy_ids;
@@ -384,19 +605,33 @@ void ServiceRoot::setAccountId(int account_id) {
 }
 
 bool ServiceRoot::loadMessagesForItem(RootItem *item, QSqlTableModel *model) {
+  model->setFilter(messagesFilterForItem(item));
+  return true;
+}
+
+QString ServiceRoot::messagesFilterForItem(RootItem *item) const {
   if (item->kind() == RootItemKind::Bin) {
-    model->setFilter(QString("is_deleted = 1 AND is_pdeleted = 0 AND account_id = %1").arg(QString::number(accountId())));
+    return QString("is_deleted = 1 AND is_pdeleted = 0 AND account_id = %1").arg(QString::number(accountId()));
+  }
+  else if (item->kind() == RootItemKind::Feed) {
+    return QString("feed = %1 AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = %2").arg(QString::number(item->customId()),
+                                                                                               QString::number(accountId()));
+  }
+  else if ((item == this || (item->kind() == RootItemKind::Category && item->id() > 0)) && updateFeedAncestry()) {
+    const int category_id = item == this ? NO_PARENT_CATEGORY : item->id();
+
+    return QString("feed IN (SELECT feed FROM CategoriesFeeds WHERE category = %1 AND account_id = %2) AND "
+                   "is_deleted = 0 AND is_pdeleted = 0 AND account_id = %2").arg(QString::number(category_id),
+                                                                                 QString::number(accountId()));
   }
   else {
     QList<Feed*> children = item->getSubTreeFeeds();
     QString filter_clause = textualFeedIds(children).join(QSL(", "));
 
-    model->setFilter(QString("feed IN (%1) AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = %2").arg(filter_clause,
-                                                                                                            QString::number(accountId())));
-    qDebug("Loading messages from feeds: %s.", qPrintable(filter_clause));
+    qCDebug(LOGMODEL, "Loading messages from feeds: %s.", qPrintable(filter_clause));
+    return QString("feed IN (%1) AND is_deleted = 0 AND is_pdeleted = 0 AND account_id = %2").arg(filter_clause,
+                                                                                                  QString::number(accountId()));
   }
-
-  return true;
 }
 
 bool ServiceRoot::onBeforeSetMessagesRead(RootItem *selected_item, const QList<Message> &messages, RootItem::ReadStatus read) {
@@ -477,6 +712,10 @@ bool ServiceRoot::onAfterMessagesRestoredFromBin(RootItem *selected_item, const
   return true;
 }
 
+void ServiceRoot::requestMessageContents(const Message &message) {
+  Q_UNUSED(message)
+}
+
 void ServiceRoot::assembleFeeds(Assignment feeds) {
   QHash<int,Category*> categories = getHashedSubTreeCategories();
 
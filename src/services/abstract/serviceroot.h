@@ -71,8 +71,6 @@ class ServiceRoot : public RootItem {
 
     void updateCounts(bool including_total_count);
 
-    QList<Message> undeletedMessages() const;
-
     // Start/stop services.
     // Start method is called when feed model gets initialized OR after user adds new service.
     // Account should synchronously initialize its children (load them from DB is recommended
@@ -94,6 +92,9 @@ class ServiceRoot : public RootItem {
     // Removes all/read only messages from given underlying feeds.
     bool cleanFeeds(QList<Feed*> items, bool clean_read_only);
 
+    // Removes all/read only messages from all feeds of given category.
+    bool cleanCategory(Category *category, bool clean_read_only);
+
     // This method should prepare messages for given "item" (download them maybe?)
     // into predefined "Messages" table
     // and then use method QSqlTableModel::setFilter(....).
@@ -101,6 +102,9 @@ class ServiceRoot : public RootItem {
     // right when feeds are updated.
     virtual bool loadMessagesForItem(RootItem *item, QSqlTableModel *model);
 
+    // Returns SQL condition which selects (undeleted) messages of given item.
+    QString messagesFilterForItem(RootItem *item) const;
+
     // Called BEFORE this read status update (triggered by user in message list) is stored in DB,
     // when false is returned, change is aborted.
     // This is the place to make some other changes like updating
@@ -151,16 +155,33 @@ class ServiceRoot : public RootItem {
     // Selected item is naturally recycle bin.
     virtual bool onAfterMessagesRestoredFromBin(RootItem *selected_item, const QList<Message> &messages);
 
+    // Called when message, which was synchronized without contents (only headline),
+    // is about to be displayed. Service root should download full contents of the message
+    // in background, store them and announce the message as updated via messagesChanged().
+    virtual void requestMessageContents(const Message &message);
+
     void completelyRemoveAllData();
     QStringList customIDSOfMessagesForItem(RootItem *item);
     bool markFeedsReadUnread(QList<Feed*> items, ReadStatus read);
+    bool markCategoryReadUnread(Category *category, ReadStatus read);
+
+    // Stored ancestry of feeds (which categories contain which feeds) is used by
+    // category-level SQL queries. It is synchronized with the tree lazily, before
+    // it is needed after any change of the tree.
+    void setFeedAncestryOutdated();
+    bool updateFeedAncestry() const;
 
     // Obvious methods to wrap signals.
     void itemChanged(const QList<RootItem*> &items);
     void requestReloadMessageList(bool mark_selected_messages_read);
+    void messagesChanged(const MessagesChanges &changes);
     void requestItemExpand(const QList<RootItem*> &items, bool expand);
     void requestItemExpandStateSave(RootItem *subtree_root);
     void requestItemReassignment(RootItem *item, RootItem *new_parent);
+
+    // Appends many new items, each under its new parent,
+    // with single notification of the model.
+    void requestItemsAppend(const QList<QPair<RootItem*,RootItem*> > &items_with_parents);
     void requestItemRemoval(RootItem *item);
 
   public slots:
@@ -176,7 +197,6 @@ class ServiceRoot : public RootItem {
     // Removes all messages/categories/feeds which are
     // associated with this account.
     void removeOldFeedTree(bool including_messages);
-    void storeNewFeedTree(RootItem *root);
     void cleanAllItems();
 
     // Removes messages which do not belong to any
@@ -186,6 +206,10 @@ class ServiceRoot : public RootItem {
     // from another machine and then performs sync-in on this machine.
     void removeLeftOverMessages();
 
+    // Applies differences between current tree and given new tree, items
+    // are matched by their custom IDs. Returns items which were added.
+    QList<RootItem*> mergeNewFeedTree(RootItem *new_tree);
+
     QStringList textualFeedIds(const QList<Feed*> &feeds) const;
     QStringList customIDsOfMessages(const QList<ImportanceChange> &changes);
     QStringList customIDsOfMessages(const QList<Message> &messages);
@@ -198,17 +222,17 @@ class ServiceRoot : public RootItem {
     // Emitted if data in any item belonging to this root are changed.
     void dataChanged(QList<RootItem*> items);
     void reloadMessageListRequested(bool mark_selected_messages_read);
+    void messagesChangesAvailable(MessagesChanges changes);
     void itemExpandRequested(QList<RootItem*> items, bool expand);
     void itemExpandStateSaveRequested(RootItem *subtree_root);
 
     void itemReassignmentRequested(RootItem *item, RootItem *new_parent);
+    void itemsAppendRequested(QList<QPair<RootItem*,RootItem*> > items_with_parents);
     void itemRemovalRequested(RootItem *item);
 
   private:
-    virtual QMap<int,QVariant> storeCustomFeedsData() = 0;
-    virtual void restoreCustomFeedsData(const QMap<int,QVariant> &data, const QHash<int,Feed*> &feeds) = 0;
-
     int m_accountId;
+    mutable bool m_feedAncestryOutdated;
 };
 
 #endif // SERVICEROOT_H
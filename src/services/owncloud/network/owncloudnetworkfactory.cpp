@@ -21,6 +21,7 @@
 #include "network-web/networkfactory.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/settings.h"
+#include "miscellaneous/jsonstreamreader.h"
 #include "miscellaneous/textfactory.h"
 #include "services/abstract/rootitem.h"
 #include "services/owncloud/owncloudcategory.h"
@@ -110,7 +111,7 @@ OwnCloudUserResponse OwnCloudNetworkFactory::userInfo() {
                                                                         QNetworkAccessManager::GetOperation,
                                                                         true, m_authUsername, m_authPassword,
                                                                         true);
-  OwnCloudUserResponse user_response(QString::fromUtf8(result_raw));
+  OwnCloudUserResponse user_response(result_raw);
 
   if (network_reply.first != QNetworkReply::NoError) {
     qWarning("ownCloud: Obtaining user info failed with error %d.", network_reply.first);
@@ -129,7 +130,7 @@ OwnCloudStatusResponse OwnCloudNetworkFactory::status() {
                                                                         QNetworkAccessManager::GetOperation,
                                                                         true, m_authUsername, m_authPassword,
                                                                         true);
-  OwnCloudStatusResponse status_response(QString::fromUtf8(result_raw));
+  OwnCloudStatusResponse status_response(result_raw);
 
   if (network_reply.first != QNetworkReply::NoError) {
     qWarning("ownCloud: Obtaining status info failed with error %d.", network_reply.first);
@@ -155,7 +156,7 @@ OwnCloudGetFeedsCategoriesResponse OwnCloudNetworkFactory::feedsCategories() {
     return OwnCloudGetFeedsCategoriesResponse();
   }
 
-  QString content_categories = QString::fromUtf8(result_raw);
+  QByteArray content_categories = result_raw;
 
   // Now, obtain feeds.
   network_reply = NetworkFactory::performNetworkOperation(m_urlFeeds,
@@ -171,7 +172,7 @@ OwnCloudGetFeedsCategoriesResponse OwnCloudNetworkFactory::feedsCategories() {
     return OwnCloudGetFeedsCategoriesResponse();
   }
 
-  QString content_feeds = QString::fromUtf8(result_raw);
+  QByteArray content_feeds = result_raw;
   m_lastError = network_reply.first;
 
   return OwnCloudGetFeedsCategoriesResponse(content_categories, content_feeds);
@@ -267,7 +268,7 @@ OwnCloudGetMessagesResponse OwnCloudNetworkFactory::getMessages(int feed_id) {
                                                                         QNetworkAccessManager::GetOperation,
                                                                         true, m_authUsername, m_authPassword,
                                                                         true);
-  OwnCloudGetMessagesResponse msgs_response(QString::fromUtf8(result_raw));
+  OwnCloudGetMessagesResponse msgs_response(result_raw);
 
   if (network_reply.first != QNetworkReply::NoError) {
     qWarning("ownCloud: Obtaining messages failed with error %d.", network_reply.first);
@@ -398,8 +399,14 @@ void OwnCloudNetworkFactory::setUserId(const QString &userId) {
   m_userId = userId;
 }
 
-OwnCloudResponse::OwnCloudResponse(const QString &raw_content) {
-  m_rawContent = QJsonDocument::fromJson(raw_content.toUtf8()).object();
+OwnCloudResponse::OwnCloudResponse(const QByteArray &raw_content, const QString &streamed_member)
+  : m_rawData(raw_content), m_streamedOffset(-1) {
+  if (streamed_member.isEmpty()) {
+    m_rawContent = QJsonDocument::fromJson(raw_content).object();
+  }
+  else {
+    m_rawContent = JsonStreamReader::readObject(raw_content, streamed_member, &m_streamedOffset);
+  }
 }
 
 OwnCloudResponse::~OwnCloudResponse() {
@@ -410,10 +417,10 @@ bool OwnCloudResponse::isLoaded() const {
 }
 
 QString OwnCloudResponse::toString() const {
-  return QJsonDocument(m_rawContent).toJson(QJsonDocument::Compact);
+  return QString::fromUtf8(m_rawData);
 }
 
-OwnCloudUserResponse::OwnCloudUserResponse(const QString &raw_content) : OwnCloudResponse(raw_content) {
+OwnCloudUserResponse::OwnCloudUserResponse(const QByteArray &raw_content) : OwnCloudResponse(raw_content) {
 }
 
 OwnCloudUserResponse::~OwnCloudUserResponse() {
@@ -461,7 +468,7 @@ QIcon OwnCloudUserResponse::avatar() const {
 }
 
 
-OwnCloudStatusResponse::OwnCloudStatusResponse(const QString &raw_content) : OwnCloudResponse(raw_content) {
+OwnCloudStatusResponse::OwnCloudStatusResponse(const QByteArray &raw_content) : OwnCloudResponse(raw_content) {
 }
 
 OwnCloudStatusResponse::~OwnCloudStatusResponse() {
@@ -486,8 +493,8 @@ bool OwnCloudStatusResponse::misconfiguredCron() const {
 }
 
 
-OwnCloudGetFeedsCategoriesResponse::OwnCloudGetFeedsCategoriesResponse(const QString &raw_categories,
-                                                                       const QString &raw_feeds)
+OwnCloudGetFeedsCategoriesResponse::OwnCloudGetFeedsCategoriesResponse(const QByteArray &raw_categories,
+                                                                       const QByteArray &raw_feeds)
   : m_contentCategories(raw_categories), m_contentFeeds(raw_feeds) {
 }
 
@@ -501,7 +508,7 @@ RootItem *OwnCloudGetFeedsCategoriesResponse::feedsCategories(bool obtain_icons)
   cats.insert(0, parent);
 
   // Process categories first, then process feeds.
-  foreach (QJsonValue cat, QJsonDocument::fromJson(m_contentCategories.toUtf8()).object()["folders"].toArray()) {
+  foreach (QJsonValue cat, QJsonDocument::fromJson(m_contentCategories).object()["folders"].toArray()) {
     QJsonObject item = cat.toObject();
     OwnCloudCategory *category = new OwnCloudCategory();
 
@@ -515,7 +522,7 @@ RootItem *OwnCloudGetFeedsCategoriesResponse::feedsCategories(bool obtain_icons)
   }
 
   // We have categories added, now add all feeds.
-  foreach (QJsonValue fed, QJsonDocument::fromJson(m_contentFeeds.toUtf8()).object()["feeds"].toArray()) {
+  foreach (QJsonValue fed, QJsonDocument::fromJson(m_contentFeeds).object()["feeds"].toArray()) {
     QJsonObject item = fed.toObject();
     OwnCloudFeed *feed = new OwnCloudFeed();
 
@@ -547,7 +554,7 @@ RootItem *OwnCloudGetFeedsCategoriesResponse::feedsCategories(bool obtain_icons)
 }
 
 
-OwnCloudGetMessagesResponse::OwnCloudGetMessagesResponse(const QString &raw_content) : OwnCloudResponse(raw_content) {
+OwnCloudGetMessagesResponse::OwnCloudGetMessagesResponse(const QByteArray &raw_content) : OwnCloudResponse(raw_content, QSL("items")) {
 }
 
 OwnCloudGetMessagesResponse::~OwnCloudGetMessagesResponse() {
@@ -556,36 +563,103 @@ OwnCloudGetMessagesResponse::~OwnCloudGetMessagesResponse() {
 QList<Message> OwnCloudGetMessagesResponse::messages() const {
   QList<Message> msgs;
 
-  foreach (QJsonValue message, m_rawContent["items"].toArray()) {
-    QJsonObject message_map = message.toObject();
+  if (m_streamedOffset < 0) {
+    return msgs;
+  }
+
+  // Items are read directly from raw data, one by one.
+  JsonStreamReader reader(m_rawData, m_streamedOffset);
+
+  if (!reader.readNext() || reader.tokenType() != JsonStreamReader::StartArray) {
+    return msgs;
+  }
+
+  while (reader.readNext() && reader.tokenType() != JsonStreamReader::EndArray) {
+    if (reader.tokenType() != JsonStreamReader::StartObject) {
+      reader.skipValue();
+      continue;
+    }
+
     Message msg;
+    QString enclosure_link;
+    QString enclosure_mime;
 
-    msg.m_author = message_map["author"].toString();
-    msg.m_contents = message_map["body"].toString();
-    msg.m_created = TextFactory::parseDateTime(message_map["pubDate"].toDouble() * 1000);
     msg.m_createdFromFeed = true;
-    msg.m_customId = QString::number(message_map["id"].toInt());
-    msg.m_customHash = message_map["guidHash"].toString();
 
-    QString enclosure_link = message_map["enclosureLink"].toString();
+    // Messages without valid "unread" flag are considered read.
+    msg.m_isRead = true;
+    msg.m_isImportant = false;
+
+    while (reader.readNext() && reader.tokenType() == JsonStreamReader::Name) {
+      const QString name = reader.text();
+
+      if (!reader.readNext()) {
+        break;
+      }
+
+      if (!reader.isScalar()) {
+        // Structured values are not used, they are skipped as a whole
+        // so that reader stays in sync with the document.
+        reader.skipValue();
+        continue;
+      }
+
+      if (name == QL1S("author")) {
+        msg.m_author = reader.text();
+      }
+      else if (name == QL1S("body")) {
+        msg.m_contents = reader.text();
+      }
+      else if (name == QL1S("pubDate")) {
+        msg.m_created = TextFactory::parseDateTime(reader.number() * 1000);
+      }
+      else if (name == QL1S("id")) {
+        msg.m_customId = QString::number((int) reader.number());
+      }
+      else if (name == QL1S("guidHash")) {
+        msg.m_customHash = reader.text();
+      }
+      else if (name == QL1S("enclosureLink")) {
+        enclosure_link = reader.text();
+      }
+      else if (name == QL1S("enclosureMime")) {
+        enclosure_mime = reader.text();
+      }
+      else if (name == QL1S("feedId")) {
+        msg.m_feedId = QString::number((int) reader.number());
+      }
+      else if (name == QL1S("starred")) {
+        msg.m_isImportant = reader.boolean();
+      }
+      else if (name == QL1S("unread")) {
+        msg.m_isRead = !reader.boolean();
+      }
+      else if (name == QL1S("title")) {
+        msg.m_title = reader.text();
+      }
+      else if (name == QL1S("url")) {
+        msg.m_url = reader.text();
+      }
+      else {
+        reader.skipValue();
+      }
+    }
 
     if (!enclosure_link.isEmpty()) {
       Enclosure enclosure;
 
-      enclosure.m_mimeType = message_map["enclosureMime"].toString();
+      enclosure.m_mimeType = enclosure_mime;
       enclosure.m_url = enclosure_link;
 
       msg.m_enclosures.append(enclosure);
     }
 
-    msg.m_feedId = QString::number(message_map["feedId"].toInt());
-    msg.m_isImportant = message_map["starred"].toBool();
-    msg.m_isRead = !message_map["unread"].toBool();
-    msg.m_title = message_map["title"].toString();
-    msg.m_url = message_map["url"].toString();
-
     msgs.append(msg);
   }
 
+  if (reader.hasError()) {
+    qWarning("ownCloud: Messages data are not well-formed, %d messages were read.", msgs.size());
+  }
+
   return msgs;
 }
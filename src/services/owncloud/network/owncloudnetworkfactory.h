@@ -23,6 +23,7 @@
 
 #include <QDateTime>
 #include <QString>
+#include <QByteArray>
 #include <QIcon>
 #include <QNetworkReply>
 #include <QJsonObject>
@@ -30,19 +31,23 @@
 
 class OwnCloudResponse {
   public:
-    explicit OwnCloudResponse(const QString &raw_content = QString());
+    // NOTE: If "streamed_member" is given and it is array, then it is not
+    // parsed into JSON tree, it is read directly from raw data when needed.
+    explicit OwnCloudResponse(const QByteArray &raw_content = QByteArray(), const QString &streamed_member = QString());
     virtual ~OwnCloudResponse();
 
     bool isLoaded() const;
     QString toString() const;
 
   protected:
+    QByteArray m_rawData;
     QJsonObject m_rawContent;
+    int m_streamedOffset;
 };
 
 class OwnCloudUserResponse : public OwnCloudResponse {
   public:
-    explicit OwnCloudUserResponse(const QString &raw_content = QString());
+    explicit OwnCloudUserResponse(const QByteArray &raw_content = QByteArray());
     virtual ~OwnCloudUserResponse();
 
     QString userId() const;
@@ -53,7 +58,7 @@ class OwnCloudUserResponse : public OwnCloudResponse {
 
 class OwnCloudGetMessagesResponse : public OwnCloudResponse {
   public:
-    explicit OwnCloudGetMessagesResponse(const QString &raw_content = QString());
+    explicit OwnCloudGetMessagesResponse(const QByteArray &raw_content = QByteArray());
     virtual ~OwnCloudGetMessagesResponse();
 
     QList<Message> messages() const;
@@ -61,7 +66,7 @@ class OwnCloudGetMessagesResponse : public OwnCloudResponse {
 
 class OwnCloudStatusResponse : public OwnCloudResponse {
   public:
-    explicit OwnCloudStatusResponse(const QString &raw_content = QString());
+    explicit OwnCloudStatusResponse(const QByteArray &raw_content = QByteArray());
     virtual ~OwnCloudStatusResponse();
 
     QString version() const;
@@ -72,8 +77,8 @@ class RootItem;
 
 class OwnCloudGetFeedsCategoriesResponse {
   public:
-    explicit OwnCloudGetFeedsCategoriesResponse(const QString &raw_categories = QString(),
-                                                const QString &raw_feeds = QString());
+    explicit OwnCloudGetFeedsCategoriesResponse(const QByteArray &raw_categories = QByteArray(),
+                                                const QByteArray &raw_feeds = QByteArray());
     virtual ~OwnCloudGetFeedsCategoriesResponse();
 
     // Returns tree of feeds/categories.
@@ -82,8 +87,8 @@ class OwnCloudGetFeedsCategoriesResponse {
     RootItem *feedsCategories(bool obtain_icons) const;
 
   private:
-    QString m_contentCategories;
-    QString m_contentFeeds;
+    QByteArray m_contentCategories;
+    QByteArray m_contentFeeds;
 };
 
 class OwnCloudNetworkFactory {
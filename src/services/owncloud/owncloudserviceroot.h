@@ -56,8 +56,6 @@ class OwnCloudServiceRoot : public ServiceRoot {
     void addNewCategory();
 
   private:
-    QMap<int,QVariant> storeCustomFeedsData();
-    void restoreCustomFeedsData(const QMap<int,QVariant> &data, const QHash<int,Feed*> &feeds);
     RootItem *obtainNewTreeForSyncIn() const;
 
     void loadFromDatabase();
@@ -30,6 +30,7 @@
 
 
 #include <QFileDialog>
+#include <QSaveFile>
 #include <QTextStream>
 
 
@@ -41,6 +42,10 @@ FormStandardImportExport::FormStandardImportExport(StandardServiceRoot *service_
   connect(m_model, SIGNAL(parsingStarted()), this, SLOT(onParsingStarted()));
   connect(m_model, SIGNAL(parsingFinished(int,int,bool)), this, SLOT(onParsingFinished(int,int,bool)));
   connect(m_model, SIGNAL(parsingProgress(int,int)), this, SLOT(onParsingProgress(int,int)));
+  connect(m_model, SIGNAL(exportingProgress(int,int)), this, SLOT(onParsingProgress(int,int)));
+
+  // Imported feeds are shown as soon as their metadata are fetched.
+  connect(m_model, SIGNAL(layoutChanged()), m_ui->m_treeFeeds, SLOT(expandAll()));
 
   setWindowFlags(Qt::MSWindowsFixedSizeDialogHint | Qt::Dialog | Qt::WindowSystemMenuHint);
 
@@ -57,6 +62,16 @@ FormStandardImportExport::FormStandardImportExport(StandardServiceRoot *service_
 FormStandardImportExport::~FormStandardImportExport() {
 }
 
+void FormStandardImportExport::reject() {
+  if (m_model->isParsing()) {
+    // Feeds which were fetched so far are kept.
+    m_model->cancelParsing();
+  }
+  else {
+    QDialog::reject();
+  }
+}
+
 void FormStandardImportExport::setMode(const FeedsImportExportModel::Mode &mode) {
   m_model->setMode(mode);
   m_ui->m_progressBar->setVisible(false);
@@ -80,6 +95,7 @@ void FormStandardImportExport::setMode(const FeedsImportExportModel::Mode &mode)
       m_ui->m_groupFile->setTitle(tr("Source file"));
       m_ui->m_groupFeeds->setTitle(tr("Target feeds && categories"));
       m_ui->m_groupFeeds->setDisabled(true);
+      m_ui->m_treeFeeds->setModel(m_model);
 
       // Load categories.
       loadCategories(m_serviceRoot->getSubTreeCategories(), m_serviceRoot);
@@ -133,7 +149,6 @@ void FormStandardImportExport::onParsingFinished(int count_failed, int count_suc
     m_ui->m_lblResult->setStatus(WidgetWithStatus::Ok, tr("Feeds were loaded."), tr("Feeds were loaded."));
     m_ui->m_groupFeeds->setEnabled(true);
     m_ui->m_btnSelectFile->setEnabled(true);
-    m_ui->m_treeFeeds->setModel(m_model);
     m_ui->m_treeFeeds->expandAll();
   }
   else {
@@ -269,9 +284,35 @@ void FormStandardImportExport::exportFeeds() {
   bool result_export = false;
 
   switch (m_conversionType) {
-    case OPML20:
-      result_export = m_model->exportToOMPL20(result_data);
-      break;
+    case OPML20: {
+      // OPML is written directly into the destination file.
+      QSaveFile output_file(m_ui->m_lblSelectFile->label()->text());
+
+      if (!output_file.open(QIODevice::WriteOnly)) {
+        m_ui->m_lblResult->setStatus(WidgetWithStatus::Error,
+                                     tr("Cannot write into destination file: '%1'.").arg(output_file.errorString()),
+                                     output_file.errorString());
+        return;
+      }
+
+      m_ui->m_progressBar->setValue(0);
+      m_ui->m_progressBar->setVisible(true);
+
+      result_export = m_model->exportToOMPL20(&output_file) && output_file.commit();
+
+      m_ui->m_progressBar->setVisible(false);
+
+      if (result_export) {
+        m_ui->m_lblResult->setStatus(WidgetWithStatus::Ok, tr("Feeds were exported successfully."), tr("Feeds were exported successfully."));
+      }
+      else {
+        m_ui->m_lblResult->setStatus(WidgetWithStatus::Error,
+                                     tr("Cannot write into destination file: '%1'.").arg(output_file.errorString()),
+                                     output_file.errorString());
+      }
+
+      return;
+    }
 
     case TXTUrlPerLine:
       result_export = m_model->exportToTxtURLPerLine(result_data);
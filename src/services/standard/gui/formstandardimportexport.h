@@ -45,6 +45,11 @@ class FormStandardImportExport : public QDialog {
 
     void setMode(const FeedsImportExportModel::Mode &mode);
 
+  public slots:
+    // Cancels running import first, dialog is closed
+    // only if no import is running.
+    void reject();
+
   private slots:
     void performAction();
     void selectFile();
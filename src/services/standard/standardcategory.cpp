@@ -114,11 +114,11 @@ bool StandardCategory::deleteViaGui() {
 }
 
 bool StandardCategory::markAsReadUnread(ReadStatus status) {
-  return serviceRoot()->markFeedsReadUnread(getSubTreeFeeds(), status);
+  return serviceRoot()->markCategoryReadUnread(this, status);
 }
 
 bool StandardCategory::cleanMessages(bool clean_read_only) {
-  return serviceRoot()->cleanFeeds(getSubTreeFeeds(), clean_read_only);
+  return serviceRoot()->cleanCategory(this, clean_read_only);
 }
 
 bool StandardCategory::removeItself() {
@@ -190,5 +190,5 @@ StandardCategory::StandardCategory(const QSqlRecord &record) : Category(nullptr)
   setTitle(record.value(CAT_DB_TITLE_INDEX).toString());
   setDescription(record.value(CAT_DB_DESCRIPTION_INDEX).toString());
   setCreationDate(TextFactory::parseDateTime(record.value(CAT_DB_DCREATED_INDEX).value<qint64>()).toLocalTime());
-  setIcon(qApp->icons()->fromByteArray(record.value(CAT_DB_ICON_INDEX).toByteArray()));
+  setIcon(qApp->icons()->fromStoreReference(record.value(CAT_DB_ICON_INDEX).toByteArray()));
 }
@@ -19,6 +19,7 @@
 
 #include "definitions/definitions.h"
 #include "core/parsingfactory.h"
+#include "core/feedstreamparser.h"
 #include "core/feedsmodel.h"
 #include "miscellaneous/databasequeries.h"
 #include "miscellaneous/textfactory.h"
@@ -26,6 +27,7 @@
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/simplecrypt/simplecrypt.h"
 #include "network-web/networkfactory.h"
+#include "network-web/faviconresolver.h"
 #include "gui/feedmessageviewer.h"
 #include "gui/feedsview.h"
 #include "services/abstract/recyclebin.h"
@@ -39,6 +41,7 @@
 #include <QDomNode>
 #include <QDomElement>
 #include <QXmlStreamReader>
+#include <QElapsedTimer>
 
 
 StandardFeed::StandardFeed(RootItem *parent_item)
@@ -49,6 +52,7 @@ StandardFeed::StandardFeed(RootItem *parent_item)
   m_networkError = QNetworkReply::NoError;
   m_type = Rss0X;
   m_encoding = QString();
+  m_iconLocations = QStringList();
 }
 
 StandardFeed::StandardFeed(const StandardFeed &other)
@@ -59,6 +63,7 @@ StandardFeed::StandardFeed(const StandardFeed &other)
   m_networkError = other.networkError();
   m_type = other.type();
   m_encoding = other.encoding();
+  m_iconLocations = other.iconLocations();
 
   setCountOfAllMessages(other.countOfAllMessages());
   setCountOfUnreadMessages(other.countOfUnreadMessages());
@@ -193,7 +198,19 @@ void StandardFeed::fetchMetadataForItself() {
     metadata.first->setAutoUpdateType(autoUpdateType());
     metadata.first->setAutoUpdateInitialInterval(autoUpdateInitialInterval());
 
+    const bool icon_pending = metadata.first->icon().isNull();
+
+    if (icon_pending) {
+      // Keep current icon until new one is resolved.
+      metadata.first->setIcon(icon());
+    }
+
     editItself(metadata.first);
+
+    if (icon_pending) {
+      serviceRoot()->requestFeedIcon(this, metadata.first->iconLocations());
+    }
+
     delete metadata.first;
 
     // Notify the model about fact, that it needs to reload new information about
@@ -209,9 +226,8 @@ void StandardFeed::fetchMetadataForItself() {
 
 QPair<StandardFeed*,QNetworkReply::NetworkError> StandardFeed::guessFeed(const QString &url,
                                                                          const QString &username,
-                                                                         const QString &password) {
-  QPair<StandardFeed*,QNetworkReply::NetworkError> result; result.first = nullptr;
-
+                                                                         const QString &password,
+                                                                         bool fetch_icon) {
   QByteArray feed_contents;
   NetworkResult network_result = NetworkFactory::downloadFeedFile(url,
                                                                   qApp->settings()->value(GROUP(Feeds),
@@ -220,7 +236,17 @@ QPair<StandardFeed*,QNetworkReply::NetworkError> StandardFeed::guessFeed(const Q
                                                                   !username.isEmpty(),
                                                                   username,
                                                                   password);
-  result.second = network_result.first;
+
+  return guessFeedFromData(url, feed_contents, network_result.first, fetch_icon);
+}
+
+QPair<StandardFeed*,QNetworkReply::NetworkError> StandardFeed::guessFeedFromData(const QString &url,
+                                                                                 const QByteArray &feed_contents,
+                                                                                 QNetworkReply::NetworkError network_error,
+                                                                                 bool fetch_icon) {
+  QPair<StandardFeed*,QNetworkReply::NetworkError> result; result.first = nullptr;
+
+  result.second = network_error;
 
   if (result.second == QNetworkReply::NoError || !feed_contents.isEmpty()) {
     // Feed XML was obtained, now we need to try to guess
@@ -337,15 +363,19 @@ QPair<StandardFeed*,QNetworkReply::NetworkError> StandardFeed::guessFeed(const Q
       result.second = QNetworkReply::UnknownContentError;
     }
 
-    // Try to obtain icon.
-    QIcon icon_data;
+    // Try to obtain icon. Sites are resolved in background and the first one
+    // (in order of priority) which has an icon is used.
+    bool icon_resolved;
+    const QIcon icon_data = qApp->favicons()->preferredIcon(icon_possible_locations, &icon_resolved);
+
+    result.first->m_iconLocations = icon_possible_locations;
 
-    if ((result.second = NetworkFactory::downloadIcon(icon_possible_locations,
-                                                      DOWNLOAD_TIMEOUT,
-                                                      icon_data)) == QNetworkReply::NoError) {
-      // Icon for feed was downloaded and is stored now in _icon_data.
+    if (!icon_data.isNull()) {
       result.first->setIcon(icon_data);
     }
+    else if (!icon_resolved && fetch_icon) {
+      qApp->favicons()->requestIcons(icon_possible_locations);
+    }
   }
 
   return result;
@@ -431,10 +461,16 @@ bool StandardFeed::editItself(StandardFeed *new_feed_data) {
 }
 
 QList<Message> StandardFeed::obtainNewMessages(bool *error_during_obtaining) {
+  const int download_timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
+  const int max_messages = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::MaxMessagesPerUpdate)).toInt();
+
+  if (qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::IncrementalParsing)).toBool()) {
+    return obtainNewMessagesIncrementally(download_timeout, max_messages, error_during_obtaining);
+  }
+
   QByteArray feed_contents;
-  int download_timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
   m_networkError = NetworkFactory::downloadFeedFile(url(), download_timeout, feed_contents,
-                                                    passwordProtected(), username(), password()).first;
+                                                    passwordProtected(), username(), password(), &telemetry()).first;
 
   if (m_networkError != QNetworkReply::NoError) {
     qWarning("Error during fetching of new messages for feed '%s' (id %d).", qPrintable(url()), id());
@@ -447,6 +483,9 @@ QList<Message> StandardFeed::obtainNewMessages(bool *error_during_obtaining) {
     *error_during_obtaining = false;
   }
 
+  QElapsedTimer timer;
+  timer.start();
+
   // Encode downloaded data for further parsing.
   QTextCodec *codec = QTextCodec::codecForName(encoding().toLocal8Bit());
   QString formatted_feed_contents;
@@ -460,6 +499,9 @@ QList<Message> StandardFeed::obtainNewMessages(bool *error_during_obtaining) {
     formatted_feed_contents = codec->toUnicode(feed_contents);
   }
 
+  telemetry().m_decodeTime = timer.nsecsElapsed() / 1000;
+  timer.restart();
+
   // Feed data are downloaded and encoded.
   // Parse data and obtain messages.
   QList<Message> messages;
@@ -481,20 +523,80 @@ QList<Message> StandardFeed::obtainNewMessages(bool *error_during_obtaining) {
       break;
   }
 
+  if (max_messages > 0 && messages.size() > max_messages) {
+    messages = messages.mid(0, max_messages);
+  }
+
+  telemetry().m_parseTime = timer.nsecsElapsed() / 1000;
   return messages;
 }
 
+QList<Message> StandardFeed::obtainNewMessagesIncrementally(int download_timeout, int max_messages,
+                                                            bool *error_during_obtaining) {
+  FeedStreamParser::Format format;
+
+  switch (type()) {
+    case StandardFeed::Rdf:
+      format = FeedStreamParser::RDF;
+      break;
+
+    case StandardFeed::Atom10:
+      format = FeedStreamParser::ATOM10;
+      break;
+
+    case StandardFeed::Rss0X:
+    case StandardFeed::Rss2X:
+    default:
+      format = FeedStreamParser::RSS20;
+      break;
+  }
+
+  // Downloaded data are decoded and parsed as they arrive.
+  FeedStreamParser parser(format, encoding(), max_messages);
+  m_networkError = NetworkFactory::downloadFeedFile(url(), download_timeout, parser,
+                                                    passwordProtected(), username(), password(), &telemetry()).first;
+
+  // Parsing ran while data were downloaded, so it is not accounted to the download.
+  telemetry().m_decodeTime = parser.decodeTime();
+  telemetry().m_parseTime = parser.parseTime();
+  telemetry().m_downloadTime = qMax(telemetry().m_downloadTime - parser.decodeTime() - parser.parseTime(), Q_INT64_C(0));
+
+  if (m_networkError != QNetworkReply::NoError) {
+    qWarning("Error during fetching of new messages for feed '%s' (id %d).", qPrintable(url()), id());
+    setStatus(NetworkError);
+    *error_during_obtaining = true;
+    return QList<Message>();
+  }
+  else if (parser.hasError()) {
+    qWarning("Data of feed '%s' (id %d) are not well-formed or are truncated: '%s'.",
+             qPrintable(url()), id(), qPrintable(parser.errorString()));
+    setStatus(ParsingError);
+    *error_during_obtaining = true;
+    return QList<Message>();
+  }
+  else if (status() != NewMessages) {
+    setStatus(Normal);
+  }
+
+  *error_during_obtaining = false;
+  return parser.messages();
+}
+
 QNetworkReply::NetworkError StandardFeed::networkError() const {
   return m_networkError;
 }
 
+QStringList StandardFeed::iconLocations() const {
+  return m_iconLocations;
+}
+
 StandardFeed::StandardFeed(const QSqlRecord &record) : Feed(nullptr) {
   setTitle(record.value(FDS_DB_TITLE_INDEX).toString());
   setId(record.value(FDS_DB_ID_INDEX).toInt());
   setCustomId(id());
   setDescription(record.value(FDS_DB_DESCRIPTION_INDEX).toString());
   setCreationDate(TextFactory::parseDateTime(record.value(FDS_DB_DCREATED_INDEX).value<qint64>()).toLocalTime());
-  setIcon(qApp->icons()->fromByteArray(record.value(FDS_DB_ICON_INDEX).toByteArray()));
+  setIcon(qApp->icons()->fromStoreReference(record.value(FDS_DB_ICON_INDEX).toByteArray()));
   setEncoding(record.value(FDS_DB_ENCODING_INDEX).toString());
   setUrl(record.value(FDS_DB_URL_INDEX).toString());
   setPasswordProtected(record.value(FDS_DB_PROTECTED_INDEX).toBool());
@@ -125,14 +125,28 @@ class StandardFeed : public Feed {
 
     QNetworkReply::NetworkError networkError() const;
 
+    // Locations of possible icons of guessed feed in order of their priority.
+    QStringList iconLocations() const;
+
     // Tries to guess feed hidden under given URL
     // and uses given credentials.
     // Returns pointer to guessed feed (if at least partially
     // guessed) and retrieved error/status code from network layer
     // or NULL feed.
+    // NOTE: Only already cached icon is assigned to the feed. If "fetch_icon"
+    // is true, then resolving of icon is started in background and caller
+    // can obtain it later from FaviconResolver via iconLocations().
     static QPair<StandardFeed*,QNetworkReply::NetworkError> guessFeed(const QString &url,
                                                                       const QString &username = QString(),
-                                                                      const QString &password = QString());
+                                                                      const QString &password = QString(),
+                                                                      bool fetch_icon = true);
+
+    // Same as guessFeed() but works with already downloaded
+    // feed data, "network_error" is error of that download.
+    static QPair<StandardFeed*,QNetworkReply::NetworkError> guessFeedFromData(const QString &url,
+                                                                              const QByteArray &feed_contents,
+                                                                              QNetworkReply::NetworkError network_error,
+                                                                              bool fetch_icon = true);
 
     // Converts particular feed type to string.
     static QString typeToString(Type type);
@@ -144,6 +158,9 @@ class StandardFeed : public Feed {
   private:
     QList<Message> obtainNewMessages(bool *error_during_obtaining);
 
+    // Parses messages while feed data are still being downloaded.
+    QList<Message> obtainNewMessagesIncrementally(int download_timeout, int max_messages, bool *error_during_obtaining);
+
   private:
     bool m_passwordProtected;
     QString m_username;
@@ -152,6 +169,7 @@ class StandardFeed : public Feed {
     Type m_type;
     QNetworkReply::NetworkError m_networkError;
     QString m_encoding;
+    QStringList m_iconLocations;
 };
 
 Q_DECLARE_METATYPE(StandardFeed::Type)
@@ -20,22 +20,25 @@
 #include "services/standard/standardfeed.h"
 #include "services/standard/standardcategory.h"
 #include "services/standard/standardserviceroot.h"
+#include "services/standard/standardfeedsmetadatafetcher.h"
 #include "definitions/definitions.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/iconfactory.h"
 
-#include <QDomDocument>
-#include <QDomElement>
-#include <QDomAttr>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 #include <QStack>
 #include <QLocale>
 
 
 FeedsImportExportModel::FeedsImportExportModel(QObject *parent)
-  : AccountCheckModel(parent), m_mode(Import) {
+  : AccountCheckModel(parent), m_mode(Import), m_metadataFetcher(nullptr) {
 }
 
 FeedsImportExportModel::~FeedsImportExportModel() {
+  // Fetcher works with items of this model, stop it first.
+  stopMetadataFetcher();
+
   if (m_rootItem != nullptr && m_mode == Import) {
     // Delete all model items, but only if we are in import mode. Export mode shares
     // root item with main feed model, thus cannot be deleted from memory now.
@@ -43,230 +46,251 @@ FeedsImportExportModel::~FeedsImportExportModel() {
   }
 }
 
-bool FeedsImportExportModel::exportToOMPL20(QByteArray &result) {
-  QDomDocument opml_document;
-  QDomProcessingInstruction xml_declaration = opml_document.createProcessingInstruction(QSL("xml"),
-                                                                                        QSL("version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\""));
-  opml_document.appendChild(xml_declaration);
+bool FeedsImportExportModel::exportToOMPL20(QIODevice *device) {
+  QXmlStreamWriter writer(device);
+  int completed = 0;
+  const int total = m_rootItem->getSubTree().size() - 1;
+
+  writer.setAutoFormatting(true);
+  writer.setAutoFormattingIndent(2);
+  writer.writeStartDocument(QSL("1.0"), true);
 
   // Added OPML 2.0 metadata.
-  opml_document.appendChild(opml_document.createElement(QSL("opml")));
-  opml_document.documentElement().setAttribute(QSL("version"), QSL("version"));
-  opml_document.documentElement().setAttribute("xmlns:rssguard", APP_URL);
-
-  QDomElement elem_opml_head = opml_document.createElement(QSL("head"));
-
-  QDomElement elem_opml_title = opml_document.createElement(QSL("title"));
-  QDomText text_opml_title = opml_document.createTextNode(QString(APP_NAME));
-  elem_opml_title.appendChild(text_opml_title);
-  elem_opml_head.appendChild(elem_opml_title);
-
-  QDomElement elem_opml_created = opml_document.createElement(QSL("dateCreated"));
-  QDomText text_opml_created = opml_document.createTextNode(QLocale::c().toString(QDateTime::currentDateTimeUtc(),
-                                                                                  QSL("ddd, dd MMM yyyy hh:mm:ss")) + QL1S(" GMT"));
-  elem_opml_created.appendChild(text_opml_created);
-  elem_opml_head.appendChild(elem_opml_created);
-  opml_document.documentElement().appendChild(elem_opml_head);
-
-  QDomElement elem_opml_body = opml_document.createElement(QSL("body"));
-  QStack<RootItem*> items_to_process; items_to_process.push(m_rootItem);
-  QStack<QDomElement> elements_to_use; elements_to_use.push(elem_opml_body);
-
-  // Process all unprocessed nodes.
-  while (!items_to_process.isEmpty()) {
-    QDomElement active_element = elements_to_use.pop();
-    RootItem *active_item = items_to_process.pop();
-
-    foreach (RootItem *child_item, active_item->childItems()) {
-      if (!isItemChecked(child_item)) {
-        continue;
-      }
+  writer.writeStartElement(QSL("opml"));
+  writer.writeAttribute(QSL("version"), QSL("2.0"));
+  writer.writeNamespace(QSL(APP_URL), QSL("rssguard"));
 
-      switch (child_item->kind()) {
-        case RootItemKind::Category: {
-          QDomElement outline_category = opml_document.createElement(QSL("outline"));
-          outline_category.setAttribute(QSL("text"), child_item->title());
-          outline_category.setAttribute(QSL("description"), child_item->description());
-          outline_category.setAttribute(QSL("rssguard:icon"), QString(qApp->icons()->toByteArray(child_item->icon())));
-          active_element.appendChild(outline_category);
-          items_to_process.push(child_item);
-          elements_to_use.push(outline_category);
-          break;
-        }
+  writer.writeStartElement(QSL("head"));
+  writer.writeTextElement(QSL("title"), QSL(APP_NAME));
+  writer.writeTextElement(QSL("dateCreated"), QLocale::c().toString(QDateTime::currentDateTimeUtc(),
+                                                                    QSL("ddd, dd MMM yyyy hh:mm:ss")) + QL1S(" GMT"));
+  writer.writeEndElement();
 
-        case RootItemKind::Feed: {
-          StandardFeed *child_feed = static_cast<StandardFeed*>(child_item);
-          QDomElement outline_feed = opml_document.createElement("outline");
-          outline_feed.setAttribute(QSL("text"), child_feed->title());
-          outline_feed.setAttribute(QSL("xmlUrl"), child_feed->url());
-          outline_feed.setAttribute(QSL("description"), child_feed->description());
-          outline_feed.setAttribute(QSL("encoding"), child_feed->encoding());
-          outline_feed.setAttribute(QSL("title"), child_feed->title());
-          outline_feed.setAttribute(QSL("rssguard:icon"), QString(qApp->icons()->toByteArray(child_feed->icon())));
-
-          switch (child_feed->type()) {
-            case StandardFeed::Rss0X:
-            case StandardFeed::Rss2X:
-              outline_feed.setAttribute(QSL("version"), QSL("RSS"));
-              break;
-
-            case StandardFeed::Rdf:
-              outline_feed.setAttribute(QSL("version"), QSL("RSS1"));
-              break;
-
-            case StandardFeed::Atom10:
-              outline_feed.setAttribute(QSL("version"), QSL("ATOM"));
-              break;
-
-            default:
-              break;
-          }
+  writer.writeStartElement(QSL("body"));
+  writeOutlines(writer, m_rootItem, completed, total);
+  writer.writeEndElement();
+
+  writer.writeEndElement();
+  writer.writeEndDocument();
+
+  return !writer.hasError();
+}
+
+void FeedsImportExportModel::writeOutlines(QXmlStreamWriter &writer, RootItem *parent_item, int &completed, int total) {
+  foreach (RootItem *child_item, parent_item->childItems()) {
+    if (!isItemChecked(child_item)) {
+      continue;
+    }
+
+    switch (child_item->kind()) {
+      case RootItemKind::Category: {
+        writer.writeStartElement(QSL("outline"));
+        writer.writeAttribute(QSL("text"), child_item->title());
+        writer.writeAttribute(QSL("description"), child_item->description());
 
-          active_element.appendChild(outline_feed);
-          break;
+        // NOTE: Icons are encoded one by one, so that only
+        // single encoded icon is held in memory at any time.
+        writer.writeAttribute(QSL(APP_URL), QSL("icon"), QString(qApp->icons()->toByteArray(child_item->icon())));
+
+        emit exportingProgress(++completed, total);
+
+        writeOutlines(writer, child_item, completed, total);
+        writer.writeEndElement();
+        break;
+      }
+
+      case RootItemKind::Feed: {
+        StandardFeed *child_feed = static_cast<StandardFeed*>(child_item);
+
+        writer.writeStartElement(QSL("outline"));
+        writer.writeAttribute(QSL("text"), child_feed->title());
+        writer.writeAttribute(QSL("xmlUrl"), child_feed->url());
+        writer.writeAttribute(QSL("description"), child_feed->description());
+        writer.writeAttribute(QSL("encoding"), child_feed->encoding());
+        writer.writeAttribute(QSL("title"), child_feed->title());
+        writer.writeAttribute(QSL(APP_URL), QSL("icon"), QString(qApp->icons()->toByteArray(child_feed->icon())));
+
+        switch (child_feed->type()) {
+          case StandardFeed::Rss0X:
+          case StandardFeed::Rss2X:
+            writer.writeAttribute(QSL("version"), QSL("RSS"));
+            break;
+
+          case StandardFeed::Rdf:
+            writer.writeAttribute(QSL("version"), QSL("RSS1"));
+            break;
+
+          case StandardFeed::Atom10:
+            writer.writeAttribute(QSL("version"), QSL("ATOM"));
+            break;
+
+          default:
+            break;
         }
 
-        default:
-          break;
+        writer.writeEndElement();
+        emit exportingProgress(++completed, total);
+        break;
       }
+
+      default:
+        break;
     }
   }
-
-  opml_document.documentElement().appendChild(elem_opml_body);
-  result = opml_document.toByteArray(2);
-  return true;
 }
 
 void FeedsImportExportModel::importAsOPML20(const QByteArray &data, bool fetch_metadata_online) {
+  stopMetadataFetcher();
+
   emit parsingStarted();
   emit layoutAboutToBeChanged();
   setRootItem(nullptr);
   emit layoutChanged();
 
-  QDomDocument opml_document;
+  QXmlStreamReader reader(data);
 
-  if (!opml_document.setContent(data)) {
-    emit parsingFinished(0, 0, true);
-  }
+  // NOTE: Prefixes are not resolved, so that files which use
+  // "rssguard:icon" without declaring the namespace are accepted too.
+  reader.setNamespaceProcessing(false);
 
-  if (opml_document.documentElement().isNull() || opml_document.documentElement().tagName() != QSL("opml") ||
-      opml_document.documentElement().elementsByTagName(QSL("body")).size() != 1) {
+  if (!reader.readNextStartElement() || reader.name() != QL1S("opml")) {
     // This really is not an OPML file.
     emit parsingFinished(0, 0, true);
+    return;
   }
 
-  int completed = 0, total = 0, succeded = 0, failed = 0;
+  // Outlines are processed in single pass, stack holds model item for each
+  // currently opened outline. Progress is reported in terms of bytes of input data.
+  int succeded = 0, body_count = 0;
+  StandardFeedsMetadataFetcher *fetcher = fetch_metadata_online ? createMetadataFetcher() : nullptr;
   StandardServiceRoot *root_item = new StandardServiceRoot();
-  QStack<RootItem*> model_items; model_items.push(root_item);
-  QStack<QDomElement> elements_to_process; elements_to_process.push(opml_document.documentElement().elementsByTagName(QSL("body")).at(0).toElement());
-
-  while (!elements_to_process.isEmpty()) {
-    RootItem *active_model_item = model_items.pop();
-    QDomElement active_element = elements_to_process.pop();
-
-    int current_count = active_element.childNodes().size();
-    total += current_count;
-
-    for (int i = 0; i < current_count; i++) {
-      QDomNode child = active_element.childNodes().at(i);
-
-      if (child.isElement()) {
-        QDomElement child_element = child.toElement();
-
-        // Now analyze if this element is category or feed.
-        // NOTE: All feeds must include xmlUrl attribute and text attribute.
-        if (child_element.attributes().contains(QSL("xmlUrl")) && child.attributes().contains(QSL("text"))) {
-          // This is FEED.
-          // Add feed and end this iteration.
-          QString feed_url = child_element.attribute(QSL("xmlUrl"));
-
-          if (!feed_url.isEmpty()) {
-            QPair<StandardFeed*,QNetworkReply::NetworkError> guessed;
-
-            if (fetch_metadata_online &&
-                (guessed = StandardFeed::guessFeed(feed_url)).second == QNetworkReply::NoError) {
-              // We should obtain fresh metadata from online feed source.
-              guessed.first->setUrl(feed_url);
-              active_model_item->appendChild(guessed.first);
-
-              succeded++;
-            }
-            else {
-              QString feed_title = child_element.attribute(QSL("text"));
-              QString feed_encoding = child_element.attribute(QSL("encoding"), DEFAULT_FEED_ENCODING);
-              QString feed_type = child_element.attribute(QSL("version"), DEFAULT_FEED_TYPE).toUpper();
-              QString feed_description = child_element.attribute(QSL("description"));
-              QIcon feed_icon = qApp->icons()->fromByteArray(child_element.attribute(QSL("rssguard:icon")).toLocal8Bit());
-
-              StandardFeed *new_feed = new StandardFeed(active_model_item);
-              new_feed->setTitle(feed_title);
-              new_feed->setDescription(feed_description);
-              new_feed->setEncoding(feed_encoding);
-              new_feed->setUrl(feed_url);
-              new_feed->setCreationDate(QDateTime::currentDateTime());
-              new_feed->setIcon(feed_icon.isNull() ? qApp->icons()->fromTheme(QSL("application-rss+xml")) : feed_icon);
-
-              if (feed_type == QL1S("RSS1")) {
-                new_feed->setType(StandardFeed::Rdf);
-              }
-              else if (feed_type == QL1S("ATOM")) {
-                new_feed->setType(StandardFeed::Atom10);
-              }
-              else {
-                new_feed->setType(StandardFeed::Rss2X);
-              }
-
-              active_model_item->appendChild(new_feed);
-
-              if (fetch_metadata_online && guessed.second != QNetworkReply::NoError) {
-                failed++;
-              }
-              else {
-                succeded++;
-              }
-            }
-          }
+  QStack<RootItem*> model_items;
+  bool in_body = false;
+
+  while (!reader.atEnd()) {
+    reader.readNext();
+
+    if (reader.isStartElement()) {
+      if (!in_body) {
+        if (reader.name() == QL1S("body")) {
+          in_body = true;
+          body_count++;
+          model_items.push(root_item);
         }
-        else {
-          // This must be CATEGORY.
-          // Add category and continue.
-          QString category_title = child_element.attribute(QSL("text"));
-          QString category_description = child_element.attribute(QSL("description"));
-          QIcon category_icon = qApp->icons()->fromByteArray(child_element.attribute(QSL("rssguard:icon")).toLocal8Bit());
 
-          if (category_title.isEmpty()) {
-            qWarning("Given OMPL file provided category without valid text attribute. Using fallback name.");
+        continue;
+      }
+      else if (reader.name() != QL1S("outline")) {
+        // Unknown element inside body, skip it.
+        reader.skipCurrentElement();
+        continue;
+      }
 
-            category_title = child_element.attribute(QSL("title"));
+      RootItem *active_model_item = model_items.top();
+      const QXmlStreamAttributes attributes = reader.attributes();
+
+      // Now analyze if this element is category or feed.
+      // NOTE: All feeds must include xmlUrl attribute and text attribute.
+      if (attributes.hasAttribute(QSL("xmlUrl")) && attributes.hasAttribute(QSL("text"))) {
+        // This is FEED.
+        const QString feed_url = attributes.value(QSL("xmlUrl")).toString();
+
+        if (!feed_url.isEmpty()) {
+          QString feed_encoding = attributes.value(QSL("encoding")).toString();
+          QString feed_type = attributes.value(QSL("version")).toString().toUpper();
+          QIcon feed_icon = qApp->icons()->fromByteArray(attributes.value(QSL("rssguard:icon")).toLatin1());
+
+          StandardFeed *new_feed = new StandardFeed();
+          new_feed->setTitle(attributes.value(QSL("text")).toString());
+          new_feed->setDescription(attributes.value(QSL("description")).toString());
+          new_feed->setEncoding(feed_encoding.isEmpty() ? QSL(DEFAULT_FEED_ENCODING) : feed_encoding);
+          new_feed->setUrl(feed_url);
+          new_feed->setCreationDate(QDateTime::currentDateTime());
+          new_feed->setIcon(feed_icon.isNull() ? qApp->icons()->fromTheme(QSL("application-rss+xml")) : feed_icon);
+
+          if (feed_type == QL1S("RSS1")) {
+            new_feed->setType(StandardFeed::Rdf);
+          }
+          else if (feed_type == QL1S("ATOM")) {
+            new_feed->setType(StandardFeed::Atom10);
+          }
+          else {
+            new_feed->setType(StandardFeed::Rss2X);
+          }
 
-            if (category_title.isEmpty()) {
-              category_title = tr("Category ") + QString::number(QDateTime::currentDateTime().toMSecsSinceEpoch());
-            }
+          if (fetcher != nullptr) {
+            // Fresh metadata will be obtained from online feed source.
+            addPendingFeed(new_feed, active_model_item);
+            fetcher->addFeed(new_feed);
+          }
+          else {
+            active_model_item->appendChild(new_feed);
+            succeded++;
           }
+        }
+
+        // Feeds cannot contain other items, possible nested
+        // outlines are added to parent of the feed.
+        model_items.push(active_model_item);
+      }
+      else {
+        // This must be CATEGORY.
+        QString category_title = attributes.value(QSL("text")).toString();
+        QIcon category_icon = qApp->icons()->fromByteArray(attributes.value(QSL("rssguard:icon")).toLatin1());
 
-          StandardCategory *new_category = new StandardCategory(active_model_item);
-          new_category->setTitle(category_title);
-          new_category->setIcon(category_icon.isNull() ? qApp->icons()->fromTheme(QSL("folder")) : category_icon);
-          new_category->setCreationDate(QDateTime::currentDateTime());
-          new_category->setDescription(category_description);
+        if (category_title.isEmpty()) {
+          qWarning("Given OMPL file provided category without valid text attribute. Using fallback name.");
 
-          active_model_item->appendChild(new_category);
+          category_title = attributes.value(QSL("title")).toString();
 
-          // Children of this node must be processed later.
-          elements_to_process.push(child_element);
-          model_items.push(new_category);
+          if (category_title.isEmpty()) {
+            category_title = tr("Category ") + QString::number(QDateTime::currentDateTime().toMSecsSinceEpoch());
+          }
         }
 
-        emit parsingProgress(++completed, total);
+        StandardCategory *new_category = new StandardCategory(active_model_item);
+        new_category->setTitle(category_title);
+        new_category->setIcon(category_icon.isNull() ? qApp->icons()->fromTheme(QSL("folder")) : category_icon);
+        new_category->setCreationDate(QDateTime::currentDateTime());
+        new_category->setDescription(attributes.value(QSL("description")).toString());
+
+        active_model_item->appendChild(new_category);
+        m_importOrder.insert(new_category, m_importOrder.size());
+
+        // Children of this node are added to it.
+        model_items.push(new_category);
       }
+
+      emit parsingProgress(reader.characterOffset(), data.size());
+    }
+    else if (reader.isEndElement() && in_body) {
+      // Either outline or body itself ends here.
+      model_items.pop();
+      in_body = !model_items.isEmpty();
     }
   }
 
+  if (reader.hasError() || body_count != 1) {
+    qWarning("Given OPML file is not well-formed: '%s'.", qPrintable(reader.errorString()));
+
+    stopMetadataFetcher();
+    delete root_item;
+    emit parsingFinished(0, 0, true);
+    return;
+  }
+
   // Now, XML is processed and we have result in form of pointer item structure.
   emit layoutAboutToBeChanged();
   setRootItem(root_item);
   emit layoutChanged();
-  emit parsingFinished(failed, succeded, false);
+
+  if (fetcher != nullptr) {
+    fetcher->start();
+  }
+  else {
+    m_importOrder.clear();
+    emit parsingFinished(0, succeded, false);
+  }
 }
 
 bool FeedsImportExportModel::exportToTxtURLPerLine(QByteArray &result) {
@@ -278,44 +302,36 @@ bool FeedsImportExportModel::exportToTxtURLPerLine(QByteArray &result) {
 }
 
 void FeedsImportExportModel::importAsTxtURLPerLine(const QByteArray &data, bool fetch_metadata_online) {
+  stopMetadataFetcher();
+
   emit parsingStarted();
   emit layoutAboutToBeChanged();
   setRootItem(nullptr);
   emit layoutChanged();
 
   int completed = 0, succeded = 0, failed = 0;
+  StandardFeedsMetadataFetcher *fetcher = fetch_metadata_online ? createMetadataFetcher() : nullptr;
   StandardServiceRoot *root_item = new StandardServiceRoot();
   QList<QByteArray> urls = data.split('\n');
 
   foreach (const QByteArray &url, urls) {
     if (!url.isEmpty()) {
-      QPair<StandardFeed*,QNetworkReply::NetworkError> guessed;
+      StandardFeed *feed = new StandardFeed();
 
-      if (fetch_metadata_online &&
-          (guessed = StandardFeed::guessFeed(url)).second == QNetworkReply::NoError) {
-        guessed.first->setUrl(url);
-        root_item->appendChild(guessed.first);
-        succeded++;
+      feed->setUrl(url);
+      feed->setTitle(url);
+      feed->setCreationDate(QDateTime::currentDateTime());
+      feed->setIcon(qApp->icons()->fromTheme(QSL("application-rss+xml")));
+      feed->setEncoding(DEFAULT_FEED_ENCODING);
+
+      if (fetcher != nullptr) {
+        addPendingFeed(feed, root_item);
+        fetcher->addFeed(feed);
       }
       else {
-        StandardFeed *feed = new StandardFeed();
-
-        feed->setUrl(url);
-        feed->setTitle(url);
-        feed->setCreationDate(QDateTime::currentDateTime());
-        feed->setIcon(qApp->icons()->fromTheme(QSL("application-rss+xml")));
-        feed->setEncoding(DEFAULT_FEED_ENCODING);
         root_item->appendChild(feed);
-
-        if (fetch_metadata_online && guessed.second != QNetworkReply::NoError) {
-          failed++;
-        }
-        else {
-          succeded++;
-        }
+        succeded++;
       }
-
-      qApp->processEvents();
     }
     else {
       qWarning("Detected empty URL when parsing input TXT [one URL per line] data.");
@@ -329,7 +345,13 @@ void FeedsImportExportModel::importAsTxtURLPerLine(const QByteArray &data, bool
   emit layoutAboutToBeChanged();
   setRootItem(root_item);
   emit layoutChanged();
-  emit parsingFinished(failed, succeded, false);
+
+  if (fetcher != nullptr) {
+    fetcher->start();
+  }
+  else {
+    emit parsingFinished(failed, succeded, false);
+  }
 }
 
 FeedsImportExportModel::Mode FeedsImportExportModel::mode() const {
@@ -339,3 +361,86 @@ FeedsImportExportModel::Mode FeedsImportExportModel::mode() const {
 void FeedsImportExportModel::setMode(const FeedsImportExportModel::Mode &mode) {
   m_mode = mode;
 }
+
+bool FeedsImportExportModel::isParsing() const {
+  return m_metadataFetcher != nullptr && m_metadataFetcher->isRunning();
+}
+
+void FeedsImportExportModel::cancelParsing() {
+  if (m_metadataFetcher != nullptr) {
+    m_metadataFetcher->cancel();
+  }
+}
+
+void FeedsImportExportModel::stopMetadataFetcher() {
+  if (m_metadataFetcher != nullptr) {
+    m_metadataFetcher->disconnect(this);
+    m_metadataFetcher->cancel();
+    m_metadataFetcher->deleteLater();
+    m_metadataFetcher = nullptr;
+  }
+
+  // Feeds which were not inserted into the tree yet are not needed anymore.
+  qDeleteAll(m_pendingFeeds);
+  m_pendingFeeds.clear();
+  m_importOrder.clear();
+}
+
+void FeedsImportExportModel::addPendingFeed(StandardFeed *feed, RootItem *parent) {
+  feed->setParent(parent);
+  m_importOrder.insert(feed, m_importOrder.size());
+  m_pendingFeeds.append(feed);
+}
+
+void FeedsImportExportModel::insertPendingFeed(StandardFeed *feed) {
+  if (!m_pendingFeeds.removeOne(feed)) {
+    return;
+  }
+
+  RootItem *parent = feed->parent();
+  QList<RootItem*> children = parent->childItems();
+  const int order = m_importOrder.value(feed);
+  int row = 0;
+
+  while (row < children.size() && m_importOrder.value(children.at(row)) < order) {
+    row++;
+  }
+
+  beginInsertRows(indexForItem(parent), row, row);
+  children.insert(row, feed);
+  parent->setChildItems(children);
+  endInsertRows();
+}
+
+StandardFeedsMetadataFetcher *FeedsImportExportModel::createMetadataFetcher() {
+  m_metadataFetcher = new StandardFeedsMetadataFetcher(this);
+
+  connect(m_metadataFetcher, &StandardFeedsMetadataFetcher::feedProcessed, this, &FeedsImportExportModel::onFeedMetadataFetched);
+  connect(m_metadataFetcher, &StandardFeedsMetadataFetcher::finished, this, &FeedsImportExportModel::onMetadataFetchingFinished);
+
+  return m_metadataFetcher;
+}
+
+void FeedsImportExportModel::onFeedMetadataFetched(StandardFeed *feed, bool fetched, int completed, int total) {
+  Q_UNUSED(fetched)
+
+  // Results are inserted into the tree as they come, feeds
+  // which were not fetched keep metadata from input file.
+  insertPendingFeed(feed);
+  emit parsingProgress(completed, total);
+}
+
+void FeedsImportExportModel::onMetadataFetchingFinished(int count_failed, int count_succeeded, bool cancelled) {
+  if (cancelled) {
+    qDebug("Fetching of online metadata was cancelled.");
+  }
+
+  // Feeds which were not fetched due to cancellation are inserted too.
+  while (!m_pendingFeeds.isEmpty()) {
+    insertPendingFeed(m_pendingFeeds.first());
+  }
+
+  m_importOrder.clear();
+
+  emit parsingFinished(count_failed, count_succeeded, false);
+}
@@ -20,6 +20,13 @@
 
 #include "services/abstract/accountcheckmodel.h"
 
+#include <QHash>
+
+
+class StandardFeed;
+class StandardFeedsMetadataFetcher;
+class QXmlStreamWriter;
+class QIODevice;
 
 class FeedsImportExportModel : public AccountCheckModel {
     Q_OBJECT
@@ -34,9 +41,9 @@ class FeedsImportExportModel : public AccountCheckModel {
     explicit FeedsImportExportModel(QObject *parent = 0);
     virtual ~FeedsImportExportModel();
 
-    // Exports to OPML 2.0
+    // Exports to OPML 2.0, outlines are streamed directly into given device.
     // NOTE: http://dev.opml.org/spec2.html
-    bool exportToOMPL20(QByteArray &result);
+    bool exportToOMPL20(QIODevice *device);
     void importAsOPML20(const QByteArray &data, bool fetch_metadata_online);
 
     // Exports to plain text format
@@ -47,6 +54,15 @@ class FeedsImportExportModel : public AccountCheckModel {
     Mode mode() const;
     void setMode(const Mode &mode);
 
+    // Returns true if import is still running, which is
+    // the case when metadata are being fetched online.
+    bool isParsing() const;
+
+  public slots:
+    // Stops fetching of online metadata, feeds which
+    // were not fetched yet keep metadata from input file.
+    void cancelParsing();
+
   signals:
     // These signals are emitted when user selects some data
     // to be imported/parsed into the model.
@@ -54,8 +70,31 @@ class FeedsImportExportModel : public AccountCheckModel {
     void parsingProgress(int completed, int total);
     void parsingFinished(int count_failed, int count_succeeded, bool parsing_error);
 
+    // Emitted after each outline written during export.
+    void exportingProgress(int completed, int total);
+
+  private slots:
+    void onFeedMetadataFetched(StandardFeed *feed, bool fetched, int completed, int total);
+    void onMetadataFetchingFinished(int count_failed, int count_succeeded, bool cancelled);
+
   private:
+    void writeOutlines(QXmlStreamWriter &writer, RootItem *parent_item, int &completed, int total);
+
+    // Cancels running metadata fetcher, if any, without notifying the outer world.
+    void stopMetadataFetcher();
+    StandardFeedsMetadataFetcher *createMetadataFetcher();
+
+    // Feeds, whose metadata are fetched online, are inserted into
+    // the tree once they are fetched, keeping order of the input file.
+    void addPendingFeed(StandardFeed *feed, RootItem *parent);
+    void insertPendingFeed(StandardFeed *feed);
+
     Mode m_mode;
+    StandardFeedsMetadataFetcher *m_metadataFetcher;
+
+    // Order of imported items in input file.
+    QHash<RootItem*,int> m_importOrder;
+    QList<StandardFeed*> m_pendingFeeds;
 };
 
 #endif // STANDARDFEEDSIMPORTEXPORTMODEL_H
@@ -0,0 +1,177 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "services/standard/standardfeedsmetadatafetcher.h"
+
+#include "services/standard/standardfeed.h"
+#include "definitions/definitions.h"
+#include "miscellaneous/application.h"
+#include "network-web/downloader.h"
+
+#include <QUrl>
+
+
+StandardFeedsMetadataFetcher::StandardFeedsMetadataFetcher(QObject *parent)
+  : QObject(parent), m_waitingCount(0), m_running(false), m_total(0), m_succeeded(0), m_failed(0) {
+}
+
+StandardFeedsMetadataFetcher::~StandardFeedsMetadataFetcher() {
+  qDebug("Destroying StandardFeedsMetadataFetcher instance.");
+}
+
+void StandardFeedsMetadataFetcher::addFeed(StandardFeed *feed) {
+  const QString host = hostOf(feed);
+
+  if (!m_hostQueues.contains(host) && m_activeHosts.value(host) < METADATA_FETCHER_MAX_HOST_DOWNLOADS) {
+    m_readyHosts.append(host);
+  }
+
+  m_hostQueues[host].enqueue(feed);
+  m_waitingCount++;
+  m_total++;
+}
+
+bool StandardFeedsMetadataFetcher::isRunning() const {
+  return m_running;
+}
+
+void StandardFeedsMetadataFetcher::start() {
+  m_running = true;
+
+  if (m_waitingCount == 0) {
+    m_running = false;
+    emit finished(m_failed, m_succeeded, false);
+  }
+  else {
+    processQueue();
+  }
+}
+
+void StandardFeedsMetadataFetcher::cancel() {
+  if (!m_running) {
+    return;
+  }
+
+  qDebug("Cancelling fetching of metadata, %d feeds were not fetched.", m_waitingCount + m_activeDownloads.size());
+
+  // Feeds which were not fetched keep their offline metadata.
+  m_failed += m_waitingCount + m_activeDownloads.size();
+  m_hostQueues.clear();
+  m_readyHosts.clear();
+  m_waitingCount = 0;
+
+  foreach (Downloader *downloader, m_activeDownloads.keys()) {
+    downloader->disconnect(this);
+    downloader->cancel();
+    downloader->deleteLater();
+  }
+
+  m_activeDownloads.clear();
+  m_activeHosts.clear();
+  m_running = false;
+
+  emit finished(m_failed, m_succeeded, true);
+}
+
+QString StandardFeedsMetadataFetcher::hostOf(const StandardFeed *feed) const {
+  return QUrl(feed->url()).host().toLower();
+}
+
+void StandardFeedsMetadataFetcher::processQueue() {
+  const int timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
+
+  while (!m_readyHosts.isEmpty() && m_activeDownloads.size() < METADATA_FETCHER_MAX_DOWNLOADS) {
+    const QString host = m_readyHosts.takeFirst();
+    StandardFeed *feed = m_hostQueues[host].dequeue();
+
+    m_waitingCount--;
+    m_activeHosts[host]++;
+
+    if (m_hostQueues.value(host).isEmpty()) {
+      m_hostQueues.remove(host);
+    }
+    else if (m_activeHosts.value(host) < METADATA_FETCHER_MAX_HOST_DOWNLOADS) {
+      // Do not flood single server, other hosts go first.
+      m_readyHosts.append(host);
+    }
+
+    Downloader *downloader = new Downloader(this);
+
+    m_activeDownloads.insert(downloader, QPair<StandardFeed*,QString>(feed, host));
+    downloader->appendRawHeader("Accept", ACCEPT_HEADER_FOR_FEED_DOWNLOADER);
+    connect(downloader, &Downloader::completed, this, &StandardFeedsMetadataFetcher::onDownloadCompleted);
+    downloader->downloadFile(feed->url(), timeout);
+  }
+}
+
+void StandardFeedsMetadataFetcher::onDownloadCompleted(QNetworkReply::NetworkError status) {
+  Downloader *downloader = qobject_cast<Downloader*>(sender());
+
+  if (downloader == nullptr || !m_activeDownloads.contains(downloader)) {
+    return;
+  }
+
+  const QPair<StandardFeed*,QString> download = m_activeDownloads.take(downloader);
+  StandardFeed *feed = download.first;
+  const QString &host = download.second;
+
+  if (--m_activeHosts[host] <= 0) {
+    m_activeHosts.remove(host);
+  }
+
+  if (m_hostQueues.contains(host) && !m_readyHosts.contains(host)) {
+    // Host has free download slot now.
+    m_readyHosts.append(host);
+  }
+
+  // NOTE: Icons are obtained asynchronously once feeds are imported.
+  QPair<StandardFeed*,QNetworkReply::NetworkError> guessed = StandardFeed::guessFeedFromData(feed->url(),
+                                                                                             downloader->lastOutputData(),
+                                                                                             status, false);
+  const bool fetched = guessed.first != nullptr && guessed.second == QNetworkReply::NoError;
+
+  downloader->deleteLater();
+
+  if (fetched) {
+    // Merge fetched metadata into existing feed.
+    feed->setTitle(guessed.first->title());
+    feed->setDescription(guessed.first->description());
+    feed->setEncoding(guessed.first->encoding());
+    feed->setType(guessed.first->type());
+
+    if (!guessed.first->icon().isNull()) {
+      feed->setIcon(guessed.first->icon());
+    }
+
+    m_succeeded++;
+  }
+  else {
+    m_failed++;
+  }
+
+  delete guessed.first;
+
+  emit feedProcessed(feed, fetched, m_succeeded + m_failed, m_total);
+
+  if (m_waitingCount == 0 && m_activeDownloads.isEmpty()) {
+    m_running = false;
+    emit finished(m_failed, m_succeeded, false);
+  }
+  else {
+    processQueue();
+  }
+}
@@ -0,0 +1,85 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef STANDARDFEEDSMETADATAFETCHER_H
+#define STANDARDFEEDSMETADATAFETCHER_H
+
+#include <QObject>
+
+#include <QHash>
+#include <QList>
+#include <QPair>
+#include <QQueue>
+#include <QStringList>
+#include <QNetworkReply>
+
+
+class StandardFeed;
+class Downloader;
+
+// Fetches metadata of many feeds online.
+//
+// Feeds are downloaded in parallel with limited number of
+// downloads in total and per host. Fetched metadata are written
+// directly into given feeds, feeds which cannot be fetched
+// are left intact.
+class StandardFeedsMetadataFetcher : public QObject {
+    Q_OBJECT
+
+  public:
+    // Constructors and destructors.
+    explicit StandardFeedsMetadataFetcher(QObject *parent = 0);
+    virtual ~StandardFeedsMetadataFetcher();
+
+    // Schedules given feed, its URL must be set.
+    void addFeed(StandardFeed *feed);
+
+    bool isRunning() const;
+
+  public slots:
+    void start();
+
+    // Aborts all running downloads and forgets remaining feeds.
+    void cancel();
+
+  signals:
+    void feedProcessed(StandardFeed *feed, bool fetched, int completed, int total);
+    void finished(int count_failed, int count_succeeded, bool cancelled);
+
+  private slots:
+    void onDownloadCompleted(QNetworkReply::NetworkError status);
+
+  private:
+    void processQueue();
+    QString hostOf(const StandardFeed *feed) const;
+
+    // Waiting feeds are queued per host, hosts which have waiting
+    // feeds and free download slots are served in round-robin order.
+    QHash<QString,QQueue<StandardFeed*> > m_hostQueues;
+    QStringList m_readyHosts;
+    int m_waitingCount;
+
+    QHash<Downloader*,QPair<StandardFeed*,QString> > m_activeDownloads;
+    QHash<QString,int> m_activeHosts;
+
+    bool m_running;
+    int m_total;
+    int m_succeeded;
+    int m_failed;
+};
+
+#endif // STANDARDFEEDSMETADATAFETCHER_H
@@ -23,6 +23,7 @@
 #include "miscellaneous/iconfactory.h"
 #include "miscellaneous/databasequeries.h"
 #include "miscellaneous/mutex.h"
+#include "network-web/faviconresolver.h"
 #include "core/feedsmodel.h"
 #include "gui/messagebox.h"
 #include "exceptions/applicationexception.h"
@@ -36,6 +37,7 @@
 #include "services/standard/gui/formstandardimportexport.h"
 
 #include <QStack>
+#include <QSet>
 #include <QAction>
 #include <QSqlTableModel>
 #include <QClipboard>
@@ -44,7 +46,8 @@
 StandardServiceRoot::StandardServiceRoot(RootItem *parent)
   : ServiceRoot(parent), m_recycleBin(new RecycleBin(this)),
     m_actionExportFeeds(nullptr), m_actionImportFeeds(nullptr), m_serviceMenu(QList<QAction*>()),
-    m_feedContextMenu(QList<QAction*>()), m_actionFeedFetchMetadata(nullptr) {
+    m_feedContextMenu(QList<QAction*>()), m_actionFeedFetchMetadata(nullptr),
+    m_feedsWaitingForIcon(QHash<QString,QList<IconRequest> >()) {
 
   setTitle(qApp->system()->getUsername() + QL1S("@") + QL1S(APP_LOW_NAME));
   setIcon(StandardServiceEntryPoint().icon());
@@ -185,15 +188,6 @@ void StandardServiceRoot::checkArgumentsForFeedAdding() {
   }
 }
 
-QMap<int,QVariant> StandardServiceRoot::storeCustomFeedsData() {
-  return QMap<int,QVariant>();
-}
-
-void StandardServiceRoot::restoreCustomFeedsData(const QMap<int,QVariant> &data, const QHash<int,Feed*> &feeds) {
-  Q_UNUSED(feeds)
-  Q_UNUSED(data)
-}
-
 QString StandardServiceRoot::processFeedUrl(const QString &feed_url) {
   if (feed_url.startsWith(QL1S(URI_SCHEME_FEED_SHORT))) {
     QString without_feed_prefix = feed_url.mid(5);
@@ -233,9 +227,21 @@ QList<QAction*> StandardServiceRoot::getContextMenuForFeed(StandardFeed *feed) {
 bool StandardServiceRoot::mergeImportExportModel(FeedsImportExportModel *model, RootItem *target_root_node, QString &output_message) {
   QStack<RootItem*> original_parents; original_parents.push(target_root_node);
   QStack<RootItem*> new_parents; new_parents.push(model->rootItem());
-  bool some_feed_category_error = false;
+  QList<StandardCategory*> new_categories;
+  QList<StandardFeed*> new_feeds;
+  QSet<RootItem*> new_items;
+  QList<QPair<RootItem*,RootItem*> > new_top_level_items;
+  QSet<QString> known_urls;
+  int duplicate_feeds = 0;
+
+  // Feeds with already existing URLs are not imported again.
+  foreach (const Feed *feed, getSubTreeFeeds()) {
+    known_urls.insert(feed->url());
+  }
 
   // Iterate all new items we would like to merge into current model.
+  // NOTE: New items are collected first, then they are stored
+  // all at once and attached to the model in single step.
   while (!new_parents.isEmpty()) {
     RootItem *target_parent = original_parents.pop();
     RootItem *source_parent = new_parents.pop();
@@ -247,67 +253,172 @@ bool StandardServiceRoot::mergeImportExportModel(FeedsImportExportModel *model,
         continue;
       }
 
+      RootItem *new_item = nullptr;
+
       if (source_item->kind() == RootItemKind::Category) {
         StandardCategory *source_category = static_cast<StandardCategory*>(source_item);
-        StandardCategory *new_category = new StandardCategory(*source_category);
-        QString new_category_title = new_category->title();
-
-        // Add category to model.
-        new_category->clearChildren();
+        RootItem *existing_category = nullptr;
 
-        if (new_category->addItself(target_parent)) {
-          requestItemReassignment(new_category, target_parent);
+        // If the same category (with same title) already exists in current
+        // parent, then add descendants to it.
+        if (!new_items.contains(target_parent)) {
+          foreach (RootItem *child, target_parent->childItems()) {
+            if (child->kind() == RootItemKind::Category && child->title() == source_category->title()) {
+              existing_category = child;
+            }
+          }
+        }
 
-          // Process all children of this category.
-          original_parents.push(new_category);
+        if (existing_category != nullptr) {
+          original_parents.push(existing_category);
           new_parents.push(source_category);
         }
         else {
-          delete new_category;
+          StandardCategory *new_category = new StandardCategory(*source_category);
 
-          // Add category failed, but this can mean that the same category (with same title)
-          // already exists. If such a category exists in current parent, then find it and
-          // add descendants to it.
-          RootItem *existing_category = nullptr;
-          foreach (RootItem *child, target_parent->childItems()) {
-            if (child->kind() == RootItemKind::Category && child->title() == new_category_title) {
-              existing_category = child;
-            }
-          }
+          new_category->clearChildren();
+          new_categories.append(new_category);
+          new_item = new_category;
 
-          if (existing_category != nullptr) {
-            original_parents.push(existing_category);
-            new_parents.push(source_category);
-          }
-          else {
-            some_feed_category_error = true;
-          }
+          // Process all children of this category.
+          original_parents.push(new_category);
+          new_parents.push(source_category);
         }
       }
       else if (source_item->kind() == RootItemKind::Feed) {
         StandardFeed *source_feed = static_cast<StandardFeed*>(source_item);
-        StandardFeed *new_feed = new StandardFeed(*source_feed);
 
-        // Append this feed and end this iteration.
-        if (new_feed->addItself(target_parent)) {
-          requestItemReassignment(new_feed, target_parent);
+        if (known_urls.contains(source_feed->url())) {
+          duplicate_feeds++;
+        }
+        else {
+          StandardFeed *new_feed = new StandardFeed(*source_feed);
+
+          known_urls.insert(new_feed->url());
+          new_feeds.append(new_feed);
+          new_item = new_feed;
+        }
+      }
+
+      if (new_item != nullptr) {
+        new_items.insert(new_item);
+
+        if (new_items.contains(target_parent)) {
+          // Parent is new too, it is not in the model yet.
+          target_parent->appendChild(new_item);
         }
         else {
-          delete new_feed;
-          some_feed_category_error = true;
+          new_item->setParent(target_parent);
+          new_top_level_items.append(QPair<RootItem*,RootItem*>(new_item, target_parent));
         }
       }
     }
   }
 
-  if (some_feed_category_error) {
-    output_message = tr("Import successful, but some feeds/categories were not imported due to error.");
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+
+  if (!DatabaseQueries::addItemsInBulk(database, accountId(), new_categories, new_feeds)) {
+    // Nothing was stored, so nothing is added to the model.
+    for (int i = 0; i < new_top_level_items.size(); i++) {
+      delete new_top_level_items.at(i).first;
+    }
+
+    output_message = tr("Import failed, feeds/categories could not be stored.");
+    return false;
+  }
+
+  requestItemsAppend(new_top_level_items);
+
+  foreach (StandardFeed *new_feed, new_feeds) {
+    if (new_feed->icon().isNull()) {
+      requestFeedIcon(new_feed);
+    }
+  }
+
+  if (duplicate_feeds > 0) {
+    output_message = tr("Import successful, but %n feed(s) were skipped because they already exist.", 0, duplicate_feeds);
   }
   else {
     output_message = tr("Import was completely successful.");
   }
 
-  return !some_feed_category_error;
+  return true;
+}
+
+void StandardServiceRoot::requestFeedIcon(StandardFeed *feed, const QStringList &icon_locations) {
+  const QStringList locations = icon_locations.isEmpty() ? QStringList() << feed->url() : icon_locations;
+  QSet<QString> sites;
+
+  // Request must be registered before icons are requested, cached icons are resolved immediately.
+  foreach (const QString &location, locations) {
+    const QString site = FaviconResolver::siteKey(QUrl(location));
+
+    if (!site.isEmpty() && !sites.contains(site)) {
+      sites.insert(site);
+      m_feedsWaitingForIcon[site].append(IconRequest(feed, locations));
+    }
+  }
+
+  connect(qApp->favicons(), &FaviconResolver::iconResolved, this, &StandardServiceRoot::onIconResolved, Qt::UniqueConnection);
+  qApp->favicons()->requestIcons(locations);
+}
+
+void StandardServiceRoot::onIconResolved(const QString &site, const QIcon &icon) {
+  Q_UNUSED(icon)
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  QList<RootItem*> changed_feeds;
+
+  foreach (const IconRequest &request, m_feedsWaitingForIcon.take(site)) {
+    if (request.first.isNull()) {
+      continue;
+    }
+
+    bool resolved;
+    const QIcon feed_icon = qApp->favicons()->preferredIcon(request.second, &resolved);
+
+    if (!resolved) {
+      // Icon with higher priority might still arrive, feed
+      // is still listed under site of that icon.
+      continue;
+    }
+
+    forgetIconRequest(request);
+
+    // NOTE: If none of sites has icon, feed keeps its current icon
+    // and nothing is stored, so that it can be resolved again later.
+    if (!feed_icon.isNull() && DatabaseQueries::editFeedIcon(database, request.first->id(), feed_icon)) {
+      request.first->setIcon(feed_icon);
+      changed_feeds.append(request.first.data());
+    }
+  }
+
+  if (!changed_feeds.isEmpty()) {
+    itemChanged(changed_feeds);
+  }
+}
+
+void StandardServiceRoot::forgetIconRequest(const IconRequest &request) {
+  // Feed does not wait for its other sites anymore.
+  foreach (const QString &location, request.second) {
+    const QString site = FaviconResolver::siteKey(QUrl(location));
+
+    if (!m_feedsWaitingForIcon.contains(site)) {
+      continue;
+    }
+
+    QList<IconRequest> &requests = m_feedsWaitingForIcon[site];
+
+    for (int i = requests.size() - 1; i >= 0; i--) {
+      if (requests.at(i).first == request.first) {
+        requests.removeAt(i);
+      }
+    }
+
+    if (requests.isEmpty()) {
+      m_feedsWaitingForIcon.remove(site);
+    }
+  }
 }
 
 void StandardServiceRoot::addNewCategory() {
@@ -21,7 +21,9 @@
 #include "services/abstract/serviceroot.h"
 
 #include <QCoreApplication>
+#include <QHash>
 #include <QPair>
+#include <QPointer>
 
 
 class RecycleBin;
@@ -75,9 +77,20 @@ class StandardServiceRoot : public ServiceRoot {
     void importFeeds();
     void exportFeeds();
 
+    // Obtains icon for the feed in background, feed is updated once icon arrives.
+    // Icon of the first of given locations which has icon is used, feed URL is
+    // used if no locations are given.
+    void requestFeedIcon(StandardFeed *feed, const QStringList &icon_locations = QStringList());
+
+  private slots:
+    void onIconResolved(const QString &site, const QIcon &icon);
+
   private:
+    typedef QPair<QPointer<StandardFeed>,QStringList> IconRequest;
+
     QString processFeedUrl(const QString &feed_url);
     void checkArgumentsForFeedAdding();
+    void forgetIconRequest(const IconRequest &request);
 
     RecycleBin *m_recycleBin;
     QAction *m_actionExportFeeds;
@@ -86,8 +99,9 @@ class StandardServiceRoot : public ServiceRoot {
     QList<QAction*> m_feedContextMenu;
     QAction *m_actionFeedFetchMetadata;
 
-    QMap<int,QVariant> storeCustomFeedsData();
-    void restoreCustomFeedsData(const QMap<int,QVariant> &data, const QHash<int,Feed*> &feeds);
+    // Feeds waiting for their icons together with locations of their possible icons,
+    // keyed by sites of the locations, feed is listed under each of its sites.
+    QHash<QString,QList<IconRequest> > m_feedsWaitingForIcon;
 };
 
 #endif // STANDARDSERVICEROOT_H
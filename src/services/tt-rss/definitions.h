@@ -30,6 +30,14 @@
 
 // Limitations
 #define MAX_MESSAGES      200
+#define MAX_ICON_DOWNLOADS  4
+
+// Prefetching of contents of messages synchronized without contents.
+#define PREFETCH_BATCH_SIZE   20
+#define PREFETCH_DELAY        10000
+
+// Downloaded icons are applied to feeds in batches.
+#define ICON_BATCH_DELAY      500
 
 // General return status codes.
 #define API_STATUS_OK     0
@@ -46,7 +46,9 @@ FormEditAccount::FormEditAccount(QWidget *parent)
                                    tr("Here, results of connection test are shown."));
 
   setTabOrder(m_ui->m_txtUrl->lineEdit(), m_ui->m_checkServerSideUpdate);
-  setTabOrder(m_ui->m_checkServerSideUpdate, m_ui->m_txtUsername->lineEdit());
+  setTabOrder(m_ui->m_checkServerSideUpdate, m_ui->m_checkHeadlinesOnly);
+  setTabOrder(m_ui->m_checkHeadlinesOnly, m_ui->m_checkPrefetchContents);
+  setTabOrder(m_ui->m_checkPrefetchContents, m_ui->m_txtUsername->lineEdit());
   setTabOrder(m_ui->m_txtUsername->lineEdit(), m_ui->m_txtPassword->lineEdit());
   setTabOrder(m_ui->m_txtPassword->lineEdit(), m_ui->m_checkShowPassword);
   setTabOrder(m_ui->m_checkShowPassword, m_ui->m_gbHttpAuthentication);
@@ -71,6 +73,7 @@ FormEditAccount::FormEditAccount(QWidget *parent)
   connect(m_ui->m_gbHttpAuthentication, SIGNAL(toggled(bool)), this, SLOT(onHttpPasswordChanged()));
   connect(m_ui->m_gbHttpAuthentication, SIGNAL(toggled(bool)), this, SLOT(onHttpUsernameChanged()));
   connect(m_ui->m_checkShowHttpPassword, SIGNAL(toggled(bool)), this, SLOT(displayHttpPassword(bool)));
+  connect(m_ui->m_checkHeadlinesOnly, SIGNAL(toggled(bool)), m_ui->m_checkPrefetchContents, SLOT(setEnabled(bool)));
 
   onPasswordChanged();
   onUsernameChanged();
@@ -102,6 +105,8 @@ void FormEditAccount::execForEdit(TtRssServiceRoot *existing_root) {
   m_ui->m_txtPassword->lineEdit()->setText(existing_root->network()->password());
   m_ui->m_txtUrl->lineEdit()->setText(existing_root->network()->url());
   m_ui->m_checkServerSideUpdate->setChecked(existing_root->network()->forceServerSideUpdate());
+  m_ui->m_checkHeadlinesOnly->setChecked(existing_root->network()->headlinesOnly());
+  m_ui->m_checkPrefetchContents->setChecked(existing_root->network()->prefetchContents());
 
   exec();
 }
@@ -189,6 +194,8 @@ void FormEditAccount::onClickedOk() {
   m_editableRoot->network()->setAuthUsername(m_ui->m_txtHttpUsername->lineEdit()->text());
   m_editableRoot->network()->setAuthPassword(m_ui->m_txtHttpPassword->lineEdit()->text());
   m_editableRoot->network()->setForceServerSideUpdate(m_ui->m_checkServerSideUpdate->isChecked());
+  m_editableRoot->network()->setHeadlinesOnly(m_ui->m_checkHeadlinesOnly->isChecked());
+  m_editableRoot->network()->setPrefetchContents(m_ui->m_checkPrefetchContents->isChecked());
   m_editableRoot->saveAccountDataToDatabase();
 
   accept();
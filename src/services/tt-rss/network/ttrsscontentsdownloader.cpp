@@ -0,0 +1,80 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "services/tt-rss/network/ttrsscontentsdownloader.h"
+
+#include "services/tt-rss/definitions.h"
+
+#include <QMutexLocker>
+
+
+TtRssContentsDownloader::TtRssContentsDownloader(QObject *parent)
+  : QObject(parent), m_network(TtRssNetworkFactory()), m_settings(TtRssNetworkFactory()), m_settingsChanged(false) {
+}
+
+TtRssContentsDownloader::~TtRssContentsDownloader() {
+}
+
+void TtRssContentsDownloader::setNetworkSettings(const TtRssNetworkFactory &network) {
+  QMutexLocker locker(&m_settingsMutex);
+
+  if (m_settings.url() != network.url() || m_settings.username() != network.username() ||
+      m_settings.password() != network.password() || m_settings.authIsUsed() != network.authIsUsed() ||
+      m_settings.authUsername() != network.authUsername() || m_settings.authPassword() != network.authPassword()) {
+    m_settings.setUrl(network.url());
+    m_settings.setUsername(network.username());
+    m_settings.setPassword(network.password());
+    m_settings.setAuthIsUsed(network.authIsUsed());
+    m_settings.setAuthUsername(network.authUsername());
+    m_settings.setAuthPassword(network.authPassword());
+    m_settingsChanged = true;
+  }
+}
+
+void TtRssContentsDownloader::applyNetworkSettings() {
+  QMutexLocker locker(&m_settingsMutex);
+
+  if (m_settingsChanged) {
+    // New settings are used with new session, which is
+    // obtained by the factory when it is not logged in.
+    m_network = m_settings;
+    m_settingsChanged = false;
+  }
+}
+
+void TtRssContentsDownloader::downloadContents(const QStringList &custom_ids, bool prefetch) {
+  applyNetworkSettings();
+
+  const TtRssGetHeadlinesResponse response = m_network.getArticles(custom_ids);
+
+  if (m_network.lastError() != QNetworkReply::NoError || response.status() != API_STATUS_OK) {
+    qWarning("TT-RSS: Contents of %d messages were not downloaded.", custom_ids.size());
+    emit contentsDownloaded(custom_ids, QList<Message>(), false, prefetch);
+    return;
+  }
+
+  QList<Message> articles = response.messages();
+
+  // Server could return fewer articles, for example if they were removed.
+  for (int i = articles.size() - 1; i >= 0; i--) {
+    if (articles.at(i).m_isPartial || !custom_ids.contains(articles.at(i).m_customId)) {
+      articles.removeAt(i);
+    }
+  }
+
+  emit contentsDownloaded(custom_ids, articles, true, prefetch);
+}
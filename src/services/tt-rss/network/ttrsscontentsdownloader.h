@@ -0,0 +1,70 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TTRSSCONTENTSDOWNLOADER_H
+#define TTRSSCONTENTSDOWNLOADER_H
+
+#include <QObject>
+
+#include "core/message.h"
+#include "services/tt-rss/network/ttrssnetworkfactory.h"
+
+#include <QStringList>
+#include <QMutex>
+
+
+// Downloads full contents of messages, which were synchronized
+// without contents, from TT-RSS server.
+//
+// Downloader is supposed to live in its own thread,
+// so that GUI is not blocked by network operations.
+// It uses its own network factory with its own session, so
+// it does not share any state with network factory of the account.
+class TtRssContentsDownloader : public QObject {
+    Q_OBJECT
+
+  public:
+    // Constructors and destructors.
+    explicit TtRssContentsDownloader(QObject *parent = 0);
+    virtual ~TtRssContentsDownloader();
+
+    // Copies connection settings of given network factory, they are used
+    // for next downloads. This can be called from any thread.
+    void setNetworkSettings(const TtRssNetworkFactory &network);
+
+  public slots:
+    // Downloads contents of messages with given custom IDs. Flag "prefetch"
+    // is not used by the downloader, it is just passed back to the caller.
+    void downloadContents(const QStringList &custom_ids, bool prefetch);
+
+  signals:
+    // Emitted when downloading finishes. Only messages with full contents
+    // are returned, "ok" is false if server could not be asked at all.
+    void contentsDownloaded(const QStringList &custom_ids, const QList<Message> &messages, bool ok, bool prefetch);
+
+  private:
+    void applyNetworkSettings();
+
+    TtRssNetworkFactory m_network;
+
+    // Settings waiting to be applied in thread of the downloader.
+    QMutex m_settingsMutex;
+    TtRssNetworkFactory m_settings;
+    bool m_settingsChanged;
+};
+
+#endif // TTRSSCONTENTSDOWNLOADER_H
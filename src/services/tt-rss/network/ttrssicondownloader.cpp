@@ -0,0 +1,112 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#include "services/tt-rss/network/ttrssicondownloader.h"
+
+#include "services/tt-rss/definitions.h"
+#include "network-web/downloader.h"
+
+#include <QPixmap>
+
+
+TtRssIconDownloader::TtRssIconDownloader(QObject *parent) : QObject(parent) {
+}
+
+TtRssIconDownloader::~TtRssIconDownloader() {
+  cancel();
+}
+
+QIcon TtRssIconDownloader::cachedIcon(const QString &icon_address) const {
+  return m_cache.value(icon_address);
+}
+
+void TtRssIconDownloader::requestIcon(int feed_custom_id, const QString &icon_address) {
+  if (m_cache.contains(icon_address)) {
+    emit iconDownloaded(feed_custom_id, m_cache.value(icon_address));
+    return;
+  }
+
+  if (!m_waitingFeeds.contains(icon_address)) {
+    // Nobody waits for this icon yet, it must be downloaded.
+    m_queue.append(icon_address);
+  }
+
+  if (!m_waitingFeeds[icon_address].contains(feed_custom_id)) {
+    m_waitingFeeds[icon_address].append(feed_custom_id);
+  }
+
+  processQueue();
+}
+
+void TtRssIconDownloader::cancel() {
+  foreach (Downloader *downloader, m_activeDownloads.keys()) {
+    downloader->disconnect(this);
+    downloader->cancel();
+    downloader->deleteLater();
+  }
+
+  m_activeDownloads.clear();
+  m_waitingFeeds.clear();
+  m_queue.clear();
+}
+
+void TtRssIconDownloader::processQueue() {
+  while (!m_queue.isEmpty() && m_activeDownloads.size() < MAX_ICON_DOWNLOADS) {
+    const QString icon_address = m_queue.takeFirst();
+    Downloader *downloader = new Downloader(this);
+
+    m_activeDownloads.insert(downloader, icon_address);
+    connect(downloader, &Downloader::completed, this, &TtRssIconDownloader::onDownloadCompleted);
+    downloader->downloadFile(icon_address);
+  }
+}
+
+void TtRssIconDownloader::onDownloadCompleted(QNetworkReply::NetworkError status) {
+  Downloader *downloader = qobject_cast<Downloader*>(sender());
+
+  if (downloader == nullptr || !m_activeDownloads.contains(downloader)) {
+    return;
+  }
+
+  const QString icon_address = m_activeDownloads.take(downloader);
+  const QList<int> feed_custom_ids = m_waitingFeeds.take(icon_address);
+
+  if (status == QNetworkReply::NoError) {
+    QPixmap icon_pixmap;
+
+    if (icon_pixmap.loadFromData(downloader->lastOutputData())) {
+      // Icon downloaded, set it up for all feeds which use it.
+      const QIcon icon(icon_pixmap);
+
+      m_cache.insert(icon_address, icon);
+
+      foreach (int feed_custom_id, feed_custom_ids) {
+        emit iconDownloaded(feed_custom_id, icon);
+      }
+    }
+    else {
+      qWarning("TT-RSS: Icon '%s' could not be decoded, %d bytes received.",
+               qPrintable(icon_address), downloader->lastOutputData().size());
+    }
+  }
+  else {
+    qWarning("TT-RSS: Icon '%s' was not downloaded, error '%d'.", qPrintable(icon_address), (int) status);
+  }
+
+  downloader->deleteLater();
+  processQueue();
+}
@@ -0,0 +1,70 @@
+// This file is part of RSS Guard.
+//
+// Copyright (C) 2011-2016 by Martin Rotter <rotter.martinos@gmail.com>
+//
+// RSS Guard is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// RSS Guard is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with RSS Guard. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TTRSSICONDOWNLOADER_H
+#define TTRSSICONDOWNLOADER_H
+
+#include <QObject>
+
+#include <QHash>
+#include <QIcon>
+#include <QStringList>
+#include <QNetworkReply>
+
+
+class Downloader;
+
+// Downloads feed icons from TT-RSS server in background.
+//
+// Limited number of icons is downloaded in parallel. Icons are
+// cached by their address, so that icon shared by many feeds
+// is downloaded only once.
+class TtRssIconDownloader : public QObject {
+    Q_OBJECT
+
+  public:
+    // Constructors and destructors.
+    explicit TtRssIconDownloader(QObject *parent = 0);
+    virtual ~TtRssIconDownloader();
+
+    // Returns cached icon for given address, null icon is returned
+    // if icon was not downloaded yet.
+    QIcon cachedIcon(const QString &icon_address) const;
+
+    // Schedules download of icon for feed with given custom ID.
+    void requestIcon(int feed_custom_id, const QString &icon_address);
+
+  public slots:
+    // Aborts all running downloads and forgets waiting feeds.
+    void cancel();
+
+  signals:
+    void iconDownloaded(int feed_custom_id, const QIcon &icon);
+
+  private slots:
+    void onDownloadCompleted(QNetworkReply::NetworkError status);
+
+  private:
+    void processQueue();
+
+    QStringList m_queue;
+    QHash<QString,QList<int> > m_waitingFeeds;
+    QHash<Downloader*,QString> m_activeDownloads;
+    QHash<QString,QIcon> m_cache;
+};
+
+#endif // TTRSSICONDOWNLOADER_H
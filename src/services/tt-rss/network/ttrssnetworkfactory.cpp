@@ -24,6 +24,7 @@
 #include "services/tt-rss/ttrsscategory.h"
 #include "miscellaneous/application.h"
 #include "miscellaneous/iconfactory.h"
+#include "miscellaneous/jsonstreamreader.h"
 #include "miscellaneous/textfactory.h"
 #include "network-web/networkfactory.h"
 
@@ -34,7 +35,8 @@
 
 
 TtRssNetworkFactory::TtRssNetworkFactory()
-  : m_bareUrl(QString()), m_fullUrl(QString()), m_username(QString()), m_password(QString()), m_forceServerSideUpdate(false), m_authIsUsed(false),
+  : m_bareUrl(QString()), m_fullUrl(QString()), m_username(QString()), m_password(QString()), m_forceServerSideUpdate(false), m_headlinesOnly(false),
+    m_prefetchContents(false), m_authIsUsed(false),
     m_authUsername(QString()), m_authPassword(QString()), m_sessionId(QString()),
     m_lastLoginTime(QDateTime()), m_lastError(QNetworkReply::NoError) {
 }
@@ -103,7 +105,7 @@ TtRssLoginResponse TtRssNetworkFactory::login() {
                                                            QJsonDocument(json).toJson(QJsonDocument::Compact), CONTENT_TYPE, result_raw,
                                                            QNetworkAccessManager::PostOperation,
                                                            m_authIsUsed, m_authUsername, m_authPassword);
-  TtRssLoginResponse login_response(QString::fromUtf8(result_raw));
+  TtRssLoginResponse login_response(result_raw);
 
   if (network_reply.first == QNetworkReply::NoError) {
     m_sessionId = login_response.sessionId();
@@ -140,7 +142,7 @@ TtRssResponse TtRssNetworkFactory::logout() {
       qWarning("TT-RSS: Logout failed with error %d.", network_reply.first);
     }
 
-    return TtRssResponse(QString::fromUtf8(result_raw));
+    return TtRssResponse(result_raw);
   }
   else {
     qWarning("TT-RSS: Cannot logout because session ID is empty.");
@@ -162,7 +164,7 @@ TtRssGetFeedsCategoriesResponse TtRssNetworkFactory::getFeedsCategories() {
                                                            CONTENT_TYPE, result_raw,
                                                            QNetworkAccessManager::PostOperation,
                                                            m_authIsUsed, m_authUsername, m_authPassword);
-  TtRssGetFeedsCategoriesResponse result(QString::fromUtf8(result_raw));
+  TtRssGetFeedsCategoriesResponse result(result_raw);
 
   if (result.isNotLoggedIn()) {
     // We are not logged in.
@@ -172,7 +174,7 @@ TtRssGetFeedsCategoriesResponse TtRssNetworkFactory::getFeedsCategories() {
     network_reply = NetworkFactory::performNetworkOperation(m_fullUrl, timeout, QJsonDocument(json).toJson(QJsonDocument::Compact), CONTENT_TYPE, result_raw,
                                                QNetworkAccessManager::PostOperation,
                                                m_authIsUsed, m_authUsername, m_authPassword);
-    result = TtRssGetFeedsCategoriesResponse(QString::fromUtf8(result_raw));
+    result = TtRssGetFeedsCategoriesResponse(result_raw);
   }
 
   if (network_reply.first != QNetworkReply::NoError) {
@@ -185,7 +187,7 @@ TtRssGetFeedsCategoriesResponse TtRssNetworkFactory::getFeedsCategories() {
 
 TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int limit, int skip,
                                                             bool show_content, bool include_attachments,
-                                                            bool sanitize) {
+                                                            bool sanitize, bool show_excerpt) {
   QJsonObject json;
   json["op"] = QSL("getHeadlines");
   json["sid"] = m_sessionId;
@@ -194,6 +196,7 @@ TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int lim
   json["limit"] = limit;
   json["skip"] = skip;
   json["show_content"] = show_content;
+  json["show_excerpt"] = show_excerpt;
   json["include_attachments"] = include_attachments;
   json["sanitize"] = sanitize;
 
@@ -203,7 +206,7 @@ TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int lim
                                                            CONTENT_TYPE, result_raw,
                                                            QNetworkAccessManager::PostOperation,
                                                            m_authIsUsed, m_authUsername, m_authPassword);
-  TtRssGetHeadlinesResponse result(QString::fromUtf8(result_raw));
+  TtRssGetHeadlinesResponse result(result_raw);
 
   if (result.isNotLoggedIn()) {
     // We are not logged in.
@@ -213,11 +216,9 @@ TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int lim
     network_reply = NetworkFactory::performNetworkOperation(m_fullUrl, timeout, QJsonDocument(json).toJson(QJsonDocument::Compact), CONTENT_TYPE, result_raw,
                                                QNetworkAccessManager::PostOperation,
                                                m_authIsUsed, m_authUsername, m_authPassword);
-    result = TtRssGetHeadlinesResponse(QString::fromUtf8(result_raw));
+    result = TtRssGetHeadlinesResponse(result_raw);
   }
 
-  IOFactory::writeTextFile("aaa", result_raw);
-
   if (network_reply.first != QNetworkReply::NoError) {
     qWarning("TT-RSS: getHeadlines failed with error %d.", network_reply.first);
   }
@@ -226,6 +227,39 @@ TtRssGetHeadlinesResponse TtRssNetworkFactory::getHeadlines(int feed_id, int lim
   return result;
 }
 
+TtRssGetHeadlinesResponse TtRssNetworkFactory::getArticles(const QStringList &ids) {
+  QJsonObject json;
+  json["op"] = QSL("getArticle");
+  json["sid"] = m_sessionId;
+  json["article_id"] = ids.join(QSL(","));
+
+  const int timeout = qApp->settings()->value(GROUP(Feeds), SETTING(Feeds::UpdateTimeout)).toInt();
+  QByteArray result_raw;
+  NetworkResult network_reply = NetworkFactory::performNetworkOperation(m_fullUrl, timeout, QJsonDocument(json).toJson(QJsonDocument::Compact),
+                                                           CONTENT_TYPE, result_raw,
+                                                           QNetworkAccessManager::PostOperation,
+                                                           m_authIsUsed, m_authUsername, m_authPassword);
+  TtRssGetHeadlinesResponse result(result_raw);
+
+  if (result.isNotLoggedIn()) {
+    // We are not logged in.
+    login();
+    json["sid"] = m_sessionId;
+
+    network_reply = NetworkFactory::performNetworkOperation(m_fullUrl, timeout, QJsonDocument(json).toJson(QJsonDocument::Compact), CONTENT_TYPE, result_raw,
+                                               QNetworkAccessManager::PostOperation,
+                                               m_authIsUsed, m_authUsername, m_authPassword);
+    result = TtRssGetHeadlinesResponse(result_raw);
+  }
+
+  if (network_reply.first != QNetworkReply::NoError) {
+    qWarning("TT-RSS: getArticle failed with error %d.", network_reply.first);
+  }
+
+  m_lastError = network_reply.first;
+  return result;
+}
+
 TtRssUpdateArticleResponse TtRssNetworkFactory::updateArticles(const QStringList &ids,
                                                                UpdateArticle::OperatingField field,
                                                                UpdateArticle::Mode mode) {
@@ -242,7 +276,7 @@ TtRssUpdateArticleResponse TtRssNetworkFactory::updateArticles(const QStringList
                                                            CONTENT_TYPE, result_raw,
                                                            QNetworkAccessManager::PostOperation,
                                                            m_authIsUsed, m_authUsername, m_authPassword);
-  TtRssUpdateArticleResponse result(QString::fromUtf8(result_raw));
+  TtRssUpdateArticleResponse result(result_raw);
 
   if (result.isNotLoggedIn()) {
     // We are not logged in.
@@ -253,7 +287,7 @@ TtRssUpdateArticleResponse TtRssNetworkFactory::updateArticles(const QStringList
                                                CONTENT_TYPE, result_raw,
                                                QNetworkAccessManager::PostOperation,
                                                m_authIsUsed, m_authUsername, m_authPassword);
-    result = TtRssUpdateArticleResponse(QString::fromUtf8(result_raw));
+    result = TtRssUpdateArticleResponse(result_raw);
   }
 
   if (network_reply.first != QNetworkReply::NoError) {
@@ -284,7 +318,7 @@ TtRssSubscribeToFeedResponse TtRssNetworkFactory::subscribeToFeed(const QString
                                                            CONTENT_TYPE, result_raw,
                                                            QNetworkAccessManager::PostOperation,
                                                            m_authIsUsed, m_authUsername, m_authPassword);
-  TtRssSubscribeToFeedResponse result(QString::fromUtf8(result_raw));
+  TtRssSubscribeToFeedResponse result(result_raw);
 
   if (result.isNotLoggedIn()) {
     // We are not logged in.
@@ -295,7 +329,7 @@ TtRssSubscribeToFeedResponse TtRssNetworkFactory::subscribeToFeed(const QString
                                                CONTENT_TYPE, result_raw,
                                                QNetworkAccessManager::PostOperation,
                                                m_authIsUsed, m_authUsername, m_authPassword);
-    result = TtRssSubscribeToFeedResponse(QString::fromUtf8(result_raw));
+    result = TtRssSubscribeToFeedResponse(result_raw);
   }
 
   if (network_reply.first != QNetworkReply::NoError) {
@@ -317,7 +351,7 @@ TtRssUnsubscribeFeedResponse TtRssNetworkFactory::unsubscribeFeed(int feed_id) {
   NetworkResult network_reply = NetworkFactory::performNetworkOperation(m_fullUrl, timeout, QJsonDocument(json).toJson(QJsonDocument::Compact), CONTENT_TYPE, result_raw,
                                                            QNetworkAccessManager::PostOperation,
                                                            m_authIsUsed, m_authUsername, m_authPassword);
-  TtRssUnsubscribeFeedResponse result(QString::fromUtf8(result_raw));
+  TtRssUnsubscribeFeedResponse result(result_raw);
 
   if (result.isNotLoggedIn()) {
     // We are not logged in.
@@ -327,7 +361,7 @@ TtRssUnsubscribeFeedResponse TtRssNetworkFactory::unsubscribeFeed(int feed_id) {
     network_reply = NetworkFactory::performNetworkOperation(m_fullUrl, timeout, QJsonDocument(json).toJson(QJsonDocument::Compact), CONTENT_TYPE, result_raw,
                                                QNetworkAccessManager::PostOperation,
                                                m_authIsUsed, m_authUsername, m_authPassword);
-    result = TtRssUnsubscribeFeedResponse(QString::fromUtf8(result_raw));
+    result = TtRssUnsubscribeFeedResponse(result_raw);
   }
 
   if (network_reply.first != QNetworkReply::NoError) {
@@ -346,6 +380,22 @@ void TtRssNetworkFactory::setForceServerSideUpdate(bool force_server_side_update
   m_forceServerSideUpdate = force_server_side_update;
 }
 
+bool TtRssNetworkFactory::headlinesOnly() const {
+  return m_headlinesOnly;
+}
+
+void TtRssNetworkFactory::setHeadlinesOnly(bool headlines_only) {
+  m_headlinesOnly = headlines_only;
+}
+
+bool TtRssNetworkFactory::prefetchContents() const {
+  return m_prefetchContents;
+}
+
+void TtRssNetworkFactory::setPrefetchContents(bool prefetch_contents) {
+  m_prefetchContents = prefetch_contents;
+}
+
 bool TtRssNetworkFactory::authIsUsed() const {
   return m_authIsUsed;
 }
@@ -370,8 +420,14 @@ void TtRssNetworkFactory::setAuthPassword(const QString &auth_password) {
   m_authPassword = auth_password;
 }
 
-TtRssResponse::TtRssResponse(const QString &raw_content) {
-  m_rawContent = QJsonDocument::fromJson(raw_content.toUtf8()).object();
+TtRssResponse::TtRssResponse(const QByteArray &raw_content, const QString &streamed_member)
+  : m_rawData(raw_content), m_streamedOffset(-1) {
+  if (streamed_member.isEmpty()) {
+    m_rawContent = QJsonDocument::fromJson(raw_content).object();
+  }
+  else {
+    m_rawContent = JsonStreamReader::readObject(raw_content, streamed_member, &m_streamedOffset);
+  }
 }
 
 TtRssResponse::~TtRssResponse() {
@@ -404,10 +460,10 @@ bool TtRssResponse::isNotLoggedIn() const {
 }
 
 QString TtRssResponse::toString() const {
-  return QJsonDocument(m_rawContent).toJson(QJsonDocument::Compact);
+  return QString::fromUtf8(m_rawData);
 }
 
-TtRssLoginResponse::TtRssLoginResponse(const QString &raw_content) : TtRssResponse(raw_content) {
+TtRssLoginResponse::TtRssLoginResponse(const QByteArray &raw_content) : TtRssResponse(raw_content) {
 }
 
 TtRssLoginResponse::~TtRssLoginResponse() {
@@ -450,14 +506,14 @@ bool TtRssResponse::hasError() const {
 }
 
 
-TtRssGetFeedsCategoriesResponse::TtRssGetFeedsCategoriesResponse(const QString &raw_content) : TtRssResponse(raw_content) {
+TtRssGetFeedsCategoriesResponse::TtRssGetFeedsCategoriesResponse(const QByteArray &raw_content) : TtRssResponse(raw_content) {
 
 }
 
 TtRssGetFeedsCategoriesResponse::~TtRssGetFeedsCategoriesResponse() {
 }
 
-RootItem *TtRssGetFeedsCategoriesResponse::feedsCategories(bool obtain_icons, QString base_address) const {
+RootItem *TtRssGetFeedsCategoriesResponse::feedsCategories(QString base_address, QHash<int,QString> *icon_addresses) const {
   RootItem *parent = new RootItem();
 
   // Chop the "api/" from the end of the address.
@@ -510,22 +566,12 @@ RootItem *TtRssGetFeedsCategoriesResponse::feedsCategories(bool obtain_icons, QS
           // We have feed.
           TtRssFeed *feed = new TtRssFeed();
 
-          if (obtain_icons) {
+          if (icon_addresses != nullptr) {
             QString icon_path = item["icon"].type() == QJsonValue::String ? item["icon"].toString() : QString();
 
             if (!icon_path.isEmpty()) {
               // Chop the "api/" suffix out and append
-              QString full_icon_address = base_address + QL1C('/') + icon_path;
-              QByteArray icon_data;
-
-              if (NetworkFactory::performNetworkOperation(full_icon_address, DOWNLOAD_TIMEOUT,
-                                                          QByteArray(), QString(), icon_data,
-                                                          QNetworkAccessManager::GetOperation).first == QNetworkReply::NoError) {
-                // Icon downloaded, set it up.
-                QPixmap icon_pixmap;
-                icon_pixmap.loadFromData(icon_data);
-                feed->setIcon(QIcon(icon_pixmap));
-              }
+              icon_addresses->insert(item_id, base_address + QL1C('/') + icon_path);
             }
           }
 
@@ -541,7 +587,7 @@ RootItem *TtRssGetFeedsCategoriesResponse::feedsCategories(bool obtain_icons, QS
 }
 
 
-TtRssGetHeadlinesResponse::TtRssGetHeadlinesResponse(const QString &raw_content) : TtRssResponse(raw_content) {
+TtRssGetHeadlinesResponse::TtRssGetHeadlinesResponse(const QByteArray &raw_content) : TtRssResponse(raw_content, QSL("content")) {
 }
 
 TtRssGetHeadlinesResponse::~TtRssGetHeadlinesResponse() {
@@ -550,44 +596,135 @@ TtRssGetHeadlinesResponse::~TtRssGetHeadlinesResponse() {
 QList<Message> TtRssGetHeadlinesResponse::messages() const {
   QList<Message> messages;
 
-  foreach (QJsonValue item, m_rawContent["content"].toArray()) {
-    QJsonObject mapped = item.toObject();
-    Message message;
+  if (m_streamedOffset < 0) {
+    return messages;
+  }
+
+  // Headlines are read directly from raw data, one by one.
+  JsonStreamReader reader(m_rawData, m_streamedOffset);
+
+  if (!reader.readNext() || reader.tokenType() != JsonStreamReader::StartArray) {
+    return messages;
+  }
+
+  while (reader.readNext() && reader.tokenType() != JsonStreamReader::EndArray) {
+    if (reader.tokenType() != JsonStreamReader::StartObject) {
+      reader.skipValue();
+      continue;
+    }
 
-    message.m_author = mapped["author"].toString();
-    message.m_isRead = !mapped["unread"].toBool();
-    message.m_isImportant = mapped["marked"].toBool();
-    message.m_contents = mapped["content"].toString();
+    Message message;
+    bool has_contents = false;
+    QString excerpt;
 
-    // Multiply by 1000 because Tiny Tiny RSS API does not include miliseconds in Unix
-    // date/time number.
-    message.m_created = TextFactory::parseDateTime(mapped["updated"].toDouble() * 1000);
     message.m_createdFromFeed = true;
-    message.m_customId = QString::number(mapped["id"].toInt());
-    message.m_feedId = mapped["feed_id"].toString();
-    message.m_title = mapped["title"].toString();
-    message.m_url = mapped["link"].toString();
-
-    if (mapped.contains(QSL("attachments"))) {
-      // Process enclosures.
-      foreach (QJsonValue attachment, mapped["attachments"].toArray()) {
-        QJsonObject mapped_attachemnt = attachment.toObject();
-        Enclosure enclosure;
-
-        enclosure.m_mimeType = mapped_attachemnt["content_type"].toString();
-        enclosure.m_url = mapped_attachemnt["content_url"].toString();
-        message.m_enclosures.append(enclosure);
+
+    // Messages without valid "unread" flag are considered read.
+    message.m_isRead = true;
+    message.m_isImportant = false;
+
+    while (reader.readNext() && reader.tokenType() == JsonStreamReader::Name) {
+      const QString name = reader.text();
+
+      if (!reader.readNext()) {
+        break;
+      }
+
+      if (!reader.isScalar() && name != QL1S("attachments")) {
+        // Structured values of other members are not used, they are
+        // skipped as a whole so that reader stays in sync with the document.
+        reader.skipValue();
+        continue;
+      }
+
+      if (name == QL1S("author")) {
+        message.m_author = reader.text();
+      }
+      else if (name == QL1S("unread")) {
+        message.m_isRead = !reader.boolean();
+      }
+      else if (name == QL1S("marked")) {
+        message.m_isImportant = reader.boolean();
+      }
+      else if (name == QL1S("content")) {
+        message.m_contents = reader.text();
+        has_contents = true;
+      }
+      else if (name == QL1S("excerpt")) {
+        excerpt = reader.text();
+      }
+      else if (name == QL1S("updated")) {
+        // Multiply by 1000 because Tiny Tiny RSS API does not include miliseconds in Unix
+        // date/time number.
+        message.m_created = TextFactory::parseDateTime(reader.number() * 1000);
+      }
+      else if (name == QL1S("id")) {
+        message.m_customId = QString::number((int) reader.number());
       }
+      else if (name == QL1S("feed_id")) {
+        message.m_feedId = reader.tokenType() == JsonStreamReader::Number ?
+                             QString::number((int) reader.number()) :
+                             reader.text();
+      }
+      else if (name == QL1S("title")) {
+        message.m_title = reader.text();
+      }
+      else if (name == QL1S("link")) {
+        message.m_url = reader.text();
+      }
+      else if (name == QL1S("attachments") && reader.tokenType() == JsonStreamReader::StartArray) {
+        // Process enclosures.
+        while (reader.readNext() && reader.tokenType() == JsonStreamReader::StartObject) {
+          Enclosure enclosure;
+
+          while (reader.readNext() && reader.tokenType() == JsonStreamReader::Name) {
+            const QString attachment_name = reader.text();
+
+            if (!reader.readNext()) {
+              break;
+            }
+
+            if (!reader.isScalar()) {
+              reader.skipValue();
+            }
+            else if (attachment_name == QL1S("content_type")) {
+              enclosure.m_mimeType = reader.text();
+            }
+            else if (attachment_name == QL1S("content_url")) {
+              enclosure.m_url = reader.text();
+            }
+            else {
+              reader.skipValue();
+            }
+          }
+
+          message.m_enclosures.append(enclosure);
+        }
+      }
+      else {
+        reader.skipValue();
+      }
+    }
+
+    if (!has_contents) {
+      // Only headline was requested, contents will be downloaded later.
+      // WARNING: There is a difference between "" and QString() in terms of nullptr SQL values!
+      message.m_contents = excerpt.isNull() ? QSL("") : excerpt;
+      message.m_isPartial = true;
     }
 
     messages.append(message);
   }
 
+  if (reader.hasError()) {
+    qWarning("TT-RSS: Headlines data are not well-formed, %d headlines were read.", messages.size());
+  }
+
   return messages;
 }
 
 
-TtRssUpdateArticleResponse::TtRssUpdateArticleResponse(const QString &raw_content) : TtRssResponse(raw_content) {
+TtRssUpdateArticleResponse::TtRssUpdateArticleResponse(const QByteArray &raw_content) : TtRssResponse(raw_content) {
 }
 
 TtRssUpdateArticleResponse::~TtRssUpdateArticleResponse() {
@@ -611,7 +748,7 @@ int TtRssUpdateArticleResponse::articlesUpdated() const {
   }
 }
 
-TtRssSubscribeToFeedResponse::TtRssSubscribeToFeedResponse(const QString &raw_content) : TtRssResponse(raw_content) {
+TtRssSubscribeToFeedResponse::TtRssSubscribeToFeedResponse(const QByteArray &raw_content) : TtRssResponse(raw_content) {
 }
 
 TtRssSubscribeToFeedResponse::~TtRssSubscribeToFeedResponse() {
@@ -627,7 +764,7 @@ int TtRssSubscribeToFeedResponse::code() const {
 }
 
 
-TtRssUnsubscribeFeedResponse::TtRssUnsubscribeFeedResponse(const QString &raw_content) : TtRssResponse(raw_content) {
+TtRssUnsubscribeFeedResponse::TtRssUnsubscribeFeedResponse(const QByteArray &raw_content) : TtRssResponse(raw_content) {
 }
 
 TtRssUnsubscribeFeedResponse::~TtRssUnsubscribeFeedResponse() {
@@ -21,7 +21,9 @@
 #include "core/message.h"
 
 #include <QString>
+#include <QByteArray>
 #include <QPair>
+#include <QHash>
 #include <QNetworkReply>
 #include <QJsonObject>
 
@@ -31,7 +33,9 @@ class TtRssFeed;
 
 class TtRssResponse {
   public:
-    explicit TtRssResponse(const QString &raw_content = QString());
+    // NOTE: If "streamed_member" is given and it is array, then it is not
+    // parsed into JSON tree, it is read directly from raw data when needed.
+    explicit TtRssResponse(const QByteArray &raw_content = QByteArray(), const QString &streamed_member = QString());
     virtual ~TtRssResponse();
 
     bool isLoaded() const;
@@ -44,12 +48,14 @@ class TtRssResponse {
     QString toString() const;
 
   protected:
+    QByteArray m_rawData;
     QJsonObject m_rawContent;
+    int m_streamedOffset;
 };
 
 class TtRssLoginResponse : public TtRssResponse {
   public:
-    explicit TtRssLoginResponse(const QString &raw_content = QString());
+    explicit TtRssLoginResponse(const QByteArray &raw_content = QByteArray());
     virtual ~TtRssLoginResponse();
 
     int apiLevel() const;
@@ -58,18 +64,20 @@ class TtRssLoginResponse : public TtRssResponse {
 
 class TtRssGetFeedsCategoriesResponse : public TtRssResponse {
   public:
-    explicit TtRssGetFeedsCategoriesResponse(const QString &raw_content = QString());
+    explicit TtRssGetFeedsCategoriesResponse(const QByteArray &raw_content = QByteArray());
     virtual ~TtRssGetFeedsCategoriesResponse();
 
     // Returns tree of feeds/categories.
     // Top-level root of the tree is not needed here.
     // Returned items do not have primary IDs assigned.
-    RootItem *feedsCategories(bool obtain_icons, QString base_address = QString()) const;
+    // NOTE: Icons are not downloaded here, if "icon_addresses" is given, then
+    // it is filled with full icon addresses of feeds, keyed by custom IDs.
+    RootItem *feedsCategories(QString base_address = QString(), QHash<int,QString> *icon_addresses = NULL) const;
 };
 
 class TtRssGetHeadlinesResponse : public TtRssResponse {
   public:
-    explicit TtRssGetHeadlinesResponse(const QString &raw_content = QString());
+    explicit TtRssGetHeadlinesResponse(const QByteArray &raw_content = QByteArray());
     virtual ~TtRssGetHeadlinesResponse();
 
     QList<Message> messages() const;
@@ -77,7 +85,7 @@ class TtRssGetHeadlinesResponse : public TtRssResponse {
 
 class TtRssUpdateArticleResponse : public TtRssResponse {
   public:
-    explicit TtRssUpdateArticleResponse(const QString &raw_content = QString());
+    explicit TtRssUpdateArticleResponse(const QByteArray &raw_content = QByteArray());
     virtual ~TtRssUpdateArticleResponse();
 
     QString updateStatus() const;
@@ -86,7 +94,7 @@ class TtRssUpdateArticleResponse : public TtRssResponse {
 
 class TtRssSubscribeToFeedResponse : public TtRssResponse {
   public:
-    explicit TtRssSubscribeToFeedResponse(const QString &raw_content = QString());
+    explicit TtRssSubscribeToFeedResponse(const QByteArray &raw_content = QByteArray());
     virtual ~TtRssSubscribeToFeedResponse();
 
     int code() const;
@@ -94,7 +102,7 @@ class TtRssSubscribeToFeedResponse : public TtRssResponse {
 
 class TtRssUnsubscribeFeedResponse : public TtRssResponse {
   public:
-    explicit TtRssUnsubscribeFeedResponse(const QString &raw_content = QString());
+    explicit TtRssUnsubscribeFeedResponse(const QByteArray &raw_content = QByteArray());
     virtual ~TtRssUnsubscribeFeedResponse();
 
     QString code() const;
@@ -140,6 +148,16 @@ class TtRssNetworkFactory {
     bool forceServerSideUpdate() const;
     void setForceServerSideUpdate(bool force_server_side_update);
 
+    // If true, then only headlines and excerpts of messages are synchronized,
+    // full contents are downloaded when messages are displayed.
+    bool headlinesOnly() const;
+    void setHeadlinesOnly(bool headlines_only);
+
+    // If true, then contents of unread messages synchronized without
+    // contents are downloaded in background.
+    bool prefetchContents() const;
+    void setPrefetchContents(bool prefetch_contents);
+
     // Metadata.
     QDateTime lastLoginTime() const;
     QNetworkReply::NetworkError lastError() const;
@@ -158,7 +176,11 @@ class TtRssNetworkFactory {
     // Gets headlines (messages) from the server.
     TtRssGetHeadlinesResponse getHeadlines(int feed_id, int limit, int skip,
                                            bool show_content, bool include_attachments,
-                                           bool sanitize);
+                                           bool sanitize, bool show_excerpt = false);
+
+    // Gets complete articles (messages) with given IDs from the server.
+    // NOTE: Articles are returned in the same format as headlines.
+    TtRssGetHeadlinesResponse getArticles(const QStringList &ids);
 
     TtRssUpdateArticleResponse updateArticles(const QStringList &ids, UpdateArticle::OperatingField field,
                                               UpdateArticle::Mode mode);
@@ -176,6 +198,8 @@ class TtRssNetworkFactory {
     QString m_username;
     QString m_password;
     bool m_forceServerSideUpdate;
+    bool m_headlinesOnly;
+    bool m_prefetchContents;
     bool m_authIsUsed;
     QString m_authUsername;
     QString m_authPassword;
@@ -56,10 +56,10 @@ bool TtRssCategory::markAsReadUnread(RootItem::ReadStatus status) {
     return false;
   }
   else {
-    return serviceRoot()->markFeedsReadUnread(getSubTreeFeeds(), status);
+    return serviceRoot()->markCategoryReadUnread(this, status);
   }
 }
 
 bool TtRssCategory::cleanMessages(bool clear_only_read) {
-  return serviceRoot()->cleanFeeds(getSubTreeFeeds(), clear_only_read);
+  return serviceRoot()->cleanCategory(this, clear_only_read);
 }
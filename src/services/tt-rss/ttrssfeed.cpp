@@ -38,7 +38,7 @@ TtRssFeed::TtRssFeed(RootItem *parent)
 TtRssFeed::TtRssFeed(const QSqlRecord &record) : Feed(nullptr) {
   setTitle(record.value(FDS_DB_TITLE_INDEX).toString());
   setId(record.value(FDS_DB_ID_INDEX).toInt());
-  setIcon(qApp->icons()->fromByteArray(record.value(FDS_DB_ICON_INDEX).toByteArray()));
+  setIcon(qApp->icons()->fromStoreReference(record.value(FDS_DB_ICON_INDEX).toByteArray()));
   setAutoUpdateType(static_cast<Feed::AutoUpdateType>(record.value(FDS_DB_UPDATE_TYPE_INDEX).toInt()));
   setAutoUpdateInitialInterval(record.value(FDS_DB_UPDATE_INTERVAL_INDEX).toInt());
   setCustomId(record.value(FDS_DB_CUSTOM_ID_INDEX).toInt());
@@ -162,9 +162,14 @@ QList<Message> TtRssFeed::obtainNewMessages(bool *error_during_obtaining) {
   int limit = MAX_MESSAGES;
   int skip = 0;
 
+  // Contents are left out if only headlines are synchronized,
+  // excerpts are shown until contents are downloaded.
+  const bool headlines_only = serviceRoot()->network()->headlinesOnly();
+
   do {
     TtRssGetHeadlinesResponse headlines = serviceRoot()->network()->getHeadlines(customId(), limit, skip,
-                                                                                 true, true, false);
+                                                                                 !headlines_only, true, false,
+                                                                                 headlines_only);
 
     if (serviceRoot()->network()->lastError() != QNetworkReply::NoError) {
       setStatus(Feed::NetworkError);
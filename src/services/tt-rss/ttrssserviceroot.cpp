@@ -22,6 +22,7 @@
 #include "miscellaneous/mutex.h"
 #include "miscellaneous/textfactory.h"
 #include "miscellaneous/databasequeries.h"
+#include "miscellaneous/feedreader.h"
 #include "network-web/networkfactory.h"
 #include "miscellaneous/iconfactory.h"
 #include "services/tt-rss/ttrssserviceentrypoint.h"
@@ -30,21 +31,39 @@
 #include "services/tt-rss/ttrsscategory.h"
 #include "services/tt-rss/definitions.h"
 #include "services/tt-rss/network/ttrssnetworkfactory.h"
+#include "services/tt-rss/network/ttrssicondownloader.h"
+#include "services/tt-rss/network/ttrsscontentsdownloader.h"
 #include "services/tt-rss/gui/formeditaccount.h"
 #include "services/tt-rss/gui/formttrssfeeddetails.h"
 
 #include <QSqlTableModel>
+#include <QSqlError>
+#include <QTimer>
+#include <QThread>
 #include <QPair>
 #include <QClipboard>
 
 
 TtRssServiceRoot::TtRssServiceRoot(RootItem *parent)
   : ServiceRoot(parent), m_recycleBin(new TtRssRecycleBin(this)),
-    m_actionSyncIn(nullptr), m_serviceMenu(QList<QAction*>()), m_network(new TtRssNetworkFactory()) {
+    m_actionSyncIn(nullptr), m_serviceMenu(QList<QAction*>()), m_network(new TtRssNetworkFactory()),
+    m_iconDownloader(new TtRssIconDownloader(this)), m_prefetchTimer(new QTimer(this)),
+    m_iconTimer(new QTimer(this)), m_downloadedIcons(QHash<int,QIcon>()), m_contentsThread(nullptr),
+    m_contentsDownloader(nullptr), m_pendingContents(QHash<QString,int>()), m_prefetchRunning(false) {
   setIcon(TtRssServiceEntryPoint().icon());
+
+  m_prefetchTimer->setSingleShot(true);
+  m_prefetchTimer->setInterval(PREFETCH_DELAY);
+  m_iconTimer->setSingleShot(true);
+  m_iconTimer->setInterval(ICON_BATCH_DELAY);
+
+  connect(m_iconDownloader, &TtRssIconDownloader::iconDownloaded, this, &TtRssServiceRoot::onIconDownloaded);
+  connect(m_prefetchTimer, &QTimer::timeout, this, &TtRssServiceRoot::prefetchMessageContents);
+  connect(m_iconTimer, &QTimer::timeout, this, &TtRssServiceRoot::applyDownloadedIcons);
 }
 
 TtRssServiceRoot::~TtRssServiceRoot() {
+  stopContentsDownloader();
   delete m_network;
 }
 
@@ -56,9 +75,18 @@ void TtRssServiceRoot::start(bool freshly_activated) {
   if (qApp->isFirstRun(QSL("3.1.1")) || (childCount() == 1 && child(0)->kind() == RootItemKind::Bin)) {
     syncIn();
   }
+
+  // Contents are prefetched when feeds are not being updated.
+  connect(qApp->feedReader(), &FeedReader::feedUpdatesFinished, this, &TtRssServiceRoot::schedulePrefetch, Qt::UniqueConnection);
+  schedulePrefetch();
 }
 
 void TtRssServiceRoot::stop() {
+  m_prefetchTimer->stop();
+  m_iconTimer->stop();
+  m_iconDownloader->cancel();
+  m_downloadedIcons.clear();
+  stopContentsDownloader();
   m_network->logout();
   qDebug("Stopping Tiny Tiny RSS account, logging out with result '%d'.", (int) m_network->lastError());
 }
@@ -212,6 +240,18 @@ bool TtRssServiceRoot::onBeforeSwitchMessageImportance(RootItem *selected_item,
   }
 }
 
+void TtRssServiceRoot::requestMessageContents(const Message &message) {
+  if (m_pendingContents.contains(message.m_customId)) {
+    // Contents of this message are being downloaded already.
+    return;
+  }
+
+  m_pendingContents.insert(message.m_customId, message.m_id);
+  contentsDownloader()->setNetworkSettings(*m_network);
+  QMetaObject::invokeMethod(m_contentsDownloader, "downloadContents",
+                            Q_ARG(QStringList, QStringList() << message.m_customId), Q_ARG(bool, false));
+}
+
 TtRssNetworkFactory *TtRssServiceRoot::network() const {
   return m_network;
 }
@@ -224,7 +264,8 @@ void TtRssServiceRoot::saveAccountDataToDatabase() {
     if (DatabaseQueries::overwriteTtRssAccount(database, m_network->username(), m_network->password(),
                                                m_network->authIsUsed(), m_network->authUsername(),
                                                m_network->authPassword(), m_network->url(),
-                                               m_network->forceServerSideUpdate(), accountId())) {
+                                               m_network->forceServerSideUpdate(), m_network->headlinesOnly(),
+                                               m_network->prefetchContents(), accountId())) {
       updateTitle();
       itemChanged(QList<RootItem*>() << this);
     }
@@ -237,7 +278,8 @@ void TtRssServiceRoot::saveAccountDataToDatabase() {
       if (DatabaseQueries::createTtRssAccount(database, id_to_assign, m_network->username(),
                                               m_network->password(), m_network->authIsUsed(),
                                               m_network->authUsername(), m_network->authPassword(),
-                                              m_network->url(), m_network->forceServerSideUpdate())) {
+                                              m_network->url(), m_network->forceServerSideUpdate(),
+                                              m_network->headlinesOnly(), m_network->prefetchContents())) {
         setId(id_to_assign);
         setAccountId(id_to_assign);
         updateTitle();
@@ -274,36 +316,212 @@ RootItem *TtRssServiceRoot::obtainNewTreeForSyncIn() const {
   TtRssGetFeedsCategoriesResponse feed_cats_response = m_network->getFeedsCategories();
 
   if (m_network->lastError() == QNetworkReply::NoError) {
-    return feed_cats_response.feedsCategories(true, m_network->url());
+    QHash<int,QString> icon_addresses;
+    RootItem *new_tree = feed_cats_response.feedsCategories(m_network->url(), &icon_addresses);
+    const QHash<int,Feed*> new_feeds = new_tree->getHashedSubTreeFeeds();
+
+    // Icons which are not cached yet are downloaded in background,
+    // they are applied to feeds once feeds are merged into the model.
+    foreach (int feed_custom_id, icon_addresses.keys()) {
+      const QIcon cached_icon = m_iconDownloader->cachedIcon(icon_addresses.value(feed_custom_id));
+
+      if (!cached_icon.isNull() && new_feeds.contains(feed_custom_id)) {
+        new_feeds.value(feed_custom_id)->setIcon(cached_icon);
+      }
+      else {
+        m_iconDownloader->requestIcon(feed_custom_id, icon_addresses.value(feed_custom_id));
+      }
+    }
+
+    return new_tree;
   }
   else {
     return nullptr;
   }
 }
 
-QMap<int,QVariant> TtRssServiceRoot::storeCustomFeedsData() {
-  QMap<int,QVariant> custom_data;
+void TtRssServiceRoot::schedulePrefetch() {
+  if (m_network->headlinesOnly() && m_network->prefetchContents()) {
+    m_prefetchTimer->start();
+  }
+}
+
+void TtRssServiceRoot::prefetchMessageContents() {
+  if (!m_network->headlinesOnly() || !m_network->prefetchContents()) {
+    return;
+  }
+
+  if (qApp->feedReader()->isFeedUpdateRunning() || m_prefetchRunning) {
+    // We are not idle, prefetching continues once update finishes.
+    return;
+  }
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  const QHash<QString,int> ids = DatabaseQueries::getPartialMessagesIds(database, accountId(), PREFETCH_BATCH_SIZE);
+  QStringList custom_ids;
+
+  foreach (const QString &custom_id, ids.keys()) {
+    if (!m_pendingContents.contains(custom_id)) {
+      m_pendingContents.insert(custom_id, ids.value(custom_id));
+      custom_ids.append(custom_id);
+    }
+  }
+
+  if (custom_ids.isEmpty()) {
+    return;
+  }
+
+  m_prefetchRunning = true;
+  contentsDownloader()->setNetworkSettings(*m_network);
+  QMetaObject::invokeMethod(m_contentsDownloader, "downloadContents",
+                            Q_ARG(QStringList, custom_ids), Q_ARG(bool, true));
+}
+
+void TtRssServiceRoot::onContentsDownloaded(const QStringList &custom_ids, const QList<Message> &messages,
+                                            bool ok, bool prefetch) {
+  QHash<QString,int> message_ids;
+
+  foreach (const QString &custom_id, custom_ids) {
+    if (m_pendingContents.contains(custom_id)) {
+      message_ids.insert(custom_id, m_pendingContents.take(custom_id));
+    }
+  }
+
+  if (prefetch) {
+    m_prefetchRunning = false;
+  }
+
+  if (!ok) {
+    // Messages stay partial. Prefetching is not retried until
+    // next update of feeds, messages being displayed are retried
+    // when they are selected again.
+    return;
+  }
+
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  QStringList missing_ids = custom_ids;
+  MessagesChanges changes;
+
+  foreach (const Message &article, messages) {
+    missing_ids.removeOne(article.m_customId);
+  }
+
+  if (!messages.isEmpty() && DatabaseQueries::storeMessagesContents(database, messages, accountId())) {
+    foreach (const Message &article, messages) {
+      if (message_ids.contains(article.m_customId)) {
+        changes.m_updatedIds.append(message_ids.value(article.m_customId));
+      }
+    }
+  }
+
+  // Articles which were not returned are not available on server anymore, so they
+  // would stay partial forever. Their excerpts are kept as their contents.
+  if (!missing_ids.isEmpty() && DatabaseQueries::clearPartialMessages(database, missing_ids, accountId())) {
+    qDebug("TT-RSS: Contents of %d messages are not available on server, excerpts are kept.", missing_ids.size());
+
+    foreach (const QString &custom_id, missing_ids) {
+      if (message_ids.contains(custom_id)) {
+        changes.m_updatedIds.append(message_ids.value(custom_id));
+      }
+    }
+  }
+
+  qDebug("TT-RSS: Contents of %d out of %d messages were downloaded.", messages.size(), custom_ids.size());
+
+  if (!changes.isEmpty()) {
+    messagesChanged(changes);
+  }
+
+  if (prefetch && custom_ids.size() == PREFETCH_BATCH_SIZE) {
+    // There are probably more messages to prefetch.
+    m_prefetchTimer->start();
+  }
+}
+
+TtRssContentsDownloader *TtRssServiceRoot::contentsDownloader() {
+  if (m_contentsDownloader == nullptr) {
+    m_contentsDownloader = new TtRssContentsDownloader();
+    m_contentsThread = new QThread();
+    m_contentsThread->setObjectName(QSL("TtRssContentsDownloader"));
+
+    m_contentsDownloader->moveToThread(m_contentsThread);
+    connect(m_contentsDownloader, &TtRssContentsDownloader::contentsDownloaded, this, &TtRssServiceRoot::onContentsDownloaded);
+
+    m_contentsThread->start();
+  }
+
+  return m_contentsDownloader;
+}
+
+void TtRssServiceRoot::stopContentsDownloader() {
+  if (m_contentsThread != nullptr) {
+    m_contentsThread->quit();
 
-  foreach (const Feed *feed, getSubTreeFeeds()) {
-    QVariantMap feed_custom_data;
+    if (!m_contentsThread->wait(CLOSE_LOCK_TIMEOUT)) {
+      qCritical("TT-RSS: Contents downloader thread is running despite it was told to quit. Terminating it.");
+      m_contentsThread->terminate();
+      m_contentsThread->wait();
+    }
 
-    feed_custom_data.insert(QSL("auto_update_interval"), feed->autoUpdateInitialInterval());
-    feed_custom_data.insert(QSL("auto_update_type"), feed->autoUpdateType());
+    // Thread is not running anymore, so its objects can be deleted right away.
+    delete m_contentsDownloader;
+    delete m_contentsThread;
 
-    custom_data.insert(feed->customId(), feed_custom_data);
+    m_contentsDownloader = nullptr;
+    m_contentsThread = nullptr;
   }
 
-  return custom_data;
+  m_pendingContents.clear();
+  m_prefetchRunning = false;
 }
 
-void TtRssServiceRoot::restoreCustomFeedsData(const QMap<int,QVariant> &data, const QHash<int,Feed*> &feeds) {
-  foreach (int custom_id, data.keys()) {
-    if (feeds.contains(custom_id)) {
-      Feed *feed = feeds.value(custom_id);
-      QVariantMap feed_custom_data = data.value(custom_id).toMap();
+void TtRssServiceRoot::onIconDownloaded(int feed_custom_id, const QIcon &icon) {
+  // Icons are collected and applied together, so that
+  // feeds are looked up only once for many icons.
+  m_downloadedIcons.insert(feed_custom_id, icon);
+
+  if (!m_iconTimer->isActive()) {
+    m_iconTimer->start();
+  }
+}
+
+void TtRssServiceRoot::applyDownloadedIcons() {
+  if (m_downloadedIcons.isEmpty()) {
+    return;
+  }
+
+  const QHash<int,Feed*> feeds = getHashedSubTreeFeeds();
+  QSqlDatabase database = qApp->database()->connection(metaObject()->className(), DatabaseFactory::FromSettings);
+  QList<RootItem*> changed_feeds;
+
+  if (!database.transaction()) {
+    qWarning("TT-RSS: Transaction for storing of icons failed: '%s'.", qPrintable(database.lastError().text()));
+  }
+
+  foreach (int feed_custom_id, m_downloadedIcons.keys()) {
+    Feed *feed = feeds.value(feed_custom_id);
+
+    if (feed == nullptr) {
+      // Feed was removed meanwhile.
+      continue;
+    }
+
+    const QIcon icon = m_downloadedIcons.value(feed_custom_id);
 
-      feed->setAutoUpdateInitialInterval(feed_custom_data.value(QSL("auto_update_interval")).toInt());
-      feed->setAutoUpdateType(static_cast<Feed::AutoUpdateType>(feed_custom_data.value(QSL("auto_update_type")).toInt()));
+    if (DatabaseQueries::editFeedIcon(database, feed->id(), icon)) {
+      feed->setIcon(icon);
+      changed_feeds.append(feed);
     }
   }
+
+  if (!database.commit()) {
+    qWarning("TT-RSS: Committing of icons failed: '%s'.", qPrintable(database.lastError().text()));
+  }
+
+  qDebug("TT-RSS: Icons of %d feeds were updated.", changed_feeds.size());
+  m_downloadedIcons.clear();
+
+  if (!changed_feeds.isEmpty()) {
+    itemChanged(changed_feeds);
+  }
 }
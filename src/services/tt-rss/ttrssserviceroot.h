@@ -26,7 +26,11 @@
 class TtRssCategory;
 class TtRssFeed;
 class TtRssNetworkFactory;
+class TtRssIconDownloader;
+class TtRssContentsDownloader;
 class TtRssRecycleBin;
+class QTimer;
+class QThread;
 
 class TtRssServiceRoot : public ServiceRoot {
     Q_OBJECT
@@ -51,6 +55,7 @@ class TtRssServiceRoot : public ServiceRoot {
 
     bool onBeforeSetMessagesRead(RootItem *selected_item, const QList<Message> &messages, ReadStatus read);
     bool onBeforeSwitchMessageImportance(RootItem *selected_item, const QList<ImportanceChange> &changes);
+    void requestMessageContents(const Message &message);
 
     // Access to network.
     TtRssNetworkFactory *network() const;
@@ -62,17 +67,42 @@ class TtRssServiceRoot : public ServiceRoot {
     void addNewFeed(const QString &url = QString());
     void addNewCategory();
 
+  private slots:
+    void onIconDownloaded(int feed_custom_id, const QIcon &icon);
+    void applyDownloadedIcons();
+
+    // Downloads contents of next batch of unread messages,
+    // which were synchronized without contents.
+    void schedulePrefetch();
+    void prefetchMessageContents();
+
+    // Stores downloaded contents and announces changed messages.
+    void onContentsDownloaded(const QStringList &custom_ids, const QList<Message> &messages, bool ok, bool prefetch);
+
   private:
     RootItem *obtainNewTreeForSyncIn() const;
-    QMap<int,QVariant> storeCustomFeedsData();
-    void restoreCustomFeedsData(const QMap<int,QVariant> &data, const QHash<int,Feed*> &feeds);
 
     void loadFromDatabase();
 
+    // Contents of messages are downloaded in separate thread,
+    // which is started when contents are requested for the first time.
+    TtRssContentsDownloader *contentsDownloader();
+    void stopContentsDownloader();
+
     TtRssRecycleBin *m_recycleBin;
     QAction *m_actionSyncIn;
     QList<QAction*> m_serviceMenu;
     TtRssNetworkFactory *m_network;
+    TtRssIconDownloader *m_iconDownloader;
+    QTimer *m_prefetchTimer;
+    QTimer *m_iconTimer;
+    QHash<int,QIcon> m_downloadedIcons;
+    QThread *m_contentsThread;
+    TtRssContentsDownloader *m_contentsDownloader;
+
+    // Primary IDs of messages whose contents are being downloaded, keyed by custom IDs.
+    QHash<QString,int> m_pendingContents;
+    bool m_prefetchRunning;
 };
 
 #endif // TTRSSSERVICEROOT_H